@@ -0,0 +1,359 @@
+#ifndef CONCURRENT_MAP_HPP
+# define CONCURRENT_MAP_HPP
+
+# include <algorithm>
+# include <cstdlib>
+# include <functional>
+# include <memory>
+# include <new>
+# include <pthread.h>
+# include "map.hpp"
+# include "vector.hpp"
+# include "utils/hash.hpp"
+# include "utils/sync.hpp"
+
+namespace ft {
+
+	/* sharded concurrent map
+	key 를 hash 해서 N 개(2의 거듭제곱)의 ft::map shard 중 하나에 넣는다.
+	shard 마다 reader-writer lock 을 따로 가지므로 서로 다른 shard 를 건드리는 thread 끼리는 기다리지 않는다.
+	shard 는 cache line 단위로 채워서 이웃 shard 의 lock 과 같은 line 을 쓰지 않는다.
+
+	iterator 는 lock 밖으로 나갈 수 없으므로 제공하지 않는다. 조회는 값을 복사해서 돌려주고,
+	순회는 for_each (shard 순서) / parallel_for_each (shard 단위 병렬) / ordered_for_each (key 순서, k-way merge) 로 한다. */
+	template <class Key, class T, class Hash = ft::hash<Key>, class Compare = std::less<Key>, typename Alloc = std::allocator<ft::pair<const Key, T> > >
+	class concurrent_map
+	{
+		public:
+			typedef Key						key_type;
+			typedef T						mapped_type;
+			typedef ft::pair<const Key, T>	value_type;
+			typedef Hash					hasher;
+			typedef Compare					key_compare;
+			typedef Alloc					allocator_type;
+			typedef std::size_t				size_type;
+
+			typedef ft::map<key_type, mapped_type, key_compare, allocator_type>	map_type;
+
+		private:
+			typedef typename map_type::const_iterator	map_const_iterator;
+
+			struct __shard
+			{
+				ft::__rwlock	lock;
+				map_type		map;
+
+				__shard(const key_compare& comp, const allocator_type& alloc) : lock(), map(comp, alloc) {}
+			};
+
+			struct __padded_shard : public __shard
+			{
+				char	__pad[ft::__cache_line_size - sizeof(__shard) % ft::__cache_line_size];
+
+				__padded_shard(const key_compare& comp, const allocator_type& alloc) : __shard(comp, alloc) {}
+			};
+
+			__padded_shard*	__shards;
+			size_type		__mask;
+			hasher			__hash;
+			key_compare		__comp;
+
+			concurrent_map(const concurrent_map&);
+			concurrent_map& operator=(const concurrent_map&);
+
+		public:
+			/* shard_count 는 2의 거듭제곱으로 올림. 보통 thread 수의 몇 배 정도면 충분하다. */
+			explicit concurrent_map(size_type shard_count = 16, const hasher& hash = hasher(),
+				const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+			: __shards(ft::NIL), __mask(0), __hash(hash), __comp(comp)
+			{
+				size_type n = 1;
+				while (n < shard_count)
+					n <<= 1;
+				void* mem;
+				if (posix_memalign(&mem, ft::__cache_line_size, n * sizeof(__padded_shard)) != 0)
+					throw std::bad_alloc();
+				__shards = static_cast<__padded_shard*>(mem);
+				size_type i = 0;
+				try
+				{
+					for ( ; i < n ; ++i)
+						::new (static_cast<void*>(__shards + i)) __padded_shard(comp, alloc);
+				}
+				catch (...)
+				{
+					while (i > 0)
+						__shards[--i].~__padded_shard();
+					std::free(mem);
+					throw;
+				}
+				__mask = n - 1;
+			}
+			~concurrent_map()
+			{
+				for (size_type i = shard_count() ; i > 0 ; --i)
+					__shards[i - 1].~__padded_shard();
+				std::free(__shards);
+			}
+
+			size_type	shard_count() const	{ return __mask + 1; }
+
+			/* shard 를 하나씩 잠그며 더하므로 다른 thread 가 쓰는 중이면 근사값 */
+			size_type	size() const
+			{
+				size_type n = 0;
+				for (size_type i = 0 ; i < shard_count() ; ++i)
+				{
+					ft::__read_guard g(__shards[i].lock);
+					n += __shards[i].map.size();
+				}
+				return n;
+			}
+			bool	empty() const	{ return size() == 0; }
+
+			/* shard 마다 map 의 내역을 더하고, shard 배열에서 map 이 아닌 부분(lock, cache line 채움)을 overhead 로 더한다.
+			size() 처럼 shard 를 하나씩 잠그므로 다른 thread 가 쓰는 중이면 근사값 */
+			ft::memory_footprint	memory_usage() const
+			{
+				ft::memory_footprint m;
+				for (size_type i = 0 ; i < shard_count() ; ++i)
+				{
+					ft::__read_guard g(__shards[i].lock);
+					m += __shards[i].map.memory_usage();
+				}
+				m.overhead += sizeof(*this) + shard_count() * (sizeof(__padded_shard) - sizeof(map_type));
+				m.allocator += ft::__heap_block_overhead(shard_count() * sizeof(__padded_shard));
+				return m;
+			}
+
+			/* point operation : key 의 shard 하나만 잠근다. */
+			bool	insert(const value_type& val)
+			{
+				__shard& s = __shard_of(val.first);
+				ft::__write_guard g(s.lock);
+				return s.map.insert(val).second;
+			}
+
+			/* key 가 없으면 삽입, 있으면 obj 로 바꾼다. 새로 삽입했으면 true */
+			bool	insert_or_assign(const key_type& key, const mapped_type& obj)
+			{
+				__shard& s = __shard_of(key);
+				ft::__write_guard g(s.lock);
+				ft::pair<typename map_type::iterator, bool> p = s.map.try_emplace(key, obj);
+				if (!p.second)
+					p.first->second = obj;
+				return p.second;
+			}
+
+			/* map::upsert 를 shard lock 아래에서 한다. */
+			template <class Combine>
+			bool	upsert(const key_type& key, const mapped_type& obj, Combine combine)
+			{
+				__shard& s = __shard_of(key);
+				ft::__write_guard g(s.lock);
+				return s.map.upsert(key, obj, combine).second;
+			}
+
+			size_type	erase(const key_type& key)
+			{
+				__shard& s = __shard_of(key);
+				ft::__write_guard g(s.lock);
+				return s.map.erase(key);
+			}
+
+			/* 찾으면 mapped 값을 out 에 복사하고 true */
+			bool	find(const key_type& key, mapped_type& out) const
+			{
+				__shard& s = __shard_of(key);
+				ft::__read_guard g(s.lock);
+				map_const_iterator it = s.map.find(key);
+				if (it == s.map.end())
+					return false;
+				out = it->second;
+				return true;
+			}
+
+			size_type	count(const key_type& key) const
+			{
+				__shard& s = __shard_of(key);
+				ft::__read_guard g(s.lock);
+				return s.map.count(key);
+			}
+
+			/* key 가 있으면 write lock 을 잡은 채로 f(mapped&) 를 호출해 제자리에서 고친다. */
+			template <class F>
+			bool	visit(const key_type& key, F f)
+			{
+				__shard& s = __shard_of(key);
+				ft::__write_guard g(s.lock);
+				typename map_type::iterator it = s.map.find(key);
+				if (it == s.map.end())
+					return false;
+				f(it->second);
+				return true;
+			}
+
+			void	clear()
+			{
+				for (size_type i = 0 ; i < shard_count() ; ++i)
+				{
+					ft::__write_guard g(__shards[i].lock);
+					__shards[i].map.clear();
+				}
+			}
+
+			/* shard 를 하나씩 read lock 하며 순회. shard 안에서만 key 순서 */
+			template <class F>
+			F	for_each(F f) const
+			{
+				for (size_type i = 0 ; i < shard_count() ; ++i)
+				{
+					ft::__read_guard g(__shards[i].lock);
+					for (map_const_iterator it = __shards[i].map.begin() ; it != __shards[i].map.end() ; ++it)
+						f(*it);
+				}
+				return f;
+			}
+
+			/* shard-parallel for_each : nthreads 개의 thread 가 shard 를 하나씩 가져가 read lock 아래에서 순회한다.
+			f 는 참조로 공유되어 여러 thread 에서 동시에 불리므로 thread-safe 해야 하고 예외를 던지면 안 된다.
+			nthreads == 0 이면 shard 수만큼 */
+			template <class F>
+			void	parallel_for_each(F& f, size_type nthreads = 0) const
+			{
+				if (nthreads == 0 || nthreads > shard_count())
+					nthreads = shard_count();
+				__for_each_job<F> job(this, &f);
+				ft::vector<pthread_t> threads;
+				threads.reserve(nthreads - 1);
+				for (size_type i = 1 ; i < nthreads ; ++i)
+				{
+					pthread_t th;
+					if (pthread_create(&th, ft::NIL, &concurrent_map::__for_each_worker<F>, &job) != 0)
+						break;
+					threads.push_back(th);
+				}
+				/* 호출한 thread 도 일한다. thread 생성에 실패해도 남은 shard 는 여기서 처리된다. */
+				__for_each_worker<F>(&job);
+				for (size_type i = 0 ; i < threads.size() ; ++i)
+					pthread_join(threads[i], ft::NIL);
+			}
+
+			/* ordered iteration : 모든 shard 를 read lock 한 채로 각 shard 의 정렬된 순서를 k-way merge 해서
+			key 순서대로 f 를 호출한다. 끝날 때까지 쓰기는 막힌다. O(n log N) */
+			template <class F>
+			F	ordered_for_each(F f) const
+			{
+				__read_all_guard g(__shards, shard_count());
+				ft::vector<__cursor> heap;
+				heap.reserve(shard_count());
+				for (size_type i = 0 ; i < shard_count() ; ++i)
+					if (!__shards[i].map.empty())
+						heap.push_back(__cursor(__shards[i].map.begin(), __shards[i].map.end()));
+				__cursor_greater greater(__comp);
+				std::make_heap(heap.begin(), heap.end(), greater);
+				while (!heap.empty())
+				{
+					std::pop_heap(heap.begin(), heap.end(), greater);
+					__cursor& c = heap.back();
+					f(*c.cur);
+					if (++c.cur == c.last)
+						heap.pop_back();
+					else
+						std::push_heap(heap.begin(), heap.end(), greater);
+				}
+				return f;
+			}
+
+			/* 한 시점의 내용을 정렬된 ft::map 으로 복사. 순서대로 들어오므로 hint 삽입으로 O(n) */
+			map_type	to_map() const
+			{
+				map_type out(__comp);
+				ordered_for_each(__append_to(out));
+				return out;
+			}
+
+			hasher		hash_function() const	{ return __hash; }
+			key_compare	key_comp() const		{ return __comp; }
+
+		private:
+			/* lock 은 const 조회에서도 잠가야 하므로 const 함수에서도 shard 를 그대로 돌려준다. */
+			__shard&	__shard_of(const key_type& key) const
+			{ return __shards[__hash(key) & __mask]; }
+
+			template <class F>
+			struct __for_each_job
+			{
+				const concurrent_map*	self;
+				F*						f;
+				size_type				next;
+
+				__for_each_job(const concurrent_map* s, F* func) : self(s), f(func), next(0) {}
+			};
+
+			template <class F>
+			static void*	__for_each_worker(void* arg)
+			{
+				__for_each_job<F>* job = static_cast<__for_each_job<F>*>(arg);
+				for (;;)
+				{
+					size_type i = __sync_fetch_and_add(&job->next, 1);
+					if (i >= job->self->shard_count())
+						break;
+					__shard& s = job->self->__shards[i];
+					ft::__read_guard g(s.lock);
+					for (map_const_iterator it = s.map.begin() ; it != s.map.end() ; ++it)
+						(*job->f)(*it);
+				}
+				return ft::NIL;
+			}
+
+			struct __read_all_guard
+			{
+				__padded_shard*	shards;
+				size_type		n;
+
+				__read_all_guard(__padded_shard* s, size_type count) : shards(s), n(count)
+				{
+					for (size_type i = 0 ; i < n ; ++i)
+						shards[i].lock.read_lock();
+				}
+				~__read_all_guard()
+				{
+					for (size_type i = n ; i > 0 ; --i)
+						shards[i - 1].lock.unlock();
+				}
+			};
+
+			struct __cursor
+			{
+				map_const_iterator	cur;
+				map_const_iterator	last;
+
+				__cursor() {}
+				__cursor(map_const_iterator c, map_const_iterator l) : cur(c), last(l) {}
+			};
+
+			/* std heap 은 max-heap 이므로 반대로 비교해서 가장 작은 key 가 위로 오게 한다. */
+			struct __cursor_greater
+			{
+				key_compare	comp;
+
+				__cursor_greater(const key_compare& c) : comp(c) {}
+				bool	operator()(const __cursor& x, const __cursor& y) const
+				{ return comp(y.cur->first, x.cur->first); }
+			};
+
+			struct __append_to
+			{
+				map_type*	out;
+
+				__append_to(map_type& m) : out(&m) {}
+				void	operator()(const value_type& val)
+				{ out->insert(out->end(), val); }
+			};
+	};
+
+}
+
+#endif
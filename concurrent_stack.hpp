@@ -0,0 +1,366 @@
+#ifndef CONCURRENT_STACK_HPP
+# define CONCURRENT_STACK_HPP
+
+# include <memory>
+# include <new>
+# include <pthread.h>
+# include <stdint.h>
+# include "utils/type.hpp"
+# include "utils/sync.hpp"
+
+namespace ft {
+
+	/* lock-free stack (Treiber)
+	 *
+	 * push / pop 은 head 하나를 CAS 로 바꾼다.
+	 * head 는 (tag 32bit, 노드 번호 32bit) 를 한 64bit word 에 담고, 바꿀 때마다 tag 를 올려서
+	 * 노드가 pop -> 재사용 -> push 되어 같은 번호가 돌아와도(ABA) CAS 가 실패하게 한다.
+	 *
+	 * 노드는 개별로 해제하지 않고 크기가 두 배씩 커지는 segment 에 모아두고, 번호로 찾는다.
+	 * 그래서 다른 thread 가 이미 가져간 노드의 next 를 읽어도 메모리는 항상 유효하다. (해제는 소멸자에서)
+	 * 쓰고 난 노드는 thread 마다의 free list 에 모았다가, 다 차면 그 묶음을 통째로 공용 free list 에 한 번의 CAS 로 넘긴다.
+	 * 공용 free list 는 묶음의 stack 이라 받아올 때도 묶음 하나를 한 번의 CAS 로 가져온다.
+	 *
+	 * push_range / pop_all 은 노드 묶음 전체를 한 번의 CAS 로 연결하거나 떼어낸다.
+	 * T 의 복사는 예외를 던지지 않아야 한다. stack 마다 pthread key 를 하나씩 쓴다.
+	 */
+	template <class T, class Alloc = std::allocator<T> >
+	class concurrent_stack
+	{
+		public:
+			typedef T			value_type;
+			typedef Alloc		allocator_type;
+			typedef std::size_t	size_type;
+
+		private:
+			typedef uint32_t	index_type;
+			typedef uint64_t	head_type;
+
+			struct __node
+			{
+				index_type	next;
+				/* 공용 free list 에서 다음 묶음의 맨 위 노드 */
+				index_type	batch_next;
+				union
+				{
+					char		buf[sizeof(value_type)];
+					long double	__align_ld;
+					void*		__align_ptr;
+					uint64_t	__align_u64;
+				}			storage;
+
+				value_type*	value()	{ return reinterpret_cast<value_type*>(storage.buf); }
+			};
+
+			typedef typename Alloc::template rebind<__node>::other	node_allocator;
+
+			/* thread 마다의 free list. (thread, stack) 쌍마다 하나씩 만들어 정리용 목록에 등록한다. */
+			struct __local_cache
+			{
+				concurrent_stack*	owner;
+				index_type			head;
+				size_type			count;
+				__local_cache*		next_registered;
+			};
+
+			/* segment k 는 __segment_base << k 개의 노드를 가진다. */
+			static const index_type	__segment_base = 64;
+			static const int		__max_segments = 27;
+			/* 로컬 free list 가 이만큼 차면 공용 free list 로 넘긴다. (pop_all 로 한꺼번에 돌려받으면 묶음이 이보다 클 수 있다) */
+			static const size_type	__local_limit = 256;
+			/* 노드 번호를 한 번에 이만큼씩 받아온다. */
+			static const index_type	__index_batch = 32;
+
+			/* 자주 CAS 되는 값들은 각자 cache line 을 쓴다. */
+			volatile head_type	__head;
+			char				__pad0[ft::__cache_line_size - sizeof(head_type)];
+			volatile head_type	__free_head;
+			char				__pad1[ft::__cache_line_size - sizeof(head_type)];
+			volatile index_type	__next_index;
+			char				__pad2[ft::__cache_line_size - sizeof(index_type)];
+
+			__node* volatile		__segments[__max_segments];
+			__local_cache* volatile	__caches;
+			pthread_key_t			__key;
+			node_allocator			__alloc;
+
+			concurrent_stack(const concurrent_stack&);
+			concurrent_stack& operator=(const concurrent_stack&);
+
+		public:
+			explicit concurrent_stack(const allocator_type& alloc = allocator_type())
+			: __head(0), __free_head(0), __next_index(0), __caches(ft::NIL), __alloc(alloc)
+			{
+				for (int i = 0 ; i < __max_segments ; ++i)
+					__segments[i] = ft::NIL;
+				if (pthread_key_create(&__key, &concurrent_stack::__on_thread_exit) != 0)
+					throw std::bad_alloc();
+			}
+			/* 다른 thread 가 더 이상 쓰지 않을 때 호출되어야 한다. */
+			~concurrent_stack()
+			{
+				pthread_key_delete(__key);
+				for (index_type i = __index_of(__head) ; i != 0 ; i = __node_at(i)->next)
+					__node_at(i)->value()->~value_type();
+				for (__local_cache* c = __caches ; c != ft::NIL ; )
+				{
+					__local_cache* next = c->next_registered;
+					delete c;
+					c = next;
+				}
+				for (int k = 0 ; k < __max_segments && __segments[k] != ft::NIL ; ++k)
+					__alloc.deallocate(__segments[k], __segment_size(k));
+			}
+
+			bool	empty() const	{ return __index_of(__load(&__head)) == 0; }
+
+			void	push(const value_type& val)
+			{
+				__local_cache* cache = __get_cache();
+				__node* nd;
+				index_type i = __take_node(cache, nd);
+				::new (static_cast<void*>(nd->value())) value_type(val);
+				__push_chain(&__head, i, i);
+			}
+
+			/* 비어있으면 false */
+			bool	try_pop(value_type& out)
+			{
+				head_type old = __load(&__head);
+				for (;;)
+				{
+					index_type i = __index_of(old);
+					if (i == 0)
+						return false;
+					/* 그 사이 다른 thread 가 i 를 가져가 재사용했다면 next 는 엉뚱하지만 tag 가 달라 CAS 가 실패한다. */
+					head_type desired = __make_head(__node_at(i)->next, __tag_of(old) + 1);
+					head_type seen = __sync_val_compare_and_swap(&__head, old, desired);
+					if (seen == old)
+						break;
+					old = seen;
+				}
+				index_type i = __index_of(old);
+				__node* nd = __node_at(i);
+				out = *nd->value();
+				nd->value()->~value_type();
+				__give_node(__get_cache(), i);
+				return true;
+			}
+
+			/* [first, last) 를 차례로 push 한 것과 같은 결과. 노드를 미리 이어두고 한 번의 CAS 로 붙인다. */
+			template <class InputIterator>
+			void	push_range(InputIterator first, InputIterator last)
+			{
+				if (first == last)
+					return;
+				__local_cache* cache = __get_cache();
+				index_type bottom = 0;
+				index_type top = 0;
+				for ( ; first != last ; ++first)
+				{
+					__node* nd;
+					index_type i = __take_node(cache, nd);
+					::new (static_cast<void*>(nd->value())) value_type(*first);
+					nd->next = top;
+					if (bottom == 0)
+						bottom = i;
+					top = i;
+				}
+				__push_chain(&__head, top, bottom);
+			}
+
+			/* 한 번의 CAS 로 stack 을 통째로 떼어내 pop 순서(LIFO)대로 out 에 쓴다. 꺼낸 개수 반환
+			 * 떼어낸 노드들은 next 로 이어진 그대로 로컬 free list 앞에 한 번에 붙인다. */
+			template <class OutputIterator>
+			size_type	pop_all(OutputIterator out)
+			{
+				index_type top = __take_all(&__head);
+				if (top == 0)
+					return 0;
+				index_type bottom = top;
+				size_type n = 0;
+				for (index_type i = top ; i != 0 ; ++n)
+				{
+					__node* nd = __node_at(i);
+					*out = *nd->value();
+					++out;
+					nd->value()->~value_type();
+					bottom = i;
+					i = nd->next;
+				}
+				__give_chain(__get_cache(), top, bottom, n);
+				return n;
+			}
+
+		private:
+			static index_type	__index_of(head_type h)	{ return static_cast<index_type>(h); }
+			static index_type	__tag_of(head_type h)	{ return static_cast<index_type>(h >> 32); }
+			static head_type	__make_head(index_type i, index_type tag)
+			{ return (static_cast<head_type>(tag) << 32) | i; }
+
+			/* 64bit 시스템에선 정렬된 64bit 읽기가 atomic 이지만 32bit 에선 CAS 로 읽는다. */
+			static head_type	__load(const volatile head_type* p)
+			{
+				if (sizeof(void*) >= sizeof(head_type))
+					return *p;
+				return __sync_val_compare_and_swap(const_cast<volatile head_type*>(p), 0, 0);
+			}
+
+			static size_type	__segment_size(int k)	{ return static_cast<size_type>(__segment_base) << k; }
+
+			/* 노드 번호는 1 부터 (0 은 null). 번호 n 은 segment floor(log2((n - 1) / base + 1)) 에 있다. */
+			__node*	__node_at(index_type i) const
+			{
+				index_type n = (i - 1) / __segment_base + 1;
+				int k = 31 - __builtin_clz(n);
+				index_type offset = (i - 1) - __segment_base * ((static_cast<index_type>(1) << k) - 1);
+				return __segments[k] + offset;
+			}
+
+			/* 처음 쓰는 segment 면 할당해서 CAS 로 설치한다. 먼저 설치한 thread 가 있으면 내 것은 버린다. */
+			void	__ensure_segment(index_type i)
+			{
+				int k = 31 - __builtin_clz((i - 1) / __segment_base + 1);
+				if (k >= __max_segments)
+					throw std::bad_alloc();
+				if (__segments[k] != ft::NIL)
+					return;
+				__node* seg = __alloc.allocate(__segment_size(k));
+				if (!__sync_bool_compare_and_swap(&__segments[k], static_cast<__node*>(ft::NIL), seg))
+					__alloc.deallocate(seg, __segment_size(k));
+			}
+
+			/* top -> ... -> bottom 로 이어진 묶음을 list 위에 붙인다. */
+			void	__push_chain(volatile head_type* list, index_type top, index_type bottom)
+			{
+				head_type old = __load(list);
+				for (;;)
+				{
+					__node_at(bottom)->next = __index_of(old);
+					head_type seen = __sync_val_compare_and_swap(list, old, __make_head(top, __tag_of(old) + 1));
+					if (seen == old)
+						return;
+					old = seen;
+				}
+			}
+
+			/* list 전체를 떼어낸다. next 를 읽지 않으므로 ABA 와 무관하다. */
+			static index_type	__take_all(volatile head_type* list)
+			{
+				head_type old = __load(list);
+				for (;;)
+				{
+					if (__index_of(old) == 0)
+						return 0;
+					head_type seen = __sync_val_compare_and_swap(list, old, __make_head(0, __tag_of(old) + 1));
+					if (seen == old)
+						return __index_of(old);
+					old = seen;
+				}
+			}
+
+			/* 로컬 -> 공용 free list -> 새 번호 순으로 빈 노드를 구한다. 번호를 돌려주고 노드는 nd 에 */
+			index_type	__take_node(__local_cache* cache, __node*& nd)
+			{
+				if (cache->head == 0)
+					__refill(cache);
+				index_type i = cache->head;
+				nd = __node_at(i);
+				cache->head = nd->next;
+				--cache->count;
+				return i;
+			}
+			void	__refill(__local_cache* cache)
+			{
+				index_type i = __pop_batch();
+				if (i != 0)
+				{
+					cache->head = i;
+					for ( ; i != 0 ; i = __node_at(i)->next)
+						++cache->count;
+					return;
+				}
+				index_type first = __sync_fetch_and_add(&__next_index, __index_batch) + 1;
+				if (first + __index_batch < first)
+					throw std::bad_alloc();
+				for (index_type j = first ; j < first + __index_batch ; ++j)
+				{
+					__ensure_segment(j);
+					__node_at(j)->next = cache->head;
+					cache->head = j;
+					++cache->count;
+				}
+			}
+			void	__give_node(__local_cache* cache, index_type i)
+			{ __give_chain(cache, i, i, 1); }
+			/* top -> ... -> bottom 로 이어진 n 개를 로컬 free list 앞에 붙인다. */
+			void	__give_chain(__local_cache* cache, index_type top, index_type bottom, size_type n)
+			{
+				__node_at(bottom)->next = cache->head;
+				cache->head = top;
+				cache->count += n;
+				if (cache->count >= __local_limit)
+					__flush(cache);
+			}
+			/* 로컬 free list 를 묶음 하나로 공용 free list 에 올린다. 묶음 안은 next 로 이어진 그대로 둔다. */
+			void	__flush(__local_cache* cache)
+			{
+				if (cache->head == 0)
+					return;
+				head_type old = __load(&__free_head);
+				for (;;)
+				{
+					__node_at(cache->head)->batch_next = __index_of(old);
+					head_type seen = __sync_val_compare_and_swap(&__free_head, old, __make_head(cache->head, __tag_of(old) + 1));
+					if (seen == old)
+						break;
+					old = seen;
+				}
+				cache->head = 0;
+				cache->count = 0;
+			}
+			/* 묶음 하나를 떼어온다. try_pop 과 같은 방식이라 tag 로 ABA 를 막는다. */
+			index_type	__pop_batch()
+			{
+				head_type old = __load(&__free_head);
+				for (;;)
+				{
+					index_type i = __index_of(old);
+					if (i == 0)
+						return 0;
+					head_type desired = __make_head(__node_at(i)->batch_next, __tag_of(old) + 1);
+					head_type seen = __sync_val_compare_and_swap(&__free_head, old, desired);
+					if (seen == old)
+						return i;
+					old = seen;
+				}
+			}
+
+			__local_cache*	__get_cache()
+			{
+				__local_cache* cache = static_cast<__local_cache*>(pthread_getspecific(__key));
+				if (cache != ft::NIL)
+					return cache;
+				cache = new __local_cache();
+				cache->owner = this;
+				cache->head = 0;
+				cache->count = 0;
+				__local_cache* old = __caches;
+				do {
+					cache->next_registered = old;
+					old = __sync_val_compare_and_swap(&__caches, cache->next_registered, cache);
+				} while (old != cache->next_registered);
+				pthread_setspecific(__key, cache);
+				return cache;
+			}
+			/* thread 가 끝나면 그 thread 의 빈 노드를 공용 free list 로 돌려준다. cache 자체는 소멸자에서 해제 */
+			static void	__on_thread_exit(void* arg)
+			{
+				__local_cache* cache = static_cast<__local_cache*>(arg);
+				cache->owner->__flush(cache);
+			}
+	};
+
+}
+
+#endif
@@ -0,0 +1,186 @@
+#ifndef FROZEN_MAP_HPP
+# define FROZEN_MAP_HPP
+
+# include <memory>
+# include <functional>
+# include <stdexcept>
+# include "./map.hpp"
+# include "./utils/pair.hpp"
+# include "./utils/iterator.hpp"
+# include "./utils/frozen_table.hpp"
+# include "./utils/snapshot.hpp"
+# include "./utils/algorithm.hpp"
+
+namespace ft {
+
+	/* 읽기 전용 map (frozen_set 참고). key 도 mapped 값도 바꿀 수 없다.
+	원소 비교는 ft::map 의 value_compare 를 그대로 쓴다. */
+	template <class Key, class T, class Compare = std::less<Key>, typename Alloc = std::allocator<ft::pair<const Key, T> >, typename Layout = ft::eytzinger_layout>
+	class frozen_map
+	{
+		public:
+			typedef Key						key_type;
+			typedef T						mapped_type;
+			typedef ft::pair<const Key, T>	value_type;
+			typedef Compare					key_compare;
+			typedef Alloc					allocator_type;
+			typedef Layout					layout_type;
+			typedef const value_type&		reference;
+			typedef const value_type&		const_reference;
+			typedef std::ptrdiff_t			difference_type;
+			typedef std::size_t				size_type;
+
+			typedef typename ft::map<Key, T, Compare, Alloc>::value_compare	value_compare;
+
+		private:
+			typedef ft::__frozen_table<value_type, value_compare, allocator_type, layout_type>	__table_type;
+
+		public:
+			typedef ft::frozen_iterator<const value_type, __table_type>	const_iterator;
+			typedef const_iterator							iterator;
+			typedef ft::reverse_iterator<const_iterator>	const_reverse_iterator;
+			typedef const_reverse_iterator					reverse_iterator;
+
+			explicit frozen_map(const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+			: __key_comp(comp), __value_comp(comp), __table(__value_comp, alloc) {}
+
+			/* [first, last) 는 key 로 정렬되어 있고 key 가 중복되지 않아야 한다. 아니면 std::invalid_argument. O(n) */
+			template <typename ForwardIterator>
+			frozen_map(ForwardIterator first, ForwardIterator last, const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type(),
+				typename ft::enable_if<!ft::is_integral<ForwardIterator>::value>::type* = ft::NIL)
+			: __key_comp(comp), __value_comp(comp), __table(__value_comp, alloc)
+			{
+				size_type n = 0;
+				for (ForwardIterator it = first ; it != last ; ++it)
+					++n;
+				if (!ft::__snapshot_sorted(first, n, __value_comp))
+					throw std::invalid_argument("ft::frozen_map: range not sorted or not unique");
+				__table.__build(first, n);
+			}
+
+			template <bool OS>
+			explicit frozen_map(const ft::map<Key, T, Compare, Alloc, OS>& m)
+			: __key_comp(m.key_comp()), __value_comp(m.key_comp()), __table(__value_comp, m.get_allocator())
+			{ __table.__build(m.begin(), m.size()); }
+
+			frozen_map(const frozen_map& rhs)
+			: __key_comp(rhs.__key_comp), __value_comp(rhs.__value_comp), __table(rhs.__table) {}
+			~frozen_map() {}
+			frozen_map& operator=(const frozen_map& rhs)
+			{
+				frozen_map tmp(rhs);
+				swap(tmp);
+				return *this;
+			}
+
+			const_iterator			begin() const	{ return const_iterator(__table.__view(), __table.__begin()); }
+			const_iterator			end() const		{ return const_iterator(__table.__view(), __table.__end()); }
+			const_reverse_iterator	rbegin() const	{ return const_reverse_iterator(end()); }
+			const_reverse_iterator	rend() const	{ return const_reverse_iterator(begin()); }
+
+			bool		empty()		const { return __table.size() == 0; }
+			size_type	size()		const { return __table.size(); }
+			size_type	max_size()	const { return __table.get_allocator().max_size(); }
+
+			const mapped_type&	at(const key_type& key) const
+			{
+				const_iterator i = find(key);
+				if (i == end())
+					throw std::out_of_range("ft::frozen_map::at");
+				return i->second;
+			}
+
+			void	swap(frozen_map& m)
+			{
+				std::swap(__key_comp, m.__key_comp);
+				std::swap(__value_comp, m.__value_comp);
+				__table.swap(m.__table);
+			}
+
+			key_compare		key_comp() const	{ return __key_comp; }
+			value_compare	value_comp() const	{ return __value_comp; }
+
+			const_iterator	find(const key_type& key) const			{ return __find(key); }
+			size_type		count(const key_type& key) const		{ return !(find(key) == end()); }
+			const_iterator	lower_bound(const key_type& key) const	{ return const_iterator(__table.__view(), __table.__lower_bound(key)); }
+			const_iterator	upper_bound(const key_type& key) const	{ return const_iterator(__table.__view(), __table.__upper_bound(key)); }
+			ft::pair<const_iterator, const_iterator>	equal_range(const key_type& key) const
+			{ return ft::make_pair(lower_bound(key), upper_bound(key)); }
+
+			/* heterogeneous lookup : key_compare::is_transparent 가 있을 때만 */
+			template <typename K>
+			typename ft::enable_if<ft::__is_transparent<key_compare, K>::value, const_iterator>::type
+			find(const K& key) const	{ return __find(key); }
+
+			template <typename K>
+			typename ft::enable_if<ft::__is_transparent<key_compare, K>::value, size_type>::type
+			count(const K& key) const	{ return !(find(key) == end()); }
+
+			template <typename K>
+			typename ft::enable_if<ft::__is_transparent<key_compare, K>::value, const_iterator>::type
+			lower_bound(const K& key) const	{ return const_iterator(__table.__view(), __table.__lower_bound(key)); }
+
+			template <typename K>
+			typename ft::enable_if<ft::__is_transparent<key_compare, K>::value, const_iterator>::type
+			upper_bound(const K& key) const	{ return const_iterator(__table.__view(), __table.__upper_bound(key)); }
+
+			template <typename K>
+			typename ft::enable_if<ft::__is_transparent<key_compare, K>::value, ft::pair<const_iterator, const_iterator> >::type
+			equal_range(const K& key) const	{ return ft::make_pair(lower_bound(key), upper_bound(key)); }
+
+			allocator_type	get_allocator() const	{ return __table.get_allocator(); }
+
+			/* 배열(과 veb 의 순서 표)의 내역에 map 객체를 더한다. (utils/footprint.hpp) */
+			ft::memory_footprint	memory_usage() const
+			{
+				ft::memory_footprint m = __table.memory_usage();
+				m.overhead += sizeof(*this);
+				return m;
+			}
+
+		private:
+			key_compare		__key_comp;
+			value_compare	__value_comp;
+			__table_type	__table;
+
+			template <typename K>
+			const_iterator	__find(const K& key) const
+			{
+				typename __table_type::size_type i = __table.__lower_bound(key);
+				if (i == __table.__end() || __value_comp(key, __table.__at(i)))
+					return end();
+				return const_iterator(__table.__view(), i);
+			}
+	};
+
+	template <class Key, class T, class Compare, class Alloc, class Layout>
+	bool	operator==(const ft::frozen_map<Key, T, Compare, Alloc, Layout>& x, const ft::frozen_map<Key, T, Compare, Alloc, Layout>& y)
+	{ return x.size() == y.size() && ft::equal(x.begin(), x.end(), y.begin()); }
+
+	template <class Key, class T, class Compare, class Alloc, class Layout>
+	bool	operator!=(const ft::frozen_map<Key, T, Compare, Alloc, Layout>& x, const ft::frozen_map<Key, T, Compare, Alloc, Layout>& y)
+	{ return !(x == y); }
+
+	template <class Key, class T, class Compare, class Alloc, class Layout>
+	bool	operator<(const ft::frozen_map<Key, T, Compare, Alloc, Layout>& x, const ft::frozen_map<Key, T, Compare, Alloc, Layout>& y)
+	{ return ft::lexicographical_compare(x.begin(), x.end(), y.begin(), y.end()); }
+
+	template <class Key, class T, class Compare, class Alloc, class Layout>
+	bool	operator<=(const ft::frozen_map<Key, T, Compare, Alloc, Layout>& x, const ft::frozen_map<Key, T, Compare, Alloc, Layout>& y)
+	{ return !(y < x); }
+
+	template <class Key, class T, class Compare, class Alloc, class Layout>
+	bool	operator>(const ft::frozen_map<Key, T, Compare, Alloc, Layout>& x, const ft::frozen_map<Key, T, Compare, Alloc, Layout>& y)
+	{ return y < x; }
+
+	template <class Key, class T, class Compare, class Alloc, class Layout>
+	bool	operator>=(const ft::frozen_map<Key, T, Compare, Alloc, Layout>& x, const ft::frozen_map<Key, T, Compare, Alloc, Layout>& y)
+	{ return !(x < y); }
+
+	template <class Key, class T, class Compare, class Alloc, class Layout>
+	void	swap(ft::frozen_map<Key, T, Compare, Alloc, Layout>& x, ft::frozen_map<Key, T, Compare, Alloc, Layout>& y)
+	{ x.swap(y); }
+
+}
+
+#endif
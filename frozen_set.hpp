@@ -0,0 +1,174 @@
+#ifndef FROZEN_SET_HPP
+# define FROZEN_SET_HPP
+
+# include <memory>
+# include <functional>
+# include <stdexcept>
+# include "./set.hpp"
+# include "./utils/pair.hpp"
+# include "./utils/iterator.hpp"
+# include "./utils/frozen_table.hpp"
+# include "./utils/snapshot.hpp"
+# include "./utils/algorithm.hpp"
+
+namespace ft {
+
+	/* 읽기 전용 set : 만들 때 한 번 배열에 펼쳐두고 이후엔 조회만 한다. (frozen_table.hpp 참고)
+	ft::set 이나 정렬되고 중복 없는 범위로 만든다. 조회와 순회는 set 과 같고 원소를 바꾸는 함수는 없다.
+	Layout : ft::eytzinger_layout (기본) / ft::veb_layout */
+	template <typename T, typename Compare = std::less<T>, typename Alloc = std::allocator<T>, typename Layout = ft::eytzinger_layout>
+	class frozen_set
+	{
+		public:
+			typedef T					key_type;
+			typedef T					value_type;
+			typedef Compare				key_compare;
+			typedef Compare				value_compare;
+			typedef Alloc				allocator_type;
+			typedef Layout				layout_type;
+			typedef const value_type&	reference;
+			typedef const value_type&	const_reference;
+			typedef std::ptrdiff_t		difference_type;
+			typedef std::size_t			size_type;
+
+		private:
+			typedef ft::__frozen_table<value_type, value_compare, allocator_type, layout_type>	__table_type;
+
+		public:
+			typedef ft::frozen_iterator<const value_type, __table_type>	const_iterator;
+			typedef const_iterator							iterator;
+			typedef ft::reverse_iterator<const_iterator>	const_reverse_iterator;
+			typedef const_reverse_iterator					reverse_iterator;
+
+			explicit frozen_set(const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+			: __comp(comp), __table(comp, alloc) {}
+
+			/* [first, last) 는 comp 로 정렬되어 있고 중복이 없어야 한다. 아니면 std::invalid_argument. O(n) */
+			template <typename ForwardIterator>
+			frozen_set(ForwardIterator first, ForwardIterator last, const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type(),
+				typename ft::enable_if<!ft::is_integral<ForwardIterator>::value>::type* = ft::NIL)
+			: __comp(comp), __table(comp, alloc)
+			{
+				size_type n = 0;
+				for (ForwardIterator it = first ; it != last ; ++it)
+					++n;
+				if (!ft::__snapshot_sorted(first, n, __comp))
+					throw std::invalid_argument("ft::frozen_set: range not sorted or not unique");
+				__table.__build(first, n);
+			}
+
+			template <bool OS>
+			explicit frozen_set(const ft::set<T, Compare, Alloc, OS>& s)
+			: __comp(s.key_comp()), __table(s.key_comp(), s.get_allocator())
+			{ __table.__build(s.begin(), s.size()); }
+
+			frozen_set(const frozen_set& rhs) : __comp(rhs.__comp), __table(rhs.__table) {}
+			~frozen_set() {}
+			frozen_set& operator=(const frozen_set& rhs)
+			{
+				frozen_set tmp(rhs);
+				swap(tmp);
+				return *this;
+			}
+
+			const_iterator			begin() const	{ return const_iterator(__table.__view(), __table.__begin()); }
+			const_iterator			end() const		{ return const_iterator(__table.__view(), __table.__end()); }
+			const_reverse_iterator	rbegin() const	{ return const_reverse_iterator(end()); }
+			const_reverse_iterator	rend() const	{ return const_reverse_iterator(begin()); }
+
+			bool		empty()		const { return __table.size() == 0; }
+			size_type	size()		const { return __table.size(); }
+			size_type	max_size()	const { return __table.get_allocator().max_size(); }
+
+			void	swap(frozen_set& s)
+			{
+				std::swap(__comp, s.__comp);
+				__table.swap(s.__table);
+			}
+
+			key_compare		key_comp() const	{ return __comp; }
+			value_compare	value_comp() const	{ return __comp; }
+
+			const_iterator	find(const value_type& val) const			{ return __find(val); }
+			size_type		count(const value_type& val) const			{ return !(find(val) == end()); }
+			const_iterator	lower_bound(const value_type& val) const	{ return const_iterator(__table.__view(), __table.__lower_bound(val)); }
+			const_iterator	upper_bound(const value_type& val) const	{ return const_iterator(__table.__view(), __table.__upper_bound(val)); }
+			ft::pair<const_iterator, const_iterator>	equal_range(const value_type& val) const
+			{ return ft::make_pair(lower_bound(val), upper_bound(val)); }
+
+			/* heterogeneous lookup : key_compare::is_transparent 가 있을 때만 */
+			template <typename K>
+			typename ft::enable_if<ft::__is_transparent<key_compare, K>::value, const_iterator>::type
+			find(const K& key) const	{ return __find(key); }
+
+			template <typename K>
+			typename ft::enable_if<ft::__is_transparent<key_compare, K>::value, size_type>::type
+			count(const K& key) const	{ return !(find(key) == end()); }
+
+			template <typename K>
+			typename ft::enable_if<ft::__is_transparent<key_compare, K>::value, const_iterator>::type
+			lower_bound(const K& key) const	{ return const_iterator(__table.__view(), __table.__lower_bound(key)); }
+
+			template <typename K>
+			typename ft::enable_if<ft::__is_transparent<key_compare, K>::value, const_iterator>::type
+			upper_bound(const K& key) const	{ return const_iterator(__table.__view(), __table.__upper_bound(key)); }
+
+			template <typename K>
+			typename ft::enable_if<ft::__is_transparent<key_compare, K>::value, ft::pair<const_iterator, const_iterator> >::type
+			equal_range(const K& key) const	{ return ft::make_pair(lower_bound(key), upper_bound(key)); }
+
+			allocator_type	get_allocator() const	{ return __table.get_allocator(); }
+
+			/* 배열(과 veb 의 순서 표)의 내역에 set 객체를 더한다. (utils/footprint.hpp) */
+			ft::memory_footprint	memory_usage() const
+			{
+				ft::memory_footprint m = __table.memory_usage();
+				m.overhead += sizeof(*this);
+				return m;
+			}
+
+		private:
+			key_compare		__comp;
+			__table_type	__table;
+
+			template <typename K>
+			const_iterator	__find(const K& key) const
+			{
+				typename __table_type::size_type i = __table.__lower_bound(key);
+				if (i == __table.__end() || __comp(key, __table.__at(i)))
+					return end();
+				return const_iterator(__table.__view(), i);
+			}
+	};
+
+	template <typename T, typename Compare, typename Alloc, typename Layout>
+	bool	operator==(const ft::frozen_set<T, Compare, Alloc, Layout>& lhs, const ft::frozen_set<T, Compare, Alloc, Layout>& rhs)
+	{ return lhs.size() == rhs.size() && ft::equal(lhs.begin(), lhs.end(), rhs.begin()); }
+
+	template <typename T, typename Compare, typename Alloc, typename Layout>
+	bool	operator!=(const ft::frozen_set<T, Compare, Alloc, Layout>& lhs, const ft::frozen_set<T, Compare, Alloc, Layout>& rhs)
+	{ return !(lhs == rhs); }
+
+	template <typename T, typename Compare, typename Alloc, typename Layout>
+	bool	operator<(const ft::frozen_set<T, Compare, Alloc, Layout>& lhs, const ft::frozen_set<T, Compare, Alloc, Layout>& rhs)
+	{ return ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end()); }
+
+	template <typename T, typename Compare, typename Alloc, typename Layout>
+	bool	operator<=(const ft::frozen_set<T, Compare, Alloc, Layout>& lhs, const ft::frozen_set<T, Compare, Alloc, Layout>& rhs)
+	{ return !(rhs < lhs); }
+
+	template <typename T, typename Compare, typename Alloc, typename Layout>
+	bool	operator>(const ft::frozen_set<T, Compare, Alloc, Layout>& lhs, const ft::frozen_set<T, Compare, Alloc, Layout>& rhs)
+	{ return rhs < lhs; }
+
+	template <typename T, typename Compare, typename Alloc, typename Layout>
+	bool	operator>=(const ft::frozen_set<T, Compare, Alloc, Layout>& lhs, const ft::frozen_set<T, Compare, Alloc, Layout>& rhs)
+	{ return !(lhs < rhs); }
+
+	template <typename T, typename Compare, typename Alloc, typename Layout>
+	void	swap(ft::frozen_set<T, Compare, Alloc, Layout>& lhs, ft::frozen_set<T, Compare, Alloc, Layout>& rhs)
+	{ lhs.swap(rhs); }
+
+}
+
+#endif
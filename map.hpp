@@ -19,10 +19,17 @@
 # include "utils/iterator.hpp"
 # include "utils/rbtree.hpp"
 # include "utils/algorithm.hpp"
+# include "utils/compare.hpp"
+# include "utils/node_handle.hpp"
+# include "utils/snapshot.hpp"
+# include "utils/trace_hook.hpp"
+# include "vector.hpp"
 
 namespace ft {
 
-	template <class Key, class T, class Compare = std::less<Key>, typename Alloc = std::allocator<ft::pair<const Key,T> > >
+	/* OrderStat == true 면 tree 가 sub-tree 크기를 유지한다.
+	rank / select / count_range 와 iterator 의 distance / advance 가 O(log n) 이 된다. */
+	template <class Key, class T, class Compare = std::less<Key>, typename Alloc = std::allocator<ft::pair<const Key,T> >, bool OrderStat = false>
 	class map
 	{
 		public:
@@ -41,14 +48,16 @@ namespace ft {
 			typedef std::size_t	size_type;
 			typedef std::ptrdiff_t	difference_type;
 
+			/* key 비교자가 three-way를 지원하면 __value_compare_base가 compare()를 제공한다. */
 			class value_compare
-				: public std::binary_function<value_type, value_type, bool>
+				: public std::binary_function<value_type, value_type, bool>,
+				public ft::__value_compare_base<value_type, key_type, key_compare>
 			{
 				friend class map;
 					protected:
-						key_compare comp;
+						using ft::__value_compare_base<value_type, key_type, key_compare>::comp;
 					public:
-						value_compare(key_compare c): comp(c){}
+						value_compare(key_compare c): ft::__value_compare_base<value_type, key_type, key_compare>(c){}
 						~value_compare(){}
 
 						bool operator()(const value_type& x, const value_type& y) const
@@ -59,18 +68,47 @@ namespace ft {
 
 						bool operator()(const key_type& x, const value_type& y) const
 						{ return comp(x, y.first); }
+
+						/* transparent key_compare 일 때 key_type 이 아닌 타입과의 비교 */
+						template <typename K>
+						typename ft::enable_if<ft::__is_transparent<key_compare, K>::value, bool>::type
+						operator()(const value_type& x, const K& y) const
+						{ return comp(x.first, y); }
+
+						template <typename K>
+						typename ft::enable_if<ft::__is_transparent<key_compare, K>::value, bool>::type
+						operator()(const K& x, const value_type& y) const
+						{ return comp(x, y.first); }
 			};
 
 		/* iterator */
-		typedef typename ft::__rbt<value_type, key_type, value_compare, allocator_type>::iterator iterator;
-		typedef typename ft::__rbt<value_type, key_type, value_compare, allocator_type>::const_iterator const_iterator;
+		typedef typename ft::__rbt<value_type, key_type, value_compare, allocator_type, OrderStat>::iterator iterator;
+		typedef typename ft::__rbt<value_type, key_type, value_compare, allocator_type, OrderStat>::const_iterator const_iterator;
 		typedef ft::reverse_iterator<iterator> reverse_iterator;
 		typedef ft::reverse_iterator<const_iterator> const_reverse_iterator;
 
+		/* node handle : extract 로 떼어낸 노드를 소유. insert(node_type) 로 다른 map 에 복사 없이 옮긴다. */
+		typedef ft::__map_node_handle<typename ft::__rbt<value_type, key_type, value_compare, allocator_type, OrderStat>::node_type, allocator_type> node_type;
+		typedef ft::__insert_return_type<iterator, node_type> insert_return_type;
+
+		/* cursor() 가 돌려주는 일괄 복사 cursor. read(out, n) 으로 n 개씩 꺼낸다. */
+		typedef typename ft::__rbt<value_type, key_type, value_compare, allocator_type, OrderStat>::batch_cursor batch_cursor;
+
 		private:
 				key_compare __key_comp;
 				value_compare __value_comp;
-				ft::__rbt<value_type, key_type, value_compare, allocator_type> __rbt;
+				ft::__rbt<value_type, key_type, value_compare, allocator_type, OrderStat> __rbt;
+
+				template <class ForwardIterator>
+				bool __is_sorted(ForwardIterator first, ForwardIterator last) const
+				{
+					if (first == last)
+						return true;
+					for (ForwardIterator prev = first++ ; first != last ; prev = first++)
+						if (__key_comp(*first, *prev))
+							return false;
+					return true;
+				}
 
 		public:
 			/* orthdox */
@@ -109,11 +147,9 @@ namespace ft {
 			size_type	size(void) const { return __rbt.size(); }
 			size_type	max_size(void) const { return __rbt.max_size(); }
 
+			/* key 가 있으면 mapped_type 을 만들지도 복사하지도 않는다. */
 			mapped_type& operator[](const key_type& key)
-			{
-				ft::pair<iterator, bool> p = insert(ft::make_pair(key, mapped_type()));
-				return p.first->second;
-			}
+			{ return try_emplace(key).first->second; }
 			mapped_type& at(const key_type& key)
 			{
 				iterator i = find(key);
@@ -130,28 +166,121 @@ namespace ft {
 			}
 
 			ft::pair<iterator, bool> insert(const value_type& value)
-			{ return __rbt.insert(value); }
+			{
+				FT_TRACE_OP(map, trace_insert, value);
+				return __rbt.insert(value);
+			}
 
 			iterator insert(iterator _idx, const value_type& value)
-			{ return __rbt.insert(_idx, value); }
+			{
+				FT_TRACE_OP(map, trace_insert, value);
+				return __rbt.insert(_idx, value);
+			}
 
 			template <class InputIterator>
 			void insert(InputIterator first, InputIterator last)
 			{ __rbt.insert(first, last); }
 
+			/* key 가 없을 때만 mapped_type() 을 노드 안에서 생성해 삽입. 있으면 기존 원소 그대로 반환 */
+			ft::pair<iterator, bool> try_emplace(const key_type& key)
+			{
+				FT_TRACE_OP(map, trace_insert, key);
+				return __rbt.try_emplace(key);
+			}
+
+			/* key 가 없을 때만 obj 로 mapped_type 을 노드 안에서 생성해 삽입 */
+			ft::pair<iterator, bool> try_emplace(const key_type& key, const mapped_type& obj)
+			{
+				FT_TRACE_KV(map, trace_insert, key, obj);
+				return __rbt.try_emplace(key, obj);
+			}
+
+			/* 한 번의 탐색으로 key 가 없으면 obj 를 삽입, 있으면 combine(기존 mapped, obj) 로 기존 원소를 직접 갱신.
+			combine 은 void (mapped_type&, const mapped_type&) 형태. (ex. counts += x, vector 이어붙이기)
+			반환 : pair<원소 iterator, 새로 삽입했는지> */
+			template <class Combine>
+			ft::pair<iterator, bool> upsert(const key_type& key, const mapped_type& obj, Combine combine)
+			{
+				FT_TRACE_KV(map, trace_insert, key, obj);
+				ft::pair<iterator, bool> p = __rbt.try_emplace(key, obj);
+				if (!p.second)
+					combine(p.first->second, obj);
+				return p;
+			}
+
 			void erase(iterator _idx)
-			{ __rbt.erase(_idx); }
+			{
+				FT_TRACE_OP(map, trace_erase, *_idx);
+				__rbt.erase(_idx);
+			}
 
 			size_type erase(const key_type& key)
-			{ return __rbt.erase(key); }
+			{
+				FT_TRACE_OP(map, trace_erase, key);
+				return __rbt.erase(key);
+			}
+
+			template <typename K>
+			typename ft::enable_if<ft::__is_transparent<key_compare, K>::value, size_type>::type
+			erase(const K& key)
+			{
+				FT_TRACE_OP(map, trace_erase, key);
+				return __rbt.erase(key);
+			}
 
 			void erase(iterator first, iterator last)
 			{ __rbt.erase(first, last); }
 
+			/* 원소의 노드를 해제하지 않고 떼어내 node handle 로 돌려준다. 없으면 빈 handle */
+			node_type extract(iterator _idx)
+			{ return node_type(__rbt.extract(_idx), get_allocator()); }
+
+			node_type extract(const key_type& key)
+			{ return node_type(__rbt.extract(key), get_allocator()); }
+
+			/* handle 의 노드를 그대로 연결한다. 같은 key 가 있으면 inserted == false 이고 노드는 node 로 돌아온다. */
+			insert_return_type insert(node_type nh)
+			{
+				insert_return_type ret;
+				ret.inserted = false;
+				if (nh.empty())
+				{
+					ret.position = end();
+					return ret;
+				}
+				ft::pair<iterator, bool> p = __rbt.insert_node(nh.__get());
+				ret.position = p.first;
+				ret.inserted = p.second;
+				if (p.second)
+					nh.__release();
+				else
+					ret.node = nh;
+				return ret;
+			}
+
+			/* hint 버전. 성공하면 nh 는 비고, 같은 key 가 있으면 노드는 nh 에 그대로 남는다.
+			(소유권이 옮겨가지 않도록 참조로 받는다. 임시 handle 도 받을 수 있게 const) */
+			iterator insert(iterator _idx, const node_type& nh)
+			{
+				if (nh.empty())
+					return end();
+				ft::pair<iterator, bool> p = __rbt.insert_node(_idx, nh.__get());
+				if (p.second)
+					nh.__release();
+				return p.first;
+			}
+
+			/* other 에서 *this 에 없는 key 의 노드를 복사 없이 옮겨온다. 겹치는 key 는 other 에 남는다. */
+			void merge(map& other)
+			{ __rbt.merge(other.__rbt); }
+
 			void swap(map& m) { __rbt.swap(m.__rbt); }
 
 			void clear(void)
-			{ __rbt.clear(); }
+			{
+				FT_TRACE_KV(map, trace_clear, 0, 0);
+				__rbt.clear();
+			}
 
 			key_compare key_comp() const
 			{ return __key_comp; }
@@ -160,19 +289,31 @@ namespace ft {
 			{ return __value_comp; }
 
 			iterator find(const key_type& key)
-			{ return __rbt.find(key); }
+			{
+				FT_TRACE_OP(map, trace_find, key);
+				return __rbt.find(key);
+			}
 
 			const_iterator find(const key_type& key) const
-			{ return __rbt.find(key); }
+			{
+				FT_TRACE_OP(map, trace_find, key);
+				return __rbt.find(key);
+			}
 
 			size_type count(const key_type& key) const
 			{ return !(find(key) == end()); }
 
 			iterator lower_bound(const key_type& key)
-			{ return __rbt.lower_bound(key); }
+			{
+				FT_TRACE_OP(map, trace_lower_bound, key);
+				return __rbt.lower_bound(key);
+			}
 
 			const_iterator lower_bound(const key_type& key) const
-			{ return __rbt.lower_bound(key); }
+			{
+				FT_TRACE_OP(map, trace_lower_bound, key);
+				return __rbt.lower_bound(key);
+			}
 
 			iterator upper_bound(const key_type& key)
 			{ return __rbt.upper_bound(key); }
@@ -186,39 +327,207 @@ namespace ft {
 			ft::pair<const_iterator, const_iterator> equal_range(const key_type& key) const
 			{ return __rbt.equal_range(key); }
 
+			/* heterogeneous lookup : key_compare::is_transparent 가 있을 때만 후보가 된다.
+			const char* 나 buffer slice 로 찾을 때 key_type 임시 객체를 만들지 않는다. */
+			template <typename K>
+			typename ft::enable_if<ft::__is_transparent<key_compare, K>::value, iterator>::type
+			find(const K& key)
+			{
+				FT_TRACE_OP(map, trace_find, key);
+				return __rbt.find(key);
+			}
+
+			template <typename K>
+			typename ft::enable_if<ft::__is_transparent<key_compare, K>::value, const_iterator>::type
+			find(const K& key) const
+			{
+				FT_TRACE_OP(map, trace_find, key);
+				return __rbt.find(key);
+			}
+
+			template <typename K>
+			typename ft::enable_if<ft::__is_transparent<key_compare, K>::value, size_type>::type
+			count(const K& key) const
+			{ return !(find(key) == end()); }
+
+			template <typename K>
+			typename ft::enable_if<ft::__is_transparent<key_compare, K>::value, iterator>::type
+			lower_bound(const K& key)
+			{
+				FT_TRACE_OP(map, trace_lower_bound, key);
+				return __rbt.lower_bound(key);
+			}
+
+			template <typename K>
+			typename ft::enable_if<ft::__is_transparent<key_compare, K>::value, const_iterator>::type
+			lower_bound(const K& key) const
+			{
+				FT_TRACE_OP(map, trace_lower_bound, key);
+				return __rbt.lower_bound(key);
+			}
+
+			template <typename K>
+			typename ft::enable_if<ft::__is_transparent<key_compare, K>::value, iterator>::type
+			upper_bound(const K& key)
+			{ return __rbt.upper_bound(key); }
+
+			template <typename K>
+			typename ft::enable_if<ft::__is_transparent<key_compare, K>::value, const_iterator>::type
+			upper_bound(const K& key) const
+			{ return __rbt.upper_bound(key); }
+
+			template <typename K>
+			typename ft::enable_if<ft::__is_transparent<key_compare, K>::value, ft::pair<iterator, iterator> >::type
+			equal_range(const K& key)
+			{ return __rbt.equal_range(key); }
+
+			template <typename K>
+			typename ft::enable_if<ft::__is_transparent<key_compare, K>::value, ft::pair<const_iterator, const_iterator> >::type
+			equal_range(const K& key) const
+			{ return __rbt.equal_range(key); }
+
+			/* order statistics : OrderStat 이면 O(log n), 아니면 순회 O(n) */
+			/* key 보다 작은 key 의 수 */
+			size_type rank(const key_type& key) const
+			{ return __rbt.rank(key); }
+
+			/* k 번째(0 부터) 원소. k >= size() 면 end() */
+			iterator select(size_type k)
+			{ return __rbt.select(k); }
+
+			const_iterator select(size_type k) const
+			{ return __rbt.select(k); }
+
+			/* [lo, hi) 에 있는 key 의 수 */
+			size_type count_range(const key_type& lo, const key_type& hi) const
+			{ return __rbt.count_range(lo, hi); }
+
+			/* 일괄 조회 : keys 마다 결과를 out 에 같은 순서로 채운다. (out 은 비우고 다시 채운다)
+			keys 가 정렬되어 있으면 앞 key 의 탐색 경로를 이어서 쓰고, 아니면 key 여러 개를 함께 내려가며 다음 노드를 prefetch 해서
+			cache miss 를 겹치게 한다. 서로 독립적인 조회를 많이 할 때 하나씩 find 하는 것보다 빠르다. */
+			template <class ForwardIterator>
+			void find_many(ForwardIterator first, ForwardIterator last, ft::vector<iterator>& out)
+			{ __rbt.find_many(first, last, out, __is_sorted(first, last)); }
+
+			template <class ForwardIterator>
+			void find_many(ForwardIterator first, ForwardIterator last, ft::vector<const_iterator>& out) const
+			{ __rbt.find_many(first, last, out, __is_sorted(first, last)); }
+
+			template <class ForwardIterator>
+			void lower_bound_many(ForwardIterator first, ForwardIterator last, ft::vector<iterator>& out)
+			{ __rbt.lower_bound_many(first, last, out, __is_sorted(first, last)); }
+
+			template <class ForwardIterator>
+			void lower_bound_many(ForwardIterator first, ForwardIterator last, ft::vector<const_iterator>& out) const
+			{ __rbt.lower_bound_many(first, last, out, __is_sorted(first, last)); }
+
+			template <class ForwardIterator>
+			void count_many(ForwardIterator first, ForwardIterator last, ft::vector<size_type>& out) const
+			{ __rbt.find_many(first, last, out, __is_sorted(first, last)); }
+
+			/* 일괄 순회 : iterator 로 도는 것과 같은 순서로 f(value) 를 부르면서 다음에 갈 노드를 미리 prefetch 한다.
+			전체 export / 집계처럼 map 전체를 훑을 때 쓴다. f 는 mapped 값을 바꿀 수 있지만 map 을 바꾸면 안 된다. */
+			template <class F>
+			F for_each(F f)
+			{ return __rbt.for_each(f); }
+
+			template <class F>
+			F for_each(F f) const
+			{ return __rbt.for_each(f); }
+
+			/* [lo, hi) 의 원소만 */
+			template <class F>
+			F range_for_each(const key_type& lo, const key_type& hi, F f)
+			{ return __rbt.range_for_each(lo, hi, f); }
+
+			template <class F>
+			F range_for_each(const key_type& lo, const key_type& hi, F f) const
+			{ return __rbt.range_for_each(lo, hi, f); }
+
+			/* 원소를 n 개씩 buffer 로 복사해 가는 cursor. 만든 뒤 map 을 바꾸면 쓸 수 없다. */
+			batch_cursor cursor() const
+			{ return __rbt.cursor(); }
+
+			batch_cursor cursor(const key_type& lo, const key_type& hi) const
+			{ return __rbt.cursor(lo, hi); }
+
+			/* tree 의 높이, 깊이 분포, 메모리 배치와 red-black 규칙 검사 결과 (ft::tree_stats). O(n), 할당하지 않는다. */
+			ft::tree_stats stats() const
+			{ return __rbt.stats(); }
+
+			/* snapshot : 원소를 key 순서의 (key, mapped) 배열로 fd 에 쓴다.
+			restore  : snapshot 버퍼(보통 ft::snapshot_file)로 내용을 바꾼다. insert 없이 O(n) 으로 tree 를 만든다.
+			Key 와 T 가 trivially copyable 일 때만 쓸 수 있다. 형식과 오류는 utils/snapshot.hpp 참고 */
+			void snapshot(int fd) const
+			{
+				ft::__snapshot_check<ft::__snapshot_safe<value_type>::value>::__ok();
+				ft::__snapshot_writer w(fd, ft::__snapshot_map, sizeof(value_type), __alignof__(value_type), size());
+				__rbt.for_each(ft::__snapshot_put<value_type>(&w));
+				w.__finish();
+			}
+
+			void restore(const void* data, size_type len)
+			{
+				ft::__snapshot_check<ft::__snapshot_safe<value_type>::value>::__ok();
+				ft::__snapshot_reader r(data, len, ft::__snapshot_map, sizeof(value_type), __alignof__(value_type));
+				const value_type* first = static_cast<const value_type*>(r.__data());
+				if (!ft::__snapshot_sorted(first, r.__size(), __value_comp))
+					throw ft::snapshot_error("ft::snapshot: keys not sorted");
+				__rbt.assign_sorted(first, r.__size());
+			}
+
+			/* set algebra : other 의 노드를 다시 연결해서 *this 를 결과로 만들고 other 는 비운다.
+			같은 key 가 양쪽에 있으면 *this 의 값이 남는다. O(m log(n / m + 1)) */
+			void set_union(map& other)
+			{ __rbt.set_union(other.__rbt); }
+
+			void set_intersection(map& other)
+			{ __rbt.set_intersection(other.__rbt); }
+
+			void set_difference(map& other)
+			{ __rbt.set_difference(other.__rbt); }
+
 			allocator_type get_allocator() const
 			{ return __rbt.get_allocator(); }
 
+			/* 노드와 sentinel 의 내역에 map 객체를 더한다. (utils/footprint.hpp) */
+			ft::memory_footprint memory_usage() const
+			{
+				ft::memory_footprint m = __rbt.memory_usage();
+				m.overhead += sizeof(*this);
+				return m;
+			}
+
 		};
 
-		template <class Key, class T, class Compare, class Alloc>
-		bool operator==(const ft::map<Key, T, Compare, Alloc>& x,
-						const ft::map<Key, T, Compare, Alloc>& y)
+		template <class Key, class T, class Compare, class Alloc, bool OS>
+		bool operator==(const ft::map<Key, T, Compare, Alloc, OS>& x,
+						const ft::map<Key, T, Compare, Alloc, OS>& y)
 		{ return x.size() == y.size() && ft::equal(x.begin(), x.end(), y.begin()); }
 
-		template <class Key, class T, class Compare, class Alloc>
-		bool operator!=(const ft::map<Key, T, Compare, Alloc>& x, const ft::map<Key, T, Compare, Alloc>& y)
+		template <class Key, class T, class Compare, class Alloc, bool OS>
+		bool operator!=(const ft::map<Key, T, Compare, Alloc, OS>& x, const ft::map<Key, T, Compare, Alloc, OS>& y)
 		{ return !(x == y); }
 
-		template <class Key, class T, class Compare, class Alloc>
-		bool operator<(const ft::map<Key, T, Compare, Alloc>& x, const ft::map<Key, T, Compare, Alloc>& y)
+		template <class Key, class T, class Compare, class Alloc, bool OS>
+		bool operator<(const ft::map<Key, T, Compare, Alloc, OS>& x, const ft::map<Key, T, Compare, Alloc, OS>& y)
 		{ return ft::lexicographical_compare(x.begin(), x.end(), y.begin(), y.end()); }
 
-		template <class Key, class T, class Compare, class Alloc>
-		bool operator<=(const ft::map<Key, T, Compare, Alloc>& x, const ft::map<Key, T, Compare, Alloc>& y)
+		template <class Key, class T, class Compare, class Alloc, bool OS>
+		bool operator<=(const ft::map<Key, T, Compare, Alloc, OS>& x, const ft::map<Key, T, Compare, Alloc, OS>& y)
 		{ return !(y < x); }
 
-		template <class Key, class T, class Compare, class Alloc>
-		bool operator>(const ft::map<Key, T, Compare, Alloc>& x, const ft::map<Key, T, Compare, Alloc>& y)
+		template <class Key, class T, class Compare, class Alloc, bool OS>
+		bool operator>(const ft::map<Key, T, Compare, Alloc, OS>& x, const ft::map<Key, T, Compare, Alloc, OS>& y)
 		{ return y < x; }
 
-		template <class Key, class T, class Compare, class Alloc>
-		bool operator>=(const ft::map<Key, T, Compare, Alloc>& x, const ft::map<Key, T, Compare, Alloc>& y)
+		template <class Key, class T, class Compare, class Alloc, bool OS>
+		bool operator>=(const ft::map<Key, T, Compare, Alloc, OS>& x, const ft::map<Key, T, Compare, Alloc, OS>& y)
 		{ return !(x < y); }
 
 		/* non-member function */
-		template <class Key, class T, class Compare, class Alloc>
-		void swap(ft::map<Key, T, Compare, Alloc>& x, ft::map<Key, T, Compare, Alloc>& y)
+		template <class Key, class T, class Compare, class Alloc, bool OS>
+		void swap(ft::map<Key, T, Compare, Alloc, OS>& x, ft::map<Key, T, Compare, Alloc, OS>& y)
 		{ x.swap(y); }
 
 }
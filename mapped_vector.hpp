@@ -0,0 +1,368 @@
+#ifndef MAPPED_VECTOR_HPP
+# define MAPPED_VECTOR_HPP
+
+# include <cerrno>
+# include <cstddef>
+# include <cstring>
+# include <limits>
+# include <stdexcept>
+# include <string>
+# include <fcntl.h>
+# include <unistd.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include "utils/iterator.hpp"
+# include "utils/type.hpp"
+# include "utils/algorithm.hpp"
+# include "utils/snapshot.hpp"
+# include "utils/footprint.hpp"
+
+namespace ft {
+
+	/* 파일을 그대로 원소 배열로 쓰는 vector
+	 *
+	 * 파일 내용은 T 배열 그대로이고 (header 없음) 원소 수는 파일 크기 / sizeof(T) 다.
+	 * 열 때는 mmap 만 하므로 크기와 상관없이 O(1) 이고, 어떤 page 를 메모리에 둘지는 page cache 가 정한다.
+	 * T 는 trivially copyable 이어야 한다.
+	 *
+	 * read_write : 파일이 없으면 만든다. 바꾼 내용은 MAP_SHARED 라 파일에 그대로 반영된다.
+	 *              자랄 때는 capacity 를 두 배씩 ftruncate 로 늘리고 mapping 을 mremap 한다. (linux 가 아니면 다시 mmap)
+	 *              그동안 파일 끝에는 capacity 까지 0 이 붙어 있다. flush() 나 close() 가 파일을 size 로 줄인다.
+	 * read_only  : 원소를 바꾸면 안 된다. (PROT_READ 라 SIGSEGV) 크기를 바꾸는 함수는 std::logic_error 를 던진다.
+	 *
+	 * 복사할 수 없다. (swap 은 된다) 크기가 바뀌면 mapping 이 옮겨질 수 있으므로 iterator 와 포인터는 모두 무효가 된다.
+	 */
+	template <typename T>
+	class mapped_vector
+	{
+		public:
+			typedef T 					value_type;
+			typedef value_type&			reference;
+			typedef const value_type&	const_reference;
+			typedef value_type*			pointer;
+			typedef const value_type*	const_pointer;
+
+			typedef ft::random_access_iterator<value_type>				iterator;
+			typedef ft::random_access_iterator<const value_type>		const_iterator;
+			typedef ft::reverse_iterator<iterator>						reverse_iterator;
+			typedef ft::reverse_iterator<const_iterator>				const_reverse_iterator;
+			typedef std::ptrdiff_t		difference_type;
+			typedef std::size_t			size_type;
+
+			enum open_mode
+			{
+				read_only,
+				read_write
+			};
+
+			/* madvise 로 넘기는 접근 방식 hint */
+			enum advice
+			{
+				normal = MADV_NORMAL,
+				sequential = MADV_SEQUENTIAL,
+				random = MADV_RANDOM,
+				willneed = MADV_WILLNEED,
+				dontneed = MADV_DONTNEED
+			};
+
+		private:
+			int			__fd;
+			open_mode	__mode;
+			pointer		__begin;
+			size_type	__size;
+			size_type	__capacity;
+
+			mapped_vector(const mapped_vector&);
+			mapped_vector& operator=(const mapped_vector&);
+
+		public:
+			mapped_vector() : __fd(-1), __mode(read_only), __begin(ft::NIL), __size(0), __capacity(0)
+			{ ft::__snapshot_check<ft::__snapshot_safe<T>::value>::__ok(); }
+			explicit mapped_vector(const char* path, open_mode mode = read_write)
+			: __fd(-1), __mode(read_only), __begin(ft::NIL), __size(0), __capacity(0)
+			{
+				ft::__snapshot_check<ft::__snapshot_safe<T>::value>::__ok();
+				open(path, mode);
+			}
+			~mapped_vector()
+			{
+				try
+				{
+					close();
+				}
+				catch (...)
+				{
+				}
+			}
+
+			/* 이미 열려 있으면 먼저 닫는다. */
+			void open(const char* path, open_mode mode = read_write)
+			{
+				close();
+				int fd = ::open(path, mode == read_write ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+				if (fd < 0)
+					throw std::runtime_error(__error("open"));
+				struct stat st;
+				if (::fstat(fd, &st) < 0)
+				{
+					::close(fd);
+					throw std::runtime_error(__error("fstat"));
+				}
+				size_type bytes = static_cast<size_type>(st.st_size);
+				if (bytes % sizeof(T) != 0)
+				{
+					::close(fd);
+					throw std::runtime_error("ft::mapped_vector: file size is not a multiple of the element size");
+				}
+				__fd = fd;
+				__mode = mode;
+				try
+				{
+					__remap(bytes / sizeof(T));
+				}
+				catch (...)
+				{
+					::close(__fd);
+					__fd = -1;
+					throw;
+				}
+				__size = __capacity;
+			}
+
+			/* read_write 면 파일을 size 로 줄인 뒤 mapping 과 fd 를 닫는다. */
+			void close()
+			{
+				if (__fd < 0)
+					return;
+				int fd = __fd;
+				size_type n = __size;
+				bool shrink = __mode == read_write && __capacity != __size;
+				__unmap();
+				__fd = -1;
+				__size = 0;
+				__capacity = 0;
+				if (shrink && ::ftruncate(fd, static_cast<off_t>(__bytes_of(n))) < 0)
+				{
+					::close(fd);
+					throw std::runtime_error(__error("ftruncate"));
+				}
+				::close(fd);
+			}
+
+			bool		is_open() const	{ return __fd >= 0; }
+			open_mode	mode() const	{ return __mode; }
+
+			/* 파일을 size 로 줄이고 바뀐 page 를 디스크에 쓴다. 돌아오면 파일만으로 지금 내용을 다시 열 수 있다. */
+			void flush()
+			{
+				if (__fd < 0 || __mode != read_write)
+					return;
+				if (__capacity != __size)
+					__resize_file(__size);
+				if (__begin != ft::NIL && ::msync(__begin, __bytes_of(__capacity), MS_SYNC) < 0)
+					throw std::runtime_error(__error("msync"));
+			}
+
+			/* 앞으로의 접근 방식을 kernel 에 알려준다. 범위는 page 단위로 넓혀진다. */
+			void advise(advice adv)
+			{ advise(adv, 0, __size); }
+			void advise(advice adv, size_type first, size_type n)
+			{
+				if (__begin == ft::NIL || first >= __capacity || n == 0)
+					return;
+				if (n > __capacity - first)
+					n = __capacity - first;
+				std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+				char* base = reinterpret_cast<char*>(__begin);
+				std::size_t lo = __bytes_of(first) / page * page;
+				std::size_t hi = __bytes_of(first + n);
+				if (::madvise(base + lo, hi - lo, adv) < 0)
+					throw std::runtime_error(__error("madvise"));
+			}
+
+			iterator begin()						{ return iterator(__begin); }
+			iterator end()							{ return iterator(__begin + __size); }
+			const_iterator begin() const			{ return const_iterator(__begin); }
+			const_iterator end() const				{ return const_iterator(__begin + __size); }
+			reverse_iterator rbegin()				{ return reverse_iterator(end()); }
+			reverse_iterator rend()					{ return reverse_iterator(begin()); }
+			const_reverse_iterator rbegin() const	{ return const_reverse_iterator(end()); }
+			const_reverse_iterator rend() const		{ return const_reverse_iterator(begin()); }
+
+			reference operator[](size_type n)				{ return __begin[n]; }
+			const_reference operator[](size_type n) const	{ return __begin[n]; }
+			reference at(size_type n)
+			{
+				if (n >= size())
+					throw std::out_of_range("ft::mapped_vector::at");
+				return __begin[n];
+			}
+			const_reference at(size_type n) const
+			{
+				if (n >= size())
+					throw std::out_of_range("ft::mapped_vector::at");
+				return __begin[n];
+			}
+			reference front()				{ return *__begin; }
+			reference back() 				{ return __begin[__size - 1]; }
+			const_reference front() const	{ return *__begin; }
+			const_reference back() const	{ return __begin[__size - 1]; }
+			T* data() throw() 				{ return __begin; }
+			const T* data() const throw()	{ return __begin; }
+
+			size_type size() const		{ return __size; }
+			size_type capacity() const	{ return __capacity; }
+			/* heap 이 아니라 file mapping 의 내역이다. slack 은 capacity 까지 늘려 둔 파일 끝,
+			allocator 는 mapping 을 page 단위로 올린 만큼. 실제로 메모리에 올라온 page 수는 page cache 가 정한다. */
+			ft::memory_footprint memory_usage() const
+			{
+				ft::memory_footprint m;
+				m.payload = __bytes_of(__size);
+				m.slack = __bytes_of(__capacity - __size);
+				m.overhead = sizeof(*this);
+				if (__begin != ft::NIL)
+				{
+					std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+					std::size_t bytes = __bytes_of(__capacity);
+					m.allocator = (bytes + page - 1) / page * page - bytes;
+				}
+				return m;
+			}
+			bool empty() const			{ return __size == 0; }
+			size_type max_size() const
+			{
+				return std::min<size_type>(std::numeric_limits<size_type>::max() / sizeof(T),
+					static_cast<size_type>(std::numeric_limits<off_t>::max()) / sizeof(T));
+			}
+
+			/* 파일을 n 개 이상으로 늘린다. capacity 의 두 배보다 작으면 두 배로 */
+			void reserve(size_type n)
+			{
+				if (n <= __capacity)
+					return;
+				__writable("ft::mapped_vector::reserve");
+				if (n > max_size())
+					throw std::length_error("ft::mapped_vector::reserve");
+				if (n < __capacity * 2)
+					n = __capacity * 2;
+				__resize_file(n);
+			}
+			void resize(size_type n, value_type val = value_type())
+			{
+				__writable("ft::mapped_vector::resize");
+				if (n > __capacity)
+					reserve(n);
+				for ( ; __size < n ; ++__size)
+					__begin[__size] = val;
+				__size = n;
+			}
+			void push_back(const value_type& val)
+			{
+				if (__size == __capacity)
+					reserve(__size + 1);
+				__writable("ft::mapped_vector::push_back");
+				__begin[__size++] = val;
+			}
+			void pop_back()
+			{
+				__writable("ft::mapped_vector::pop_back");
+				--__size;
+			}
+			template <class InputIterator>
+			void assign(InputIterator first, InputIterator last,
+				typename ft::enable_if<!ft::is_integral<InputIterator>::value>::type* = ft::NIL)
+			{
+				__writable("ft::mapped_vector::assign");
+				size_type n = std::distance(first, last);
+				reserve(n);
+				std::copy(first, last, __begin);
+				__size = n;
+			}
+			void assign(size_type n, const value_type& val)
+			{
+				__writable("ft::mapped_vector::assign");
+				reserve(n);
+				std::fill_n(__begin, n, val);
+				__size = n;
+			}
+			void clear()
+			{
+				__writable("ft::mapped_vector::clear");
+				__size = 0;
+			}
+			void swap(mapped_vector& v)
+			{
+				std::swap(__fd, v.__fd);
+				std::swap(__mode, v.__mode);
+				std::swap(__begin, v.__begin);
+				std::swap(__size, v.__size);
+				std::swap(__capacity, v.__capacity);
+			}
+
+		private:
+			static std::string	__error(const char* what)
+			{ return std::string("ft::mapped_vector: ") + what + ": " + std::strerror(errno); }
+
+			static std::size_t	__bytes_of(size_type n)	{ return n * sizeof(T); }
+
+			void	__writable(const char* what) const
+			{
+				if (__fd < 0 || __mode != read_write)
+					throw std::logic_error(std::string(what) + ": not opened read_write");
+			}
+
+			/* 파일 길이를 n 개로 맞추고 mapping 을 따라 옮긴다. */
+			void	__resize_file(size_type n)
+			{
+				if (::ftruncate(__fd, static_cast<off_t>(__bytes_of(n))) < 0)
+					throw std::runtime_error(__error("ftruncate"));
+				__remap(n);
+			}
+
+			/* mapping 을 n 개 길이로 바꾼다. 0 이면 mapping 이 없다. (길이 0 인 mmap 은 안 된다) */
+			void	__remap(size_type n)
+			{
+				if (n == __capacity && (__begin != ft::NIL || n == 0))
+					return;
+				if (n == 0)
+				{
+					__unmap();
+					__capacity = 0;
+					return;
+				}
+				void* addr;
+#ifdef __linux__
+				if (__begin != ft::NIL)
+					addr = ::mremap(__begin, __bytes_of(__capacity), __bytes_of(n), MREMAP_MAYMOVE);
+				else
+					addr = ::mmap(ft::NIL, __bytes_of(n), __prot(), MAP_SHARED, __fd, 0);
+#else
+				addr = ::mmap(ft::NIL, __bytes_of(n), __prot(), MAP_SHARED, __fd, 0);
+#endif
+				if (addr == MAP_FAILED)
+					throw std::runtime_error(__error("mmap"));
+#ifndef __linux__
+				__unmap();
+#endif
+				__begin = static_cast<pointer>(addr);
+				__capacity = n;
+			}
+
+			void	__unmap()
+			{
+				if (__begin != ft::NIL)
+					::munmap(__begin, __bytes_of(__capacity));
+				__begin = ft::NIL;
+			}
+
+			int	__prot() const
+			{ return __mode == read_write ? PROT_READ | PROT_WRITE : PROT_READ; }
+	};
+
+	template <typename T>
+	void swap(ft::mapped_vector<T>& x, ft::mapped_vector<T>& y)
+	{ x.swap(y); }
+
+}
+
+#endif
@@ -0,0 +1,284 @@
+#ifndef MPMC_QUEUE_HPP
+# define MPMC_QUEUE_HPP
+
+# include <cstddef>
+# include <memory>
+# include "utils/type.hpp"
+# include "utils/sync.hpp"
+# include "utils/footprint.hpp"
+
+namespace ft {
+
+	/* 크기가 정해진 lock-free queue (Vyukov)
+	 *
+	 * 용량은 2의 거듭제곱이고 칸(cell)마다 순번(seq)을 둔다. pos 번째 원소가 들어갈 칸은 pos & mask.
+	 *   seq == pos      : 비어있어서 pos 번째 push 가 쓸 수 있다.
+	 *   seq == pos + 1  : pos 번째 원소가 들어있어서 pop 할 수 있다.
+	 * push 는 tail 을, pop 은 head 를 CAS 로 한 칸씩 차지한 뒤 칸에 쓰고/읽고 seq 를 다음 상태로 넘긴다.
+	 * 차지한 칸은 자기만 쓰므로 다른 thread 는 그 칸의 seq 가 바뀌기 전까지 건드리지 않는다.
+	 * head 와 tail 은 각자 cache line 을 써서 producer 와 consumer 가 서로의 line 을 뺏지 않게 한다.
+	 *
+	 * try_push_n / try_pop_n 은 이어진 빈(찬) 칸의 개수를 세고 한 번의 CAS 로 그만큼을 한꺼번에 차지한다.
+	 *
+	 * SingleProducerConsumer 가 true 이면 producer, consumer 가 각각 하나뿐이라고 보고
+	 * CAS 나 seq 없이 head / tail 의 읽기(acquire) 쓰기(release) 만으로 동작한다.
+	 * 상대편 index 는 필요할 때만 다시 읽고 평소엔 자기 line 에 캐시해둔 값을 쓴다.
+	 *
+	 * T 의 복사는 예외를 던지지 않아야 한다. 가득 차거나 비어있으면 기다리지 않고 false (0개) 를 돌려준다.
+	 */
+	template <class T, bool SingleProducerConsumer = false, class Alloc = std::allocator<T> >
+	class mpmc_queue
+	{
+		public:
+			typedef T			value_type;
+			typedef Alloc		allocator_type;
+			typedef std::size_t	size_type;
+
+		private:
+			typedef ft::integral_constant<bool, SingleProducerConsumer>	__spsc;
+
+			struct __cell
+			{
+				volatile size_type	seq;
+				union
+				{
+					char		buf[sizeof(value_type)];
+					long double	__align_ld;
+					void*		__align_ptr;
+				}					storage;
+
+				value_type*	value()	{ return reinterpret_cast<value_type*>(storage.buf); }
+			};
+
+			typedef typename Alloc::template rebind<__cell>::other	cell_allocator;
+
+			/* 읽기만 하는 값 */
+			__cell*				__cells;
+			size_type			__mask;
+			char				__pad0[ft::__cache_line_size - sizeof(__cell*) - sizeof(size_type)];
+			/* consumer 의 line : head 와 (spsc) consumer 가 마지막으로 본 tail */
+			volatile size_type	__head;
+			size_type			__tail_cache;
+			char				__pad1[ft::__cache_line_size - 2 * sizeof(size_type)];
+			/* producer 의 line : tail 과 (spsc) producer 가 마지막으로 본 head */
+			volatile size_type	__tail;
+			size_type			__head_cache;
+			char				__pad2[ft::__cache_line_size - 2 * sizeof(size_type)];
+			cell_allocator		__alloc;
+
+			mpmc_queue(const mpmc_queue&);
+			mpmc_queue& operator=(const mpmc_queue&);
+
+		public:
+			/* capacity 는 2의 거듭제곱으로 올림 (최소 2) */
+			explicit mpmc_queue(size_type capacity, const allocator_type& alloc = allocator_type())
+			: __cells(ft::NIL), __mask(0), __head(0), __tail_cache(0), __tail(0), __head_cache(0), __alloc(alloc)
+			{
+				size_type n = 2;
+				while (n < capacity)
+					n <<= 1;
+				__cells = __alloc.allocate(n);
+				for (size_type i = 0 ; i < n ; ++i)
+					__cells[i].seq = i;
+				__mask = n - 1;
+			}
+			/* 다른 thread 가 더 이상 쓰지 않을 때 호출되어야 한다. */
+			~mpmc_queue()
+			{
+				for (size_type pos = __head ; pos != __tail ; ++pos)
+					__cells[pos & __mask].value()->~value_type();
+				__alloc.deallocate(__cells, __mask + 1);
+			}
+
+			size_type	capacity() const	{ return __mask + 1; }
+
+			/* 다른 thread 가 쓰는 중이면 근사값 */
+			size_type	size() const
+			{
+				size_type head = ft::__load_acquire(&__head);
+				size_type tail = ft::__load_acquire(&__tail);
+				/* head 를 먼저 읽었으므로 tail - head 가 음수일 일은 없지만 그 사이 밀려서 용량을 넘을 수는 있다. */
+				return tail - head > capacity() ? capacity() : tail - head;
+			}
+			bool		empty() const	{ return size() == 0; }
+
+			/* 빈 cell 은 slack, cell 의 sequence 번호와 queue 객체(cache line 채움 포함)는 overhead. size() 처럼 근사값 */
+			ft::memory_footprint	memory_usage() const
+			{
+				ft::memory_footprint m;
+				size_type n = size();
+				m.payload = n * sizeof(value_type);
+				m.slack = (capacity() - n) * sizeof(value_type);
+				m.overhead = sizeof(*this) + capacity() * (sizeof(__cell) - sizeof(value_type));
+				m.allocator = ft::__heap_block_overhead(capacity() * sizeof(__cell));
+				return m;
+			}
+
+			/* 가득 찼으면 false */
+			bool	try_push(const value_type& val)	{ return __try_push(val, __spsc()); }
+			/* 비어있으면 false */
+			bool	try_pop(value_type& out)		{ return __try_pop(out, __spsc()); }
+
+			/* first 부터 최대 n 개를 순서대로 넣는다. 넣은 개수 반환 */
+			template <class InputIterator>
+			size_type	try_push_n(InputIterator first, size_type n)	{ return __try_push_n(first, n, __spsc()); }
+			/* 최대 n 개를 꺼내 순서대로 out 에 쓴다. 꺼낸 개수 반환 */
+			template <class OutputIterator>
+			size_type	try_pop_n(OutputIterator out, size_type n)	{ return __try_pop_n(out, n, __spsc()); }
+
+		private:
+			static std::ptrdiff_t	__diff(size_type a, size_type b)	{ return static_cast<std::ptrdiff_t>(a - b); }
+
+			__cell*	__cell_at(size_type pos) const	{ return __cells + (pos & __mask); }
+
+			/* pos 부터 이어서 seq == 자기 위치 + offset 인 칸을 최대 n 개까지 센다. (push 는 offset 0, pop 은 1) */
+			size_type	__count_ready(size_type pos, size_type offset, size_type n) const
+			{
+				size_type k = 0;
+				while (k < n && ft::__load_acquire(&__cell_at(pos + k)->seq) == pos + k + offset)
+					++k;
+				return k;
+			}
+
+			/* index 를 CAS 로 pos -> pos + k 로 옮겨 칸 k 개를 차지한다.
+			 * 맨 앞 칸이 아직 준비 안 됐으면 (가득 참 / 비어있음) 0, 다른 thread 가 먼저 차지했으면 다시 센다. */
+			size_type	__claim(volatile size_type* index, size_type offset, size_type n, size_type& pos)
+			{
+				pos = ft::__load_relaxed(index);
+				for (;;)
+				{
+					size_type k = __count_ready(pos, offset, n);
+					if (k == 0)
+					{
+						std::ptrdiff_t dif = __diff(ft::__load_acquire(&__cell_at(pos)->seq), pos + offset);
+						if (dif < 0)
+							return 0;
+						pos = ft::__load_relaxed(index);
+						continue;
+					}
+					size_type seen = __sync_val_compare_and_swap(index, pos, pos + k);
+					if (seen == pos)
+						return k;
+					pos = seen;
+				}
+			}
+
+			/* mpmc */
+			bool	__try_push(const value_type& val, ft::false_type)
+			{
+				size_type pos;
+				if (__claim(&__tail, 0, 1, pos) == 0)
+					return false;
+				__cell* c = __cell_at(pos);
+				::new (static_cast<void*>(c->value())) value_type(val);
+				ft::__store_release(&c->seq, pos + 1);
+				return true;
+			}
+			bool	__try_pop(value_type& out, ft::false_type)
+			{
+				size_type pos;
+				if (__claim(&__head, 1, 1, pos) == 0)
+					return false;
+				__cell* c = __cell_at(pos);
+				out = *c->value();
+				c->value()->~value_type();
+				ft::__store_release(&c->seq, pos + __mask + 1);
+				return true;
+			}
+			template <class InputIterator>
+			size_type	__try_push_n(InputIterator first, size_type n, ft::false_type)
+			{
+				size_type pos;
+				size_type k = n == 0 ? 0 : __claim(&__tail, 0, n, pos);
+				for (size_type i = 0 ; i < k ; ++i, ++first)
+				{
+					__cell* c = __cell_at(pos + i);
+					::new (static_cast<void*>(c->value())) value_type(*first);
+					ft::__store_release(&c->seq, pos + i + 1);
+				}
+				return k;
+			}
+			template <class OutputIterator>
+			size_type	__try_pop_n(OutputIterator out, size_type n, ft::false_type)
+			{
+				size_type pos;
+				size_type k = n == 0 ? 0 : __claim(&__head, 1, n, pos);
+				for (size_type i = 0 ; i < k ; ++i)
+				{
+					__cell* c = __cell_at(pos + i);
+					*out = *c->value();
+					++out;
+					c->value()->~value_type();
+					ft::__store_release(&c->seq, pos + i + __mask + 1);
+				}
+				return k;
+			}
+
+			/* spsc : tail 은 producer 만, head 는 consumer 만 쓴다. */
+			size_type	__free_slots(size_type want)
+			{
+				size_type tail = __tail;
+				if (capacity() - (tail - __head_cache) < want)
+					__head_cache = ft::__load_acquire(&__head);
+				return capacity() - (tail - __head_cache);
+			}
+			size_type	__filled_slots(size_type want)
+			{
+				size_type head = __head;
+				if (__tail_cache - head < want)
+					__tail_cache = ft::__load_acquire(&__tail);
+				return __tail_cache - head;
+			}
+
+			bool	__try_push(const value_type& val, ft::true_type)
+			{
+				if (__free_slots(1) == 0)
+					return false;
+				::new (static_cast<void*>(__cell_at(__tail)->value())) value_type(val);
+				ft::__store_release(&__tail, __tail + 1);
+				return true;
+			}
+			bool	__try_pop(value_type& out, ft::true_type)
+			{
+				if (__filled_slots(1) == 0)
+					return false;
+				__cell* c = __cell_at(__head);
+				out = *c->value();
+				c->value()->~value_type();
+				ft::__store_release(&__head, __head + 1);
+				return true;
+			}
+			template <class InputIterator>
+			size_type	__try_push_n(InputIterator first, size_type n, ft::true_type)
+			{
+				size_type k = __free_slots(n);
+				if (k > n)
+					k = n;
+				size_type tail = __tail;
+				for (size_type i = 0 ; i < k ; ++i, ++first)
+					::new (static_cast<void*>(__cell_at(tail + i)->value())) value_type(*first);
+				ft::__store_release(&__tail, tail + k);
+				return k;
+			}
+			template <class OutputIterator>
+			size_type	__try_pop_n(OutputIterator out, size_type n, ft::true_type)
+			{
+				size_type k = __filled_slots(n);
+				if (k > n)
+					k = n;
+				size_type head = __head;
+				for (size_type i = 0 ; i < k ; ++i)
+				{
+					__cell* c = __cell_at(head + i);
+					*out = *c->value();
+					++out;
+					c->value()->~value_type();
+				}
+				ft::__store_release(&__head, head + k);
+				return k;
+			}
+	};
+
+}
+
+#endif
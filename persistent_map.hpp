@@ -0,0 +1,185 @@
+#ifndef PERSISTENT_MAP_HPP
+# define PERSISTENT_MAP_HPP
+
+# include <memory>
+# include <functional>
+# include <stdexcept>
+# include "utils/pair.hpp"
+# include "utils/iterator.hpp"
+# include "utils/persistent_rbtree.hpp"
+# include "utils/algorithm.hpp"
+
+namespace ft {
+
+	/* copy-on-write map
+	복사 / snapshot() 은 O(1) 이고, 쓰기는 바뀌는 경로의 노드(O(log n))만 복사한다.
+	snapshot 은 이후의 쓰기에 영향을 받지 않으므로 reader thread 에 넘겨 lock 없이 순회할 수 있다.
+	공유된 노드를 참조로 고칠 수 없도록 iterator 는 const 뿐이고, operator[] 대신 insert_or_assign 을 쓴다. */
+	template <class Key, class T, class Compare = std::less<Key>, typename Alloc = std::allocator<ft::pair<const Key,T> > >
+	class persistent_map
+	{
+		public:
+			typedef Key						key_type;
+			typedef T						mapped_type;
+			typedef ft::pair<const Key, T>	value_type;
+			typedef Compare					key_compare;
+			typedef Alloc					allocator_type;
+			typedef const value_type&		reference;
+			typedef const value_type&		const_reference;
+
+			typedef std::size_t		size_type;
+			typedef std::ptrdiff_t	difference_type;
+
+			class value_compare : public std::binary_function<value_type, value_type, bool>
+			{
+				friend class persistent_map;
+				protected:
+					key_compare comp;
+				public:
+					value_compare(key_compare c) : comp(c) {}
+
+					bool operator()(const value_type& x, const value_type& y) const
+					{ return comp(x.first, y.first); }
+
+					bool operator()(const value_type& x, const key_type& y) const
+					{ return comp(x.first, y); }
+
+					bool operator()(const key_type& x, const value_type& y) const
+					{ return comp(x, y.first); }
+			};
+
+			typedef typename ft::__persistent_rbt<value_type, key_type, value_compare, allocator_type>::const_iterator	const_iterator;
+			typedef const_iterator							iterator;
+			typedef ft::reverse_iterator<const_iterator>	const_reverse_iterator;
+			typedef const_reverse_iterator					reverse_iterator;
+
+		private:
+			key_compare		__key_comp;
+			value_compare	__value_comp;
+			ft::__persistent_rbt<value_type, key_type, value_compare, allocator_type>	__rbt;
+
+		public:
+			explicit persistent_map(const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+				: __key_comp(comp), __value_comp(comp), __rbt(__value_comp, alloc) {}
+			template <class InputIterator>
+			persistent_map(InputIterator first, InputIterator last, const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type(),
+				typename ft::enable_if<!ft::is_integral<InputIterator>::value>::type* = ft::NIL)
+				: __key_comp(comp), __value_comp(comp), __rbt(__value_comp, alloc)
+			{ insert(first, last); }
+			/* 노드를 공유하므로 O(1) */
+			persistent_map(const persistent_map& m) : __key_comp(m.__key_comp), __value_comp(m.__value_comp), __rbt(m.__rbt) {}
+			~persistent_map(void) {}
+
+			persistent_map& operator=(const persistent_map& m)
+			{
+				if (this != &m)
+				{
+					__key_comp = m.__key_comp;
+					__value_comp = m.__value_comp;
+					__rbt = m.__rbt;
+				}
+				return *this;
+			}
+
+			/* 현재 상태의 읽기 전용 view. O(1) */
+			persistent_map	snapshot(void) const	{ return *this; }
+
+			const_iterator			begin(void) const	{ return __rbt.begin(); }
+			const_iterator			end(void) const		{ return __rbt.end(); }
+			const_reverse_iterator	rbegin(void) const	{ return const_reverse_iterator(end()); }
+			const_reverse_iterator	rend(void) const	{ return const_reverse_iterator(begin()); }
+
+			bool		empty(void) const		{ return __rbt.empty(); }
+			size_type	size(void) const		{ return __rbt.size(); }
+			size_type	max_size(void) const	{ return __rbt.max_size(); }
+
+			const mapped_type& at(const key_type& key) const
+			{
+				const_iterator i = find(key);
+				if (i == end())
+					throw std::out_of_range("ft::persistent_map::at");
+				return i->second;
+			}
+
+			ft::pair<iterator, bool> insert(const value_type& value)
+			{ return __rbt.insert(value); }
+
+			template <class InputIterator>
+			void insert(InputIterator first, InputIterator last)
+			{
+				for ( ; first != last ; ++first)
+					__rbt.insert(*first);
+			}
+
+			/* key 가 있으면 obj 로 바꾼 새 노드로 교체한다. 반환 : pair<원소 iterator, 새로 삽입했는지> */
+			ft::pair<iterator, bool> insert_or_assign(const key_type& key, const mapped_type& obj)
+			{ return __rbt.insert_or_assign(value_type(key, obj)); }
+
+			size_type erase(const key_type& key)
+			{ return __rbt.erase(key); }
+
+			void erase(iterator _idx)
+			{ __rbt.erase(_idx->first); }
+
+			void swap(persistent_map& m)
+			{
+				std::swap(__key_comp, m.__key_comp);
+				std::swap(__value_comp, m.__value_comp);
+				__rbt.swap(m.__rbt);
+			}
+
+			void clear(void)
+			{ __rbt.clear(); }
+
+			key_compare key_comp() const
+			{ return __key_comp; }
+
+			value_compare value_comp() const
+			{ return __value_comp; }
+
+			const_iterator find(const key_type& key) const
+			{ return __rbt.find(key); }
+
+			size_type count(const key_type& key) const
+			{ return !(find(key) == end()); }
+
+			const_iterator lower_bound(const key_type& key) const
+			{ return __rbt.lower_bound(key); }
+
+			const_iterator upper_bound(const key_type& key) const
+			{ return __rbt.upper_bound(key); }
+
+			ft::pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+			{ return ft::make_pair(lower_bound(key), upper_bound(key)); }
+
+			allocator_type get_allocator() const
+			{ return __rbt.get_allocator(); }
+
+			/* 이 version 에서 닿는 노드(다른 snapshot 과 공유하는 것 포함)에 map 객체를 더한다. */
+			ft::memory_footprint memory_usage() const
+			{
+				ft::memory_footprint m = __rbt.memory_usage();
+				m.overhead += sizeof(*this);
+				return m;
+			}
+	};
+
+	template <class Key, class T, class Compare, class Alloc>
+	bool operator==(const ft::persistent_map<Key, T, Compare, Alloc>& x, const ft::persistent_map<Key, T, Compare, Alloc>& y)
+	{ return x.size() == y.size() && ft::equal(x.begin(), x.end(), y.begin()); }
+
+	template <class Key, class T, class Compare, class Alloc>
+	bool operator!=(const ft::persistent_map<Key, T, Compare, Alloc>& x, const ft::persistent_map<Key, T, Compare, Alloc>& y)
+	{ return !(x == y); }
+
+	template <class Key, class T, class Compare, class Alloc>
+	bool operator<(const ft::persistent_map<Key, T, Compare, Alloc>& x, const ft::persistent_map<Key, T, Compare, Alloc>& y)
+	{ return ft::lexicographical_compare(x.begin(), x.end(), y.begin(), y.end()); }
+
+	template <class Key, class T, class Compare, class Alloc>
+	void swap(ft::persistent_map<Key, T, Compare, Alloc>& x, ft::persistent_map<Key, T, Compare, Alloc>& y)
+	{ x.swap(y); }
+
+}
+
+#endif
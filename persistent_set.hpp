@@ -0,0 +1,127 @@
+#ifndef PERSISTENT_SET_HPP
+# define PERSISTENT_SET_HPP
+
+# include <memory>
+# include <functional>
+# include "./utils/pair.hpp"
+# include "./utils/iterator.hpp"
+# include "./utils/persistent_rbtree.hpp"
+# include "./utils/algorithm.hpp"
+
+namespace ft {
+
+	/* copy-on-write set : 복사 / snapshot() 은 O(1), 쓰기는 바뀌는 경로(O(log n))만 복사 (persistent_map 참고) */
+	template <typename T, typename Compare = std::less<T>, typename Alloc = std::allocator<T> >
+	class persistent_set
+	{
+		public:
+			typedef T					key_type;
+			typedef T					value_type;
+			typedef Compare				key_compare;
+			typedef Compare				value_compare;
+			typedef Alloc				allocator_type;
+			typedef const value_type&	reference;
+			typedef const value_type&	const_reference;
+			typedef std::ptrdiff_t		difference_type;
+			typedef std::size_t			size_type;
+
+			typedef typename ft::__persistent_rbt<value_type, key_type, value_compare, allocator_type>::const_iterator	const_iterator;
+			typedef const_iterator							iterator;
+			typedef ft::reverse_iterator<const_iterator>	const_reverse_iterator;
+			typedef const_reverse_iterator					reverse_iterator;
+
+			explicit persistent_set(const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+			: __comp(comp), __rbt(comp, alloc) {}
+
+			template <typename InputIterator>
+			persistent_set(InputIterator first, InputIterator last, const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type(),
+				typename ft::enable_if<!ft::is_integral<InputIterator>::value>::type* = ft::NIL)
+			: __comp(comp), __rbt(comp, alloc)
+			{ insert(first, last); }
+			/* 노드를 공유하므로 O(1) */
+			persistent_set(const persistent_set& rhs) : __comp(rhs.__comp), __rbt(rhs.__rbt) {}
+			~persistent_set() {}
+			persistent_set& operator=(const persistent_set& rhs)
+			{
+				persistent_set tmp(rhs);
+				swap(tmp);
+				return *this;
+			}
+
+			/* 현재 상태의 읽기 전용 view. O(1) */
+			persistent_set	snapshot() const	{ return *this; }
+
+			const_iterator			begin() const	{ return __rbt.begin(); }
+			const_iterator			end() const		{ return __rbt.end(); }
+			const_reverse_iterator	rbegin() const	{ return const_reverse_iterator(end()); }
+			const_reverse_iterator	rend() const	{ return const_reverse_iterator(begin()); }
+
+			bool		empty()		const { return __rbt.empty(); }
+			size_type	size()		const { return __rbt.size(); }
+			size_type	max_size()	const { return __rbt.max_size(); }
+
+			ft::pair<iterator, bool>	insert(const value_type& val)
+			{ return __rbt.insert(val); }
+
+			template <class InputIterator>
+			void	insert(InputIterator first, InputIterator last)
+			{
+				for ( ; first != last ; ++first)
+					__rbt.insert(*first);
+			}
+
+			size_type	erase(const value_type& val)	{ return __rbt.erase(val); }
+			void		erase(iterator _idx)			{ __rbt.erase(*_idx); }
+
+			void	swap(persistent_set& s)
+			{
+				std::swap(__comp, s.__comp);
+				__rbt.swap(s.__rbt);
+			}
+
+			void	clear()	{ __rbt.clear(); }
+
+			key_compare		key_comp() const	{ return __comp; }
+			value_compare	value_comp() const	{ return __comp; }
+
+			const_iterator	find(const value_type& val) const			{ return __rbt.find(val); }
+			size_type		count(const value_type& val) const			{ return !(find(val) == end()); }
+			const_iterator	lower_bound(const value_type& val) const	{ return __rbt.lower_bound(val); }
+			const_iterator	upper_bound(const value_type& val) const	{ return __rbt.upper_bound(val); }
+			ft::pair<const_iterator, const_iterator>	equal_range(const value_type& val) const
+			{ return ft::make_pair(lower_bound(val), upper_bound(val)); }
+
+			allocator_type	get_allocator() const	{ return __rbt.get_allocator(); }
+
+			/* 이 version 에서 닿는 노드(다른 snapshot 과 공유하는 것 포함)에 set 객체를 더한다. */
+			ft::memory_footprint	memory_usage() const
+			{
+				ft::memory_footprint m = __rbt.memory_usage();
+				m.overhead += sizeof(*this);
+				return m;
+			}
+
+		private:
+			key_compare	__comp;
+			ft::__persistent_rbt<value_type, key_type, value_compare, allocator_type>	__rbt;
+	};
+
+	template <typename T, typename Compare, typename Alloc>
+	bool	operator==(const ft::persistent_set<T, Compare, Alloc>& lhs, const ft::persistent_set<T, Compare, Alloc>& rhs)
+	{ return lhs.size() == rhs.size() && ft::equal(lhs.begin(), lhs.end(), rhs.begin()); }
+
+	template <typename T, typename Compare, typename Alloc>
+	bool	operator!=(const ft::persistent_set<T, Compare, Alloc>& lhs, const ft::persistent_set<T, Compare, Alloc>& rhs)
+	{ return !(lhs == rhs); }
+
+	template <typename T, typename Compare, typename Alloc>
+	bool	operator<(const ft::persistent_set<T, Compare, Alloc>& lhs, const ft::persistent_set<T, Compare, Alloc>& rhs)
+	{ return ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end()); }
+
+	template <typename T, typename Compare, typename Alloc>
+	void	swap(ft::persistent_set<T, Compare, Alloc>& lhs, ft::persistent_set<T, Compare, Alloc>& rhs)
+	{ lhs.swap(rhs); }
+
+}
+
+#endif
@@ -8,10 +8,16 @@
 # include "./utils/rbtree.hpp"
 # include "./utils/algorithm.hpp"
 # include "./utils/type.hpp"
+# include "./utils/compare.hpp"
+# include "./utils/node_handle.hpp"
+# include "./utils/snapshot.hpp"
+# include "./utils/trace_hook.hpp"
+# include "./vector.hpp"
 
 namespace ft {
 
-	template <typename T, typename Compare = std::less<T>, typename Alloc = std::allocator<T> >
+	/* OrderStat == true 면 rank / select / count_range 와 iterator 의 distance / advance 가 O(log n) */
+	template <typename T, typename Compare = std::less<T>, typename Alloc = std::allocator<T>, bool OrderStat = false>
 	class set
 	{
 		public:
@@ -33,11 +39,18 @@ namespace ft {
 			typedef std::size_t				size_type;
 
 			/* iterator */
-			typedef typename ft::__rbt<const value_type, key_type, value_compare, allocator_type>::iterator			iterator;
-			typedef typename ft::__rbt<const value_type, key_type, value_compare, allocator_type>::const_iterator	const_iterator;
+			typedef typename ft::__rbt<const value_type, key_type, value_compare, allocator_type, OrderStat>::iterator			iterator;
+			typedef typename ft::__rbt<const value_type, key_type, value_compare, allocator_type, OrderStat>::const_iterator	const_iterator;
 			typedef ft::reverse_iterator<iterator>			reverse_iterator;
 			typedef ft::reverse_iterator<const_iterator>	const_reverse_iterator;
 
+			/* node handle : extract 로 떼어낸 노드를 소유. insert(node_type) 로 다른 set 에 복사 없이 옮긴다. */
+			typedef ft::__set_node_handle<typename ft::__rbt<const value_type, key_type, value_compare, allocator_type, OrderStat>::node_type, allocator_type>	node_type;
+			typedef ft::__insert_return_type<iterator, node_type>	insert_return_type;
+
+			/* cursor() 가 돌려주는 일괄 복사 cursor. read(out, n) 으로 n 개씩 꺼낸다. */
+			typedef typename ft::__rbt<const value_type, key_type, value_compare, allocator_type, OrderStat>::batch_cursor	batch_cursor;
+
 			/* orthdox */
 			explicit set(const compare_type& comp = compare_type(), const allocator_type& alloc = allocator_type())
 			: __comp(comp), __alloc(alloc), __rbt(comp, alloc) {}
@@ -72,32 +85,104 @@ namespace ft {
 			size_type	max_size()	const { return __rbt.max_size(); }
 
 			ft::pair<iterator, bool>	insert(const value_type& val)
-			{ return __rbt.insert(val); }
+			{
+				FT_TRACE_OP(set, trace_insert, val);
+				return __rbt.insert(val);
+			}
 
 			iterator	insert(iterator _idx, const value_type& val)
-			{ return __rbt.insert(_idx, val); }
+			{
+				FT_TRACE_OP(set, trace_insert, val);
+				return __rbt.insert(_idx, val);
+			}
 
 			template <class InputIterator>
 			void	insert(InputIterator first, InputIterator last)
 			{ __rbt.insert(first, last); }
 
-			void		erase(iterator _idx)					{ __rbt.erase(_idx); }
-			size_type	erase(const value_type& val)			{ return __rbt.erase(val); }
+			void		erase(iterator _idx)
+			{
+				FT_TRACE_OP(set, trace_erase, *_idx);
+				__rbt.erase(_idx);
+			}
+			size_type	erase(const value_type& val)
+			{
+				FT_TRACE_OP(set, trace_erase, val);
+				return __rbt.erase(val);
+			}
 			void		erase(iterator first, iterator last)	{ __rbt.erase(first, last); }
 
+			template <typename K>
+			typename ft::enable_if<ft::__is_transparent<compare_type, K>::value, size_type>::type
+			erase(const K& key)
+			{
+				FT_TRACE_OP(set, trace_erase, key);
+				return __rbt.erase(key);
+			}
+
+			/* 원소의 노드를 해제하지 않고 떼어내 node handle 로 돌려준다. 없으면 빈 handle */
+			node_type	extract(iterator _idx)			{ return node_type(__rbt.extract(_idx), get_allocator()); }
+			node_type	extract(const value_type& val)	{ return node_type(__rbt.extract(val), get_allocator()); }
+
+			/* handle 의 노드를 그대로 연결한다. 같은 값이 있으면 inserted == false 이고 노드는 node 로 돌아온다. */
+			insert_return_type	insert(node_type nh)
+			{
+				insert_return_type ret;
+				ret.inserted = false;
+				if (nh.empty())
+				{
+					ret.position = end();
+					return ret;
+				}
+				ft::pair<iterator, bool> p = __rbt.insert_node(nh.__get());
+				ret.position = p.first;
+				ret.inserted = p.second;
+				if (p.second)
+					nh.__release();
+				else
+					ret.node = nh;
+				return ret;
+			}
+
+			/* hint 버전. 성공하면 nh 는 비고, 같은 값이 있으면 노드는 nh 에 그대로 남는다.
+			(소유권이 옮겨가지 않도록 참조로 받는다. 임시 handle 도 받을 수 있게 const) */
+			iterator	insert(iterator _idx, const node_type& nh)
+			{
+				if (nh.empty())
+					return end();
+				ft::pair<iterator, bool> p = __rbt.insert_node(_idx, nh.__get());
+				if (p.second)
+					nh.__release();
+				return p.first;
+			}
+
+			/* other 에서 *this 에 없는 값의 노드를 복사 없이 옮겨온다. 겹치는 값은 other 에 남는다. */
+			void	merge(set& other)	{ __rbt.merge(other.__rbt); }
+
 			void	swap(set& s)	{ __rbt.swap(s.__rbt); }
 
-			void	clear()	{ __rbt.clear(); }
+			void	clear()
+			{
+				FT_TRACE_KV(set, trace_clear, 0, 0);
+				__rbt.clear();
+			}
 
 			key_compare		key_comp() const	{ return __comp; }
 			value_compare	value_comp() const	{ return __comp; }
 
-			iterator		find(const value_type& val) const	{ return __rbt.find(val); }
+			iterator		find(const value_type& val) const
+			{
+				FT_TRACE_OP(set, trace_find, val);
+				return __rbt.find(val);
+			}
 
 			size_type	count(const value_type& val) const { return !(find(val) == end()); }
 
 			iterator		lower_bound(const value_type& val) const
-			{ return __rbt.lower_bound(val); }
+			{
+				FT_TRACE_OP(set, trace_lower_bound, val);
+				return __rbt.lower_bound(val);
+			}
 
 			iterator		upper_bound(const value_type& val) const
 			{ return __rbt.upper_bound(val); }
@@ -105,48 +190,158 @@ namespace ft {
 			ft::pair<iterator, iterator>	equal_range(const value_type& val) const
 			{ return __rbt.equal_range(val); }
 
+			/* heterogeneous lookup : compare_type::is_transparent 가 있을 때만 후보가 된다. */
+			template <typename K>
+			typename ft::enable_if<ft::__is_transparent<compare_type, K>::value, iterator>::type
+			find(const K& key) const
+			{
+				FT_TRACE_OP(set, trace_find, key);
+				return __rbt.find(key);
+			}
+
+			template <typename K>
+			typename ft::enable_if<ft::__is_transparent<compare_type, K>::value, size_type>::type
+			count(const K& key) const	{ return !(find(key) == end()); }
+
+			template <typename K>
+			typename ft::enable_if<ft::__is_transparent<compare_type, K>::value, iterator>::type
+			lower_bound(const K& key) const
+			{
+				FT_TRACE_OP(set, trace_lower_bound, key);
+				return __rbt.lower_bound(key);
+			}
+
+			template <typename K>
+			typename ft::enable_if<ft::__is_transparent<compare_type, K>::value, iterator>::type
+			upper_bound(const K& key) const
+			{ return __rbt.upper_bound(key); }
+
+			template <typename K>
+			typename ft::enable_if<ft::__is_transparent<compare_type, K>::value, ft::pair<iterator, iterator> >::type
+			equal_range(const K& key) const
+			{ return __rbt.equal_range(key); }
+
+			/* order statistics : OrderStat 이면 O(log n), 아니면 순회 O(n) */
+			size_type	rank(const value_type& val) const	{ return __rbt.rank(val); }
+			iterator	select(size_type k) const			{ return __rbt.select(k); }
+
+			size_type	count_range(const value_type& lo, const value_type& hi) const
+			{ return __rbt.count_range(lo, hi); }
+
+			/* 일괄 조회 : vals 마다 결과를 out 에 같은 순서로 채운다. (map::find_many 참고) */
+			template <class ForwardIterator>
+			void	find_many(ForwardIterator first, ForwardIterator last, ft::vector<iterator>& out) const
+			{ __rbt.find_many(first, last, out, __is_sorted(first, last)); }
+
+			template <class ForwardIterator>
+			void	lower_bound_many(ForwardIterator first, ForwardIterator last, ft::vector<iterator>& out) const
+			{ __rbt.lower_bound_many(first, last, out, __is_sorted(first, last)); }
+
+			template <class ForwardIterator>
+			void	count_many(ForwardIterator first, ForwardIterator last, ft::vector<size_type>& out) const
+			{ __rbt.find_many(first, last, out, __is_sorted(first, last)); }
+
+			/* 일괄 순회 : iterator 로 도는 것과 같은 순서지만 다음에 갈 노드를 미리 prefetch 한다. f 가 set 을 바꾸면 안 된다. */
+			template <class F>
+			F	for_each(F f) const	{ return __rbt.for_each(f); }
+
+			/* [lo, hi) 의 원소만 */
+			template <class F>
+			F	range_for_each(const value_type& lo, const value_type& hi, F f) const
+			{ return __rbt.range_for_each(lo, hi, f); }
+
+			batch_cursor	cursor() const	{ return __rbt.cursor(); }
+			batch_cursor	cursor(const value_type& lo, const value_type& hi) const
+			{ return __rbt.cursor(lo, hi); }
+
+			/* tree 모양과 red-black 규칙 검사 결과 (map::stats 참고) */
+			ft::tree_stats	stats() const	{ return __rbt.stats(); }
+
+			/* snapshot / restore : 정렬된 원소 배열로 쓰고, 그 버퍼에서 O(n) 으로 다시 만든다. (map::snapshot 참고) */
+			void	snapshot(int fd) const
+			{
+				ft::__snapshot_check<ft::__snapshot_safe<value_type>::value>::__ok();
+				ft::__snapshot_writer w(fd, ft::__snapshot_set, sizeof(value_type), __alignof__(value_type), size());
+				__rbt.for_each(ft::__snapshot_put<value_type>(&w));
+				w.__finish();
+			}
+
+			void	restore(const void* data, size_type len)
+			{
+				ft::__snapshot_check<ft::__snapshot_safe<value_type>::value>::__ok();
+				ft::__snapshot_reader r(data, len, ft::__snapshot_set, sizeof(value_type), __alignof__(value_type));
+				const value_type* first = static_cast<const value_type*>(r.__data());
+				if (!ft::__snapshot_sorted(first, r.__size(), __comp))
+					throw ft::snapshot_error("ft::snapshot: keys not sorted");
+				__rbt.assign_sorted(first, r.__size());
+			}
+
+			/* set algebra : other 의 노드를 다시 연결해서 *this 를 결과로 만들고 other 는 비운다. O(m log(n / m + 1)) */
+			void	set_union(set& other)			{ __rbt.set_union(other.__rbt); }
+			void	set_intersection(set& other)	{ __rbt.set_intersection(other.__rbt); }
+			void	set_difference(set& other)		{ __rbt.set_difference(other.__rbt); }
+
 			allocator_type	get_allocator() const	{ return __rbt.get_allocator(); }
 
+			/* 노드와 sentinel 의 내역에 set 객체를 더한다. (utils/footprint.hpp) */
+			ft::memory_footprint	memory_usage() const
+			{
+				ft::memory_footprint m = __rbt.memory_usage();
+				m.overhead += sizeof(*this);
+				return m;
+			}
+
 			private:
 				compare_type	__comp;
 				allocator_type	__alloc;
-				ft::__rbt<const value_type, key_type, value_compare, allocator_type>	__rbt;
+				ft::__rbt<const value_type, key_type, value_compare, allocator_type, OrderStat>	__rbt;
+
+				template <class ForwardIterator>
+				bool	__is_sorted(ForwardIterator first, ForwardIterator last) const
+				{
+					if (first == last)
+						return true;
+					for (ForwardIterator prev = first++ ; first != last ; prev = first++)
+						if (__comp(*first, *prev))
+							return false;
+					return true;
+				}
 	};
 
-	template <class T, class Compare, class Alloc>
-	bool operator==(const ft::set<T, Compare, Alloc>& __x,
-		const ft::set<T, Compare, Alloc>& __y)
+	template <class T, class Compare, class Alloc, bool OS>
+	bool operator==(const ft::set<T, Compare, Alloc, OS>& __x,
+		const ft::set<T, Compare, Alloc, OS>& __y)
 	{ return __x.size() == __y.size() && ft::equal(__x.begin(), __x.end(), __y.begin()); }
 
-	template <class T, class Compare, class Alloc>
-	bool operator!=(const ft::set<T, Compare, Alloc>& __x,
-		const ft::set<T, Compare, Alloc>& __y)
+	template <class T, class Compare, class Alloc, bool OS>
+	bool operator!=(const ft::set<T, Compare, Alloc, OS>& __x,
+		const ft::set<T, Compare, Alloc, OS>& __y)
 	{ return !(__x == __y); }
 
-	template <class T, class Compare, class Alloc>
-	bool operator<(const ft::set<T, Compare, Alloc>& __x,
-		const ft::set<T, Compare, Alloc>& __y)
+	template <class T, class Compare, class Alloc, bool OS>
+	bool operator<(const ft::set<T, Compare, Alloc, OS>& __x,
+		const ft::set<T, Compare, Alloc, OS>& __y)
 	{ return ft::lexicographical_compare(__x.begin(), __x.end(), __y.begin(), __y.end()); }
 
-	template <class T, class Compare, class Alloc>
-	bool operator<=(const ft::set<T, Compare, Alloc>& __x,
-		const ft::set<T, Compare, Alloc>& __y)
+	template <class T, class Compare, class Alloc, bool OS>
+	bool operator<=(const ft::set<T, Compare, Alloc, OS>& __x,
+		const ft::set<T, Compare, Alloc, OS>& __y)
 	{ return !(__y < __x); }
 
-	template <class T, class Compare, class Alloc>
-	bool operator>(const ft::set<T, Compare, Alloc>& __x,
-		const ft::set<T, Compare, Alloc>& __y)
+	template <class T, class Compare, class Alloc, bool OS>
+	bool operator>(const ft::set<T, Compare, Alloc, OS>& __x,
+		const ft::set<T, Compare, Alloc, OS>& __y)
 	{ return (__y < __x); }
 
-	template <class T, class Compare, class Alloc>
-	bool operator>=(const ft::set<T, Compare, Alloc>& __x,
-		const ft::set<T, Compare, Alloc>& __y)
+	template <class T, class Compare, class Alloc, bool OS>
+	bool operator>=(const ft::set<T, Compare, Alloc, OS>& __x,
+		const ft::set<T, Compare, Alloc, OS>& __y)
 	{ return !(__x < __y); }
 
 	/* non-member function */
-	template <class T, class Compare, class Alloc>
-	void	swap(ft::set<T, Compare, Alloc>& __x,
-		ft::set<T, Compare, Alloc>& __y)
+	template <class T, class Compare, class Alloc, bool OS>
+	void	swap(ft::set<T, Compare, Alloc, OS>& __x,
+		ft::set<T, Compare, Alloc, OS>& __y)
 	{ __x.swap(__y); }
 
 }
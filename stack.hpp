@@ -45,6 +45,13 @@ namespace ft {
 			const value_type&	top() const {return c.back(); }
 			void				push(const value_type& __val) { c.push_back(__val); }
 			void				pop() { c.pop_back(); }
+			/* container 의 memory_usage() 에 stack 객체에서 container 를 뺀 만큼을 더한다. */
+			ft::memory_footprint	memory_usage() const
+			{
+				ft::memory_footprint m = c.memory_usage();
+				m.overhead += sizeof(*this) - sizeof(c);
+				return m;
+			}
 
 			template <typename Tp, typename Cnt>
 			friend bool operator==(const stack<Tp, Cnt>& lhs, const stack<Tp, Cnt>& rhs)
@@ -0,0 +1,286 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+/* bench_suites --json 결과 두 개(baseline, 새 결과)를 benchmark 마다 비교한다.
+ *
+ * bench_suites 는 ft 와 std 를 번갈아 재므로 i 번째 ft sample 과 i 번째 std sample 은 같은 기계 상태(주파수, 부하)에서 잰 것이다.
+ * 그래서 sample 마다 ft / std 비율을 내고 baseline 의 비율들과 Mann-Whitney U 검정(양측, 동률 보정한 정규 근사)을 한다.
+ * p < alpha 이고 비율의 median 이 threshold % 넘게 커졌으면 regression 이다. 하나라도 있으면 1 로 끝난다.
+ * 기계가 통째로 느려지면 ft 와 std 가 같이 느려져 비율은 그대로이므로 기계 drift 는 regression 으로 세지 않는다.
+ * ft 의 median 이 얼마나 바뀌었는지도 참고로 보여준다.
+ *
+ * bench_compare <baseline.json> <current.json> [--threshold pct] [--alpha p]
+ */
+
+/* ---------------------------------------------------- 작은 JSON parser */
+
+struct Json {
+  enum Type { null_t, number_t, string_t, array_t, object_t, bool_t };
+  Type type;
+  double number;
+  std::string text;
+  std::vector<Json> items;
+  std::map<std::string, Json> fields;
+
+  Json(void) : type(null_t), number(0) {}
+
+  const Json& operator[](const char* key) const {
+    static const Json none;
+    std::map<std::string, Json>::const_iterator it = fields.find(key);
+    return it == fields.end() ? none : it->second;
+  }
+};
+
+class Parser {
+ public:
+  explicit Parser(const std::string& src) : _s(src), _i(0), _ok(true) {}
+
+  bool parse(Json& out) {
+    value(out);
+    space();
+    return _ok && _i == _s.size();
+  }
+
+ private:
+  const std::string& _s;
+  std::size_t _i;
+  bool _ok;
+
+  void space(void) {
+    while (_i < _s.size() && std::strchr(" \t\r\n", _s[_i]))
+      _i++;
+  }
+  bool eat(char c) {
+    space();
+    if (_i < _s.size() && _s[_i] == c) {
+      _i++;
+      return true;
+    }
+    return false;
+  }
+  void fail(void) { _ok = false; _i = _s.size(); }
+
+  void string(std::string& out) {
+    if (!eat('"'))
+      return fail();
+    while (_i < _s.size() && _s[_i] != '"') {
+      if (_s[_i] == '\\' && _i + 1 < _s.size())
+        _i++;
+      out += _s[_i++];
+    }
+    if (!eat('"'))
+      fail();
+  }
+
+  void value(Json& out) {
+    space();
+    if (_i >= _s.size())
+      return fail();
+    char c = _s[_i];
+    if (c == '{') {
+      out.type = Json::object_t;
+      _i++;
+      if (eat('}'))
+        return;
+      do {
+        std::string key;
+        string(key);
+        if (!eat(':'))
+          return fail();
+        value(out.fields[key]);
+      } while (_ok && eat(','));
+      if (!eat('}'))
+        fail();
+    } else if (c == '[') {
+      out.type = Json::array_t;
+      _i++;
+      if (eat(']'))
+        return;
+      do {
+        out.items.push_back(Json());
+        value(out.items.back());
+      } while (_ok && eat(','));
+      if (!eat(']'))
+        fail();
+    } else if (c == '"') {
+      out.type = Json::string_t;
+      string(out.text);
+    } else if (_s.compare(_i, 4, "true") == 0 || _s.compare(_i, 5, "false") == 0) {
+      out.type = Json::bool_t;
+      out.number = c == 't';
+      _i += c == 't' ? 4 : 5;
+    } else if (_s.compare(_i, 4, "null") == 0) {
+      _i += 4;
+    } else {
+      char* end;
+      out.type = Json::number_t;
+      out.number = std::strtod(_s.c_str() + _i, &end);
+      if (end == _s.c_str() + _i)
+        return fail();
+      _i = end - _s.c_str();
+    }
+  }
+};
+
+static bool	load(const char* path, Json& out) {
+  std::FILE* in = std::fopen(path, "r");
+  if (!in) {
+    std::fprintf(stderr, "bench_compare: cannot open %s\n", path);
+    return false;
+  }
+  std::string src;
+  char buf[65536];
+  std::size_t n;
+  while ((n = std::fread(buf, 1, sizeof(buf), in)) > 0)
+    src.append(buf, n);
+  std::fclose(in);
+  if (!Parser(src).parse(out) || out["benchmarks"].type != Json::array_t) {
+    std::fprintf(stderr, "bench_compare: %s is not a bench_suites result\n", path);
+    return false;
+  }
+  return true;
+}
+
+/* ------------------------------------------------------------ 통계 */
+
+static std::vector<double>	samples_of(const Json& side) {
+  std::vector<double> v;
+  const Json& s = side["samples"];
+  for (std::size_t i = 0 ; i < s.items.size() ; i++)
+    v.push_back(s.items[i].number);
+  return v;
+}
+
+/* sample 마다 ft / std. 같은 순서로 잰 sample 끼리 나눈다. */
+static std::vector<double>	ratios_of(const Json& bench) {
+  std::vector<double> ft = samples_of(bench["ft"]);
+  std::vector<double> st = samples_of(bench["std"]);
+  std::vector<double> v;
+  for (std::size_t i = 0 ; i < ft.size() && i < st.size() ; i++)
+    if (st[i] > 0)
+      v.push_back(ft[i] / st[i]);
+  return v;
+}
+
+/* 양측 Mann-Whitney U 검정의 p 값. 동률은 평균 순위를 주고 분산을 보정한다. */
+static double	mann_whitney(const std::vector<double>& a, const std::vector<double>& b) {
+  std::size_t n1 = a.size();
+  std::size_t n2 = b.size();
+  if (n1 == 0 || n2 == 0)
+    return 1.0;
+  std::vector<std::pair<double, int> > all;
+  for (std::size_t i = 0 ; i < n1 ; i++)
+    all.push_back(std::make_pair(a[i], 0));
+  for (std::size_t i = 0 ; i < n2 ; i++)
+    all.push_back(std::make_pair(b[i], 1));
+  std::sort(all.begin(), all.end());
+  double rank_a = 0;
+  double ties = 0;
+  for (std::size_t i = 0 ; i < all.size() ; ) {
+    std::size_t j = i;
+    while (j < all.size() && all[j].first == all[i].first)
+      j++;
+    double rank = (i + 1 + j) / 2.0;
+    double t = static_cast<double>(j - i);
+    ties += t * t * t - t;
+    for (std::size_t k = i ; k < j ; k++)
+      if (all[k].second == 0)
+        rank_a += rank;
+    i = j;
+  }
+  double n = static_cast<double>(n1 + n2);
+  double u = rank_a - n1 * (n1 + 1) / 2.0;
+  double mean = n1 * n2 / 2.0;
+  double var = n1 * n2 / 12.0 * ((n + 1) - ties / (n * (n - 1)));
+  if (var <= 0)
+    return 1.0;
+  /* 연속성 보정 */
+  double z = (std::fabs(u - mean) - 0.5) / std::sqrt(var);
+  if (z < 0)
+    z = 0;
+  return erfc(z / std::sqrt(2.0));
+}
+
+static double	median_of(std::vector<double> v) {
+  if (v.empty())
+    return 0;
+  std::sort(v.begin(), v.end());
+  std::size_t n = v.size();
+  return n % 2 ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2;
+}
+
+/* ------------------------------------------------------------- main */
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    std::fprintf(stderr, "usage: bench_compare <baseline.json> <current.json> [--threshold pct] [--alpha p]\n");
+    return 2;
+  }
+  double threshold = 10.0;
+  double alpha = 0.01;
+  for (int i = 3 ; i + 1 < argc ; i += 2) {
+    if (std::strcmp(argv[i], "--threshold") == 0)
+      threshold = std::atof(argv[i + 1]);
+    else if (std::strcmp(argv[i], "--alpha") == 0)
+      alpha = std::atof(argv[i + 1]);
+  }
+  Json base;
+  Json cur;
+  if (!load(argv[1], base) || !load(argv[2], cur))
+    return 2;
+  if (base["fingerprint"].text != cur["fingerprint"].text)
+    std::printf("\033[1;33mwarning: baseline was recorded on a different machine\n  baseline: %s\n  current : %s\033[0m\n",
+                base["machine"].text.c_str(), cur["machine"].text.c_str());
+
+  std::map<std::string, const Json*> old;
+  for (std::size_t i = 0 ; i < base["benchmarks"].items.size() ; i++)
+    old[base["benchmarks"].items[i]["name"].text] = &base["benchmarks"].items[i];
+
+  std::printf("\033[1;34m--- median ft/std per sample vs baseline (regression: > %.1f%% higher, p < %g) ---\033[0m\n", threshold, alpha);
+  std::printf("%-28s %10s %10s %8s %9s %8s  %s\n", "benchmark", "baseline", "current", "change", "p", "ft", "verdict");
+  int regressions = 0;
+  const Json& list = cur["benchmarks"];
+  for (std::size_t i = 0 ; i < list.items.size() ; i++) {
+    const Json& b = list.items[i];
+    std::map<std::string, const Json*>::iterator it = old.find(b["name"].text);
+    if (it == old.end()) {
+      std::printf("%-28s %10s %10.3f %8s %9s %8s  new\n", b["name"].text.c_str(), "-", median_of(ratios_of(b)), "", "", "");
+      continue;
+    }
+    const Json& a = *it->second;
+    old.erase(it);
+    std::vector<double> ra = ratios_of(a);
+    std::vector<double> rb = ratios_of(b);
+    double ma = median_of(ra);
+    double mb = median_of(rb);
+    double change = ma > 0 ? (mb / ma - 1) * 100 : 0;
+    double p = mann_whitney(ra, rb);
+    double fa = median_of(samples_of(a["ft"]));
+    double ft_change = fa > 0 ? (median_of(samples_of(b["ft"])) / fa - 1) * 100 : 0;
+    const char* verdict = "";
+    if (p < alpha && change > threshold) {
+      verdict = "\033[1;31mREGRESSION\033[0m";
+      regressions++;
+    } else if (p < alpha && change < -threshold) {
+      verdict = "\033[1;32mfaster\033[0m";
+    }
+    std::printf("%-28s %10.3f %10.3f %+7.1f%% %9.2g %+7.1f%%  %s\n",
+                b["name"].text.c_str(), ma, mb, change, p, ft_change, verdict);
+  }
+  for (std::map<std::string, const Json*>::iterator it = old.begin() ; it != old.end() ; ++it)
+    std::printf("%-28s %10.3f %10s %8s %9s %8s  removed\n", it->first.c_str(), median_of(ratios_of(*it->second)), "-", "", "", "");
+
+  if (regressions) {
+    std::printf("\033[1;31m%d benchmark(s) regressed\033[0m\n", regressions);
+    return 1;
+  }
+  std::printf("\033[1;32mno regression\033[0m\n");
+  return 0;
+}
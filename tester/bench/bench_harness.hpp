@@ -0,0 +1,479 @@
+#ifndef BENCH_HARNESS_HPP
+# define BENCH_HARNESS_HPP
+
+# include <algorithm>
+# include <cmath>
+# include <cstdio>
+# include <cstdlib>
+# include <cstring>
+# include <ctime>
+# include <string>
+# include <vector>
+# include <unistd.h>
+# ifdef __linux__
+#  include <sched.h>
+# endif
+# include "bench_perf.hpp"
+
+/* ft 와 std container 를 같은 조건으로 재는 benchmark harness
+ *
+ * 한 benchmark 는 ft 용, std 용 함수 한 쌍이다. 함수는 state::iterations() 만큼 같은 일을 반복하고,
+ * 준비 작업이 있으면 state::start() / stop() 으로 잴 구간만 감싼다. (부르지 않으면 함수 전체를 잰다)
+ *
+ * 1. warmup   : 정해진 시간 동안 돌리면서 한 sample 이 min_time 이상 걸리도록 반복 횟수를 늘린다.
+ * 2. sample   : ft 와 std 를 번갈아 samples 번씩 잰다. 순서도 매번 뒤집어 시간에 따른 drift (발열, 주파수) 가 양쪽에 똑같이 걸리게 한다.
+ * 3. 통계     : item 하나당 ns 의 median, MAD (정규분포 기준으로 1.4826 배), 분포 가정 없는 median 의 95% 신뢰구간.
+ *
+ * 시간은 CLOCK_MONOTONIC_RAW (없으면 CLOCK_MONOTONIC) 로 잰다.
+ * --cpu N 이면 sched_setaffinity 로 CPU 하나에 묶는다. (linux)
+ * --perf 면 잰 구간의 hardware counter (bench_perf.hpp) 도 item 당 값으로 함께 보여준다. 열 수 없으면 이유를 알리고 시간만 잰다.
+ * --json 파일에는 요약과 함께 sample 원본과 기계 fingerprint 도 남긴다. (bench_compare 가 baseline 과 비교할 때 쓴다)
+ */
+
+namespace bench {
+
+inline unsigned long long	now_ns(void) {
+  struct timespec ts;
+# ifdef CLOCK_MONOTONIC_RAW
+  clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+# else
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+# endif
+  return static_cast<unsigned long long>(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+}
+
+/* compiler 가 결과를 버리고 loop 를 지우지 못하게 한다. */
+template <class T>
+inline void	keep(const T& value) {
+  asm volatile("" : : "r"(&value) : "memory");
+}
+
+/* 실행 순서가 같으면 항상 같은 key 를 만드는 xorshift */
+struct Rng {
+  unsigned long long s;
+  explicit Rng(unsigned long long seed = 88172645463325252ull) : s(seed) {}
+  unsigned long long next(void) {
+    s ^= s << 13;
+    s ^= s >> 7;
+    s ^= s << 17;
+    return s;
+  }
+};
+
+class state {
+ public:
+  explicit state(unsigned long iters, perf_counters* perf = 0)
+    : _iters(iters), _items(iters), _start(0), _elapsed(0), _timed(false), _perf(perf) {}
+
+  unsigned long iterations(void) const { return _iters; }
+  /* 한 번 호출에서 처리한 단위 수. 기본은 iterations() 이고 결과는 item 하나당 ns 로 나온다. */
+  void set_items(unsigned long items) { _items = items; }
+  unsigned long items(void) const { return _items; }
+
+  /* 처음 start() 하면 그 전까지 센 counter (준비 작업) 는 버린다. */
+  void start(void) {
+    if (_perf) {
+      if (!_timed) {
+        _perf->disable();
+        _perf->reset();
+      }
+      _perf->enable();
+    }
+    _timed = true;
+    _start = now_ns();
+  }
+  void stop(void) {
+    _elapsed += now_ns() - _start;
+    if (_perf)
+      _perf->disable();
+  }
+
+  bool timed(void) const { return _timed; }
+  unsigned long long elapsed(void) const { return _elapsed; }
+
+ private:
+  unsigned long _iters;
+  unsigned long _items;
+  unsigned long long _start;
+  unsigned long long _elapsed;
+  bool _timed;
+  perf_counters* _perf;
+};
+
+typedef void (*bench_fn)(state&);
+
+struct Case {
+  std::string name;
+  bench_fn ft_fn;
+  bench_fn std_fn;
+};
+
+struct Options {
+  unsigned int samples;
+  double min_time_ms;   /* sample 하나의 최소 시간 */
+  double warmup_ms;
+  int cpu;              /* -1 이면 묶지 않는다 */
+  const char* filter;   /* 이름에 이 문자열이 들어간 benchmark 만 */
+  const char* json;
+  bool list;
+  bool print_fingerprint;
+  bool perf;
+
+  Options(void)
+    : samples(15), min_time_ms(5), warmup_ms(20), cpu(-1), filter(0), json(0), list(false), print_fingerprint(false), perf(false) {}
+};
+
+struct Summary {
+  unsigned long iterations;
+  std::vector<double> samples;   /* ns / item, 잰 순서 그대로 */
+  double median;
+  double mad;
+  double ci_low;
+  double ci_high;
+  double mean;
+  double min;
+  std::vector<perf_values> perf_samples;   /* --perf 일 때 sample 마다 item 당 counter */
+  perf_values perf;                        /* counter 마다 median */
+};
+
+struct Result {
+  std::string name;
+  Summary ft_side;
+  Summary std_side;
+};
+
+inline std::vector<Case>&	registry(void) {
+  static std::vector<Case> cases;
+  return cases;
+}
+
+inline void	add(const char* name, bench_fn ft_fn, bench_fn std_fn) {
+  Case c;
+  c.name = name;
+  c.ft_fn = ft_fn;
+  c.std_fn = std_fn;
+  registry().push_back(c);
+}
+
+/* --perf 로 counter 를 열었으면 여기 있다. */
+inline perf_counters*&	perf_session(void) {
+  static perf_counters* perf = 0;
+  return perf;
+}
+
+/* fn 을 iters 번 돌린 시간 (ns). perf 를 넘기면 잰 구간의 counter 를 item 당 값으로 채운다. */
+inline unsigned long long	run_once(bench_fn fn, unsigned long iters, unsigned long& items, perf_values* perf = 0) {
+  perf_counters* pc = perf ? perf_session() : 0;
+  state st(iters, pc);
+  if (pc) {
+    pc->reset();
+    pc->enable();
+  }
+  unsigned long long t0 = now_ns();
+  fn(st);
+  unsigned long long total = now_ns() - t0;
+  items = st.items();
+  if (pc) {
+    pc->disable();
+    *perf = perf_per_item(perf_values(0), pc->read_values(), static_cast<double>(items ? items : 1));
+  }
+  return st.timed() ? st.elapsed() : total;
+}
+
+/* warmup 하면서 한 sample 이 min_time 이상 걸리는 반복 횟수를 찾는다. */
+inline unsigned long	calibrate(bench_fn fn, const Options& opt) {
+  const unsigned long long min_ns = static_cast<unsigned long long>(opt.min_time_ms * 1e6);
+  const unsigned long long warm_ns = static_cast<unsigned long long>(opt.warmup_ms * 1e6);
+  unsigned long iters = 1;
+  unsigned long items;
+  unsigned long long begin = now_ns();
+  for (;;) {
+    unsigned long long t = run_once(fn, iters, items);
+    if (t >= min_ns) {
+      if (now_ns() - begin >= warm_ns)
+        return iters;
+      continue;
+    }
+    /* 목표의 1.2 배를 노리되 한 번에 10 배 넘게는 늘리지 않는다. */
+    double grow = t ? 1.2 * min_ns / t : 10.0;
+    if (grow > 10.0)
+      grow = 10.0;
+    unsigned long next = static_cast<unsigned long>(iters * grow);
+    iters = next > iters ? next : iters + 1;
+  }
+}
+
+inline double	median_of(std::vector<double> v) {
+  std::sort(v.begin(), v.end());
+  std::size_t n = v.size();
+  return n % 2 ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2;
+}
+
+/* 순서 통계량으로 구한 median 의 95% 신뢰구간. 이항분포 B(n, 1/2) 의 정규 근사로 순위를 잡는다. */
+inline void	median_ci(std::vector<double> v, double& lo, double& hi) {
+  std::sort(v.begin(), v.end());
+  double n = static_cast<double>(v.size());
+  double half = 1.96 * std::sqrt(n) / 2;
+  long j = static_cast<long>(std::floor(n / 2 - half));
+  long k = static_cast<long>(std::ceil(n / 2 + half));
+  if (j < 0)
+    j = 0;
+  if (k > static_cast<long>(v.size()) - 1)
+    k = static_cast<long>(v.size()) - 1;
+  lo = v[j];
+  hi = v[k];
+}
+
+inline void	summarize(Summary& s) {
+  s.median = median_of(s.samples);
+  std::vector<double> dev(s.samples.size());
+  double sum = 0;
+  s.min = s.samples[0];
+  for (std::size_t i = 0 ; i < s.samples.size() ; i++) {
+    dev[i] = std::fabs(s.samples[i] - s.median);
+    sum += s.samples[i];
+    s.min = std::min(s.min, s.samples[i]);
+  }
+  s.mad = 1.4826 * median_of(dev);
+  s.mean = sum / s.samples.size();
+  median_ci(s.samples, s.ci_low, s.ci_high);
+  for (int e = 0 ; e < perf_event_count && !s.perf_samples.empty() ; e++) {
+    std::vector<double> v;
+    for (std::size_t i = 0 ; i < s.perf_samples.size() ; i++)
+      if (s.perf_samples[i].v[e] >= 0)
+        v.push_back(s.perf_samples[i].v[e]);
+    if (!v.empty())
+      s.perf.v[e] = median_of(v);
+  }
+}
+
+inline void	sample(bench_fn fn, Summary& s) {
+  unsigned long items;
+  if (perf_session()) {
+    perf_values pv;
+    unsigned long long t = run_once(fn, s.iterations, items, &pv);
+    s.samples.push_back(static_cast<double>(t) / (items ? items : 1));
+    s.perf_samples.push_back(pv);
+  } else {
+    unsigned long long t = run_once(fn, s.iterations, items);
+    s.samples.push_back(static_cast<double>(t) / (items ? items : 1));
+  }
+}
+
+inline Result	measure(const Case& c, const Options& opt) {
+  Result r;
+  r.name = c.name;
+  r.ft_side.iterations = calibrate(c.ft_fn, opt);
+  r.std_side.iterations = calibrate(c.std_fn, opt);
+  for (unsigned int i = 0 ; i < opt.samples ; i++) {
+    if (i % 2 == 0) {
+      sample(c.ft_fn, r.ft_side);
+      sample(c.std_fn, r.std_side);
+    } else {
+      sample(c.std_fn, r.std_side);
+      sample(c.ft_fn, r.ft_side);
+    }
+  }
+  summarize(r.ft_side);
+  summarize(r.std_side);
+  return r;
+}
+
+inline bool	pin_cpu(int cpu) {
+# ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  return sched_setaffinity(0, sizeof(set), &set) == 0;
+# else
+  (void)cpu;
+  return false;
+# endif
+}
+
+/* 결과를 비교해도 되는 기계인지 가리는 설명. CPU 모델, CPU 수, compiler 가 같으면 같은 문자열이다. */
+inline std::string	machine(void) {
+  std::string model = "unknown cpu";
+  std::FILE* in = std::fopen("/proc/cpuinfo", "r");
+  if (in) {
+    char line[512];
+    while (std::fgets(line, sizeof(line), in)) {
+      if (std::strncmp(line, "model name", 10) != 0)
+        continue;
+      const char* p = std::strchr(line, ':');
+      if (p) {
+        model = p + 2;
+        model.erase(model.find_last_not_of(" \n") + 1);
+      }
+      break;
+    }
+    std::fclose(in);
+  }
+  char buf[64];
+  std::snprintf(buf, sizeof(buf), " x%ld", sysconf(_SC_NPROCESSORS_ONLN));
+  std::string compiler = "unknown compiler";
+# ifdef __VERSION__
+  compiler = __VERSION__;
+# endif
+  return model + buf + ", " + compiler;
+}
+
+/* machine() 의 FNV-1a 64 bit hash. baseline 파일 이름으로 쓴다. */
+inline std::string	fingerprint(void) {
+  std::string m = machine();
+  unsigned long long h = 14695981039346656037ull;
+  for (std::size_t i = 0 ; i < m.size() ; i++) {
+    h ^= static_cast<unsigned char>(m[i]);
+    h *= 1099511628211ull;
+  }
+  char buf[32];
+  std::snprintf(buf, sizeof(buf), "%016llx", h);
+  return buf;
+}
+
+inline std::string	json_escape(const std::string& s) {
+  std::string out;
+  for (std::size_t i = 0 ; i < s.size() ; i++) {
+    if (s[i] == '"' || s[i] == '\\')
+      out += '\\';
+    if (static_cast<unsigned char>(s[i]) >= 0x20)
+      out += s[i];
+  }
+  return out;
+}
+
+inline void	json_summary(std::FILE* out, const char* impl, const Summary& s) {
+  std::fprintf(out, "\"%s\": {\"iterations\": %lu, \"median\": %.4f, \"mad\": %.4f, \"ci_low\": %.4f, \"ci_high\": %.4f, "
+               "\"mean\": %.4f, \"min\": %.4f, \"samples\": [",
+               impl, s.iterations, s.median, s.mad, s.ci_low, s.ci_high, s.mean, s.min);
+  for (std::size_t i = 0 ; i < s.samples.size() ; i++)
+    std::fprintf(out, "%s%.4f", i ? ", " : "", s.samples[i]);
+  std::fprintf(out, "]");
+  if (!s.perf_samples.empty()) {
+    std::fprintf(out, ", \"perf\": {");
+    for (int e = 0 ; e < perf_event_count ; e++) {
+      std::fprintf(out, "%s\"%s\": ", e ? ", " : "", perf_event_name(e));
+      if (s.perf.v[e] >= 0)
+        std::fprintf(out, "%.4f", s.perf.v[e]);
+      else
+        std::fprintf(out, "null");
+    }
+    std::fprintf(out, "}");
+  }
+  std::fprintf(out, "}");
+}
+
+inline bool	write_json(const char* path, const Options& opt, const std::vector<Result>& results) {
+  std::FILE* out = std::fopen(path, "w");
+  if (!out)
+    return false;
+  char host[256] = "unknown";
+  gethostname(host, sizeof(host) - 1);
+  std::fprintf(out, "{\n  \"host\": \"%s\",\n  \"machine\": \"%s\",\n  \"fingerprint\": \"%s\",\n",
+               json_escape(host).c_str(), json_escape(machine()).c_str(), fingerprint().c_str());
+  std::fprintf(out, "  \"timestamp\": %ld,\n  \"unit\": \"ns/item\",\n", static_cast<long>(std::time(0)));
+  std::fprintf(out, "  \"options\": {\"samples\": %u, \"min_time_ms\": %g, \"warmup_ms\": %g, \"cpu\": %d},\n",
+               opt.samples, opt.min_time_ms, opt.warmup_ms, opt.cpu);
+  std::fprintf(out, "  \"benchmarks\": [\n");
+  for (std::size_t i = 0 ; i < results.size() ; i++) {
+    std::fprintf(out, "    {\"name\": \"%s\", ", results[i].name.c_str());
+    json_summary(out, "ft", results[i].ft_side);
+    std::fprintf(out, ", ");
+    json_summary(out, "std", results[i].std_side);
+    std::fprintf(out, "}%s\n", i + 1 < results.size() ? "," : "");
+  }
+  std::fprintf(out, "  ]\n}\n");
+  return std::fclose(out) == 0;
+}
+
+inline void	usage(const char* prog) {
+  std::fprintf(stderr, "usage: %s [--filter str] [--samples n] [--min-time ms] [--warmup ms] [--cpu n] [--json file] [--perf] [--list] [--fingerprint]\n", prog);
+}
+
+inline bool	parse_options(int argc, char** argv, Options& opt) {
+  for (int i = 1 ; i < argc ; i++) {
+    std::string arg = argv[i];
+    bool has_value = i + 1 < argc;
+    if (arg == "--list")
+      opt.list = true;
+    else if (arg == "--fingerprint")
+      opt.print_fingerprint = true;
+    else if (arg == "--perf")
+      opt.perf = true;
+    else if (arg == "--filter" && has_value)
+      opt.filter = argv[++i];
+    else if (arg == "--samples" && has_value)
+      opt.samples = static_cast<unsigned int>(std::atoi(argv[++i]));
+    else if (arg == "--min-time" && has_value)
+      opt.min_time_ms = std::atof(argv[++i]);
+    else if (arg == "--warmup" && has_value)
+      opt.warmup_ms = std::atof(argv[++i]);
+    else if (arg == "--cpu" && has_value)
+      opt.cpu = std::atoi(argv[++i]);
+    else if (arg == "--json" && has_value)
+      opt.json = argv[++i];
+    else
+      return false;
+  }
+  if (opt.samples < 3)
+    opt.samples = 3;
+  return true;
+}
+
+/* 등록된 benchmark 를 돌리고 표로 출력한다. 실패하면 0 이 아닌 값 */
+inline int	run_all(int argc, char** argv) {
+  Options opt;
+  if (!parse_options(argc, argv, opt)) {
+    usage(argv[0]);
+    return 2;
+  }
+  if (opt.print_fingerprint) {
+    std::printf("%s\n", fingerprint().c_str());
+    return 0;
+  }
+  std::vector<Case>& cases = registry();
+  if (opt.list) {
+    for (std::size_t i = 0 ; i < cases.size() ; i++)
+      std::printf("%s\n", cases[i].name.c_str());
+    return 0;
+  }
+  if (opt.cpu >= 0 && !pin_cpu(opt.cpu))
+    std::fprintf(stderr, "warning: could not pin to cpu %d, running unpinned\n", opt.cpu);
+  perf_counters* counters = opt.perf ? new perf_counters : 0;
+  if (counters && counters->available())
+    perf_session() = counters;
+  else if (counters)
+    std::fprintf(stderr, "warning: perf counters unavailable: %s, timings only\n", counters->reason().c_str());
+
+  std::printf("\033[1;34m--- %u samples, >= %g ms each (ns/item, median +- MAD [95%% CI]) ---\033[0m\n",
+              opt.samples, opt.min_time_ms);
+  std::printf("%-28s %34s %34s %8s\n", "benchmark", "ft", "std", "ft/std");
+  std::vector<Result> results;
+  for (std::size_t i = 0 ; i < cases.size() ; i++) {
+    if (opt.filter && cases[i].name.find(opt.filter) == std::string::npos)
+      continue;
+    Result r = measure(cases[i], opt);
+    char ft_text[64];
+    char std_text[64];
+    std::snprintf(ft_text, sizeof(ft_text), "%.2f +- %.2f [%.2f, %.2f]", r.ft_side.median, r.ft_side.mad, r.ft_side.ci_low, r.ft_side.ci_high);
+    std::snprintf(std_text, sizeof(std_text), "%.2f +- %.2f [%.2f, %.2f]", r.std_side.median, r.std_side.mad, r.std_side.ci_low, r.std_side.ci_high);
+    std::printf("%-28s %34s %34s %7.2fx\n", r.name.c_str(), ft_text, std_text, r.ft_side.median / r.std_side.median);
+    if (perf_session()) {
+      std::printf("  %-4s %s\n", "ft", perf_format(r.ft_side.perf).c_str());
+      std::printf("  %-4s %s\n", "std", perf_format(r.std_side.perf).c_str());
+    }
+    std::fflush(stdout);
+    results.push_back(r);
+  }
+  perf_session() = 0;
+  delete counters;
+  if (opt.json && !write_json(opt.json, opt, results)) {
+    std::fprintf(stderr, "error: could not write %s\n", opt.json);
+    return 1;
+  }
+  return 0;
+}
+
+}
+
+#endif
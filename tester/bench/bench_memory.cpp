@@ -0,0 +1,246 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <new>
+#include <set>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "../../vector.hpp"
+#include "../../map.hpp"
+#include "../../set.hpp"
+
+#if defined(__GLIBC__)
+# include <malloc.h>
+#elif defined(__APPLE__)
+# include <malloc/malloc.h>
+#else
+# error "bench_memory needs malloc_usable_size (glibc) or malloc_size (macOS)"
+#endif
+
+/* 원소 하나가 실제로 차지하는 byte 를 크기(1, 10, ..., --max)마다 ft 와 std 로 잰다.
+ *
+ * 이 binary 의 operator new / delete 가 malloc 이 실제로 내준 block 크기(header 와 올림 포함)를 더하고 빼므로
+ * container 를 채우기 전후의 차이 + container 객체 크기가 그 container 의 실제 사용량이다.
+ * 원소가 따로 잡은 heap (string 의 buffer) 도 들어간다.
+ * ft 쪽은 memory_usage() 의 내역(payload / overhead / slack / allocator 추정)도 같이 보여준다.
+ * memory_usage 는 원소의 heap 을 세지 않으므로 string 에선 잰 값보다 작다.
+ *
+ * payload 는 int, 20 글자 std::string, 32 byte struct. vector 는 push_back 으로 채워서 두 배씩 늘린 slack 이 남고,
+ * map 은 key 가 int 이고 payload 가 mapped value, set 은 payload 자체가 key 다.
+ *
+ * ./bench_memory --max 1e8 --payload int --container vector --mem-limit 8192
+ * 다음 크기가 --mem-limit (MiB, 기본 물리 메모리의 절반) 을 넘을 것 같으면 재지 않고 건너뛴다.
+ */
+
+#if __cplusplus >= 201103L
+# define BENCH_NEW_THROW
+# define BENCH_NO_THROW noexcept
+#else
+# define BENCH_NEW_THROW throw(std::bad_alloc)
+# define BENCH_NO_THROW throw()
+#endif
+
+static long g_live = 0;  /* 살아 있는 block 의 byte */
+
+static std::size_t block_size(void* p) {
+#if defined(__GLIBC__)
+  return malloc_usable_size(p) + sizeof(std::size_t);
+#else
+  return malloc_size(p);
+#endif
+}
+
+static void* counted_alloc(std::size_t size) {
+  void* p = std::malloc(size ? size : 1);
+  if (p)
+    g_live += static_cast<long>(block_size(p));
+  return p;
+}
+
+static void counted_free(void* p) {
+  if (!p)
+    return;
+  g_live -= static_cast<long>(block_size(p));
+  std::free(p);
+}
+
+void* operator new(std::size_t size) BENCH_NEW_THROW {
+  void* p = counted_alloc(size);
+  if (!p)
+    throw std::bad_alloc();
+  return p;
+}
+void* operator new[](std::size_t size) BENCH_NEW_THROW { return operator new(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) BENCH_NO_THROW { return counted_alloc(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) BENCH_NO_THROW { return counted_alloc(size); }
+void operator delete(void* p) BENCH_NO_THROW { counted_free(p); }
+void operator delete[](void* p) BENCH_NO_THROW { counted_free(p); }
+void operator delete(void* p, const std::nothrow_t&) BENCH_NO_THROW { counted_free(p); }
+void operator delete[](void* p, const std::nothrow_t&) BENCH_NO_THROW { counted_free(p); }
+#if __cplusplus >= 201402L
+void operator delete(void* p, std::size_t) BENCH_NO_THROW { counted_free(p); }
+void operator delete[](void* p, std::size_t) BENCH_NO_THROW { counted_free(p); }
+#endif
+
+/* --------------------------------------------------------------- payload */
+
+struct record {
+  long id;
+  double score;
+  char tag[16];
+};
+
+inline bool operator<(const record& a, const record& b) { return a.id < b.id; }
+
+template <class T>
+T make(unsigned long i);
+
+template <>
+int make<int>(unsigned long i) { return static_cast<int>(i); }
+
+template <>
+std::string make<std::string>(unsigned long i) {
+  char buf[32];
+  std::snprintf(buf, sizeof(buf), "payload-%012lu", i);
+  return buf;
+}
+
+template <>
+record make<record>(unsigned long i) {
+  record r;
+  r.id = static_cast<long>(i);
+  r.score = i * 0.5;
+  std::memset(r.tag, 'x', sizeof(r.tag));
+  return r;
+}
+
+/* ---------------------------------------------------------------- fill */
+
+template <class Vector>
+void fill_vector(Vector& c, unsigned long n) {
+  for (unsigned long i = 0 ; i < n ; i++)
+    c.push_back(make<typename Vector::value_type>(i));
+}
+
+template <class Map>
+void fill_map(Map& c, unsigned long n) {
+  for (unsigned long i = 0 ; i < n ; i++)
+    c.insert(typename Map::value_type(static_cast<int>(i), make<typename Map::mapped_type>(i)));
+}
+
+template <class Set>
+void fill_set(Set& c, unsigned long n) {
+  for (unsigned long i = 0 ; i < n ; i++)
+    c.insert(make<typename Set::value_type>(i));
+}
+
+/* std container 는 memory_usage 가 없으므로 빈 내역 */
+template <class C>
+ft::memory_footprint usage_of(const C&) { return ft::memory_footprint(); }
+template <class T, class A>
+ft::memory_footprint usage_of(const ft::vector<T, A>& c) { return c.memory_usage(); }
+template <class K, class T, class C, class A, bool O>
+ft::memory_footprint usage_of(const ft::map<K, T, C, A, O>& c) { return c.memory_usage(); }
+template <class T, class C, class A, bool O>
+ft::memory_footprint usage_of(const ft::set<T, C, A, O>& c) { return c.memory_usage(); }
+
+/* n 개를 채운 container 의 실제 byte (container 객체 포함) */
+template <class C, void (*Fill)(C&, unsigned long)>
+long measure(unsigned long n, ft::memory_footprint* usage) {
+  long before = g_live;
+  long bytes;
+  {
+    C c;
+    Fill(c, n);
+    bytes = g_live - before + static_cast<long>(sizeof(C));
+    *usage = usage_of(c);
+  }
+  return bytes;
+}
+
+typedef long (*measure_fn)(unsigned long n, ft::memory_footprint* usage);
+
+struct Row {
+  const char* payload;
+  const char* container;
+  measure_fn ft_fn;
+  measure_fn std_fn;
+};
+
+template <class T>
+void add_rows(std::vector<Row>& rows, const char* payload) {
+  typedef ft::vector<T> ft_vector;
+  typedef std::vector<T> std_vector;
+  typedef ft::map<int, T> ft_map;
+  typedef std::map<int, T> std_map;
+  typedef ft::set<T> ft_set;
+  typedef std::set<T> std_set;
+  Row v = { payload, "vector", measure<ft_vector, fill_vector<ft_vector> >, measure<std_vector, fill_vector<std_vector> > };
+  Row m = { payload, "map", measure<ft_map, fill_map<ft_map> >, measure<std_map, fill_map<std_map> > };
+  Row s = { payload, "set", measure<ft_set, fill_set<ft_set> >, measure<std_set, fill_set<std_set> > };
+  rows.push_back(v);
+  rows.push_back(m);
+  rows.push_back(s);
+}
+
+/* ---------------------------------------------------------------- main */
+
+static double per(std::size_t bytes, unsigned long n) { return static_cast<double>(bytes) / n; }
+
+int main(int argc, char** argv) {
+  double max_n = 1e6;
+  const char* only_payload = 0;
+  const char* only_container = 0;
+  double limit_mib = static_cast<double>(sysconf(_SC_PHYS_PAGES)) * sysconf(_SC_PAGESIZE) / 2 / (1 << 20);
+  for (int i = 1 ; i < argc ; i++) {
+    if (i + 1 < argc && std::strcmp(argv[i], "--max") == 0)
+      max_n = std::atof(argv[++i]);
+    else if (i + 1 < argc && std::strcmp(argv[i], "--payload") == 0)
+      only_payload = argv[++i];
+    else if (i + 1 < argc && std::strcmp(argv[i], "--container") == 0)
+      only_container = argv[++i];
+    else if (i + 1 < argc && std::strcmp(argv[i], "--mem-limit") == 0)
+      limit_mib = std::atof(argv[++i]);
+    else {
+      std::fprintf(stderr, "usage: bench_memory [--max n] [--payload int|string|struct] [--container vector|map|set] [--mem-limit MiB]\n");
+      return 2;
+    }
+  }
+
+  std::vector<Row> rows;
+  add_rows<int>(rows, "int");
+  add_rows<std::string>(rows, "string");
+  add_rows<record>(rows, "struct");
+
+  std::printf("bytes per element (measured = malloc blocks + container object; usage = ft memory_usage() breakdown)\n");
+  std::printf("%-7s %-7s %10s %10s %10s %7s | %9s %9s %9s %9s %9s\n",
+              "payload", "kind", "n", "ft", "std", "ft/std", "usage", "payload", "overhead", "slack", "alloc");
+  for (std::size_t r = 0 ; r < rows.size() ; r++) {
+    const Row& row = rows[r];
+    if ((only_payload && std::strcmp(only_payload, row.payload)) || (only_container && std::strcmp(only_container, row.container)))
+      continue;
+    double last_per = 0;
+    for (double dn = 1 ; dn <= max_n ; dn *= 10) {
+      unsigned long n = static_cast<unsigned long>(dn);
+      double need_mib = last_per * n * 1.1 / (1 << 20);
+      if (need_mib > limit_mib) {
+        std::printf("%-7s %-7s %10lu  skipped: needs about %.0f MiB (--mem-limit %.0f)\n", row.payload, row.container, n, need_mib, limit_mib);
+        break;
+      }
+      ft::memory_footprint u;
+      ft::memory_footprint unused;
+      long ft_bytes = row.ft_fn(n, &u);
+      long std_bytes = row.std_fn(n, &unused);
+      double ft_per = per(ft_bytes, n);
+      double std_per = per(std_bytes, n);
+      last_per = ft_per > std_per ? ft_per : std_per;
+      std::printf("%-7s %-7s %10lu %10.2f %10.2f %7.2f | %9.2f %9.2f %9.2f %9.2f %9.2f\n",
+                  row.payload, row.container, n, ft_per, std_per, std_per > 0 ? ft_per / std_per : 0,
+                  per(u.total(), n), per(u.payload, n), per(u.overhead, n), per(u.slack, n), per(u.allocator, n));
+      std::fflush(stdout);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,206 @@
+#ifndef BENCH_PERF_HPP
+# define BENCH_PERF_HPP
+
+# include <cerrno>
+# include <cstdio>
+# include <cstring>
+# include <string>
+# include <unistd.h>
+# ifdef __linux__
+#  include <linux/perf_event.h>
+#  include <sys/ioctl.h>
+#  include <sys/syscall.h>
+# endif
+
+/* perf_event_open 으로 여는 hardware counter 묶음
+ *
+ * cycles, instructions, L1D read miss, LLC miss, branch miss, dTLB read miss 를 user 영역만 센다.
+ * 각 counter 는 따로 열어서 하나가 안 되어도 나머지는 쓴다. (VM 에선 cache / TLB event 가 없는 경우가 많다)
+ * counter 수가 PMU 보다 많으면 kernel 이 돌아가며 세므로 enabled / running 시간 비율로 값을 늘려 보정한다.
+ *
+ * 하나도 열리지 않으면 (linux 가 아님, container 안이라 권한 없음, perf_event_paranoid 가 높음) available() 이 false 이고
+ * reason() 이 이유를 알려준다. 이때 enable / disable / read 는 아무것도 하지 않는다.
+ */
+
+namespace bench {
+
+enum perf_event_id {
+  perf_cycles,
+  perf_instructions,
+  perf_l1d_miss,
+  perf_llc_miss,
+  perf_branch_miss,
+  perf_dtlb_miss,
+  perf_event_count
+};
+
+inline const char*	perf_event_name(int id) {
+  static const char* names[perf_event_count] = { "cycles", "instructions", "l1d_miss", "llc_miss", "branch_miss", "dtlb_miss" };
+  return names[id];
+}
+
+/* 값이 없는 counter 는 -1 */
+struct perf_values {
+  double v[perf_event_count];
+  explicit perf_values(double init = -1) { for (int i = 0 ; i < perf_event_count ; i++) v[i] = init; }
+};
+
+class perf_counters {
+ public:
+  perf_counters(void) : _open(0) {
+    for (int i = 0 ; i < perf_event_count ; i++)
+      _fd[i] = -1;
+# ifdef __linux__
+    int err = 0;
+    for (int i = 0 ; i < perf_event_count ; i++) {
+      _fd[i] = open_event(i);
+      if (_fd[i] >= 0)
+        _open++;
+      else if (!err)
+        err = errno;
+    }
+    if (_open == 0)
+      _reason = explain(err);
+# else
+    _reason = "perf_event_open is linux only";
+# endif
+  }
+  ~perf_counters(void) {
+    for (int i = 0 ; i < perf_event_count ; i++)
+      if (_fd[i] >= 0)
+        close(_fd[i]);
+  }
+
+  bool available(void) const { return _open > 0; }
+  const std::string& reason(void) const { return _reason; }
+  bool has(int id) const { return _fd[id] >= 0; }
+
+  void reset(void) { each(0); }
+  void enable(void) { each(1); }
+  void disable(void) { each(2); }
+
+  perf_values read_values(void) const {
+    perf_values out;
+    for (int i = 0 ; i < perf_event_count ; i++) {
+      unsigned long long buf[3];  /* value, time_enabled, time_running */
+      if (_fd[i] < 0 || ::read(_fd[i], buf, sizeof(buf)) != static_cast<ssize_t>(sizeof(buf)))
+        continue;
+      if (buf[2] == 0)
+        out.v[i] = buf[1] == 0 ? 0 : -1;
+      else
+        out.v[i] = static_cast<double>(buf[0]) * buf[1] / buf[2];
+    }
+    return out;
+  }
+
+ private:
+  int _fd[perf_event_count];
+  int _open;
+  std::string _reason;
+
+  perf_counters(const perf_counters&);
+  perf_counters& operator=(const perf_counters&);
+
+  /* 0 : reset, 1 : enable, 2 : disable */
+  void each(int what) {
+# ifdef __linux__
+    static const unsigned long requests[3] = { PERF_EVENT_IOC_RESET, PERF_EVENT_IOC_ENABLE, PERF_EVENT_IOC_DISABLE };
+    for (int i = 0 ; i < perf_event_count ; i++)
+      if (_fd[i] >= 0)
+        ioctl(_fd[i], requests[what], 0);
+# else
+    (void)what;
+# endif
+  }
+
+# ifdef __linux__
+  static unsigned long long cache_config(unsigned long long cache, unsigned long long result) {
+    return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (result << 16);
+  }
+
+  static int open_event(int id) {
+    struct perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    switch (id) {
+      case perf_cycles:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CPU_CYCLES;
+        break;
+      case perf_instructions:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+        break;
+      case perf_l1d_miss:
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = cache_config(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_RESULT_MISS);
+        break;
+      case perf_llc_miss:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        break;
+      case perf_branch_miss:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+        break;
+      default:
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = cache_config(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_RESULT_MISS);
+        break;
+    }
+    return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+  }
+
+  static std::string explain(int err) {
+    std::string msg = std::strerror(err);
+    if (err == EACCES || err == EPERM) {
+      std::FILE* in = std::fopen("/proc/sys/kernel/perf_event_paranoid", "r");
+      int level;
+      if (in && std::fscanf(in, "%d", &level) == 1) {
+        char buf[96];
+        std::snprintf(buf, sizeof(buf), " (perf_event_paranoid = %d, needs <= 2 or CAP_PERFMON)", level);
+        msg += buf;
+      }
+      if (in)
+        std::fclose(in);
+    } else if (err == ENOENT || err == ENODEV || err == EOPNOTSUPP) {
+      msg += " (no hardware PMU, e.g. inside a VM or container)";
+    }
+    return msg;
+  }
+# endif
+};
+
+/* before 와 after 의 차이를 n 으로 나눈 값. 없는 counter 는 -1 그대로 */
+inline perf_values	perf_per_item(const perf_values& before, const perf_values& after, double n) {
+  perf_values out;
+  for (int i = 0 ; i < perf_event_count ; i++)
+    if (before.v[i] >= 0 && after.v[i] >= 0 && n > 0)
+      out.v[i] = (after.v[i] - before.v[i]) / n;
+  return out;
+}
+
+/* "cycles 12.3  instructions 20.1  IPC 1.63 ..." 없는 counter 는 빼고 */
+inline std::string	perf_format(const perf_values& p) {
+  std::string out;
+  char buf[64];
+  for (int i = 0 ; i < perf_event_count ; i++) {
+    if (p.v[i] < 0)
+      continue;
+    std::snprintf(buf, sizeof(buf), "%s%s %.3g", out.empty() ? "" : "  ", perf_event_name(i), p.v[i]);
+    out += buf;
+    if (i == perf_instructions && p.v[perf_cycles] > 0) {
+      std::snprintf(buf, sizeof(buf), "  IPC %.2f", p.v[perf_instructions] / p.v[perf_cycles]);
+      out += buf;
+    }
+  }
+  return out.empty() ? "-" : out;
+}
+
+}
+
+#endif
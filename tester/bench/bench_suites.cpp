@@ -0,0 +1,416 @@
+#include <map>
+#include <set>
+#include <stack>
+#include <vector>
+#include "../../vector.hpp"
+#include "../../map.hpp"
+#include "../../set.hpp"
+#include "../../stack.hpp"
+#include "../../frozen_set.hpp"
+#include "../../frozen_map.hpp"
+#include "./bench_harness.hpp"
+
+/* vector / map / set / stack 의 주요 연산을 ft 와 std 로 한 쌍씩 잰다.
+ * frozen/ 은 frozen_set / frozen_map 의 조회를 std::set / std::map 과 잰다.
+ * 결과는 모두 item (원소 하나 또는 연산 하나) 당 ns 다.
+ *
+ * ./bench_suites --filter map/ --samples 31 --cpu 2 --json map.json
+ */
+
+static const unsigned long N = 1 << 14;   /* 크기가 정해진 준비 container 의 원소 수 */
+
+/* 모든 benchmark 가 같은 순서로 쓰는 random key. N 개는 서로 다르다. */
+static const std::vector<int>&	keys(void) {
+  static std::vector<int> k;
+  if (k.empty()) {
+    bench::Rng rng;
+    std::set<int> seen;
+    while (k.size() < N) {
+      int v = static_cast<int>(rng.next() >> 33);
+      if (seen.insert(v).second)
+        k.push_back(v);
+    }
+  }
+  return k;
+}
+
+/* ----------------------------------------------------------------- vector */
+
+/* 크기가 반복 횟수를 따라 커지면 page fault 가 결과를 흔드므로 N 개씩 새 vector 에 넣는다. */
+template <class Vector>
+void	vector_push_back(bench::state& st) {
+  for (unsigned long r = 0 ; r < st.iterations() ; r++) {
+    Vector v;
+    for (unsigned long i = 0 ; i < N ; i++)
+      v.push_back(static_cast<int>(i));
+    bench::keep(v.back());
+  }
+  st.set_items(st.iterations() * N);
+}
+
+template <class Vector>
+void	vector_push_back_reserved(bench::state& st) {
+  for (unsigned long r = 0 ; r < st.iterations() ; r++) {
+    Vector v;
+    v.reserve(N);
+    for (unsigned long i = 0 ; i < N ; i++)
+      v.push_back(static_cast<int>(i));
+    bench::keep(v.back());
+  }
+  st.set_items(st.iterations() * N);
+}
+
+template <class Vector>
+void	vector_iterate(bench::state& st) {
+  Vector v(N, 1);
+  long sum = 0;
+  st.start();
+  for (unsigned long r = 0 ; r < st.iterations() ; r++)
+    for (typename Vector::const_iterator it = v.begin() ; it != v.end() ; ++it)
+      sum += *it;
+  st.stop();
+  st.set_items(st.iterations() * N);
+  bench::keep(sum);
+}
+
+template <class Vector>
+void	vector_random_access(bench::state& st) {
+  const std::vector<int>& k = keys();
+  Vector v(N, 1);
+  long sum = 0;
+  st.start();
+  for (unsigned long i = 0 ; i < st.iterations() ; i++)
+    sum += v[k[i % N] % N];
+  st.stop();
+  bench::keep(sum);
+}
+
+template <class Vector>
+void	vector_insert_middle(bench::state& st) {
+  Vector v(1024, 0);
+  for (unsigned long i = 0 ; i < st.iterations() ; i++) {
+    v.insert(v.begin() + v.size() / 2, static_cast<int>(i));
+    v.pop_back();
+  }
+  bench::keep(v.front());
+}
+
+template <class Vector>
+void	vector_copy(bench::state& st) {
+  Vector v(N, 1);
+  st.start();
+  for (unsigned long i = 0 ; i < st.iterations() ; i++) {
+    Vector c(v);
+    bench::keep(c.back());
+  }
+  st.stop();
+  st.set_items(st.iterations() * N);
+}
+
+template <class Vector>
+void	vector_clear_refill(bench::state& st) {
+  Vector v(N, 0);
+  st.start();
+  for (unsigned long r = 0 ; r < st.iterations() ; r++) {
+    v.clear();
+    for (unsigned long i = 0 ; i < N ; i++)
+      v.push_back(static_cast<int>(i));
+  }
+  st.stop();
+  st.set_items(st.iterations() * N);
+  bench::keep(v.back());
+}
+
+/* -------------------------------------------------------------------- map */
+
+template <class Map>
+void	map_insert_random(bench::state& st) {
+  const std::vector<int>& k = keys();
+  st.start();
+  for (unsigned long r = 0 ; r < st.iterations() ; r++) {
+    Map m;
+    for (unsigned long i = 0 ; i < N ; i++)
+      m.insert(typename Map::value_type(k[i], true));
+    bench::keep(m.size());
+  }
+  st.stop();
+  st.set_items(st.iterations() * N);
+}
+
+template <class Map>
+void	map_insert_sorted(bench::state& st) {
+  st.start();
+  for (unsigned long r = 0 ; r < st.iterations() ; r++) {
+    Map m;
+    for (unsigned long i = 0 ; i < N ; i++)
+      m[static_cast<int>(i)] = true;
+    bench::keep(m.size());
+  }
+  st.stop();
+  st.set_items(st.iterations() * N);
+}
+
+template <class Map>
+void	map_find_hit(bench::state& st) {
+  const std::vector<int>& k = keys();
+  Map m;
+  for (unsigned long i = 0 ; i < N ; i++)
+    m[k[i]] = true;
+  unsigned long found = 0;
+  st.start();
+  for (unsigned long i = 0 ; i < st.iterations() ; i++)
+    found += m.find(k[(i * 7919) % N]) != m.end();
+  st.stop();
+  bench::keep(found);
+}
+
+template <class Map>
+void	map_find_miss(bench::state& st) {
+  const std::vector<int>& k = keys();
+  Map m;
+  for (unsigned long i = 0 ; i < N ; i++)
+    m[k[i] | 1] = true;
+  unsigned long found = 0;
+  st.start();
+  for (unsigned long i = 0 ; i < st.iterations() ; i++)
+    found += m.find(k[(i * 7919) % N] & ~1) != m.end();
+  st.stop();
+  bench::keep(found);
+}
+
+template <class Map>
+void	map_erase(bench::state& st) {
+  const std::vector<int>& k = keys();
+  for (unsigned long r = 0 ; r < st.iterations() ; r++) {
+    Map m;
+    for (unsigned long i = 0 ; i < N ; i++)
+      m[k[i]] = true;
+    st.start();
+    for (unsigned long i = 0 ; i < N ; i++)
+      m.erase(k[(i * 7919) % N]);
+    st.stop();
+    bench::keep(m.size());
+  }
+  st.set_items(st.iterations() * N);
+}
+
+template <class Map>
+void	map_iterate(bench::state& st) {
+  const std::vector<int>& k = keys();
+  Map m;
+  for (unsigned long i = 0 ; i < N ; i++)
+    m[k[i]] = true;
+  long sum = 0;
+  st.start();
+  for (unsigned long r = 0 ; r < st.iterations() ; r++)
+    for (typename Map::const_iterator it = m.begin() ; it != m.end() ; ++it)
+      sum += it->first;
+  st.stop();
+  st.set_items(st.iterations() * N);
+  bench::keep(sum);
+}
+
+/* -------------------------------------------------------------------- set */
+
+template <class Set>
+void	set_insert_random(bench::state& st) {
+  const std::vector<int>& k = keys();
+  st.start();
+  for (unsigned long r = 0 ; r < st.iterations() ; r++) {
+    Set s;
+    for (unsigned long i = 0 ; i < N ; i++)
+      s.insert(k[i]);
+    bench::keep(s.size());
+  }
+  st.stop();
+  st.set_items(st.iterations() * N);
+}
+
+template <class Set>
+void	set_find_hit(bench::state& st) {
+  const std::vector<int>& k = keys();
+  Set s(k.begin(), k.end());
+  unsigned long found = 0;
+  st.start();
+  for (unsigned long i = 0 ; i < st.iterations() ; i++)
+    found += s.find(k[(i * 7919) % N]) != s.end();
+  st.stop();
+  bench::keep(found);
+}
+
+template <class Set>
+void	set_lower_bound(bench::state& st) {
+  const std::vector<int>& k = keys();
+  Set s(k.begin(), k.end());
+  long sum = 0;
+  st.start();
+  for (unsigned long i = 0 ; i < st.iterations() ; i++) {
+    typename Set::const_iterator it = s.lower_bound(k[(i * 7919) % N] + 1);
+    if (it != s.end())
+      sum += *it;
+  }
+  st.stop();
+  bench::keep(sum);
+}
+
+template <class Set>
+void	set_erase(bench::state& st) {
+  const std::vector<int>& k = keys();
+  for (unsigned long r = 0 ; r < st.iterations() ; r++) {
+    Set s(k.begin(), k.end());
+    st.start();
+    for (unsigned long i = 0 ; i < N ; i++)
+      s.erase(k[(i * 7919) % N]);
+    st.stop();
+    bench::keep(s.size());
+  }
+  st.set_items(st.iterations() * N);
+}
+
+template <class Set>
+void	set_iterate(bench::state& st) {
+  const std::vector<int>& k = keys();
+  Set s(k.begin(), k.end());
+  long sum = 0;
+  st.start();
+  for (unsigned long r = 0 ; r < st.iterations() ; r++)
+    for (typename Set::const_iterator it = s.begin() ; it != s.end() ; ++it)
+      sum += *it;
+  st.stop();
+  st.set_items(st.iterations() * N);
+  bench::keep(sum);
+}
+
+/* ----------------------------------------------------------------- frozen */
+
+/* frozen 은 정렬되고 중복 없는 입력만 받으므로 std::set 으로 한 번 정렬한 key 로 만든다. */
+static const std::vector<int>&	sorted_keys(void) {
+  static std::vector<int> k;
+  if (k.empty()) {
+    std::set<int> s(keys().begin(), keys().end());
+    k.assign(s.begin(), s.end());
+  }
+  return k;
+}
+
+template <class Set>
+void	frozen_set_find_hit(bench::state& st) {
+  const std::vector<int>& k = keys();
+  Set s(sorted_keys().begin(), sorted_keys().end());
+  unsigned long found = 0;
+  st.start();
+  for (unsigned long i = 0 ; i < st.iterations() ; i++)
+    found += s.find(k[(i * 7919) % N]) != s.end();
+  st.stop();
+  bench::keep(found);
+}
+
+template <class Set>
+void	frozen_set_lower_bound(bench::state& st) {
+  const std::vector<int>& k = keys();
+  Set s(sorted_keys().begin(), sorted_keys().end());
+  long sum = 0;
+  st.start();
+  for (unsigned long i = 0 ; i < st.iterations() ; i++) {
+    typename Set::const_iterator it = s.lower_bound(k[(i * 7919) % N] + 1);
+    if (it != s.end())
+      sum += *it;
+  }
+  st.stop();
+  bench::keep(sum);
+}
+
+template <class Map>
+void	frozen_map_find_hit(bench::state& st) {
+  const std::vector<int>& k = keys();
+  const std::vector<int>& sk = sorted_keys();
+  std::vector<typename Map::value_type> v;
+  for (unsigned long i = 0 ; i < N ; i++)
+    v.push_back(typename Map::value_type(sk[i], true));
+  Map m(v.begin(), v.end());
+  unsigned long found = 0;
+  st.start();
+  for (unsigned long i = 0 ; i < st.iterations() ; i++)
+    found += m.find(k[(i * 7919) % N]) != m.end();
+  st.stop();
+  bench::keep(found);
+}
+
+/* ------------------------------------------------------------------ stack */
+
+template <class Stack>
+void	stack_push_pop(bench::state& st) {
+  Stack s;
+  long sum = 0;
+  for (unsigned long r = 0 ; r < st.iterations() ; r++) {
+    for (unsigned long i = 0 ; i < 64 ; i++)
+      s.push(static_cast<int>(i));
+    while (!s.empty()) {
+      sum += s.top();
+      s.pop();
+    }
+  }
+  st.set_items(st.iterations() * 64);
+  bench::keep(sum);
+}
+
+template <class Stack>
+void	stack_push_grow(bench::state& st) {
+  for (unsigned long r = 0 ; r < st.iterations() ; r++) {
+    Stack s;
+    for (unsigned long i = 0 ; i < N ; i++)
+      s.push(static_cast<int>(i));
+    bench::keep(s.top());
+  }
+  st.set_items(st.iterations() * N);
+}
+
+/* ----------------------------------------------------------------------- */
+
+typedef ft::vector<int>								ft_vector;
+typedef std::vector<int>							std_vector;
+typedef ft::map<int, bool>							ft_map;
+typedef std::map<int, bool>							std_map;
+typedef ft::set<int>								ft_set;
+typedef std::set<int>								std_set;
+typedef ft::frozen_set<int>							ft_frozen_set;
+typedef ft::frozen_set<int, std::less<int>, std::allocator<int>, ft::veb_layout>	ft_frozen_set_veb;
+typedef ft::frozen_map<int, bool>					ft_frozen_map;
+typedef ft::frozen_map<int, bool, std::less<int>, std::allocator<ft::pair<const int, bool> >, ft::veb_layout>	ft_frozen_map_veb;
+typedef ft::stack<int>								ft_stack;
+typedef std::stack<int, std::vector<int> >			std_stack;
+
+int main(int argc, char** argv) {
+  bench::add("vector/push_back", vector_push_back<ft_vector>, vector_push_back<std_vector>);
+  bench::add("vector/push_back_reserved", vector_push_back_reserved<ft_vector>, vector_push_back_reserved<std_vector>);
+  bench::add("vector/iterate", vector_iterate<ft_vector>, vector_iterate<std_vector>);
+  bench::add("vector/random_access", vector_random_access<ft_vector>, vector_random_access<std_vector>);
+  bench::add("vector/insert_middle", vector_insert_middle<ft_vector>, vector_insert_middle<std_vector>);
+  bench::add("vector/copy", vector_copy<ft_vector>, vector_copy<std_vector>);
+  bench::add("vector/clear_refill", vector_clear_refill<ft_vector>, vector_clear_refill<std_vector>);
+
+  bench::add("map/insert_random", map_insert_random<ft_map>, map_insert_random<std_map>);
+  bench::add("map/insert_sorted", map_insert_sorted<ft_map>, map_insert_sorted<std_map>);
+  bench::add("map/find_hit", map_find_hit<ft_map>, map_find_hit<std_map>);
+  bench::add("map/find_miss", map_find_miss<ft_map>, map_find_miss<std_map>);
+  bench::add("map/erase", map_erase<ft_map>, map_erase<std_map>);
+  bench::add("map/iterate", map_iterate<ft_map>, map_iterate<std_map>);
+
+  bench::add("set/insert_random", set_insert_random<ft_set>, set_insert_random<std_set>);
+  bench::add("set/find_hit", set_find_hit<ft_set>, set_find_hit<std_set>);
+  bench::add("set/lower_bound", set_lower_bound<ft_set>, set_lower_bound<std_set>);
+  bench::add("set/erase", set_erase<ft_set>, set_erase<std_set>);
+  bench::add("set/iterate", set_iterate<ft_set>, set_iterate<std_set>);
+
+  bench::add("frozen/set_find_hit", frozen_set_find_hit<ft_frozen_set>, frozen_set_find_hit<std_set>);
+  bench::add("frozen/set_find_hit_veb", frozen_set_find_hit<ft_frozen_set_veb>, frozen_set_find_hit<std_set>);
+  bench::add("frozen/set_lower_bound", frozen_set_lower_bound<ft_frozen_set>, frozen_set_lower_bound<std_set>);
+  bench::add("frozen/set_lower_bound_veb", frozen_set_lower_bound<ft_frozen_set_veb>, frozen_set_lower_bound<std_set>);
+  bench::add("frozen/map_find_hit", frozen_map_find_hit<ft_frozen_map>, frozen_map_find_hit<std_map>);
+  bench::add("frozen/map_find_hit_veb", frozen_map_find_hit<ft_frozen_map_veb>, frozen_map_find_hit<std_map>);
+
+  bench::add("stack/push_pop", stack_push_pop<ft_stack>, stack_push_pop<std_stack>);
+  bench::add("stack/push_grow", stack_push_grow<ft_stack>, stack_push_grow<std_stack>);
+
+  return bench::run_all(argc, argv);
+}
@@ -0,0 +1,385 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <set>
+#include <stack>
+#include <string>
+#include <vector>
+#include "../../vector.hpp"
+#include "../../map.hpp"
+#include "../../set.hpp"
+#include "../../stack.hpp"
+#include "../../utils/trace.hpp"
+#include "./bench_harness.hpp"
+
+/* utils/trace.hpp 형식의 binary trace 를 mmap 해서 container 에 그대로 다시 돌린다.
+ * 입력 해석도 출력도 없이 연산만 재고, 결과는 checksum 하나로 모아 ft 와 std 가 같은 일을 했는지 확인한다.
+ *
+ * trace_replay info <trace>
+ * trace_replay gen  <map|set|vector|stack> <n> <out> [seed]      test3 와 같은 모양의 합성 trace
+ * trace_replay run  <trace> <map|set|vector|stack> [--impl ft|std|both] [--stream n] [--repeat r] [--perf]
+ *
+ * key 는 long, map 의 value 는 int 로 돌린다. stack 은 vector stream 의 push / pop 을 그대로 받는다.
+ * --stream 이 없으면 이름이 kind 와 맞는 stream (ft::map<...>, generated map, ...) 하나만 돌린다.
+ * 맞는 stream 이 여럿이거나 없으면 (stream 이 하나뿐인 trace 는 빼고) 다른 container 의 연산을 섞지 않도록 --stream 을 요구한다.
+ * --perf 면 replay loop 의 hardware counter 를 연산 하나당 값으로 함께 보여준다. (bench_perf.hpp)
+ */
+
+/* 연산 하나의 결과를 checksum 에 섞는다. */
+static inline unsigned long long	mix(unsigned long long h, unsigned long long x) {
+  return (h ^ x) * 0x100000001b3ull;
+}
+
+/* ------------------------------------------------------------ replayers */
+
+template <class Map>
+struct MapReplay {
+  Map c;
+  unsigned long long apply(const ft::trace_record& r) {
+    long key = static_cast<long>(r.key);
+    switch (r.op) {
+      case ft::trace_insert:
+        return c.insert(typename Map::value_type(key, r.value)).second;
+      case ft::trace_erase:
+        return c.erase(key);
+      case ft::trace_find: {
+        typename Map::iterator it = c.find(key);
+        return it == c.end() ? 0 : static_cast<unsigned long long>(it->second) + 1;
+      }
+      case ft::trace_lower_bound: {
+        typename Map::iterator it = c.lower_bound(key);
+        return it == c.end() ? 0 : static_cast<unsigned long long>(it->first);
+      }
+      case ft::trace_clear:
+        c.clear();
+        return 0;
+    }
+    return c.size();
+  }
+};
+
+template <class Set>
+struct SetReplay {
+  Set c;
+  unsigned long long apply(const ft::trace_record& r) {
+    long key = static_cast<long>(r.key);
+    switch (r.op) {
+      case ft::trace_insert:
+        return c.insert(key).second;
+      case ft::trace_erase:
+        return c.erase(key);
+      case ft::trace_find:
+        return c.find(key) != c.end();
+      case ft::trace_lower_bound: {
+        typename Set::iterator it = c.lower_bound(key);
+        return it == c.end() ? 0 : static_cast<unsigned long long>(*it);
+      }
+      case ft::trace_clear:
+        c.clear();
+        return 0;
+    }
+    return c.size();
+  }
+};
+
+/* find 는 key 를 index 로 읽는다. */
+template <class Vector>
+struct VectorReplay {
+  Vector c;
+  unsigned long long apply(const ft::trace_record& r) {
+    switch (r.op) {
+      case ft::trace_insert:
+      case ft::trace_push:
+        c.push_back(static_cast<long>(r.key));
+        return c.size();
+      case ft::trace_erase:
+      case ft::trace_pop:
+        if (c.empty())
+          return 0;
+        c.pop_back();
+        return c.size();
+      case ft::trace_find:
+      case ft::trace_lower_bound:
+        return c.empty() ? 0 : static_cast<unsigned long long>(c[static_cast<unsigned long>(r.key) % c.size()]);
+      case ft::trace_clear:
+        c.clear();
+        return 0;
+    }
+    return c.size();
+  }
+};
+
+/* pop 은 꺼내기 전에 top 을 checksum 에 넣는다. */
+template <class Stack>
+struct StackReplay {
+  Stack c;
+  unsigned long long apply(const ft::trace_record& r) {
+    switch (r.op) {
+      case ft::trace_insert:
+      case ft::trace_push:
+        c.push(static_cast<long>(r.key));
+        return c.size();
+      case ft::trace_erase:
+      case ft::trace_pop: {
+        if (c.empty())
+          return 0;
+        unsigned long long top = static_cast<unsigned long long>(c.top());
+        c.pop();
+        return top;
+      }
+      case ft::trace_find:
+      case ft::trace_lower_bound:
+        return c.empty() ? 0 : static_cast<unsigned long long>(c.top());
+      case ft::trace_clear:
+        while (!c.empty())
+          c.pop();
+        return 0;
+    }
+    return c.size();
+  }
+};
+
+/* --------------------------------------------------------------- driver */
+
+struct Run {
+  std::vector<double> ns_per_op;
+  bench::Summary perf;
+  unsigned long long checksum;
+};
+
+template <class Replay>
+void	replay_once(const ft::trace_record* rec, std::size_t n, Run& run) {
+  bench::perf_counters* pc = bench::perf_session();
+  Replay* r = new Replay;
+  unsigned long long h = 0xcbf29ce484222325ull;
+  if (pc) {
+    pc->reset();
+    pc->enable();
+  }
+  unsigned long long t0 = bench::now_ns();
+  for (std::size_t i = 0 ; i < n ; i++)
+    h = mix(h, r->apply(rec[i]));
+  unsigned long long t = bench::now_ns() - t0;
+  if (pc) {
+    pc->disable();
+    run.perf.perf_samples.push_back(bench::perf_per_item(bench::perf_values(0), pc->read_values(), static_cast<double>(n)));
+  }
+  delete r;
+  run.ns_per_op.push_back(n ? static_cast<double>(t) / n : 0.0);
+  run.checksum = h;
+}
+
+static void	report(const char* impl, Run& run, std::size_t ops) {
+  std::vector<double> v(run.ns_per_op);
+  std::printf("%-4s %10lu ops   median %8.2f ns/op   min %8.2f ns/op   checksum %016llx\n",
+              impl, static_cast<unsigned long>(ops), bench::median_of(v),
+              *std::min_element(v.begin(), v.end()), run.checksum);
+  if (!run.perf.perf_samples.empty()) {
+    run.perf.samples = run.ns_per_op;
+    bench::summarize(run.perf);
+    std::printf("     per op: %s\n", bench::perf_format(run.perf.perf).c_str());
+  }
+}
+
+template <class FtReplay, class StdReplay>
+int	replay(const ft::trace_record* rec, std::size_t n, const std::string& impl, unsigned int repeat) {
+  Run ft_run;
+  Run std_run;
+  bool run_ft = impl != "std";
+  bool run_std = impl != "ft";
+  for (unsigned int i = 0 ; i < repeat ; i++) {
+    /* 둘 다 돌리면 순서를 번갈아 바꾼다. */
+    if (run_ft && i % 2 == 0)
+      replay_once<FtReplay>(rec, n, ft_run);
+    if (run_std)
+      replay_once<StdReplay>(rec, n, std_run);
+    if (run_ft && i % 2 == 1)
+      replay_once<FtReplay>(rec, n, ft_run);
+  }
+  if (run_ft)
+    report("ft", ft_run, n);
+  if (run_std)
+    report("std", std_run, n);
+  if (run_ft && run_std) {
+    double ratio = bench::median_of(ft_run.ns_per_op) / bench::median_of(std_run.ns_per_op);
+    std::printf("ft/std %.2fx\n", ratio);
+    if (ft_run.checksum != std_run.checksum) {
+      std::printf("\033[1;31mchecksum mismatch: ft and std gave different results\033[0m\n");
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static int	usage(void) {
+  std::fprintf(stderr,
+               "usage: trace_replay info <trace>\n"
+               "       trace_replay gen <map|set|vector|stack> <n> <out> [seed]\n"
+               "       trace_replay run <trace> <map|set|vector|stack> [--impl ft|std|both] [--stream n] [--repeat r] [--perf]\n");
+  return 2;
+}
+
+static int	info(const char* path) {
+  ft::snapshot_file file(path);
+  ft::trace_reader reader(file.data(), file.size());
+  std::vector<std::vector<unsigned long> > ops(reader.stream_count() + 1, std::vector<unsigned long>(ft::trace_clear + 1, 0));
+  for (std::size_t i = 0 ; i < reader.size() ; i++) {
+    const ft::trace_record& r = reader.records()[i];
+    std::size_t s = r.stream < reader.stream_count() ? r.stream : reader.stream_count();
+    ops[s][r.op <= ft::trace_clear ? r.op : 0]++;
+  }
+  static const char* names[] = { "other", "insert", "erase", "find", "lower_bound", "push", "pop", "clear" };
+  std::printf("%lu records, %lu streams\n", static_cast<unsigned long>(reader.size()), static_cast<unsigned long>(reader.stream_count()));
+  for (std::size_t s = 0 ; s < reader.stream_count() ; s++) {
+    std::printf("stream %lu: %s\n ", static_cast<unsigned long>(s), reader.stream_name(s).c_str());
+    for (int op = 0 ; op <= ft::trace_clear ; op++)
+      if (ops[s][op])
+        std::printf(" %s %lu", names[op], ops[s][op]);
+    std::printf("\n");
+  }
+  return 0;
+}
+
+/* test3 의 generate_input_*.py 와 같은 모양: 증가하는 key 로 n 번 넣고 n/5 번씩 지우고 찾는다. */
+static int	gen(const std::string& kind, unsigned long n, const char* out, unsigned long long seed) {
+  bench::Rng rng(seed);
+  ft::trace_writer* w = new ft::trace_writer(out);
+  uint16_t stream = w->add_stream(("generated " + kind).c_str());
+  long acc = 0;
+  if (kind == "map" || kind == "set") {
+    for (unsigned long i = 0 ; i < n ; i++) {
+      acc += static_cast<long>(rng.next() % 11);
+      w->append(ft::trace_insert, stream, acc, kind == "map" ? static_cast<int32_t>(rng.next() % 85) - 42 : 0);
+    }
+    for (unsigned long i = 0 ; i < n / 5 ; i++)
+      w->append(ft::trace_erase, stream, static_cast<long>(rng.next() % (acc + 1)), 0);
+    for (unsigned long i = 0 ; i < n / 5 ; i++)
+      w->append(ft::trace_find, stream, static_cast<long>(rng.next() % (acc + 1)), 0);
+    for (unsigned long i = 0 ; i < n / 5 ; i++)
+      w->append(ft::trace_lower_bound, stream, static_cast<long>(rng.next() % (acc + 1)), 0);
+  } else if (kind == "vector" || kind == "stack") {
+    for (unsigned long i = 0 ; i < n ; i++)
+      w->append(ft::trace_push, stream, static_cast<long>(rng.next() >> 33), 0);
+    for (unsigned long i = 0 ; i < n / 5 ; i++)
+      w->append(ft::trace_find, stream, static_cast<long>(rng.next() >> 33), 0);
+    for (unsigned long i = 0 ; i < n ; i++)
+      w->append(ft::trace_pop, stream, 0, 0);
+  } else {
+    delete w;
+    return usage();
+  }
+  w->close();
+  std::printf("%lu records -> %s\n", static_cast<unsigned long>(w->count()), out);
+  delete w;
+  return 0;
+}
+
+/* "ft::map<long, int, ...>", "std::set<...>", "generated vector" 처럼 template 이름이나 gen 의 이름이 kind 인 stream */
+static bool	stream_matches(const std::string& name, const std::string& kind) {
+  if (name == "generated " + kind)
+    return true;
+  std::string base = name.substr(0, name.find('<'));
+  std::string::size_type colon = base.rfind("::");
+  if (colon != std::string::npos)
+    base = base.substr(colon + 2);
+  return base == kind || (kind == "stack" && base == "vector");
+}
+
+/* --stream 이 없을 때 돌릴 stream. 고를 수 없으면 stream 목록을 보여주고 -1 */
+static long	default_stream(const ft::trace_reader& reader, const std::string& kind) {
+  long found = -1;
+  std::size_t matches = 0;
+  for (std::size_t s = 0 ; s < reader.stream_count() ; s++)
+    if (stream_matches(reader.stream_name(s), kind)) {
+      found = static_cast<long>(s);
+      matches++;
+    }
+  if (matches == 1)
+    return found;
+  if (matches == 0 && reader.stream_count() <= 1)
+    return 0;
+  std::fprintf(stderr, "trace_replay: %s stream matches %s, pick one with --stream n\n",
+               matches ? "more than one" : "no", kind.c_str());
+  for (std::size_t s = 0 ; s < reader.stream_count() ; s++)
+    std::fprintf(stderr, "  stream %lu: %s\n", static_cast<unsigned long>(s), reader.stream_name(s).c_str());
+  return -1;
+}
+
+static int	run(int argc, char** argv) {
+  const char* path = argv[2];
+  std::string kind = argv[3];
+  std::string impl = "both";
+  long stream = -1;
+  unsigned int repeat = 5;
+  bool perf = false;
+  for (int i = 4 ; i < argc ; i++) {
+    std::string arg = argv[i];
+    if (arg == "--impl" && i + 1 < argc)
+      impl = argv[++i];
+    else if (arg == "--stream" && i + 1 < argc)
+      stream = std::atol(argv[++i]);
+    else if (arg == "--repeat" && i + 1 < argc)
+      repeat = static_cast<unsigned int>(std::atoi(argv[++i]));
+    else if (arg == "--perf")
+      perf = true;
+    else
+      return usage();
+  }
+  if ((impl != "ft" && impl != "std" && impl != "both") || repeat == 0)
+    return usage();
+
+  ft::snapshot_file file(path);
+  ft::trace_reader reader(file.data(), file.size());
+  const ft::trace_record* rec = reader.records();
+  std::size_t n = reader.size();
+  if (stream < 0 && (stream = default_stream(reader, kind)) < 0)
+    return 2;
+  /* 고른 stream 의 record 만 따로 모은다. (재는 loop 에 분기를 넣지 않는다) stream 이 하나뿐인 trace 의 0 번이면 그대로 쓴다. */
+  std::vector<ft::trace_record> picked;
+  if (reader.stream_count() > 1 || stream != 0) {
+    for (std::size_t i = 0 ; i < n ; i++)
+      if (rec[i].stream == stream)
+        picked.push_back(rec[i]);
+    rec = picked.empty() ? 0 : &picked[0];
+    n = picked.size();
+  }
+  bench::perf_counters* counters = perf ? new bench::perf_counters : 0;
+  if (counters && counters->available())
+    bench::perf_session() = counters;
+  else if (counters)
+    std::fprintf(stderr, "warning: perf counters unavailable: %s, timings only\n", counters->reason().c_str());
+  std::printf("\033[1;34m--- replay %s as %s (%u runs) ---\033[0m\n", path, kind.c_str(), repeat);
+  int status = 2;
+  if (kind == "map")
+    status = replay<MapReplay<ft::map<long, int> >, MapReplay<std::map<long, int> > >(rec, n, impl, repeat);
+  else if (kind == "set")
+    status = replay<SetReplay<ft::set<long> >, SetReplay<std::set<long> > >(rec, n, impl, repeat);
+  else if (kind == "vector")
+    status = replay<VectorReplay<ft::vector<long> >, VectorReplay<std::vector<long> > >(rec, n, impl, repeat);
+  else if (kind == "stack")
+    status = replay<StackReplay<ft::stack<long> >, StackReplay<std::stack<long, std::vector<long> > > >(rec, n, impl, repeat);
+  else
+    usage();
+  bench::perf_session() = 0;
+  delete counters;
+  return status;
+}
+
+int main(int argc, char** argv) {
+  if (argc < 3)
+    return usage();
+  std::string cmd = argv[1];
+  try {
+    if (cmd == "info")
+      return info(argv[2]);
+    if (cmd == "gen" && argc >= 5)
+      return gen(argv[2], std::strtoul(argv[3], 0, 10), argv[4], argc > 5 ? std::strtoul(argv[5], 0, 10) : 1);
+    if (cmd == "run" && argc >= 4)
+      return run(argc, argv);
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "trace_replay: %s\n", e.what());
+    return 1;
+  }
+  return usage();
+}
@@ -0,0 +1,95 @@
+#include <cstdio>
+#include <cstdlib>
+#include "../../map.hpp"
+#include "../../concurrent_map.hpp"
+#include "../../utils/sync.hpp"
+#include "./bench_util.hpp"
+
+/* ft::concurrent_map (shard 마다 rwlock) 과 mutex 하나로 감싼 ft::map 의 처리량 비교
+ * read : write 비율을 바꿔가며 1 ~ 32 thread 에서 초당 연산 수(Mops/s)를 출력한다. */
+
+static const int KEYS = 1 << 16;
+static const int OPS_PER_THREAD = 200000;
+
+struct LockedMap {
+  ft::__mutex m;
+  ft::map<int, int> map;
+
+  bool find(int key, int& out) {
+    ft::__lock_guard g(m);
+    ft::map<int, int>::iterator it = map.find(key);
+    if (it == map.end())
+      return false;
+    out = it->second;
+    return true;
+  }
+  void insert_or_assign(int key, int val) {
+    ft::__lock_guard g(m);
+    map[key] = val;
+  }
+  void erase(int key) {
+    ft::__lock_guard g(m);
+    map.erase(key);
+  }
+};
+
+struct ShardedMap {
+  ft::concurrent_map<int, int> map;
+
+  ShardedMap(void) : map(128) {}
+  bool find(int key, int& out) { return map.find(key, out); }
+  void insert_or_assign(int key, int val) { map.insert_or_assign(key, val); }
+  void erase(int key) { map.erase(key); }
+};
+
+template <class Map>
+struct Worker {
+  Map& map;
+  int write_pct;
+  volatile long sink;
+
+  Worker(Map& m, int w) : map(m), write_pct(w), sink(0) {}
+  void run(int id) {
+    Rng rng(id + 1);
+    long hit = 0;
+    for (int i = 0 ; i < OPS_PER_THREAD ; i++) {
+      unsigned int r = rng.next();
+      int key = static_cast<int>(r % KEYS);
+      if (static_cast<int>((r >> 20) % 100) < write_pct) {
+        if (r & 1)
+          map.insert_or_assign(key, i);
+        else
+          map.erase(key);
+      } else {
+        int v;
+        hit += map.find(key, v);
+      }
+    }
+    __sync_fetch_and_add(&sink, hit);
+  }
+};
+
+template <class Map>
+double	measure(int nthreads, int write_pct) {
+  Map map;
+  for (int i = 0 ; i < KEYS ; i += 2)
+    map.insert_or_assign(i, i);
+  Worker<Map> worker(map, write_pct);
+  double sec = run_threads(worker, nthreads);
+  return static_cast<double>(nthreads) * OPS_PER_THREAD / sec / 1e6;
+}
+
+int main(void) {
+  static const int threads[] = { 1, 2, 4, 8, 16, 32 };
+  static const int writes[] = { 10, 50 };
+  printf("\033[1;34m--- CONCURRENT MAP BENCHMARK (Mops/s) ---\033[0m\n");
+  for (int w = 0 ; w < 2 ; w++) {
+    printf("\nwrite %d%%\n%8s %14s %14s %8s\n", writes[w], "threads", "mutex+map", "concurrent", "ratio");
+    for (int t = 0 ; t < 6 ; t++) {
+      double locked = measure<LockedMap>(threads[t], writes[w]);
+      double sharded = measure<ShardedMap>(threads[t], writes[w]);
+      printf("%8d %14.2f %14.2f %7.2fx\n", threads[t], locked, sharded, sharded / locked);
+    }
+  }
+  return 0;
+}
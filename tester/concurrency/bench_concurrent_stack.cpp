@@ -0,0 +1,117 @@
+#include <cstdio>
+#include <cstdlib>
+#include "../../stack.hpp"
+#include "../../concurrent_stack.hpp"
+#include "../../utils/sync.hpp"
+#include "./bench_util.hpp"
+
+/* ft::concurrent_stack (lock-free) 와 mutex 하나로 감싼 ft::stack 의 처리량 비교
+ * 모든 thread 가 같은 stack 에 push / pop 을 번갈아 하는 최악의 경합 상황에서 1 ~ 32 thread 의 초당 연산 수(Mops/s)를 출력한다.
+ * batch 는 BATCH 개씩 push_range / pop_all 로 묶어서 한 번의 CAS(혹은 lock) 에 여러 원소를 옮긴다. */
+
+static const int OPS_PER_THREAD = 200000;
+static const int BATCH = 16;
+
+struct LockedStack {
+  ft::__mutex m;
+  ft::stack<long> stack;
+
+  void push(long val) {
+    ft::__lock_guard g(m);
+    stack.push(val);
+  }
+  bool try_pop(long& out) {
+    ft::__lock_guard g(m);
+    if (stack.empty())
+      return false;
+    out = stack.top();
+    stack.pop();
+    return true;
+  }
+  void push_range(const long* first, const long* last) {
+    ft::__lock_guard g(m);
+    for ( ; first != last ; ++first)
+      stack.push(*first);
+  }
+  long pop_all(void) {
+    ft::__lock_guard g(m);
+    long sum = 0;
+    for ( ; !stack.empty() ; stack.pop())
+      sum += stack.top();
+    return sum;
+  }
+};
+
+struct LockFreeStack {
+  ft::concurrent_stack<long> stack;
+
+  /* pop_all 의 결과를 합만 남기고 버리는 output iterator */
+  struct Summer {
+    long* sum;
+    explicit Summer(long* s) : sum(s) {}
+    Summer& operator*(void) { return *this; }
+    Summer& operator++(void) { return *this; }
+    Summer& operator=(long val) { *sum += val; return *this; }
+  };
+
+  void push(long val) { stack.push(val); }
+  bool try_pop(long& out) { return stack.try_pop(out); }
+  void push_range(const long* first, const long* last) { stack.push_range(first, last); }
+  long pop_all(void) {
+    long sum = 0;
+    stack.pop_all(Summer(&sum));
+    return sum;
+  }
+};
+
+template <class Stack>
+struct Worker {
+  Stack& stack;
+  bool batch;
+  volatile long sink;
+
+  Worker(Stack& s, bool b) : stack(s), batch(b), sink(0) {}
+  void run(int id) {
+    long sum = 0;
+    if (!batch) {
+      for (int i = 0 ; i < OPS_PER_THREAD / 2 ; i++) {
+        stack.push(id + i);
+        long v;
+        if (stack.try_pop(v))
+          sum += v;
+      }
+    } else {
+      long buf[BATCH];
+      for (int i = 0 ; i < OPS_PER_THREAD / 2 ; i += BATCH) {
+        for (int j = 0 ; j < BATCH ; j++)
+          buf[j] = id + i + j;
+        stack.push_range(buf, buf + BATCH);
+        sum += stack.pop_all();
+      }
+    }
+    __sync_fetch_and_add(&sink, sum);
+  }
+};
+
+template <class Stack>
+double	measure(int nthreads, bool batch) {
+  Stack stack;
+  Worker<Stack> worker(stack, batch);
+  double sec = run_threads(worker, nthreads);
+  return static_cast<double>(nthreads) * OPS_PER_THREAD / sec / 1e6;
+}
+
+int main(void) {
+  static const int threads[] = { 1, 2, 4, 8, 16, 32 };
+  static const char* modes[] = { "push / try_pop", "push_range / pop_all (batch 16)" };
+  printf("\033[1;34m--- CONCURRENT STACK BENCHMARK (Mops/s) ---\033[0m\n");
+  for (int b = 0 ; b < 2 ; b++) {
+    printf("\n%s\n%8s %14s %14s %8s\n", modes[b], "threads", "mutex+stack", "lock-free", "ratio");
+    for (int t = 0 ; t < 6 ; t++) {
+      double locked = measure<LockedStack>(threads[t], b == 1);
+      double lockfree = measure<LockFreeStack>(threads[t], b == 1);
+      printf("%8d %14.2f %14.2f %7.2fx\n", threads[t], locked, lockfree, lockfree / locked);
+    }
+  }
+  return 0;
+}
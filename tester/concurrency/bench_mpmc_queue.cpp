@@ -0,0 +1,157 @@
+#include <cstdio>
+#include <cstdlib>
+#include <sched.h>
+#include "../../vector.hpp"
+#include "../../mpmc_queue.hpp"
+#include "../../utils/sync.hpp"
+#include "./bench_util.hpp"
+
+/* ft::mpmc_queue 와 mutex 하나로 감싼 고리 버퍼(deque 대신 ft::vector) 의 비교
+ * throughput : producer N 개, consumer N 개 (1 ~ 16) 가 원소를 넘기는 초당 개수(Mops/s)
+ * latency    : 두 thread 가 queue 두 개로 값을 주고받는 왕복 시간의 절반(ns)
+ * 가득 차거나 비어있으면 sched_yield 하고 다시 시도한다. */
+
+static const int CAPACITY = 1024;
+static const int ITEMS_PER_PRODUCER = 200000;
+static const int BATCH = 16;
+static const int ROUND_TRIPS = 100000;
+
+struct LockedQueue {
+  ft::__mutex m;
+  ft::vector<long> buf;
+  unsigned long head;
+  unsigned long tail;
+
+  LockedQueue(void) : buf(CAPACITY), head(0), tail(0) {}
+  bool try_push(long val) {
+    ft::__lock_guard g(m);
+    if (tail - head == buf.size())
+      return false;
+    buf[tail++ % buf.size()] = val;
+    return true;
+  }
+  bool try_pop(long& out) {
+    ft::__lock_guard g(m);
+    if (tail == head)
+      return false;
+    out = buf[head++ % buf.size()];
+    return true;
+  }
+  unsigned long try_push_n(const long* first, unsigned long n) {
+    ft::__lock_guard g(m);
+    unsigned long k = 0;
+    for ( ; k < n && tail - head < buf.size() ; k++)
+      buf[tail++ % buf.size()] = first[k];
+    return k;
+  }
+  unsigned long try_pop_n(long* out, unsigned long n) {
+    ft::__lock_guard g(m);
+    unsigned long k = 0;
+    for ( ; k < n && head != tail ; k++)
+      out[k] = buf[head++ % buf.size()];
+    return k;
+  }
+};
+
+template <bool Spsc>
+struct LockFreeQueue {
+  ft::mpmc_queue<long, Spsc> q;
+
+  LockFreeQueue(void) : q(CAPACITY) {}
+  bool try_push(long val) { return q.try_push(val); }
+  bool try_pop(long& out) { return q.try_pop(out); }
+  unsigned long try_push_n(const long* first, unsigned long n) { return q.try_push_n(first, n); }
+  unsigned long try_pop_n(long* out, unsigned long n) { return q.try_pop_n(out, n); }
+};
+
+/* id < producers 는 producer, 나머지는 consumer. consumer 도 producer 와 같은 수라 각자 같은 개수를 꺼낸다. */
+template <class Queue>
+struct Worker {
+  Queue& q;
+  int producers;
+  bool batch;
+  volatile long sink;
+
+  Worker(Queue& queue, int p, bool b) : q(queue), producers(p), batch(b), sink(0) {}
+  void run(int id) {
+    long buf[BATCH];
+    long sum = 0;
+    int done = 0;
+    while (done < ITEMS_PER_PRODUCER) {
+      int want = batch ? BATCH : 1;
+      if (want > ITEMS_PER_PRODUCER - done)
+        want = ITEMS_PER_PRODUCER - done;
+      unsigned long k;
+      if (id < producers) {
+        for (int j = 0 ; j < want ; j++)
+          buf[j] = done + j;
+        k = batch ? q.try_push_n(buf, want) : q.try_push(buf[0]);
+      } else {
+        k = batch ? q.try_pop_n(buf, want) : q.try_pop(buf[0]);
+        for (unsigned long j = 0 ; j < k ; j++)
+          sum += buf[j];
+      }
+      if (k == 0)
+        sched_yield();
+      done += k;
+    }
+    __sync_fetch_and_add(&sink, sum);
+  }
+};
+
+template <class Queue>
+double	throughput(int pairs, bool batch) {
+  Queue q;
+  Worker<Queue> worker(q, pairs, batch);
+  double sec = run_threads(worker, pairs * 2);
+  return static_cast<double>(pairs) * ITEMS_PER_PRODUCER / sec / 1e6;
+}
+
+/* thread 0 이 ping 에 넣으면 thread 1 이 꺼내서 pong 에 돌려준다. */
+template <class Queue>
+struct PingPong {
+  Queue ping;
+  Queue pong;
+
+  void run(int id) {
+    Queue& in = id == 0 ? pong : ping;
+    Queue& out = id == 0 ? ping : pong;
+    for (long i = 0 ; i < ROUND_TRIPS ; i++) {
+      long v = i;
+      if (id == 0)
+        while (!out.try_push(v))
+          sched_yield();
+      while (!in.try_pop(v))
+        sched_yield();
+      if (id == 1)
+        while (!out.try_push(v))
+          sched_yield();
+    }
+  }
+};
+
+template <class Queue>
+double	latency(void) {
+  PingPong<Queue>* pp = new PingPong<Queue>();
+  double sec = run_threads(*pp, 2);
+  delete pp;
+  return sec / ROUND_TRIPS / 2 * 1e9;
+}
+
+int main(void) {
+  static const int pairs[] = { 1, 2, 4, 8, 16 };
+  printf("\033[1;34m--- MPMC QUEUE BENCHMARK ---\033[0m\n");
+  for (int b = 0 ; b < 2 ; b++) {
+    printf("\nthroughput (Mops/s) %s\n%12s %14s %14s %8s\n", b ? "try_push_n / try_pop_n (batch 16)" : "try_push / try_pop",
+      "prod x cons", "mutex+ring", "mpmc_queue", "ratio");
+    for (int i = 0 ; i < 5 ; i++) {
+      double locked = throughput<LockedQueue>(pairs[i], b == 1);
+      double lockfree = throughput<LockFreeQueue<false> >(pairs[i], b == 1);
+      printf("%6d x %-3d %14.2f %14.2f %7.2fx\n", pairs[i], pairs[i], locked, lockfree, lockfree / locked);
+    }
+    printf("%6s %-5s %14s %14.2f\n", "spsc", "", "", throughput<LockFreeQueue<true> >(1, b == 1));
+  }
+  printf("\nlatency (ns, one way)\n%14s %14s %14s\n", "mutex+ring", "mpmc_queue", "spsc");
+  printf("%14.1f %14.1f %14.1f\n", latency<LockedQueue>(), latency<LockFreeQueue<false> >(), latency<LockFreeQueue<true> >());
+  return 0;
+}
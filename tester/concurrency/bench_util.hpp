@@ -0,0 +1,78 @@
+#ifndef BENCH_UTIL_HPP
+# define BENCH_UTIL_HPP
+
+# include <cstdio>
+# include <sys/time.h>
+# include <pthread.h>
+
+/* 여러 thread 로 같은 작업을 돌리고 벽시계 시간을 잰다. */
+
+inline double	now_sec(void) {
+  struct timeval tv;
+  gettimeofday(&tv, 0);
+  return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+/* thread 마다 다른 seed 의 xorshift */
+struct Rng {
+  unsigned int s;
+  explicit Rng(unsigned int seed) : s(seed * 2654435761u + 1) {}
+  unsigned int next(void) {
+    s ^= s << 13;
+    s ^= s >> 17;
+    s ^= s << 5;
+    return s;
+  }
+};
+
+/* 모든 thread 가 준비된 뒤 동시에 출발시키기 위한 barrier */
+struct StartGate {
+  volatile int ready;
+  volatile int go;
+  StartGate(void) : ready(0), go(0) {}
+  void wait(void) {
+    __sync_fetch_and_add(&ready, 1);
+    while (!go) {}
+  }
+  void open(int nthreads) {
+    while (ready < nthreads) {}
+    __sync_synchronize();
+    go = 1;
+  }
+};
+
+/* Worker::run(int id) 를 nthreads 개의 thread 에서 동시에 실행하고 걸린 시간(초)을 돌려준다. */
+template <class Worker>
+struct ThreadArg {
+  Worker* worker;
+  StartGate* gate;
+  int id;
+};
+
+template <class Worker>
+void*	thread_main(void* p) {
+  ThreadArg<Worker>* arg = static_cast<ThreadArg<Worker>*>(p);
+  arg->gate->wait();
+  arg->worker->run(arg->id);
+  return 0;
+}
+
+template <class Worker>
+double	run_threads(Worker& worker, int nthreads) {
+  pthread_t th[64];
+  ThreadArg<Worker> args[64];
+  StartGate gate;
+  for (int i = 0 ; i < nthreads ; i++) {
+    args[i].worker = &worker;
+    args[i].gate = &gate;
+    args[i].id = i;
+    pthread_create(&th[i], 0, thread_main<Worker>, &args[i]);
+  }
+  gate.open(nthreads);
+  double start = now_sec();
+  for (int i = 0 ; i < nthreads ; i++)
+    pthread_join(th[i], 0);
+  return now_sec() - start;
+}
+
+#endif
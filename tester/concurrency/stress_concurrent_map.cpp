@@ -0,0 +1,216 @@
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <unistd.h>
+#include <vector>
+#include "../../concurrent_map.hpp"
+#include "./bench_util.hpp"
+
+/* ft::concurrent_map 의 정확성 test
+ * writer thread 들이 각자 맡은 key (key % WRITERS == 자기 번호, 모든 shard 에 흩어짐) 에 insert / insert_or_assign / upsert /
+ * erase / visit 를 섞어 하면서 find / count 를 자기 std::map 과 비교한다. 모든 writer 는 공용 key 몇 개에 upsert 로 더하기도 한다.
+ * 그동안 reader thread 하나는 ordered_for_each 를 돌리며 key 가 계속 올라가는지 본다.
+ * 끝나면 writer 들의 std::map 을 합친 것과 size / for_each / parallel_for_each / ordered_for_each (k-way merge) / to_map 이
+ * 모두 같아야 한다. shard 수를 바꿔가며 돌리고 실패하면 1 을 반환한다. */
+
+static const int WRITERS = 6;
+static const int READERS = 1;
+static const int OPS_PER_WRITER = 100000;
+static const int KEYS_PER_WRITER = 4000;
+static const int SHARED_KEYS = 8;
+/* 공용 key 는 writer 의 key 와 겹치지 않게 음수 */
+static const int SHARED_BASE = -SHARED_KEYS;
+
+typedef ft::concurrent_map<int, long> Map;
+typedef std::map<int, long> Reference;
+
+static int failures = 0;
+
+static void	check(bool ok, const char* what) {
+  if (!ok) {
+    printf("\033[31m[KO]\033[0m %s\n", what);
+    ++failures;
+  }
+}
+
+struct Add {
+  void operator()(long& cur, const long& val) const { cur += val; }
+};
+
+struct Increment {
+  void operator()(long& cur) const { ++cur; }
+};
+
+/* ordered_for_each 가 넘겨주는 순서를 검사한다. */
+struct OrderCheck {
+  int last;
+  bool first;
+  bool sorted;
+  OrderCheck(void) : last(0), first(true), sorted(true) {}
+  void operator()(const Map::value_type& v) {
+    if (!first && !(last < v.first))
+      sorted = false;
+    last = v.first;
+    first = false;
+  }
+};
+
+struct Collect {
+  std::vector<std::pair<int, long> >* out;
+  explicit Collect(std::vector<std::pair<int, long> >* o) : out(o) {}
+  void operator()(const Map::value_type& v) { out->push_back(std::make_pair(v.first, v.second)); }
+};
+
+/* parallel_for_each 용. 여러 thread 에서 불리므로 atomic 으로 더한다. */
+struct ParallelSum {
+  volatile long count;
+  volatile long key_sum;
+  volatile long value_sum;
+  ParallelSum(void) : count(0), key_sum(0), value_sum(0) {}
+  void operator()(const Map::value_type& v) {
+    __sync_fetch_and_add(&count, 1);
+    __sync_fetch_and_add(&key_sum, v.first);
+    __sync_fetch_and_add(&value_sum, v.second);
+  }
+};
+
+struct Worker {
+  Map& map;
+  Reference refs[WRITERS];
+  volatile int writers_done;
+  volatile int mismatches;
+  volatile long shared_added;
+
+  explicit Worker(Map& m) : map(m), writers_done(0), mismatches(0), shared_added(0) {}
+
+  void run(int id) {
+    if (id < WRITERS)
+      write(id, refs[id]);
+    else
+      read();
+  }
+
+  void write(int id, Reference& ref) {
+    Rng rng(id + 1);
+    int bad = 0;
+    long shared = 0;
+    for (int i = 0 ; i < OPS_PER_WRITER ; i++) {
+      int key = static_cast<int>(rng.next() % KEYS_PER_WRITER) * WRITERS + id;
+      long val = rng.next() % 1000;
+      Reference::iterator it = ref.find(key);
+      bool exists = it != ref.end();
+      switch (rng.next() % 8) {
+        case 0:
+          bad += map.insert(Map::value_type(key, val)) == exists;
+          if (!exists)
+            ref[key] = val;
+          break;
+        case 1:
+          bad += map.insert_or_assign(key, val) == exists;
+          ref[key] = val;
+          break;
+        case 2:
+          bad += map.upsert(key, val, Add()) == exists;
+          ref[key] += val;
+          break;
+        case 3:
+          bad += map.erase(key) != static_cast<Map::size_type>(exists);
+          ref.erase(key);
+          break;
+        case 4:
+          bad += map.visit(key, Increment()) != exists;
+          if (exists)
+            ++it->second;
+          break;
+        case 5:
+          map.upsert(SHARED_BASE + static_cast<int>(rng.next() % SHARED_KEYS), 1, Add());
+          ++shared;
+          break;
+        default: {
+          long out = -1;
+          bool found = map.find(key, out);
+          bad += found != exists || (found && out != it->second);
+          bad += map.count(key) != static_cast<Map::size_type>(exists);
+        }
+      }
+    }
+    if (bad)
+      printf("  writer %d : %d operations differ from std::map\n", id, bad);
+    __sync_fetch_and_add(&mismatches, bad);
+    __sync_fetch_and_add(&shared_added, shared);
+    __sync_fetch_and_add(&writers_done, 1);
+  }
+
+  /* 쓰는 중에도 ordered_for_each 는 한 시점의 내용을 key 순서로 보여줘야 한다.
+   * 모든 shard 를 read lock 하므로 쉬지 않고 돌리면 (glibc rwlock 은 reader 우선) writer 가 굶는다. 한 번 돌 때마다 잠깐 쉰다. */
+  void read(void) {
+    do {
+      OrderCheck c = map.ordered_for_each(OrderCheck());
+      if (!c.sorted)
+        __sync_fetch_and_add(&mismatches, 1);
+      usleep(1000);
+    } while (writers_done != WRITERS);
+  }
+};
+
+static void	run(std::size_t shard_count) {
+  Map map(shard_count);
+  Worker worker(map);
+  run_threads(worker, WRITERS + READERS);
+  check(worker.mismatches == 0, "concurrent operations differ from a sequential std::map");
+
+  Reference expect;
+  for (int w = 0 ; w < WRITERS ; w++)
+    expect.insert(worker.refs[w].begin(), worker.refs[w].end());
+  /* 공용 key 는 writer 들이 1 씩 더했으므로 key 별 값은 정해져 있지 않지만 합은 더한 횟수와 같아야 한다. */
+  long shared_total = 0;
+  for (int k = SHARED_BASE ; k < 0 ; k++) {
+    long v = 0;
+    if (map.find(k, v))
+      expect[k] = v;
+    shared_total += v;
+  }
+  check(shared_total == worker.shared_added, "concurrent upserts on shared keys lost an update");
+
+  check(map.size() == expect.size(), "size() differs from the sequential reference");
+
+  std::vector<std::pair<int, long> > expected(expect.begin(), expect.end());
+  std::vector<std::pair<int, long> > ordered;
+  map.ordered_for_each(Collect(&ordered));
+  check(ordered == expected, "ordered_for_each differs from the sequential reference");
+
+  Map::map_type copy = map.to_map();
+  bool same = copy.size() == expect.size();
+  Reference::iterator e = expect.begin();
+  for (Map::map_type::iterator it = copy.begin() ; same && it != copy.end() ; ++it, ++e)
+    same = it->first == e->first && it->second == e->second;
+  check(same, "to_map differs from the sequential reference");
+
+  std::vector<std::pair<int, long> > unordered;
+  map.for_each(Collect(&unordered));
+  std::sort(unordered.begin(), unordered.end());
+  check(unordered == expected, "for_each does not visit every element once");
+
+  ParallelSum sum;
+  map.parallel_for_each(sum, 4);
+  long key_sum = 0;
+  long value_sum = 0;
+  for (e = expect.begin() ; e != expect.end() ; ++e) {
+    key_sum += e->first;
+    value_sum += e->second;
+  }
+  check(sum.count == static_cast<long>(expect.size()) && sum.key_sum == key_sum && sum.value_sum == value_sum,
+    "parallel_for_each does not visit every element once");
+
+  map.clear();
+  check(map.empty(), "clear() left elements");
+}
+
+int main(void) {
+  printf("\033[1;34m--- CONCURRENT MAP STRESS ---\033[0m\n");
+  static const std::size_t shards[] = { 1, 5, 16, 128 };
+  for (int i = 0 ; i < 4 ; i++)
+    run(shards[i]);
+  printf("%s\n", failures ? "\033[31mFAIL\033[0m" : "\033[32mOK\033[0m");
+  return failures != 0;
+}
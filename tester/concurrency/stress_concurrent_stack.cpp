@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <cstdio>
+#include <iterator>
+#include <vector>
+#include "../../concurrent_stack.hpp"
+#include "../../utils/counting_allocator.hpp"
+#include "./bench_util.hpp"
+
+/* ft::concurrent_stack 의 정확성 stress test
+ * producer 들은 push 와 push_range 를 섞어서 (producer 번호, 순번) 을 하나씩 넣고, consumer 들은 try_pop 과 pop_all 을 섞어서 꺼낸다.
+ * 끝나면 꺼낸 값 전체가 넣은 값 전체와 (중복도 빠짐도 없이) 같아야 한다.
+ * 그 다음 thread 를 하나씩 만들고 끝내기를 반복해서, 끝난 thread 의 빈 노드가 공용 free list 로 돌아오는지
+ * (새 segment 를 할당하지 않는지) 빈 stack 에서 본다. 실패하면 1 을 반환한다. */
+
+static const int PRODUCERS = 4;
+static const int CONSUMERS = 4;
+static const long PER_PRODUCER = 100000;
+static const int BATCH = 16;
+static const int ROUNDS = 5;
+static const int CHURN_THREADS = 500;
+
+typedef ft::concurrent_stack<long, ft::counting_allocator<long> > Stack;
+
+static int failures = 0;
+
+static void	check(bool ok, const char* what) {
+  if (!ok) {
+    printf("\033[31m[KO]\033[0m %s\n", what);
+    ++failures;
+  }
+}
+
+static long	make_value(int producer, long seq) { return producer * PER_PRODUCER + seq; }
+
+struct Worker {
+  Stack& stack;
+  volatile int producers_done;
+  std::vector<long> popped[CONSUMERS];
+
+  explicit Worker(Stack& s) : stack(s), producers_done(0) {}
+
+  void run(int id) {
+    if (id < PRODUCERS)
+      produce(id);
+    else
+      consume(popped[id - PRODUCERS], id);
+  }
+
+  /* 짝수 번째 묶음은 push 로 하나씩, 홀수 번째는 push_range 로 한꺼번에 넣는다. */
+  void produce(int id) {
+    Rng rng(id + 1);
+    long buf[BATCH];
+    for (long seq = 0, turn = 0 ; seq < PER_PRODUCER ; ++turn) {
+      long n = std::min(static_cast<long>(rng.next() % BATCH + 1), PER_PRODUCER - seq);
+      for (long j = 0 ; j < n ; j++)
+        buf[j] = make_value(id, seq + j);
+      if (turn % 2 == 0)
+        for (long j = 0 ; j < n ; j++)
+          stack.push(buf[j]);
+      else
+        stack.push_range(buf, buf + n);
+      seq += n;
+    }
+    __sync_fetch_and_add(&producers_done, 1);
+  }
+
+  /* producer 가 모두 끝나고 stack 이 빌 때까지 꺼낸다. */
+  void consume(std::vector<long>& out, int id) {
+    Rng rng(id + 1);
+    for (;;) {
+      bool done = producers_done == PRODUCERS;
+      __sync_synchronize();
+      long v;
+      if (rng.next() % 8 == 0)
+        stack.pop_all(std::back_inserter(out));
+      else if (stack.try_pop(v))
+        out.push_back(v);
+      else if (done && stack.empty())
+        break;
+    }
+  }
+};
+
+/* 넣은 값 PRODUCERS * PER_PRODUCER 개가 정확히 한 번씩 나왔는지 */
+static void	check_conservation(Worker& worker, std::vector<long>& rest) {
+  std::vector<long> all(rest);
+  for (int c = 0 ; c < CONSUMERS ; c++)
+    all.insert(all.end(), worker.popped[c].begin(), worker.popped[c].end());
+  check(all.size() == static_cast<size_t>(PRODUCERS * PER_PRODUCER), "popped count differs from pushed count");
+  std::sort(all.begin(), all.end());
+  bool same = all.size() == static_cast<size_t>(PRODUCERS * PER_PRODUCER);
+  for (size_t i = 0 ; same && i < all.size() ; i++)
+    same = all[i] == static_cast<long>(i);
+  check(same, "popped values are not the pushed multiset");
+}
+
+/* 값 하나를 넣고 빼고 끝나는 thread. 끝날 때 로컬 free list 가 공용으로 넘어간다. */
+struct Churn {
+  Stack& stack;
+  explicit Churn(Stack& s) : stack(s) {}
+  void run(int id) {
+    long v;
+    stack.push(id);
+    stack.try_pop(v);
+  }
+};
+
+int main(void) {
+  ft::allocation_stats stats;
+  printf("\033[1;34m--- CONCURRENT STACK STRESS ---\033[0m\n");
+  {
+    Stack stack((ft::counting_allocator<long>(&stats)));
+    for (int r = 0 ; r < ROUNDS ; r++) {
+      Worker worker(stack);
+      run_threads(worker, PRODUCERS + CONSUMERS);
+      std::vector<long> rest;
+      stack.pop_all(std::back_inserter(rest));
+      check(stack.empty(), "stack not empty after draining");
+      check_conservation(worker, rest);
+    }
+  }
+  {
+    /* 빈 stack 에서 thread 를 하나씩 돌린다. 첫 thread 가 받아간 노드 묶음이 끝날 때마다 공용 free list 로 돌아오므로
+     * 그 뒤로는 새 노드를 할당할 일이 없어야 한다. (돌아오지 않으면 thread 마다 새 번호 묶음을 받아 segment 가 늘어난다) */
+    Stack stack((ft::counting_allocator<long>(&stats)));
+    Churn churn(stack);
+    run_threads(churn, 1);
+    unsigned long before = stats.snapshot().allocations;
+    for (int i = 0 ; i < CHURN_THREADS ; i++)
+      run_threads(churn, 1);
+    check(stats.snapshot().allocations == before, "nodes of exited threads were not reused");
+    check(stack.empty(), "stack not empty after churn");
+  }
+  check(stats.snapshot().live_bytes == 0, "segments leaked after destruction");
+  printf("%s\n", failures ? "\033[31mFAIL\033[0m" : "\033[32mOK\033[0m");
+  return failures != 0;
+}
@@ -0,0 +1,204 @@
+#include <algorithm>
+#include <cstdio>
+#include <sched.h>
+#include <vector>
+#include "../../mpmc_queue.hpp"
+#include "./bench_util.hpp"
+
+/* ft::mpmc_queue 의 정확성 stress test
+ * boundary : thread 하나로 용량 경계에서 try_push / try_pop / try_push_n / try_pop_n 이 가득 참 / 비어있음을 맞게 알리는지,
+ *            index 가 용량을 여러 번 돌아도 FIFO 인지 본다.
+ * mpmc     : producer 여러 개가 (producer 번호, 순번) 을 넣고 consumer 여러 개가 꺼낸다. 하나씩(try_push / try_pop) 과
+ *            묶음(try_push_n / try_pop_n, 한 번의 __claim 으로 여러 칸) 두 가지.
+ *            consumer 하나가 본 값들 중 같은 producer 의 것은 순번이 올라가야 하고, 모두 모으면 넣은 값과 같아야 한다.
+ * spsc     : producer, consumer 하나씩 하나 / 묶음을 섞어서 넘기고 받은 순서가 넣은 순서와 같아야 한다.
+ * 실패하면 1 을 반환한다. */
+
+static const int PRODUCERS = 4;
+static const int CONSUMERS = 4;
+static const long PER_PRODUCER = 200000;
+static const int CAPACITY = 64;
+static const int BATCH = 16;
+
+static int failures = 0;
+
+static void	check(bool ok, const char* what) {
+  if (!ok) {
+    printf("\033[31m[KO]\033[0m %s\n", what);
+    ++failures;
+  }
+}
+
+static long	make_value(int producer, long seq) { return producer * PER_PRODUCER + seq; }
+
+// -------------------------------------------------------------------------- //
+//                                  boundary                                  //
+// -------------------------------------------------------------------------- //
+
+template <bool Spsc>
+void	check_boundary(std::size_t requested) {
+  ft::mpmc_queue<long, Spsc> q(requested);
+  std::size_t cap = q.capacity();
+  check(cap >= requested && cap >= 2 && (cap & (cap - 1)) == 0, "capacity is not a power of two >= requested");
+
+  long out;
+  std::vector<long> buf(cap + BATCH);
+  long next_in = 0;
+  long next_out = 0;
+  /* 용량을 여러 번 돌도록 채우고 비우기를 반복한다. */
+  for (int round = 0 ; round < 5 ; round++) {
+    check(q.empty() && !q.try_pop(out), "try_pop succeeded on an empty queue");
+    check(q.try_pop_n(buf.begin(), BATCH) == 0, "try_pop_n returned elements from an empty queue");
+    for (std::size_t i = 0 ; i < cap ; i++)
+      check(q.try_push(next_in++), "try_push failed before the queue was full");
+    check(q.size() == cap, "size() differs from capacity on a full queue");
+    check(!q.try_push(-1), "try_push succeeded on a full queue");
+    check(q.try_push_n(buf.begin(), BATCH) == 0, "try_push_n pushed into a full queue");
+
+    /* 하나 빼면 정확히 한 칸이 빈다. */
+    check(q.try_pop(out) && out == next_out++, "try_pop broke FIFO order");
+    check(q.try_push(next_in++) && !q.try_push(-1), "one pop did not free exactly one slot");
+
+    /* 남은 것보다 많이 달라고 하면 있는 만큼만 */
+    std::size_t half = cap / 2;
+    std::size_t k = q.try_pop_n(buf.begin(), half);
+    check(k == half, "try_pop_n returned fewer than available");
+    for (std::size_t i = 0 ; i < k ; i++)
+      check(buf[i] == next_out++, "try_pop_n broke FIFO order");
+    for (std::size_t i = 0 ; i < half + 3 ; i++)
+      buf[i] = next_in + i;
+    k = q.try_push_n(buf.begin(), half + 3);
+    check(k == half, "try_push_n did not stop at the free slot count");
+    next_in += k;
+    check(q.try_push_n(buf.begin(), 0) == 0 && q.try_pop_n(buf.begin(), 0) == 0, "n == 0 moved elements");
+
+    std::vector<long> rest(cap + 5);
+    k = q.try_pop_n(rest.begin(), cap + 5);
+    check(k == cap, "try_pop_n on a full queue did not return capacity elements");
+    for (std::size_t i = 0 ; i < k ; i++)
+      check(rest[i] == next_out++, "try_pop_n broke FIFO order across the wrap");
+  }
+  check(next_in == next_out, "boundary pushes and pops do not match");
+}
+
+// -------------------------------------------------------------------------- //
+//                                    mpmc                                    //
+// -------------------------------------------------------------------------- //
+
+template <bool Spsc>
+struct Worker {
+  ft::mpmc_queue<long, Spsc>& q;
+  int producers;
+  bool batch;
+  volatile int producers_done;
+  std::vector<long> popped[CONSUMERS];
+
+  Worker(ft::mpmc_queue<long, Spsc>& queue, int p, bool b) : q(queue), producers(p), batch(b), producers_done(0) {}
+
+  void run(int id) {
+    if (id < producers)
+      produce(id);
+    else
+      consume(popped[id - producers], id);
+  }
+
+  /* batch 면 묶음 크기를 바꿔가며 try_push_n, 아니면 try_push. spsc 면 둘을 번갈아 쓴다. */
+  void produce(int id) {
+    Rng rng(id + 1);
+    long buf[BATCH];
+    for (long seq = 0 ; seq < PER_PRODUCER ; ) {
+      bool use_batch = Spsc ? rng.next() % 2 == 0 : batch;
+      if (!use_batch) {
+        while (!q.try_push(make_value(id, seq)))
+          sched_yield();
+        ++seq;
+        continue;
+      }
+      long n = std::min(static_cast<long>(rng.next() % BATCH + 1), PER_PRODUCER - seq);
+      for (long j = 0 ; j < n ; j++)
+        buf[j] = make_value(id, seq + j);
+      std::size_t k = q.try_push_n(buf, n);
+      if (k == 0)
+        sched_yield();
+      seq += k;
+    }
+    __sync_fetch_and_add(&producers_done, 1);
+  }
+
+  void consume(std::vector<long>& out, int id) {
+    Rng rng(id + 101);
+    long buf[BATCH];
+    for (;;) {
+      bool done = producers_done == producers;
+      __sync_synchronize();
+      bool use_batch = Spsc ? rng.next() % 2 == 0 : batch;
+      std::size_t k;
+      if (use_batch) {
+        k = q.try_pop_n(buf, rng.next() % BATCH + 1);
+        out.insert(out.end(), buf, buf + k);
+      } else {
+        k = q.try_pop(buf[0]) ? 1 : 0;
+        if (k)
+          out.push_back(buf[0]);
+      }
+      if (k == 0) {
+        if (done)
+          break;
+        sched_yield();
+      }
+    }
+  }
+};
+
+/* consumer 마다 같은 producer 의 값은 순번이 올라가고, 전부 모으면 넣은 값과 같아야 한다. */
+template <bool Spsc>
+void	check_worker(Worker<Spsc>& worker, int consumers, const char* mode) {
+  std::vector<long> all;
+  for (int c = 0 ; c < consumers ; c++) {
+    std::vector<long>& got = worker.popped[c];
+    std::vector<long> last(worker.producers, -1);
+    bool fifo = true;
+    for (std::size_t i = 0 ; i < got.size() ; i++) {
+      int p = static_cast<int>(got[i] / PER_PRODUCER);
+      long seq = got[i] % PER_PRODUCER;
+      if (p < 0 || p >= worker.producers || seq <= last[p])
+        fifo = false;
+      else
+        last[p] = seq;
+    }
+    if (!fifo)
+      printf("  %s : consumer %d\n", mode, c);
+    check(fifo, "values of one producer were popped out of order");
+    all.insert(all.end(), got.begin(), got.end());
+  }
+  std::sort(all.begin(), all.end());
+  bool same = all.size() == static_cast<std::size_t>(worker.producers * PER_PRODUCER);
+  for (std::size_t i = 0 ; same && i < all.size() ; i++)
+    same = all[i] == static_cast<long>(i);
+  if (!same)
+    printf("  %s : %lu popped\n", mode, static_cast<unsigned long>(all.size()));
+  check(same, "popped values are not the pushed set");
+}
+
+template <bool Spsc>
+void	run_mode(int producers, int consumers, bool batch, const char* mode) {
+  ft::mpmc_queue<long, Spsc> q(CAPACITY);
+  Worker<Spsc> worker(q, producers, batch);
+  run_threads(worker, producers + consumers);
+  check(q.empty(), "queue not empty after all consumers finished");
+  check_worker(worker, consumers, mode);
+}
+
+int main(void) {
+  printf("\033[1;34m--- MPMC QUEUE STRESS ---\033[0m\n");
+  static const std::size_t caps[] = { 0, 2, 3, 16, 1000 };
+  for (int i = 0 ; i < 5 ; i++) {
+    check_boundary<false>(caps[i]);
+    check_boundary<true>(caps[i]);
+  }
+  run_mode<false>(PRODUCERS, CONSUMERS, false, "mpmc try_push / try_pop");
+  run_mode<false>(PRODUCERS, CONSUMERS, true, "mpmc try_push_n / try_pop_n");
+  run_mode<true>(1, 1, false, "spsc");
+  printf("%s\n", failures ? "\033[31mFAIL\033[0m" : "\033[32mOK\033[0m");
+  return failures != 0;
+}
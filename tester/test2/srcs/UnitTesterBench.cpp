@@ -1,17 +1,119 @@
 #include "./includes/UnitTester.hpp"
+#include "../../../utils/counting_allocator.hpp"
 #include <cmath>
+#include <cstdlib>
 #include <ctime>
 #include <iostream>
+#include <new>
 #include <time.h>
 
+/*
+ * The bench functions build ft and std containers with their default allocators,
+ * so every heap request of this binary is counted here instead, into the same
+ * ft::allocation_stats that ft::counting_allocator fills. The requested size is
+ * kept in a 16 byte header in front of each block for the delete side.
+ */
+#if __cplusplus >= 201103L
+#define BENCH_NEW_THROW
+#define BENCH_NO_THROW noexcept
+#else
+#define BENCH_NEW_THROW throw(std::bad_alloc)
+#define BENCH_NO_THROW  throw()
+#endif
+
+static const std::size_t k_block_header = 16;
+
+static ft::allocation_stats& _heap_stats()
+{
+	static ft::allocation_stats stats;
+	return stats;
+}
+
+static void* _counted_alloc(std::size_t size)
+{
+	char* block = static_cast<char*>(std::malloc(size + k_block_header));
+	if (!block)
+		return NULL;
+	*reinterpret_cast<std::size_t*>(block) = size;
+	_heap_stats().record_allocate(size);
+	return block + k_block_header;
+}
+
+static void _counted_free(void* ptr)
+{
+	if (!ptr)
+		return;
+	char* block = static_cast<char*>(ptr) - k_block_header;
+	_heap_stats().record_deallocate(*reinterpret_cast<std::size_t*>(block));
+	std::free(block);
+}
+
+void* operator new(std::size_t size) BENCH_NEW_THROW
+{
+	void* ptr = _counted_alloc(size);
+	if (!ptr)
+		throw std::bad_alloc();
+	return ptr;
+}
+
+void* operator new[](std::size_t size) BENCH_NEW_THROW
+{
+	return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) BENCH_NO_THROW
+{
+	return _counted_alloc(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) BENCH_NO_THROW
+{
+	return _counted_alloc(size);
+}
+
+void operator delete(void* ptr) BENCH_NO_THROW
+{
+	_counted_free(ptr);
+}
+
+void operator delete[](void* ptr) BENCH_NO_THROW
+{
+	_counted_free(ptr);
+}
+
+#if __cplusplus >= 201402L
+void operator delete(void* ptr, std::size_t) BENCH_NO_THROW
+{
+	_counted_free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) BENCH_NO_THROW
+{
+	_counted_free(ptr);
+}
+#endif
+
+void operator delete(void* ptr, const std::nothrow_t&) BENCH_NO_THROW
+{
+	_counted_free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) BENCH_NO_THROW
+{
+	_counted_free(ptr);
+}
+
 void UnitTester::_bench_sandbox(t_unit_subtests& current_test)
 {
-	clock_t time;
+	clock_t       time;
+	unsigned long allocations;
 
-	time = clock();
+	allocations = _heap_stats().snapshot().allocations;
+	time        = clock();
 	current_test.func_test_ptr();
-	time                = clock() - time;
-	current_test.result = time;
+	time                     = clock() - time;
+	current_test.result      = time;
+	current_test.allocations = _heap_stats().snapshot().allocations - allocations;
 }
 
 float _calc_time_in_msec(clock_t time)
@@ -59,6 +161,13 @@ void UnitTester::_display_percentage(float std, float ft)
 	}
 }
 
+void UnitTester::_display_allocations(unsigned long std, unsigned long ft)
+{
+	std::cout << "allocs " << std << " / " << ft;
+	if (ft > std)
+		std::cout << COLOR_WARNING " (+" << ft - std << ")" COLOR_CLEAR;
+}
+
 void UnitTester::_display_funcname(std::string func_name, std::string type_stirng)
 {
 	func_name = func_name.substr((type_stirng + '_').length());
@@ -88,8 +197,9 @@ void UnitTester::_display_bench_result(t_unit_subtests& current_test)
 	static const char* prev_func_name;
 	static t_stl_types type;
 	std::string        type_string = _stl_type_to_string(current_test.type);
-	static float       std_time;
-	float              ft_time;
+	static float         std_time;
+	static unsigned long std_allocations;
+	float                ft_time;
 
 	if (type != current_test.type) {
 		if (type)
@@ -100,7 +210,8 @@ void UnitTester::_display_bench_result(t_unit_subtests& current_test)
 	}
 	if (!prev_func_name || strcmp(prev_func_name, current_test.func_name)) {
 		std::cout << std::endl;
-		std_time = _calc_time_in_msec(current_test.result);
+		std_time        = _calc_time_in_msec(current_test.result);
+		std_allocations = current_test.allocations;
 		_display_time(std_time, true);
 		_display_funcname(current_test.func_name, type_string);
 		prev_func_name = current_test.func_name;
@@ -108,6 +219,7 @@ void UnitTester::_display_bench_result(t_unit_subtests& current_test)
 		ft_time = _calc_time_in_msec(current_test.result);
 		_display_time(ft_time, false);
 		_display_percentage(std_time, ft_time);
+		_display_allocations(std_allocations, current_test.allocations);
 	}
 	std::cout << std::flush;
 }
@@ -65,6 +65,19 @@ void map_ft_swap();
 /* ft::pair */
 void map_ft_make_pair();
 
+#if !STD
+/* Extensions */
+void map_persistent();
+void map_order_stat();
+void map_find_many();
+void map_node_handle();
+void map_snapshot();
+void map_frozen();
+void map_heterogeneous();
+void map_try_emplace();
+void map_allocation();
+#endif
+
 /* Benchmark */
 void bench_map_copy_constructor();
 void bench_map_assignment_operator();
@@ -58,6 +58,17 @@ void set_operator_g();
 void set_operator_ge();
 void set_ft_swap();
 
+#if !STD
+/* Extensions */
+void set_algebra();
+void set_order_stat();
+void set_node_handle();
+void set_snapshot();
+void set_frozen();
+void set_heterogeneous();
+void set_allocation();
+#endif
+
 /* Benchmark */
 void bench_set_copy_constructor();
 void bench_set_assignment_operator();
@@ -49,8 +49,9 @@ typedef struct s_unit_subtests {
 	const char* func_name;
 	const char* subtest_name;
 	void (*func_test_ptr)();
-	clock_t     result;
-	t_stl_types type;
+	clock_t       result;
+	unsigned long allocations;
+	t_stl_types   type;
 } t_unit_subtests;
 #else
 typedef struct s_unit_subtests {
@@ -103,6 +104,7 @@ class UnitTester
 	void _bench_sandbox(t_unit_subtests& current_test);
 	void _display_bench_result(t_unit_subtests& current_test);
 	void _display_percentage(float std, float ft);
+	void _display_allocations(unsigned long std, unsigned long ft);
 	void _display_funcname(std::string func_name, std::string type_stirng);
 	void _print_bench_subheader(const std::string& type_string);
 
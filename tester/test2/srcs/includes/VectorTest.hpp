@@ -60,6 +60,13 @@ void vector_operator_g();
 void vector_operator_ge();
 void vector_ft_swap();
 
+#if !STD
+/* Extensions */
+void vector_snapshot();
+void vector_mapped();
+void vector_allocation();
+#endif
+
 /* Benchmark */
 void bench_vector_copy_constructor();
 void bench_vector_assignment_operator();
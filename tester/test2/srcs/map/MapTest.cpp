@@ -59,6 +59,18 @@ t_unit_tests func_test_table[] = {
     {            "map_ft_swap",             map_ft_swap, FAIL, MAP},
  // ------------------------------ ft::pair ------------------------------ //
 	{	   "map_ft_make_pair",        map_ft_make_pair, FAIL, MAP},
+#if !STD
+ // ----------------------------- Extensions ----------------------------- //
+	{	     "map_persistent",          map_persistent, FAIL, MAP},
+	{	     "map_order_stat",          map_order_stat, FAIL, MAP},
+	{	      "map_find_many",           map_find_many, FAIL, MAP},
+	{	    "map_node_handle",         map_node_handle, FAIL, MAP},
+	{	       "map_snapshot",            map_snapshot, FAIL, MAP},
+	{	         "map_frozen",              map_frozen, FAIL, MAP},
+	{	  "map_heterogeneous",       map_heterogeneous, FAIL, MAP},
+	{	    "map_try_emplace",         map_try_emplace, FAIL, MAP},
+	{	     "map_allocation",          map_allocation, FAIL, MAP},
+#endif
  // ------------------- Terminater (Do not comment out) ------------------ //
 	{	                 "\0",	                NULL, FAIL, MAP}
 };
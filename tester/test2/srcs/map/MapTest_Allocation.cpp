@@ -0,0 +1,121 @@
+#include "../includes/MapTest.hpp"
+#include "../includes/UnitTester.hpp"
+#include <iostream>
+#include <map>
+
+#if !STD
+#include "../../../../utils/counting_allocator.hpp"
+
+namespace MapTest {
+
+/* ft::counting_allocator 로 map 의 할당을 센다. map 에 넘긴 allocator 는 __rbt 안에서 노드 타입으로 rebind 되지만
+   같은 allocation_stats 를 가리키므로 노드 할당이 모두 여기에 모인다. 원소 하나에 노드 하나, 찾기는 할당 없음. */
+
+typedef ft::counting_allocator<ft::pair<const int, int> >      t_count_alloc;
+typedef ft::map<int, int, std::less<int>, t_count_alloc>       t_count_map;
+typedef ft::map<int, int, std::less<int>, t_count_alloc, true> t_count_ost;
+
+// -------------------------------------------------------------------------- //
+//                                 allocation                                 //
+// -------------------------------------------------------------------------- //
+
+template <class Map>
+void _alloc_rebind()
+{
+	ft::allocation_stats stats;
+	{
+		Map           m((std::less<int>()), t_count_alloc(&stats));
+		unsigned long empty = stats.snapshot().allocations;
+
+		for (int i = 0; i < 100; ++i)
+			m.insert(ft::make_pair(i, i));
+		ft::allocation_stats s = stats.snapshot();
+
+		/* rebind 한 node allocator 도 같은 stats 에 기록하고, 노드는 value_type 보다 크다. */
+		UnitTester::assert_(s.allocations - empty == 100);
+		UnitTester::assert_(s.bytes_allocated / s.allocations > sizeof(ft::pair<const int, int>));
+		UnitTester::assert_(stats.live_blocks() == s.allocations);
+
+		/* 이미 있는 key 의 insert 와 operator[] 는 할당하지 않는다. */
+		for (int i = 0; i < 100; ++i) {
+			UnitTester::assert_(!m.insert(ft::make_pair(i, -1)).second);
+			UnitTester::assert_(m[i] == i);
+		}
+		UnitTester::assert_(stats.snapshot().allocations == s.allocations);
+
+		/* 복사본은 원본을 만들 때와 같은 수의 노드를 할당하고 같은 stats 에 기록한다. */
+		{
+			Map copy(m);
+
+			UnitTester::assert_(stats.snapshot().allocations - s.allocations == s.allocations);
+			UnitTester::assert_(copy == m);
+		}
+		UnitTester::assert_(stats.snapshot().live_bytes == s.live_bytes);
+
+		/* 지운 원소마다 노드 하나를 돌려준다. */
+		unsigned long freed = stats.snapshot().deallocations;
+		for (int i = 0; i < 100; i += 2)
+			m.erase(i);
+		UnitTester::assert_(stats.snapshot().deallocations - freed == 50);
+		m.clear();
+		UnitTester::assert_(m.empty());
+	}
+	UnitTester::assert_(stats.snapshot().live_bytes == 0);
+	UnitTester::assert_(stats.live_blocks() == 0);
+}
+
+void _map_allocation_rebind()
+{
+	set_explanation_("node allocations do not reach the allocator's stats through rebind, or leak");
+	_alloc_rebind<t_count_map>();
+	_alloc_rebind<t_count_ost>();
+}
+
+template <class Map>
+void _alloc_find()
+{
+	ft::allocation_stats stats;
+	Map                  m((std::less<int>()), t_count_alloc(&stats));
+	const Map&           cm = m;
+
+	for (int i = 0; i < 500; ++i)
+		m.insert(ft::make_pair(2 * i, i));
+	ft::allocation_stats before = stats.snapshot();
+
+	for (int k = -1; k < 1001; ++k) {
+		UnitTester::assert_((m.find(k) != m.end()) == (k >= 0 && k < 1000 && k % 2 == 0));
+		UnitTester::assert_((cm.find(k) != cm.end()) == (k >= 0 && k < 1000 && k % 2 == 0));
+		UnitTester::assert_(m.count(k) == static_cast<size_t>(k >= 0 && k < 1000 && k % 2 == 0));
+		m.lower_bound(k);
+		m.upper_bound(k);
+		m.equal_range(k);
+		cm.equal_range(k);
+	}
+	int sum = 0;
+	for (typename Map::const_iterator it = cm.begin(); it != cm.end(); ++it)
+		sum += it->second;
+	for (typename Map::reverse_iterator it = m.rbegin(); it != m.rend(); ++it)
+		sum -= it->second;
+	UnitTester::assert_(sum == 0);
+
+	ft::allocation_stats after = stats.snapshot();
+	UnitTester::assert_(after.allocations == before.allocations);
+	UnitTester::assert_(after.deallocations == before.deallocations);
+}
+
+void _map_allocation_find()
+{
+	set_explanation_("map::find / count / bounds / iteration allocate");
+	_alloc_find<t_count_map>();
+	_alloc_find<t_count_ost>();
+}
+
+void map_allocation()
+{
+	load_subtest_(_map_allocation_rebind);
+	load_subtest_(_map_allocation_find);
+}
+
+} // namespace MapTest
+
+#endif
@@ -0,0 +1,125 @@
+#include "../includes/MapTest.hpp"
+#include "../includes/UnitTester.hpp"
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <vector>
+
+#if !STD
+
+namespace MapTest {
+
+/* find_many / lower_bound_many / count_many 의 결과를 key 하나씩 std::map 에 물어본 값과 비교한다.
+   key 가 정렬되어 있으면 앞 key 의 경로를 잇는 경로, 아니면 key 여러 개를 함께 내려가는 경로를 탄다.
+   함께 내려가는 key 수(16) 의 앞뒤 크기와 있는 / 없는 key, 중복 key 를 섞는다. */
+
+template <bool OrderStat>
+void _find_many_check(ft::map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >, OrderStat>& ft,
+                      const std::map<int, int>& std, const std::vector<int>& keys)
+{
+	typedef ft::map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >, OrderStat> t_map;
+	const t_map& cft = ft;
+
+	ft::vector<typename t_map::iterator>       found;
+	ft::vector<typename t_map::const_iterator> cfound;
+	ft::vector<typename t_map::iterator>       lower;
+	ft::vector<typename t_map::const_iterator> clower;
+	ft::vector<typename t_map::size_type>      counts;
+
+	ft.find_many(keys.begin(), keys.end(), found);
+	cft.find_many(keys.begin(), keys.end(), cfound);
+	ft.lower_bound_many(keys.begin(), keys.end(), lower);
+	cft.lower_bound_many(keys.begin(), keys.end(), clower);
+	cft.count_many(keys.begin(), keys.end(), counts);
+
+	UnitTester::assert_(found.size() == keys.size());
+	UnitTester::assert_(cfound.size() == keys.size());
+	UnitTester::assert_(lower.size() == keys.size());
+	UnitTester::assert_(clower.size() == keys.size());
+	UnitTester::assert_(counts.size() == keys.size());
+	for (size_t i = 0; i < keys.size(); ++i) {
+		std::map<int, int>::const_iterator its = std.find(keys[i]);
+		std::map<int, int>::const_iterator itl = std.lower_bound(keys[i]);
+
+		if (its == std.end()) {
+			UnitTester::assert_(found[i] == ft.end());
+			UnitTester::assert_(cfound[i] == cft.end());
+		} else {
+			UnitTester::assert_(found[i] != ft.end() && found[i]->first == its->first && found[i]->second == its->second);
+			UnitTester::assert_(cfound[i] == found[i]);
+		}
+		if (itl == std.end()) {
+			UnitTester::assert_(lower[i] == ft.end());
+		} else {
+			UnitTester::assert_(lower[i] != ft.end() && lower[i]->first == itl->first);
+		}
+		UnitTester::assert_(clower[i] == lower[i]);
+		UnitTester::assert_(counts[i] == std.count(keys[i]));
+	}
+}
+
+template <bool OrderStat>
+void _find_many_random(bool sorted)
+{
+	typedef ft::map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >, OrderStat> t_map;
+	int sizes[] = { 0, 1, 15, 16, 17, 100, 1000 };
+
+	for (int i = 0; i < 7; ++i) {
+		t_map              ft;
+		std::map<int, int> std;
+		int                range = 4 * sizes[i] + 2;
+
+		for (int j = 0; j < sizes[i]; ++j) {
+			int key = std::rand() % range;
+			int val = std::rand();
+
+			ft.insert(ft::make_pair(key, val));
+			std.insert(std::make_pair(key, val));
+		}
+		for (int j = 0; j < 7; ++j) {
+			std::vector<int> keys;
+
+			for (int k = 0; k < sizes[j]; ++k)
+				keys.push_back(std::rand() % (range + 2) - 1);
+			if (sorted)
+				std::sort(keys.begin(), keys.end());
+			else if (keys.size() > 1 && keys[0] <= keys[1])
+				std::swap(keys[0], keys[1]);
+			_find_many_check(ft, std, keys);
+		}
+	}
+}
+
+// -------------------------------------------------------------------------- //
+//                              batched lookup                                //
+// -------------------------------------------------------------------------- //
+
+void _map_find_many_sorted()
+{
+	set_explanation_("find_many / lower_bound_many / count_many on sorted keys differ from find / lower_bound / count");
+	_find_many_random<false>(true);
+}
+
+void _map_find_many_grouped()
+{
+	set_explanation_("find_many / lower_bound_many / count_many on unsorted keys differ from find / lower_bound / count");
+	_find_many_random<false>(false);
+}
+
+void _map_find_many_order_stat()
+{
+	set_explanation_("batched lookup on an order-statistic map differs from find / lower_bound / count");
+	_find_many_random<true>(true);
+	_find_many_random<true>(false);
+}
+
+void map_find_many()
+{
+	load_subtest_(_map_find_many_sorted);
+	load_subtest_(_map_find_many_grouped);
+	load_subtest_(_map_find_many_order_stat);
+}
+
+} // namespace MapTest
+
+#endif
@@ -0,0 +1,180 @@
+#include "../includes/MapTest.hpp"
+#include "../includes/UnitTester.hpp"
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+#if !STD
+#include "../../../../frozen_map.hpp"
+
+namespace MapTest {
+
+/* frozen_map 을 eytzinger / veb 두 layout 으로 만들어 크기 0 ~ 300 에서 std::map 과 비교한다.
+   key 는 짝수만 넣고 질의는 min - 2 ~ max + 2 의 모든 정수라 있는 key, 없는 key, 양 끝 밖을 모두 묻는다. */
+
+template <class Frozen>
+void _frozen_map_check(const Frozen& ft, const std::map<int, int>& std)
+{
+	typedef typename Frozen::const_iterator         t_iter;
+	typedef typename Frozen::const_reverse_iterator t_riter;
+	typedef std::map<int, int>::const_iterator      t_std_iter;
+
+	UnitTester::assert_(ft.size() == std.size());
+	UnitTester::assert_(ft.empty() == std.empty());
+
+	t_std_iter its = std.begin();
+	for (t_iter it = ft.begin(); it != ft.end(); ++it, ++its)
+		UnitTester::assert_(it->first == its->first && it->second == its->second);
+	UnitTester::assert_(its == std.end());
+
+	std::map<int, int>::const_reverse_iterator rits = std.rbegin();
+	for (t_riter rit = ft.rbegin(); rit != ft.rend(); ++rit, ++rits)
+		UnitTester::assert_(rit->first == rits->first && rit->second == rits->second);
+	UnitTester::assert_(rits == std.rend());
+
+	int lo = std.empty() ? 0 : std.begin()->first - 2;
+	int hi = std.empty() ? 2 : std.rbegin()->first + 2;
+	for (int key = lo; key <= hi; ++key) {
+		t_std_iter itf = std.find(key);
+		t_std_iter itl = std.lower_bound(key);
+		t_std_iter itu = std.upper_bound(key);
+
+		UnitTester::assert_(ft.count(key) == std.count(key));
+		UnitTester::assert_(itf == std.end() ? ft.find(key) == ft.end() : ft.find(key)->second == itf->second);
+		UnitTester::assert_(itl == std.end() ? ft.lower_bound(key) == ft.end() : ft.lower_bound(key)->first == itl->first);
+		UnitTester::assert_(itu == std.end() ? ft.upper_bound(key) == ft.end() : ft.upper_bound(key)->first == itu->first);
+		ft::pair<t_iter, t_iter> range = ft.equal_range(key);
+		UnitTester::assert_(range.first == ft.lower_bound(key) && range.second == ft.upper_bound(key));
+
+		/* at 은 예외가 비싸므로 몇 key 만 */
+		if (key % 7 != 0 && key != lo && key != hi)
+			continue;
+		bool thrown = false;
+		try {
+			UnitTester::assert_(ft.at(key) == itf->second);
+		} catch (std::out_of_range&) {
+			thrown = true;
+		}
+		UnitTester::assert_(thrown == (itf == std.end()));
+	}
+	if (!std.empty()) {
+		UnitTester::assert_(ft.lower_bound(std.rbegin()->first + 1) == ft.end());
+		UnitTester::assert_(ft.upper_bound(std.rbegin()->first) == ft.end());
+		UnitTester::assert_(ft.lower_bound(std.begin()->first - 1) == ft.begin());
+	}
+}
+
+template <class Layout>
+void _frozen_map_sizes()
+{
+	typedef ft::frozen_map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >, Layout> t_frozen;
+
+	for (int n = 0; n <= 300; ++n) {
+		std::vector<ft::pair<int, int> > sorted;
+		std::map<int, int>               std;
+		ft::map<int, int>                src;
+
+		for (int i = 0, k = 0; i < n; ++i) {
+			int val = std::rand();
+
+			k += 2 * (1 + std::rand() % 3);
+			sorted.push_back(ft::make_pair(k, val));
+			std.insert(std::make_pair(k, val));
+			src.insert(ft::make_pair(k, val));
+		}
+		_frozen_map_check(t_frozen(sorted.begin(), sorted.end()), std);
+		_frozen_map_check(t_frozen(src), std);
+	}
+}
+
+template <class Layout>
+void _frozen_map_reject()
+{
+	typedef ft::frozen_map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >, Layout> t_frozen;
+	std::vector<ft::pair<int, int> > unsorted;
+	std::vector<ft::pair<int, int> > duplicate;
+	int                              thrown = 0;
+
+	for (int i = 0; i < 10; ++i) {
+		unsorted.push_back(ft::make_pair(i == 7 ? 3 : i, i));
+		duplicate.push_back(ft::make_pair(i / 2 * 2 + (i == 5), i));
+	}
+	try { t_frozen m(unsorted.begin(), unsorted.end()); } catch (std::invalid_argument&) { ++thrown; }
+	/* key 만 같고 mapped 가 달라도 중복이다. */
+	try { t_frozen m(duplicate.begin(), duplicate.end()); } catch (std::invalid_argument&) { ++thrown; }
+	UnitTester::assert_(thrown == 2);
+
+	t_frozen ok(unsorted.begin(), unsorted.begin() + 7);
+	UnitTester::assert_(ok.size() == 7 && ok.at(6) == 6);
+}
+
+template <class Layout>
+void _frozen_map_swap()
+{
+	typedef ft::frozen_map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >, Layout> t_frozen;
+	ft::map<int, int> ma = _set_map(100, true);
+	ft::map<int, int> mb = _set_map(37, false);
+
+	t_frozen                          a(ma);
+	t_frozen                          b(mb);
+	typename t_frozen::const_iterator ia = a.find(42);
+	typename t_frozen::const_iterator ib = b.begin();
+	int                               va = ia->second;
+	int                               vb = ib->second;
+
+	a.swap(b);
+	/* 원소는 옮겨지지 않으므로 iterator 는 이제 상대 container 를 가리킨다. */
+	UnitTester::assert_(ia->first == 42 && ia->second == va && ib->second == vb);
+	UnitTester::assert_(ib == a.begin() && b.find(42) == ia);
+	UnitTester::assert_(std::distance(b.begin(), b.end()) == 100 && std::distance(a.begin(), a.end()) == 37);
+
+	ft::swap(a, b);
+	UnitTester::assert_(a.find(42) == ia && b.begin() == ib);
+	std::map<int, int> std_a;
+	for (ft::map<int, int>::iterator it = ma.begin(); it != ma.end(); ++it)
+		std_a.insert(std::make_pair(it->first, it->second));
+	_frozen_map_check(a, std_a);
+}
+
+// -------------------------------------------------------------------------- //
+//                                   frozen                                   //
+// -------------------------------------------------------------------------- //
+
+void _map_frozen_eytzinger()
+{
+	set_explanation_("frozen_map (eytzinger) of size 0 ~ 300 differs from std::map");
+	_frozen_map_sizes<ft::eytzinger_layout>();
+}
+
+void _map_frozen_veb()
+{
+	set_explanation_("frozen_map (veb) of size 0 ~ 300 differs from std::map");
+	_frozen_map_sizes<ft::veb_layout>();
+}
+
+void _map_frozen_reject()
+{
+	set_explanation_("frozen_map must throw std::invalid_argument on an unsorted or duplicated range");
+	_frozen_map_reject<ft::eytzinger_layout>();
+	_frozen_map_reject<ft::veb_layout>();
+}
+
+void _map_frozen_swap()
+{
+	set_explanation_("frozen_map iterators must stay valid across swap and follow the elements");
+	_frozen_map_swap<ft::eytzinger_layout>();
+	_frozen_map_swap<ft::veb_layout>();
+}
+
+void map_frozen()
+{
+	load_subtest_(_map_frozen_eytzinger);
+	load_subtest_(_map_frozen_veb);
+	load_subtest_(_map_frozen_reject);
+	load_subtest_(_map_frozen_swap);
+}
+
+} // namespace MapTest
+
+#endif
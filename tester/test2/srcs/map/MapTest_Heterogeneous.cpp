@@ -0,0 +1,152 @@
+#include "../includes/MapTest.hpp"
+#include "../includes/UnitTester.hpp"
+#include <iostream>
+#include <map>
+
+#if !STD
+#include "../../../../utils/counting_allocator.hpp"
+
+namespace MapTest {
+
+/* transparent 비교자를 쓰는 map 에 key_type 이 아닌 probe 로 find / count / lower_bound / upper_bound / equal_range / erase 를 한다.
+   key 는 생성될 때마다 (복사 포함) 수를 세고, probe 에서 key 로 가는 변환은 없으므로 heterogeneous overload 가 아니면 compile 되지 않는다.
+   질의 중에는 key 가 하나도 생기지 않고 할당도 없어야 하며, 결과는 같은 key 로 std::map 에 물은 것과 같아야 한다. */
+
+struct t_het_key
+{
+	static int constructed;
+	int        v;
+
+	t_het_key() : v(0) { ++constructed; }
+	explicit t_het_key(int x) : v(x) { ++constructed; }
+	t_het_key(const t_het_key& other) : v(other.v) { ++constructed; }
+};
+
+int t_het_key::constructed = 0;
+
+struct t_het_probe
+{
+	int v;
+
+	explicit t_het_probe(int x) : v(x) {}
+};
+
+struct t_het_less
+{
+	typedef void is_transparent;
+
+	bool operator()(const t_het_key& x, const t_het_key& y) const { return x.v < y.v; }
+	bool operator()(const t_het_key& x, const t_het_probe& y) const { return x.v < y.v; }
+	bool operator()(const t_het_probe& x, const t_het_key& y) const { return x.v < y.v; }
+};
+
+typedef ft::counting_allocator<ft::pair<const t_het_key, int> > t_het_alloc;
+typedef ft::map<t_het_key, int, t_het_less, t_het_alloc>        t_het_map;
+typedef ft::map<t_het_key, int, t_het_less, t_het_alloc, true>  t_het_counted;
+
+template <class Map>
+void _het_fill(Map& m, std::map<int, int>& std, int size)
+{
+	for (int i = 0; i < size; ++i) {
+		m.insert(ft::make_pair(t_het_key(3 * i), i));
+		std.insert(std::make_pair(3 * i, i));
+	}
+}
+
+/* ft 의 iterator 가 std 의 iterator 와 같은 원소(또는 둘 다 end) 를 가리키는지 */
+template <class Iter>
+bool _het_same(Iter it, Iter end, std::map<int, int>::const_iterator sit, std::map<int, int>::const_iterator send)
+{
+	if (it == end || sit == send)
+		return it == end && sit == send;
+	return it->first.v == sit->first && it->second == sit->second;
+}
+
+template <class Map>
+void _het_lookup()
+{
+	ft::allocation_stats stats;
+	Map                  m((t_het_less()), t_het_alloc(&stats));
+	std::map<int, int>   std;
+	const Map&           cm = m;
+
+	_het_fill(m, std, 200);
+	int           constructed = t_het_key::constructed;
+	unsigned long allocations = stats.snapshot().allocations;
+
+	for (int k = -2; k < 3 * 200 + 2; ++k) {
+		t_het_probe                        p(k);
+		std::map<int, int>::const_iterator lo = std.lower_bound(k);
+		std::map<int, int>::const_iterator hi = std.upper_bound(k);
+
+		UnitTester::assert_(_het_same(m.find(p), m.end(), std.find(k), std.end()));
+		UnitTester::assert_(_het_same(cm.find(p), cm.end(), std.find(k), std.end()));
+		UnitTester::assert_(m.count(p) == std.count(k));
+		UnitTester::assert_(_het_same(m.lower_bound(p), m.end(), lo, std.end()));
+		UnitTester::assert_(_het_same(cm.lower_bound(p), cm.end(), lo, std.end()));
+		UnitTester::assert_(_het_same(m.upper_bound(p), m.end(), hi, std.end()));
+		UnitTester::assert_(_het_same(cm.upper_bound(p), cm.end(), hi, std.end()));
+		UnitTester::assert_(_het_same(m.equal_range(p).first, m.end(), lo, std.end()));
+		UnitTester::assert_(_het_same(m.equal_range(p).second, m.end(), hi, std.end()));
+		UnitTester::assert_(_het_same(cm.equal_range(p).first, cm.end(), lo, std.end()));
+		UnitTester::assert_(_het_same(cm.equal_range(p).second, cm.end(), hi, std.end()));
+	}
+	UnitTester::assert_(t_het_key::constructed == constructed);
+	UnitTester::assert_(stats.snapshot().allocations == allocations);
+}
+
+template <class Map>
+void _het_erase()
+{
+	ft::allocation_stats stats;
+	std::map<int, int>   std;
+	{
+		Map m((t_het_less()), t_het_alloc(&stats));
+
+		_het_fill(m, std, 200);
+		int           constructed = t_het_key::constructed;
+		unsigned long allocations = stats.snapshot().allocations;
+		unsigned long freed       = stats.snapshot().deallocations;
+
+		for (int k = -1; k < 3 * 200 + 1; k += 2)
+			UnitTester::assert_(m.erase(t_het_probe(k)) == std.erase(k));
+		UnitTester::assert_(t_het_key::constructed == constructed);
+		UnitTester::assert_(stats.snapshot().allocations == allocations);
+		/* 지운 원소마다 노드 하나를 돌려준다. */
+		UnitTester::assert_(stats.snapshot().deallocations - freed == 200 - std.size());
+		UnitTester::assert_(m.stats().valid);
+		UnitTester::assert_(m.size() == std.size());
+		std::map<int, int>::const_iterator sit = std.begin();
+		for (typename Map::iterator it = m.begin(); it != m.end(); ++it, ++sit)
+			UnitTester::assert_(it->first.v == sit->first && it->second == sit->second);
+	}
+	UnitTester::assert_(stats.snapshot().live_bytes == 0);
+}
+
+// -------------------------------------------------------------------------- //
+//                               heterogeneous                                //
+// -------------------------------------------------------------------------- //
+
+void _map_heterogeneous_lookup()
+{
+	set_explanation_("lookup by a transparent probe differs from std::map, constructs a key or allocates");
+	_het_lookup<t_het_map>();
+	_het_lookup<t_het_counted>();
+}
+
+void _map_heterogeneous_erase()
+{
+	set_explanation_("erase by a transparent probe differs from std::map, constructs a key or allocates");
+	_het_erase<t_het_map>();
+	_het_erase<t_het_counted>();
+}
+
+void map_heterogeneous()
+{
+	load_subtest_(_map_heterogeneous_lookup);
+	load_subtest_(_map_heterogeneous_erase);
+}
+
+} // namespace MapTest
+
+#endif
@@ -0,0 +1,232 @@
+#include "../includes/MapTest.hpp"
+#include "../includes/UnitTester.hpp"
+#include <iostream>
+#include <map>
+
+#if !STD
+
+namespace MapTest {
+
+/* extract / insert(node_type) / merge 는 노드를 복사 없이 옮긴다. 매 단계 std::map 과 내용을 비교하고,
+   OrderStat 이면 sub-tree 크기가 맞는지 select / rank 로 확인한다. */
+
+template <bool OrderStat>
+void _node_check(const ft::map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >, OrderStat>& ft,
+                 const std::map<int, int>& std)
+{
+	typedef typename ft::map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >,
+	                         OrderStat>::const_iterator t_iter;
+
+	UnitTester::assert_(ft.stats().valid);
+	UnitTester::assert_(ft.size() == std.size());
+
+	size_t                             k   = 0;
+	std::map<int, int>::const_iterator its = std.begin();
+
+	for (t_iter it = ft.begin(); it != ft.end(); ++it, ++its, ++k) {
+		UnitTester::assert_(it->first == its->first && it->second == its->second);
+		UnitTester::assert_(ft.select(k) == it);
+		UnitTester::assert_(ft.rank(it->first) == k);
+	}
+	UnitTester::assert_(ft.select(k) == ft.end());
+}
+
+template <bool OrderStat>
+void _node_extract()
+{
+	typedef ft::map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >, OrderStat> t_map;
+	t_map              ft;
+	std::map<int, int> std;
+
+	for (int i = 0; i < 200; ++i) {
+		ft.insert(ft::make_pair(i * 2, i));
+		std.insert(std::make_pair(i * 2, i));
+	}
+
+	typename t_map::node_type nh = ft.extract(10);
+	UnitTester::assert_(!nh.empty() && nh.key() == 10 && nh.mapped() == 5);
+	std.erase(10);
+	_node_check(ft, std);
+
+	nh = ft.extract(11);
+	UnitTester::assert_(nh.empty());
+	_node_check(ft, std);
+
+	for (int i = 0; i < 50; ++i) {
+		typename t_map::iterator it = ft.select(std::rand() % ft.size());
+		int                      key = it->first;
+
+		nh = ft.extract(it);
+		UnitTester::assert_(!nh.empty() && nh.key() == key);
+		nh.mapped() = -key;
+		std.erase(key);
+		_node_check(ft, std);
+
+		/* 떼어낸 노드를 그대로 다시 넣으면 바꾼 mapped 가 보인다. */
+		typename t_map::insert_return_type ret = ft.insert(nh);
+		UnitTester::assert_(ret.inserted && ret.node.empty() && nh.empty());
+		UnitTester::assert_(ret.position->first == key && ret.position->second == -key);
+		std[key] = -key;
+		_node_check(ft, std);
+	}
+}
+
+template <bool OrderStat>
+void _node_reinsert()
+{
+	typedef ft::map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >, OrderStat> t_map;
+	t_map              src;
+	t_map              dst;
+	std::map<int, int> std_src;
+	std::map<int, int> std_dst;
+
+	for (int i = 0; i < 300; ++i) {
+		int key = std::rand() % 1000;
+
+		src.insert(ft::make_pair(key, i));
+		std_src.insert(std::make_pair(key, i));
+	}
+	for (int i = 0; i < 300 && !std_src.empty(); ++i) {
+		int                                 key = std::rand() % 1000;
+		typename t_map::node_type           nh  = src.extract(key);
+		std::map<int, int>::iterator        its = std_src.find(key);
+
+		UnitTester::assert_(nh.empty() == (its == std_src.end()));
+		if (nh.empty())
+			continue;
+		UnitTester::assert_(nh.mapped() == its->second);
+		std_dst.insert(*its);
+		std_src.erase(its);
+		if (i % 2) {
+			typename t_map::insert_return_type ret = dst.insert(nh);
+			UnitTester::assert_(ret.inserted && ret.position->first == key);
+		} else {
+			typename t_map::iterator it = dst.insert(dst.lower_bound(key), nh);
+			UnitTester::assert_(nh.empty() && it->first == key);
+		}
+		_node_check(src, std_src);
+		_node_check(dst, std_dst);
+	}
+}
+
+template <bool OrderStat>
+void _node_duplicate()
+{
+	typedef ft::map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >, OrderStat> t_map;
+	t_map              a;
+	t_map              b;
+	std::map<int, int> std_a;
+
+	for (int i = 0; i < 100; ++i) {
+		a.insert(ft::make_pair(i, i));
+		b.insert(ft::make_pair(i, -i));
+		std_a.insert(std::make_pair(i, i));
+	}
+
+	/* hint 없이 : 노드는 ret.node 로 돌아오고 a 는 그대로 */
+	typename t_map::node_type nh = b.extract(42);
+	typename t_map::insert_return_type ret = a.insert(nh);
+	UnitTester::assert_(!ret.inserted && ret.position == a.find(42));
+	UnitTester::assert_(!ret.node.empty() && ret.node.key() == 42 && ret.node.mapped() == -42);
+	_node_check(a, std_a);
+
+	/* hint 버전 : 실패하면 노드는 넘겨준 handle 에 남는다. */
+	nh = b.extract(7);
+	typename t_map::iterator it = a.insert(a.find(7), nh);
+	UnitTester::assert_(it == a.find(7) && it->second == 7);
+	UnitTester::assert_(!nh.empty() && nh.key() == 7 && nh.mapped() == -7);
+	it = a.insert(a.end(), nh);
+	UnitTester::assert_(it == a.find(7) && !nh.empty() && nh.mapped() == -7);
+	_node_check(a, std_a);
+
+	/* 남은 노드는 원래 map 으로 되돌릴 수 있다. */
+	it = b.insert(b.end(), nh);
+	UnitTester::assert_(nh.empty() && it->first == 7 && it->second == -7);
+	ret = b.insert(ret.node);
+	UnitTester::assert_(ret.inserted && ret.position->second == -42 && b.size() == 100);
+
+	/* 빈 handle */
+	typename t_map::node_type none;
+	UnitTester::assert_(a.insert(a.begin(), none) == a.end());
+	UnitTester::assert_(a.insert(none).position == a.end());
+	_node_check(a, std_a);
+}
+
+template <bool OrderStat>
+void _node_merge()
+{
+	typedef ft::map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >, OrderStat> t_map;
+
+	for (int round = 0; round < 20; ++round) {
+		t_map              dst;
+		t_map              src;
+		std::map<int, int> std_dst;
+		std::map<int, int> std_src;
+
+		for (int i = 0; i < round * 20; ++i) {
+			int key = std::rand() % (round * 30 + 1);
+
+			dst.insert(ft::make_pair(key, 1));
+			std_dst.insert(std::make_pair(key, 1));
+			key = std::rand() % (round * 30 + 1);
+			src.insert(ft::make_pair(key, 2));
+			std_src.insert(std::make_pair(key, 2));
+		}
+		dst.merge(src);
+
+		/* 겹치는 key 는 src 에 남고 dst 의 값은 바뀌지 않는다. */
+		std::map<int, int> left;
+		for (std::map<int, int>::iterator it = std_src.begin(); it != std_src.end(); ++it) {
+			if (std_dst.count(it->first))
+				left.insert(*it);
+			else
+				std_dst.insert(*it);
+		}
+		_node_check(dst, std_dst);
+		_node_check(src, left);
+	}
+}
+
+// -------------------------------------------------------------------------- //
+//                                node handle                                 //
+// -------------------------------------------------------------------------- //
+
+void _map_node_extract()
+{
+	set_explanation_("extract by key / iterator and reinsert differ from std::map or break subtree counts");
+	_node_extract<false>();
+	_node_extract<true>();
+}
+
+void _map_node_reinsert()
+{
+	set_explanation_("moving nodes into another map with insert(node) / insert(hint, node) differs from std::map");
+	_node_reinsert<false>();
+	_node_reinsert<true>();
+}
+
+void _map_node_duplicate()
+{
+	set_explanation_("insert(node) of a duplicate key must leave the map unchanged and hand the node back");
+	_node_duplicate<false>();
+	_node_duplicate<true>();
+}
+
+void _map_node_merge()
+{
+	set_explanation_("merge must move only missing keys and leave overlapping keys in the source");
+	_node_merge<false>();
+	_node_merge<true>();
+}
+
+void map_node_handle()
+{
+	load_subtest_(_map_node_extract);
+	load_subtest_(_map_node_reinsert);
+	load_subtest_(_map_node_duplicate);
+	load_subtest_(_map_node_merge);
+}
+
+} // namespace MapTest
+
+#endif
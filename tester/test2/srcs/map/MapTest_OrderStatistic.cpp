@@ -0,0 +1,173 @@
+#include "../includes/MapTest.hpp"
+#include "../includes/UnitTester.hpp"
+#include <iostream>
+#include <iterator>
+#include <map>
+
+#if !STD
+
+namespace MapTest {
+
+/* rank / select / count_range 와 iterator 의 distance / advance 를 std::map 에 std::distance 로 잰 값과 비교한다.
+   OrderStat 이면 O(log n) 경로, 아니면 순회 경로를 탄다. */
+
+template <bool OrderStat>
+void _order_stat_check(const ft::map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >, OrderStat>& ft,
+                       const std::map<int, int>& std, int range)
+{
+	typedef typename ft::map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >,
+	                         OrderStat>::const_iterator t_iter;
+
+	UnitTester::assert_(ft.stats().valid);
+	UnitTester::assert_(ft.size() == std.size());
+	UnitTester::assert_(static_cast<size_t>(std::distance(ft.begin(), ft.end())) == std.size());
+
+	for (int i = 0; i < 30; ++i) {
+		size_t k = std::rand() % (std.size() + 2);
+		t_iter it = ft.select(k);
+
+		if (k >= std.size()) {
+			UnitTester::assert_(it == ft.end());
+			continue;
+		}
+		std::map<int, int>::const_iterator its = std.begin();
+		std::advance(its, k);
+		UnitTester::assert_(it->first == its->first);
+		UnitTester::assert_(it->second == its->second);
+
+		t_iter adv = ft.begin();
+		std::advance(adv, k);
+		UnitTester::assert_(adv == it);
+		UnitTester::assert_(static_cast<size_t>(std::distance(ft.begin(), it)) == k);
+		UnitTester::assert_(static_cast<size_t>(std::distance(it, ft.end())) == std.size() - k);
+	}
+	for (int i = 0; i < 30; ++i) {
+		int lo = std::rand() % (range + 2) - 1;
+		int hi = std::rand() % (range + 2) - 1;
+		long std_lo = std::distance(std.begin(), std.lower_bound(lo));
+		long std_hi = std::distance(std.begin(), std.lower_bound(hi));
+
+		UnitTester::assert_(ft.rank(lo) == static_cast<size_t>(std_lo));
+		UnitTester::assert_(ft.count_range(lo, hi) == static_cast<size_t>(std_lo < std_hi ? std_hi - std_lo : 0));
+	}
+}
+
+template <bool OrderStat>
+void _order_stat_fill(ft::map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >, OrderStat>& ft,
+                      std::map<int, int>& std, int size, int range)
+{
+	for (int i = 0; i < size; ++i) {
+		int key   = std::rand() % range;
+		int value = std::rand();
+
+		ft.insert(ft::make_pair(key, value));
+		std.insert(std::make_pair(key, value));
+	}
+}
+
+template <bool OrderStat>
+void _order_stat_erase()
+{
+	typedef ft::map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >, OrderStat> t_map;
+	t_map                                                                                            ft;
+	std::map<int, int>                                                                               std;
+
+	_order_stat_fill(ft, std, 1000, 2000);
+	_order_stat_check(ft, std, 2000);
+	while (!std.empty()) {
+		for (int i = 0; i < 50 && !std.empty(); ++i) {
+			if (std::rand() % 2) {
+				int key = std::rand() % 2000;
+
+				UnitTester::assert_(ft.erase(key) == std.erase(key));
+			} else {
+				size_t                       k   = std::rand() % std.size();
+				std::map<int, int>::iterator its = std.begin();
+
+				std::advance(its, k);
+				ft.erase(ft.select(k));
+				std.erase(its);
+			}
+		}
+		_order_stat_check(ft, std, 2000);
+	}
+}
+
+template <bool OrderStat>
+void _order_stat_merge()
+{
+	typedef ft::map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >, OrderStat> t_map;
+	t_map                                                                                            ft;
+	std::map<int, int>                                                                               std;
+
+	for (int i = 0; i < 10; ++i) {
+		t_map              other;
+		std::map<int, int> std_other;
+
+		_order_stat_fill(other, std_other, 200, 3000);
+		ft.merge(other);
+		for (std::map<int, int>::iterator it = std_other.begin(); it != std_other.end();) {
+			if (std.insert(*it).second)
+				std_other.erase(it++);
+			else
+				++it;
+		}
+		_order_stat_check(ft, std, 3000);
+		_order_stat_check(other, std_other, 3000);
+	}
+}
+
+// -------------------------------------------------------------------------- //
+//                              order statistics                              //
+// -------------------------------------------------------------------------- //
+
+void _map_order_stat_erase()
+{
+	set_explanation_("rank / select / count_range / distance differ from std::map after erase");
+	_order_stat_erase<true>();
+	_order_stat_erase<false>();
+}
+
+void _map_order_stat_merge()
+{
+	set_explanation_("rank / select / count_range / distance differ from std::map after merge");
+	_order_stat_merge<true>();
+	_order_stat_merge<false>();
+}
+
+void _map_order_stat_iterator()
+{
+	set_explanation_("counted iterator arithmetic differs from std::distance");
+	typedef ft::map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >, true> t_map;
+	t_map                                                                                       ft;
+	std::map<int, int>                                                                          std;
+
+	_order_stat_fill(ft, std, 1000, 5000);
+	for (int i = 0; i < 200; ++i) {
+		long            a    = std::rand() % (std.size() + 1);
+		long            b    = std::rand() % (std.size() + 1);
+		t_map::iterator it_a = ft.begin() + a;
+		t_map::iterator it_b = ft.end() - (std.size() - b);
+
+		UnitTester::assert_(it_b - it_a == b - a);
+		UnitTester::assert_((it_a < it_b) == (a < b));
+		UnitTester::assert_(it_a + (b - a) == it_b);
+		if (a < static_cast<long>(std.size())) {
+			std::map<int, int>::iterator its = std.begin();
+
+			std::advance(its, a);
+			UnitTester::assert_(ft.begin()[a].first == its->first);
+		}
+	}
+}
+
+void map_order_stat()
+{
+	load_subtest_(_map_order_stat_erase);
+	load_subtest_(_map_order_stat_merge);
+	load_subtest_(_map_order_stat_iterator);
+}
+
+} // namespace MapTest
+
+#endif
@@ -0,0 +1,137 @@
+#include "../includes/MapTest.hpp"
+#include "../includes/UnitTester.hpp"
+#include <iostream>
+#include <map>
+#include <vector>
+
+#if !STD
+#include "../../../../persistent_map.hpp"
+
+namespace MapTest {
+
+typedef ft::persistent_map<int, int> t_persistent_map;
+
+bool _same_persistent(const t_persistent_map& ft, const std::map<int, int>& std)
+{
+	if (ft.size() != std.size())
+		return false;
+
+	t_persistent_map::const_iterator   it  = ft.begin();
+	std::map<int, int>::const_iterator its = std.begin();
+
+	for (; its != std.end(); ++it, ++its) {
+		if (it->first != its->first || it->second != its->second)
+			return false;
+	}
+	return it == ft.end();
+}
+
+void _persistent_random_write(t_persistent_map& ft, std::map<int, int>& std)
+{
+	int key   = std::rand() % 300;
+	int value = std::rand();
+
+	switch (std::rand() % 3) {
+	case 0:
+		ft.insert(ft::make_pair(key, value));
+		std.insert(std::make_pair(key, value));
+		break;
+	case 1:
+		ft.insert_or_assign(key, value);
+		std[key] = value;
+		break;
+	default:
+		ft.erase(key);
+		std.erase(key);
+	}
+}
+
+// -------------------------------------------------------------------------- //
+//                                  snapshot                                  //
+// -------------------------------------------------------------------------- //
+
+void _map_persistent_snapshot_unchanged()
+{
+	set_explanation_("snapshot changed after writes to the original");
+	t_persistent_map                ft;
+	std::map<int, int>              std;
+	std::vector<t_persistent_map>   snapshots;
+	std::vector<std::map<int, int> > expected;
+
+	for (int i = 0; i < 3000; ++i) {
+		_persistent_random_write(ft, std);
+		if (i % 100 == 0) {
+			snapshots.push_back(ft.snapshot());
+			expected.push_back(std);
+		}
+		if (i % 500 == 0) {
+			for (size_t j = 0; j < snapshots.size(); ++j)
+				UnitTester::assert_(_same_persistent(snapshots[j], expected[j]));
+		}
+	}
+	for (size_t j = 0; j < snapshots.size(); ++j)
+		UnitTester::assert_(_same_persistent(snapshots[j], expected[j]));
+	UnitTester::assert_(_same_persistent(ft, std));
+}
+
+void _map_persistent_snapshot_write()
+{
+	set_explanation_("writes to a snapshot are visible in the original");
+	t_persistent_map   ft;
+	std::map<int, int> std;
+
+	for (int i = 0; i < 500; ++i)
+		_persistent_random_write(ft, std);
+
+	t_persistent_map   snap     = ft.snapshot();
+	std::map<int, int> snap_std = std;
+
+	for (int i = 0; i < 1000; ++i)
+		_persistent_random_write(snap, snap_std);
+	UnitTester::assert_(_same_persistent(ft, std));
+	UnitTester::assert_(_same_persistent(snap, snap_std));
+}
+
+void _map_persistent_snapshot_released()
+{
+	set_explanation_("original changed after its snapshots were destroyed");
+	t_persistent_map   ft;
+	std::map<int, int> std;
+
+	for (int i = 0; i < 1000; ++i) {
+		_persistent_random_write(ft, std);
+		if (i % 10 == 0) {
+			t_persistent_map snap = ft.snapshot();
+			_persistent_random_write(ft, std);
+		}
+	}
+	UnitTester::assert_(_same_persistent(ft, std));
+}
+
+void _map_persistent_insert_position()
+{
+	set_explanation_("insert does not return the position of the key");
+	t_persistent_map ft;
+	t_persistent_map snap;
+
+	for (int i = 0; i < 200; ++i) {
+		if (i % 3 == 0)
+			snap = ft.snapshot();
+		t_persistent_map::const_iterator it = ft.insert(ft::make_pair(i, i)).first;
+		UnitTester::assert_(it->first == i);
+		UnitTester::assert_(++it == ft.end());
+		UnitTester::assert_((--it)->first == i);
+	}
+}
+
+void map_persistent()
+{
+	load_subtest_(_map_persistent_snapshot_unchanged);
+	load_subtest_(_map_persistent_snapshot_write);
+	load_subtest_(_map_persistent_snapshot_released);
+	load_subtest_(_map_persistent_insert_position);
+}
+
+} // namespace MapTest
+
+#endif
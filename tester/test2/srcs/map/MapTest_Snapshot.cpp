@@ -0,0 +1,177 @@
+#include "../includes/MapTest.hpp"
+#include "../includes/UnitTester.hpp"
+#include "../../../../set.hpp"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <unistd.h>
+
+#if !STD
+
+namespace MapTest {
+
+/* snapshot 을 임시 파일에 쓰고 버퍼로 읽어 restore 한다. 깨진 버퍼는 snapshot_error 를 던지고 map 은 그대로여야 한다. */
+
+typedef ft::map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >, true> t_snap_counted;
+
+template <class Container>
+void _snapshot_bytes(const Container& m, std::vector<char>& out)
+{
+	std::FILE* f  = std::tmpfile();
+	int        fd = fileno(f);
+
+	m.snapshot(fd);
+	off_t len = lseek(fd, 0, SEEK_END);
+	out.resize(len);
+	UnitTester::assert_(pread(fd, &out[0], len, 0) == len);
+	std::fclose(f);
+}
+
+template <class Map>
+bool _snapshot_rejected(Map& m, const void* data, size_t len)
+{
+	Map before(m);
+
+	try {
+		m.restore(data, len);
+	} catch (ft::snapshot_error&) {
+		UnitTester::assert_(m.stats().valid);
+		UnitTester::assert_(m == before);
+		return true;
+	}
+	return false;
+}
+
+template <class Map>
+void _snapshot_round_trip(int size)
+{
+	Map                m;
+	Map                back;
+	std::map<int, int> std;
+	std::vector<char>  buf;
+
+	for (int i = 0; i < size; ++i) {
+		int key = std::rand() % (4 * size + 1);
+
+		m.insert(ft::make_pair(key, i));
+		std.insert(std::make_pair(key, i));
+	}
+	back.insert(ft::make_pair(-1, -1));
+	_snapshot_bytes(m, buf);
+	back.restore(&buf[0], buf.size());
+	UnitTester::assert_(back.stats().valid);
+	UnitTester::assert_(back == m);
+	UnitTester::assert_(back.size() == std.size());
+	for (std::map<int, int>::iterator it = std.begin(); it != std.end(); ++it)
+		UnitTester::assert_(back.at(it->first) == it->second);
+	for (size_t k = 0; k < back.size(); k += 1 + back.size() / 8) {
+		typename Map::iterator it = back.begin();
+
+		std::advance(it, k);
+		UnitTester::assert_(back.select(k) == it);
+		UnitTester::assert_(back.rank(it->first) == k);
+	}
+	back.insert(ft::make_pair(4 * size + 5, 0));
+	UnitTester::assert_(back.stats().valid);
+}
+
+// -------------------------------------------------------------------------- //
+//                                  snapshot                                  //
+// -------------------------------------------------------------------------- //
+
+void _map_snapshot_round_trip()
+{
+	set_explanation_("restore(snapshot) must rebuild the same map");
+	int sizes[] = { 0, 1, 2, 3, 7, 100, 1000 };
+
+	for (int i = 0; i < 7; ++i) {
+		_snapshot_round_trip<ft::map<int, int> >(sizes[i]);
+		_snapshot_round_trip<t_snap_counted>(sizes[i]);
+	}
+}
+
+void _map_snapshot_corrupt()
+{
+	set_explanation_("restore of a corrupted snapshot must throw and leave the map untouched");
+	ft::map<int, int> m  = _set_map(100, false);
+	ft::map<int, int> to = _set_map(10, true);
+	std::vector<char> buf;
+
+	_snapshot_bytes(m, buf);
+	for (size_t i = 64; i < buf.size(); i += 37) {
+		std::vector<char> bad(buf);
+
+		bad[i] ^= 0x10;
+		UnitTester::assert_(_snapshot_rejected(to, &bad[0], bad.size()));
+	}
+	std::vector<char> bad(buf);
+	bad[0] = 'X';
+	UnitTester::assert_(_snapshot_rejected(to, &bad[0], bad.size()));
+}
+
+void _map_snapshot_kind()
+{
+	set_explanation_("restore of a set or vector snapshot into a map must throw");
+	ft::map<int, int> to = _set_map(10, true);
+	ft::set<int>      s;
+	ft::vector<int>   v(5, 1);
+	std::vector<char> buf;
+
+	s.insert(1);
+	_snapshot_bytes(s, buf);
+	UnitTester::assert_(_snapshot_rejected(to, &buf[0], buf.size()));
+
+	_snapshot_bytes(v, buf);
+	UnitTester::assert_(_snapshot_rejected(to, &buf[0], buf.size()));
+
+	/* 원소 layout 이 다른 map */
+	ft::map<int, long> wide;
+	wide.insert(ft::make_pair(1, 1L));
+	_snapshot_bytes(wide, buf);
+	UnitTester::assert_(_snapshot_rejected(to, &buf[0], buf.size()));
+}
+
+void _map_snapshot_truncated()
+{
+	set_explanation_("restore of a truncated snapshot must throw and leave the map untouched");
+	ft::map<int, int> m  = _set_map(50, false);
+	ft::map<int, int> to = _set_map(10, true);
+	std::vector<char> buf;
+
+	_snapshot_bytes(m, buf);
+	for (size_t len = 0; len < buf.size(); len += 13)
+		UnitTester::assert_(_snapshot_rejected(to, &buf[0], len));
+	UnitTester::assert_(_snapshot_rejected(to, &buf[0], buf.size() - 1));
+	UnitTester::assert_(_snapshot_rejected(to, NULL, 0));
+}
+
+void _map_snapshot_misaligned()
+{
+	set_explanation_("restore from a misaligned buffer must throw and leave the map untouched");
+	ft::map<int, int> m  = _set_map(50, false);
+	ft::map<int, int> to = _set_map(10, true);
+	std::vector<char> buf;
+
+	_snapshot_bytes(m, buf);
+	std::vector<char> shifted(buf.size() + 1);
+	std::memcpy(&shifted[1], &buf[0], buf.size());
+	UnitTester::assert_(_snapshot_rejected(to, &shifted[1], buf.size()));
+	std::memcpy(&shifted[0], &buf[0], buf.size());
+	to.restore(&shifted[0], buf.size());
+	UnitTester::assert_(to == m);
+}
+
+void map_snapshot()
+{
+	load_subtest_(_map_snapshot_round_trip);
+	load_subtest_(_map_snapshot_corrupt);
+	load_subtest_(_map_snapshot_kind);
+	load_subtest_(_map_snapshot_truncated);
+	load_subtest_(_map_snapshot_misaligned);
+}
+
+} // namespace MapTest
+
+#endif
@@ -0,0 +1,207 @@
+#include "../includes/MapTest.hpp"
+#include "../includes/UnitTester.hpp"
+#include <iostream>
+#include <map>
+#include <stdexcept>
+
+#if !STD
+#include "../../../../utils/counting_allocator.hpp"
+
+namespace MapTest {
+
+/* try_emplace / upsert / operator[] 를 생성 수를 세는 mapped_type 으로 확인한다.
+   key 가 있으면 (hit) mapped_type 은 만들어지지도 복사되지도 않고 할당도 없어야 하며, combine 은 hit 일 때만 불린다.
+   key 가 없으면 (miss) 노드 하나를 할당해 그 안에서 한 번만 생성한다. 복사 중에 던지면 노드를 돌려주고 map 은 그대로여야 한다. */
+
+struct t_emplace_val
+{
+	static int  constructed;
+	static bool throw_on_copy;
+	int         v;
+
+	t_emplace_val() : v(0) { ++constructed; }
+	explicit t_emplace_val(int x) : v(x) { ++constructed; }
+	t_emplace_val(const t_emplace_val& other) : v(other.v)
+	{
+		if (throw_on_copy)
+			throw std::runtime_error("t_emplace_val copy");
+		++constructed;
+	}
+};
+
+int  t_emplace_val::constructed   = 0;
+bool t_emplace_val::throw_on_copy = false;
+
+/* 불린 횟수를 세면서 기존 값에 더한다. */
+struct t_emplace_add
+{
+	int* calls;
+
+	explicit t_emplace_add(int* c) : calls(c) {}
+	void operator()(t_emplace_val& cur, const t_emplace_val& obj) const
+	{
+		++*calls;
+		cur.v += obj.v;
+	}
+};
+
+typedef ft::counting_allocator<ft::pair<const int, t_emplace_val> >  t_emplace_alloc;
+typedef ft::map<int, t_emplace_val, std::less<int>, t_emplace_alloc> t_emplace_map;
+
+/* 0, 2, 4, ... 2 * (size - 1) 에 v == key 인 원소 */
+void _emplace_fill(t_emplace_map& m, int size)
+{
+	for (int i = 0; i < size; ++i)
+		m.insert(ft::make_pair(2 * i, t_emplace_val(2 * i)));
+}
+
+// -------------------------------------------------------------------------- //
+//                                 try_emplace                                //
+// -------------------------------------------------------------------------- //
+
+void _map_try_emplace_hit_miss()
+{
+	set_explanation_("try_emplace constructs a mapped value on a hit or does not insert exactly once on a miss");
+	ft::allocation_stats stats;
+	t_emplace_map        m((std::less<int>()), t_emplace_alloc(&stats));
+	t_emplace_val        obj(-7);
+
+	_emplace_fill(m, 50);
+	for (int k = 0; k < 100; ++k) {
+		int           constructed = t_emplace_val::constructed;
+		unsigned long allocations = stats.snapshot().allocations;
+		size_t        size        = m.size();
+		bool          hit         = m.count(k) == 1;
+
+		ft::pair<t_emplace_map::iterator, bool> r = (k % 4 < 2) ? m.try_emplace(k) : m.try_emplace(k, obj);
+
+		UnitTester::assert_(r.second == !hit);
+		UnitTester::assert_(r.first != m.end() && r.first->first == k);
+		if (hit) {
+			UnitTester::assert_(t_emplace_val::constructed == constructed);
+			UnitTester::assert_(stats.snapshot().allocations == allocations);
+			UnitTester::assert_(m.size() == size);
+			UnitTester::assert_(r.first->second.v == k);
+		} else {
+			UnitTester::assert_(t_emplace_val::constructed == constructed + 1);
+			UnitTester::assert_(stats.snapshot().allocations == allocations + 1);
+			UnitTester::assert_(m.size() == size + 1);
+			UnitTester::assert_(r.first->second.v == ((k % 4 < 2) ? 0 : -7));
+		}
+	}
+	UnitTester::assert_(m.stats().valid);
+	UnitTester::assert_(m.size() == 100);
+}
+
+void _map_try_emplace_subscript()
+{
+	set_explanation_("operator[] constructs a mapped value on a hit");
+	ft::allocation_stats stats;
+	t_emplace_map        m((std::less<int>()), t_emplace_alloc(&stats));
+
+	_emplace_fill(m, 50);
+	int           constructed = t_emplace_val::constructed;
+	unsigned long allocations = stats.snapshot().allocations;
+
+	for (int i = 0; i < 50; ++i)
+		UnitTester::assert_(m[2 * i].v == 2 * i);
+	UnitTester::assert_(t_emplace_val::constructed == constructed);
+	UnitTester::assert_(stats.snapshot().allocations == allocations);
+
+	UnitTester::assert_(m[1].v == 0);
+	UnitTester::assert_(t_emplace_val::constructed == constructed + 1);
+	UnitTester::assert_(stats.snapshot().allocations == allocations + 1);
+}
+
+// -------------------------------------------------------------------------- //
+//                                   upsert                                   //
+// -------------------------------------------------------------------------- //
+
+void _map_upsert_hit_miss()
+{
+	set_explanation_("upsert differs from std::map or calls combine on a miss");
+	ft::allocation_stats stats;
+	t_emplace_map        m((std::less<int>()), t_emplace_alloc(&stats));
+	std::map<int, int>   std;
+	int                  calls = 0;
+
+	_emplace_fill(m, 50);
+	for (int i = 0; i < 50; ++i)
+		std[2 * i] = 2 * i;
+	for (int k = 0; k < 100; ++k) {
+		t_emplace_val obj(k + 1000);
+		int           constructed = t_emplace_val::constructed;
+		unsigned long allocations = stats.snapshot().allocations;
+		int           before      = calls;
+		bool          hit         = std.count(k) == 1;
+
+		ft::pair<t_emplace_map::iterator, bool> r = m.upsert(k, obj, t_emplace_add(&calls));
+		std[k] += k + 1000;
+
+		UnitTester::assert_(r.second == !hit);
+		UnitTester::assert_(r.first->first == k && r.first->second.v == std[k]);
+		UnitTester::assert_(calls == before + (hit ? 1 : 0));
+		UnitTester::assert_(t_emplace_val::constructed == constructed + (hit ? 0 : 1));
+		UnitTester::assert_(stats.snapshot().allocations == allocations + (hit ? 0 : 1));
+	}
+	UnitTester::assert_(calls == 50);
+	UnitTester::assert_(m.stats().valid);
+	UnitTester::assert_(m.size() == std.size());
+	std::map<int, int>::iterator sit = std.begin();
+	for (t_emplace_map::iterator it = m.begin(); it != m.end(); ++it, ++sit)
+		UnitTester::assert_(it->first == sit->first && it->second.v == sit->second);
+}
+
+// -------------------------------------------------------------------------- //
+//                                  exception                                 //
+// -------------------------------------------------------------------------- //
+
+void _map_try_emplace_throw()
+{
+	set_explanation_("a throwing mapped copy changes the map or leaks a node");
+	ft::allocation_stats stats;
+	t_emplace_map        m((std::less<int>()), t_emplace_alloc(&stats));
+	t_emplace_val        obj(5);
+	int                  calls = 0;
+
+	_emplace_fill(m, 50);
+	ft::allocation_stats before = stats.snapshot();
+
+	t_emplace_val::throw_on_copy = true;
+	for (int k = 1; k < 100; k += 2) {
+		bool threw = false;
+		try {
+			if (k % 4 == 1)
+				m.try_emplace(k, obj);
+			else
+				m.upsert(k, obj, t_emplace_add(&calls));
+		} catch (std::runtime_error&) {
+			threw = true;
+		}
+		UnitTester::assert_(threw);
+		UnitTester::assert_(m.count(k) == 0);
+	}
+	/* hit 은 아무것도 복사하지 않으므로 던지지 않는다. */
+	UnitTester::assert_(!m.try_emplace(0, obj).second);
+	UnitTester::assert_(!m.upsert(2, obj, t_emplace_add(&calls)).second);
+	t_emplace_val::throw_on_copy = false;
+
+	ft::allocation_stats after = stats.snapshot();
+	UnitTester::assert_(calls == 1 && m[2].v == 7);
+	UnitTester::assert_(m.size() == 50);
+	UnitTester::assert_(m.stats().valid);
+	UnitTester::assert_(after.live_bytes == before.live_bytes);
+	UnitTester::assert_(after.allocations - before.allocations == after.deallocations - before.deallocations);
+}
+
+void map_try_emplace()
+{
+	load_subtest_(_map_try_emplace_hit_miss);
+	load_subtest_(_map_try_emplace_subscript);
+	load_subtest_(_map_upsert_hit_miss);
+	load_subtest_(_map_try_emplace_throw);
+}
+
+} // namespace MapTest
+
+#endif
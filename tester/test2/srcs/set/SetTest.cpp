@@ -53,6 +53,16 @@ t_unit_tests func_test_table[] = {
 	{	     "set_operator_g",          set_operator_g, FAIL, SET},
 	{	    "set_operator_ge",         set_operator_ge, FAIL, SET},
     {            "set_ft_swap",             set_ft_swap, FAIL, SET},
+#if !STD
+ // ----------------------------- Extensions ----------------------------- //
+	{	        "set_algebra",             set_algebra, FAIL, SET},
+	{	     "set_order_stat",          set_order_stat, FAIL, SET},
+	{	    "set_node_handle",         set_node_handle, FAIL, SET},
+	{	       "set_snapshot",            set_snapshot, FAIL, SET},
+	{	         "set_frozen",              set_frozen, FAIL, SET},
+	{	  "set_heterogeneous",       set_heterogeneous, FAIL, SET},
+	{	     "set_allocation",          set_allocation, FAIL, SET},
+#endif
  // ------------------- Terminater (Do not comment out) ------------------ //
 	{	                 "\0",	                NULL, FAIL, SET}
 };
@@ -0,0 +1,158 @@
+#include "../includes/SetTest.hpp"
+#include "../includes/UnitTester.hpp"
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <set>
+
+#if !STD
+
+namespace SetTest {
+
+/* set algebra 는 *this 를 결과로 만들고 other 를 비운다. 결과는 std::set_* 로 만든 std::set 과 비교한다. */
+
+enum e_algebra
+{
+	ALGEBRA_UNION,
+	ALGEBRA_INTERSECTION,
+	ALGEBRA_DIFFERENCE
+};
+
+template <bool OrderStat>
+void _algebra_fill(ft::set<int, std::less<int>, std::allocator<int>, OrderStat>& ft, std::set<int>& std,
+                   int size, int range)
+{
+	for (int i = 0; i < size; ++i) {
+		int val = std::rand() % range;
+
+		ft.insert(val);
+		std.insert(val);
+	}
+}
+
+template <bool OrderStat>
+void _algebra_apply(ft::set<int, std::less<int>, std::allocator<int>, OrderStat>& ft,
+                    ft::set<int, std::less<int>, std::allocator<int>, OrderStat>& ft_other,
+                    std::set<int>& std, const std::set<int>& std_other, e_algebra op)
+{
+	std::set<int> result;
+
+	switch (op) {
+	case ALGEBRA_UNION:
+		ft.set_union(ft_other);
+		std::set_union(std.begin(), std.end(), std_other.begin(), std_other.end(),
+		               std::inserter(result, result.end()));
+		break;
+	case ALGEBRA_INTERSECTION:
+		ft.set_intersection(ft_other);
+		std::set_intersection(std.begin(), std.end(), std_other.begin(), std_other.end(),
+		                      std::inserter(result, result.end()));
+		break;
+	case ALGEBRA_DIFFERENCE:
+		ft.set_difference(ft_other);
+		std::set_difference(std.begin(), std.end(), std_other.begin(), std_other.end(),
+		                    std::inserter(result, result.end()));
+		break;
+	}
+	std.swap(result);
+
+	UnitTester::assert_(ft.stats().valid);
+	UnitTester::assert_(ft_other.empty());
+	UnitTester::assert_(ft_other.stats().valid);
+	UnitTester::assert_(ft.size() == std.size());
+	UnitTester::assert_(std::equal(ft.begin(), ft.end(), std.begin()));
+	UnitTester::assert_(ft.empty() || *ft.rbegin() == *std.rbegin());
+}
+
+/* 크기가 비슷한 경우, 한쪽이 훨씬 작은 경우, 빈 경우를 섞어 op 를 여러 번 한다. */
+template <bool OrderStat>
+void _algebra_random(e_algebra op)
+{
+	typedef ft::set<int, std::less<int>, std::allocator<int>, OrderStat> t_set;
+	int sizes[] = { 0, 1, 7, 100, 1000 };
+
+	for (int i = 0; i < 5; ++i) {
+		for (int j = 0; j < 5; ++j) {
+			t_set         ft;
+			t_set         ft_other;
+			std::set<int> std;
+			std::set<int> std_other;
+
+			_algebra_fill(ft, std, sizes[i], 2 * sizes[i] + 2 * sizes[j] + 1);
+			_algebra_fill(ft_other, std_other, sizes[j], 2 * sizes[i] + 2 * sizes[j] + 1);
+			_algebra_apply(ft, ft_other, std, std_other, op);
+		}
+	}
+}
+
+/* 하나의 set 에 무작위 op 를 이어서 하고, 결과가 다음 op 의 입력이 된다. */
+template <bool OrderStat>
+void _algebra_chain()
+{
+	typedef ft::set<int, std::less<int>, std::allocator<int>, OrderStat> t_set;
+	t_set         ft;
+	std::set<int> std;
+
+	_algebra_fill(ft, std, 500, 2000);
+	for (int i = 0; i < 200; ++i) {
+		t_set         ft_other;
+		std::set<int> std_other;
+
+		_algebra_fill(ft_other, std_other, std::rand() % 600, 2000);
+		_algebra_apply(ft, ft_other, std, std_other, static_cast<e_algebra>(std::rand() % 3));
+		if (ft.size() < 100) {
+			_algebra_fill(ft, std, 400, 2000);
+			UnitTester::assert_(ft.stats().valid);
+		}
+	}
+}
+
+// -------------------------------------------------------------------------- //
+//                                set algebra                                 //
+// -------------------------------------------------------------------------- //
+
+void _set_algebra_union()
+{
+	set_explanation_("set_union result differs from std::set_union");
+	_algebra_random<false>(ALGEBRA_UNION);
+}
+
+void _set_algebra_intersection()
+{
+	set_explanation_("set_intersection result differs from std::set_intersection");
+	_algebra_random<false>(ALGEBRA_INTERSECTION);
+}
+
+void _set_algebra_difference()
+{
+	set_explanation_("set_difference result differs from std::set_difference");
+	_algebra_random<false>(ALGEBRA_DIFFERENCE);
+}
+
+void _set_algebra_chain()
+{
+	set_explanation_("chained set algebra differs from std::set_*");
+	_algebra_chain<false>();
+}
+
+void _set_algebra_order_stat()
+{
+	set_explanation_("set algebra on an order-statistic set differs from std::set_* or breaks subtree counts");
+	_algebra_random<true>(ALGEBRA_UNION);
+	_algebra_random<true>(ALGEBRA_INTERSECTION);
+	_algebra_random<true>(ALGEBRA_DIFFERENCE);
+	_algebra_chain<true>();
+}
+
+void set_algebra()
+{
+	load_subtest_(_set_algebra_union);
+	load_subtest_(_set_algebra_intersection);
+	load_subtest_(_set_algebra_difference);
+	load_subtest_(_set_algebra_chain);
+	load_subtest_(_set_algebra_order_stat);
+}
+
+} // namespace SetTest
+
+#endif
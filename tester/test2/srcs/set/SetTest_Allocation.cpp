@@ -0,0 +1,111 @@
+#include "../includes/SetTest.hpp"
+#include "../includes/UnitTester.hpp"
+#include <iostream>
+#include <set>
+
+#if !STD
+#include "../../../../utils/counting_allocator.hpp"
+
+namespace SetTest {
+
+/* map 쪽(MapTest_Allocation) 과 같은 확인을 set 으로 한다. rebind 한 노드 할당이 넘긴 allocator 의 stats 에 모이고,
+   원소 하나에 노드 하나, 찾기와 중복 insert 는 할당 없음. */
+
+typedef ft::counting_allocator<int>                       t_count_alloc;
+typedef ft::set<int, std::less<int>, t_count_alloc>       t_count_set;
+typedef ft::set<int, std::less<int>, t_count_alloc, true> t_count_ost;
+
+// -------------------------------------------------------------------------- //
+//                                 allocation                                 //
+// -------------------------------------------------------------------------- //
+
+template <class Set>
+void _alloc_rebind()
+{
+	ft::allocation_stats stats;
+	{
+		Set           s((std::less<int>()), t_count_alloc(&stats));
+		unsigned long empty = stats.snapshot().allocations;
+
+		for (int i = 0; i < 100; ++i)
+			s.insert(i);
+		ft::allocation_stats snap = stats.snapshot();
+
+		UnitTester::assert_(snap.allocations - empty == 100);
+		UnitTester::assert_(snap.bytes_allocated / snap.allocations > sizeof(int));
+		UnitTester::assert_(stats.live_blocks() == snap.allocations);
+
+		for (int i = 0; i < 100; ++i)
+			UnitTester::assert_(!s.insert(i).second);
+		UnitTester::assert_(stats.snapshot().allocations == snap.allocations);
+
+		{
+			Set copy(s);
+
+			UnitTester::assert_(stats.snapshot().allocations - snap.allocations == snap.allocations);
+			UnitTester::assert_(copy == s);
+		}
+		UnitTester::assert_(stats.snapshot().live_bytes == snap.live_bytes);
+
+		/* 지운 원소마다 노드 하나를 돌려준다. */
+		unsigned long freed = stats.snapshot().deallocations;
+		for (int i = 0; i < 100; i += 2)
+			s.erase(i);
+		UnitTester::assert_(stats.snapshot().deallocations - freed == 50);
+		s.clear();
+		UnitTester::assert_(s.empty());
+	}
+	UnitTester::assert_(stats.snapshot().live_bytes == 0);
+	UnitTester::assert_(stats.live_blocks() == 0);
+}
+
+void _set_allocation_rebind()
+{
+	set_explanation_("node allocations do not reach the allocator's stats through rebind, or leak");
+	_alloc_rebind<t_count_set>();
+	_alloc_rebind<t_count_ost>();
+}
+
+template <class Set>
+void _alloc_find()
+{
+	ft::allocation_stats stats;
+	Set                  s((std::less<int>()), t_count_alloc(&stats));
+
+	for (int i = 0; i < 500; ++i)
+		s.insert(2 * i);
+	ft::allocation_stats before = stats.snapshot();
+
+	for (int k = -1; k < 1001; ++k) {
+		UnitTester::assert_((s.find(k) != s.end()) == (k >= 0 && k < 1000 && k % 2 == 0));
+		UnitTester::assert_(s.count(k) == static_cast<size_t>(k >= 0 && k < 1000 && k % 2 == 0));
+		s.lower_bound(k);
+		s.upper_bound(k);
+		s.equal_range(k);
+	}
+	long sum = 0;
+	for (typename Set::iterator it = s.begin(); it != s.end(); ++it)
+		sum += *it;
+	UnitTester::assert_(sum == 499L * 500L);
+
+	ft::allocation_stats after = stats.snapshot();
+	UnitTester::assert_(after.allocations == before.allocations);
+	UnitTester::assert_(after.deallocations == before.deallocations);
+}
+
+void _set_allocation_find()
+{
+	set_explanation_("set::find / count / bounds / iteration allocate");
+	_alloc_find<t_count_set>();
+	_alloc_find<t_count_ost>();
+}
+
+void set_allocation()
+{
+	load_subtest_(_set_allocation_rebind);
+	load_subtest_(_set_allocation_find);
+}
+
+} // namespace SetTest
+
+#endif
@@ -0,0 +1,170 @@
+#include "../includes/SetTest.hpp"
+#include "../includes/UnitTester.hpp"
+#include <iostream>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+#if !STD
+#include "../../../../frozen_set.hpp"
+
+namespace SetTest {
+
+/* frozen_set 을 eytzinger / veb 두 layout 으로 만들어 크기 0 ~ 300 에서 std::set 과 비교한다.
+   원소는 짝수만 넣고 질의는 min - 2 ~ max + 2 의 모든 정수라 있는 값, 없는 값, 양 끝 밖을 모두 묻는다. */
+
+template <class Frozen>
+void _frozen_set_check(const Frozen& ft, const std::set<int>& std)
+{
+	typedef typename Frozen::const_iterator         t_iter;
+	typedef typename Frozen::const_reverse_iterator t_riter;
+
+	UnitTester::assert_(ft.size() == std.size());
+	UnitTester::assert_(ft.empty() == std.empty());
+	UnitTester::assert_(std::equal(ft.begin(), ft.end(), std.begin()));
+
+	std::set<int>::const_reverse_iterator rits = std.rbegin();
+	for (t_riter rit = ft.rbegin(); rit != ft.rend(); ++rit, ++rits)
+		UnitTester::assert_(*rit == *rits);
+	UnitTester::assert_(rits == std.rend());
+
+	/* end() 에서 하나씩 뒤로 */
+	t_iter it = ft.end();
+	for (std::set<int>::const_reverse_iterator r = std.rbegin(); r != std.rend(); ++r)
+		UnitTester::assert_(*--it == *r);
+	UnitTester::assert_(it == ft.begin());
+
+	int lo = std.empty() ? 0 : *std.begin() - 2;
+	int hi = std.empty() ? 2 : *std.rbegin() + 2;
+	for (int key = lo; key <= hi; ++key) {
+		std::set<int>::const_iterator its = std.find(key);
+		std::set<int>::const_iterator itl = std.lower_bound(key);
+		std::set<int>::const_iterator itu = std.upper_bound(key);
+
+		UnitTester::assert_(ft.count(key) == std.count(key));
+		UnitTester::assert_(its == std.end() ? ft.find(key) == ft.end() : *ft.find(key) == *its);
+		UnitTester::assert_(itl == std.end() ? ft.lower_bound(key) == ft.end() : *ft.lower_bound(key) == *itl);
+		UnitTester::assert_(itu == std.end() ? ft.upper_bound(key) == ft.end() : *ft.upper_bound(key) == *itu);
+		ft::pair<t_iter, t_iter> range = ft.equal_range(key);
+		UnitTester::assert_(range.first == ft.lower_bound(key) && range.second == ft.upper_bound(key));
+	}
+	if (!std.empty()) {
+		UnitTester::assert_(ft.lower_bound(*std.rbegin() + 1) == ft.end());
+		UnitTester::assert_(ft.upper_bound(*std.rbegin()) == ft.end());
+		UnitTester::assert_(ft.lower_bound(*std.begin() - 1) == ft.begin());
+	}
+}
+
+template <class Layout>
+void _frozen_set_sizes()
+{
+	typedef ft::frozen_set<int, std::less<int>, std::allocator<int>, Layout> t_frozen;
+
+	for (int n = 0; n <= 300; ++n) {
+		std::vector<int> sorted;
+		std::set<int>    std;
+		ft::set<int>     src;
+
+		for (int i = 0, v = 0; i < n; ++i) {
+			v += 2 * (1 + std::rand() % 3);
+			sorted.push_back(v);
+			std.insert(v);
+			src.insert(v);
+		}
+		_frozen_set_check(t_frozen(sorted.begin(), sorted.end()), std);
+		_frozen_set_check(t_frozen(src), std);
+	}
+}
+
+template <class Layout>
+void _frozen_set_reject()
+{
+	typedef ft::frozen_set<int, std::less<int>, std::allocator<int>, Layout> t_frozen;
+	int unsorted[]  = { 1, 2, 3, 5, 4, 6 };
+	int duplicate[] = { 1, 2, 3, 3, 4 };
+	int desc[]      = { 9, 7, 5, 3 };
+	int thrown      = 0;
+
+	try { t_frozen s(unsorted, unsorted + 6); } catch (std::invalid_argument&) { ++thrown; }
+	try { t_frozen s(duplicate, duplicate + 5); } catch (std::invalid_argument&) { ++thrown; }
+	try { t_frozen s(desc, desc + 4); } catch (std::invalid_argument&) { ++thrown; }
+	try { t_frozen s(duplicate + 2, duplicate + 4); } catch (std::invalid_argument&) { ++thrown; }
+	UnitTester::assert_(thrown == 4);
+
+	/* 비교자 순서대로면 받는다. */
+	ft::frozen_set<int, std::greater<int>, std::allocator<int>, Layout> g(desc, desc + 4);
+	UnitTester::assert_(g.size() == 4 && *g.begin() == 9 && *g.rbegin() == 3 && g.count(5) && !g.count(4));
+}
+
+template <class Layout>
+void _frozen_set_swap()
+{
+	typedef ft::frozen_set<int, std::less<int>, std::allocator<int>, Layout> t_frozen;
+	std::vector<int> va;
+	std::vector<int> vb;
+
+	for (int i = 0; i < 100; ++i)
+		va.push_back(i);
+	for (int i = 0; i < 37; ++i)
+		vb.push_back(1000 + i * 3);
+
+	t_frozen                         a(va.begin(), va.end());
+	t_frozen                         b(vb.begin(), vb.end());
+	typename t_frozen::const_iterator ia = a.find(42);
+	typename t_frozen::const_iterator ib = b.begin();
+	typename t_frozen::const_iterator ea = a.end();
+
+	a.swap(b);
+	/* 원소는 옮겨지지 않으므로 iterator 는 이제 상대 container 를 가리킨다. */
+	UnitTester::assert_(*ia == 42 && *ib == 1000);
+	UnitTester::assert_(std::distance(ia, b.end()) == 58 && ea == b.end());
+	UnitTester::assert_(std::distance(ib, a.end()) == 37 && ib == a.begin());
+	UnitTester::assert_(*--b.end() == 99 && *--ia == 41);
+
+	ft::swap(a, b);
+	UnitTester::assert_(a.size() == 100 && b.size() == 37 && a.find(41) == ia);
+	std::set<int> std_a(va.begin(), va.end());
+	_frozen_set_check(a, std_a);
+}
+
+// -------------------------------------------------------------------------- //
+//                                   frozen                                   //
+// -------------------------------------------------------------------------- //
+
+void _set_frozen_eytzinger()
+{
+	set_explanation_("frozen_set (eytzinger) of size 0 ~ 300 differs from std::set");
+	_frozen_set_sizes<ft::eytzinger_layout>();
+}
+
+void _set_frozen_veb()
+{
+	set_explanation_("frozen_set (veb) of size 0 ~ 300 differs from std::set");
+	_frozen_set_sizes<ft::veb_layout>();
+}
+
+void _set_frozen_reject()
+{
+	set_explanation_("frozen_set must throw std::invalid_argument on an unsorted or duplicated range");
+	_frozen_set_reject<ft::eytzinger_layout>();
+	_frozen_set_reject<ft::veb_layout>();
+}
+
+void _set_frozen_swap()
+{
+	set_explanation_("frozen_set iterators must stay valid across swap and follow the elements");
+	_frozen_set_swap<ft::eytzinger_layout>();
+	_frozen_set_swap<ft::veb_layout>();
+}
+
+void set_frozen()
+{
+	load_subtest_(_set_frozen_eytzinger);
+	load_subtest_(_set_frozen_veb);
+	load_subtest_(_set_frozen_reject);
+	load_subtest_(_set_frozen_swap);
+}
+
+} // namespace SetTest
+
+#endif
@@ -0,0 +1,143 @@
+#include "../includes/SetTest.hpp"
+#include "../includes/UnitTester.hpp"
+#include <iostream>
+#include <set>
+
+#if !STD
+#include "../../../../utils/counting_allocator.hpp"
+
+namespace SetTest {
+
+/* map 쪽(MapTest_Heterogeneous) 과 같은 확인을 set 으로 한다. 원소는 생성 수를 세는 key, 질의는 변환되지 않는 probe 로 하고
+   질의 중에 원소가 생기거나 할당이 있으면 안 된다. */
+
+struct t_het_key
+{
+	static int constructed;
+	int        v;
+
+	t_het_key() : v(0) { ++constructed; }
+	explicit t_het_key(int x) : v(x) { ++constructed; }
+	t_het_key(const t_het_key& other) : v(other.v) { ++constructed; }
+};
+
+int t_het_key::constructed = 0;
+
+struct t_het_probe
+{
+	int v;
+
+	explicit t_het_probe(int x) : v(x) {}
+};
+
+struct t_het_less
+{
+	typedef void is_transparent;
+
+	bool operator()(const t_het_key& x, const t_het_key& y) const { return x.v < y.v; }
+	bool operator()(const t_het_key& x, const t_het_probe& y) const { return x.v < y.v; }
+	bool operator()(const t_het_probe& x, const t_het_key& y) const { return x.v < y.v; }
+};
+
+typedef ft::counting_allocator<t_het_key>                t_het_alloc;
+typedef ft::set<t_het_key, t_het_less, t_het_alloc>       t_het_set;
+typedef ft::set<t_het_key, t_het_less, t_het_alloc, true> t_het_counted;
+
+template <class Set>
+void _het_fill(Set& s, std::set<int>& std, int size)
+{
+	for (int i = 0; i < size; ++i) {
+		s.insert(t_het_key(3 * i));
+		std.insert(3 * i);
+	}
+}
+
+template <class Iter>
+bool _het_same(Iter it, Iter end, std::set<int>::const_iterator sit, std::set<int>::const_iterator send)
+{
+	if (it == end || sit == send)
+		return it == end && sit == send;
+	return it->v == *sit;
+}
+
+template <class Set>
+void _het_lookup()
+{
+	ft::allocation_stats stats;
+	Set                  s((t_het_less()), t_het_alloc(&stats));
+	std::set<int>        std;
+
+	_het_fill(s, std, 200);
+	int           constructed = t_het_key::constructed;
+	unsigned long allocations = stats.snapshot().allocations;
+
+	for (int k = -2; k < 3 * 200 + 2; ++k) {
+		t_het_probe                   p(k);
+		std::set<int>::const_iterator lo = std.lower_bound(k);
+		std::set<int>::const_iterator hi = std.upper_bound(k);
+
+		UnitTester::assert_(_het_same(s.find(p), s.end(), std.find(k), std.end()));
+		UnitTester::assert_(s.count(p) == std.count(k));
+		UnitTester::assert_(_het_same(s.lower_bound(p), s.end(), lo, std.end()));
+		UnitTester::assert_(_het_same(s.upper_bound(p), s.end(), hi, std.end()));
+		UnitTester::assert_(_het_same(s.equal_range(p).first, s.end(), lo, std.end()));
+		UnitTester::assert_(_het_same(s.equal_range(p).second, s.end(), hi, std.end()));
+	}
+	UnitTester::assert_(t_het_key::constructed == constructed);
+	UnitTester::assert_(stats.snapshot().allocations == allocations);
+}
+
+template <class Set>
+void _het_erase()
+{
+	ft::allocation_stats stats;
+	std::set<int>        std;
+	{
+		Set s((t_het_less()), t_het_alloc(&stats));
+
+		_het_fill(s, std, 200);
+		int           constructed = t_het_key::constructed;
+		unsigned long allocations = stats.snapshot().allocations;
+		unsigned long freed       = stats.snapshot().deallocations;
+
+		for (int k = -1; k < 3 * 200 + 1; k += 2)
+			UnitTester::assert_(s.erase(t_het_probe(k)) == std.erase(k));
+		UnitTester::assert_(t_het_key::constructed == constructed);
+		UnitTester::assert_(stats.snapshot().allocations == allocations);
+		UnitTester::assert_(stats.snapshot().deallocations - freed == 200 - std.size());
+		UnitTester::assert_(s.stats().valid);
+		UnitTester::assert_(s.size() == std.size());
+		std::set<int>::const_iterator sit = std.begin();
+		for (typename Set::iterator it = s.begin(); it != s.end(); ++it, ++sit)
+			UnitTester::assert_(it->v == *sit);
+	}
+	UnitTester::assert_(stats.snapshot().live_bytes == 0);
+}
+
+// -------------------------------------------------------------------------- //
+//                               heterogeneous                                //
+// -------------------------------------------------------------------------- //
+
+void _set_heterogeneous_lookup()
+{
+	set_explanation_("lookup by a transparent probe differs from std::set, constructs a key or allocates");
+	_het_lookup<t_het_set>();
+	_het_lookup<t_het_counted>();
+}
+
+void _set_heterogeneous_erase()
+{
+	set_explanation_("erase by a transparent probe differs from std::set, constructs a key or allocates");
+	_het_erase<t_het_set>();
+	_het_erase<t_het_counted>();
+}
+
+void set_heterogeneous()
+{
+	load_subtest_(_set_heterogeneous_lookup);
+	load_subtest_(_set_heterogeneous_erase);
+}
+
+} // namespace SetTest
+
+#endif
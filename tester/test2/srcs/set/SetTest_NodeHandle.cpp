@@ -0,0 +1,97 @@
+#include "../includes/SetTest.hpp"
+#include "../includes/UnitTester.hpp"
+#include <algorithm>
+#include <iostream>
+#include <set>
+
+#if !STD
+
+namespace SetTest {
+
+/* set 의 extract / insert(node_type) / merge. map 쪽(MapTest_NodeHandle) 과 같은 흐름을 값 하나로 확인한다. */
+
+template <bool OrderStat>
+void _node_check(const ft::set<int, std::less<int>, std::allocator<int>, OrderStat>& ft, const std::set<int>& std)
+{
+	UnitTester::assert_(ft.stats().valid);
+	UnitTester::assert_(ft.size() == std.size());
+	UnitTester::assert_(std::equal(ft.begin(), ft.end(), std.begin()));
+	for (size_t k = 0; k < ft.size(); k += 7)
+		UnitTester::assert_(ft.rank(*ft.select(k)) == k);
+}
+
+template <bool OrderStat>
+void _node_move()
+{
+	typedef ft::set<int, std::less<int>, std::allocator<int>, OrderStat> t_set;
+	t_set         a;
+	t_set         b;
+	std::set<int> std_a;
+	std::set<int> std_b;
+
+	for (int i = 0; i < 200; ++i) {
+		a.insert(i);
+		std_a.insert(i);
+		if (i % 3 == 0) {
+			b.insert(i);
+			std_b.insert(i);
+		}
+	}
+
+	/* 없는 값은 hint 로, 있는 값은 실패해서 handle 에 남는다. */
+	for (int i = 0; i < 200; i += 2) {
+		typename t_set::node_type nh = (i % 4) ? a.extract(a.find(i)) : a.extract(i);
+
+		UnitTester::assert_(!nh.empty() && nh.value() == i);
+		std_a.erase(i);
+		typename t_set::iterator it = b.insert(b.lower_bound(i), nh);
+		UnitTester::assert_(*it == i);
+		if (std_b.insert(i).second) {
+			UnitTester::assert_(nh.empty());
+		} else {
+			UnitTester::assert_(!nh.empty() && nh.value() == i);
+			typename t_set::insert_return_type ret = b.insert(nh);
+			UnitTester::assert_(!ret.inserted && !ret.node.empty() && ret.node.value() == i);
+			ret = a.insert(ret.node);
+			UnitTester::assert_(ret.inserted && *ret.position == i);
+			std_a.insert(i);
+		}
+		_node_check(a, std_a);
+		_node_check(b, std_b);
+	}
+
+	/* merge : 겹치는 값은 a 에 남는다. */
+	b.merge(a);
+	std::set<int> left;
+	for (std::set<int>::iterator it = std_a.begin(); it != std_a.end(); ++it)
+		if (!std_b.insert(*it).second)
+			left.insert(*it);
+	_node_check(a, left);
+	_node_check(b, std_b);
+}
+
+// -------------------------------------------------------------------------- //
+//                                node handle                                 //
+// -------------------------------------------------------------------------- //
+
+void _set_node_move()
+{
+	set_explanation_("extract / insert(node) / merge differ from std::set or lose a node on a duplicate value");
+	_node_move<false>();
+}
+
+void _set_node_order_stat()
+{
+	set_explanation_("extract / insert(node) / merge break subtree counts of an order-statistic set");
+	_node_move<true>();
+}
+
+void set_node_handle()
+{
+	load_subtest_(_set_node_move);
+	load_subtest_(_set_node_order_stat);
+}
+
+} // namespace SetTest
+
+#endif
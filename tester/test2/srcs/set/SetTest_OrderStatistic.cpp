@@ -0,0 +1,239 @@
+#include "../includes/SetTest.hpp"
+#include "../includes/UnitTester.hpp"
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <set>
+
+#if !STD
+
+namespace SetTest {
+
+/* rank / select / count_range 와 iterator 의 distance / advance 를 std::set 에 std::distance 로 잰 값과 비교한다.
+   OrderStat 이면 O(log n) 경로, 아니면 순회 경로를 탄다. */
+
+template <bool OrderStat>
+void _order_stat_check(const ft::set<int, std::less<int>, std::allocator<int>, OrderStat>& ft,
+                       const std::set<int>& std, int range)
+{
+	typedef typename ft::set<int, std::less<int>, std::allocator<int>, OrderStat>::const_iterator t_iter;
+
+	UnitTester::assert_(ft.stats().valid);
+	UnitTester::assert_(ft.size() == std.size());
+	UnitTester::assert_(static_cast<size_t>(std::distance(ft.begin(), ft.end())) == std.size());
+
+	for (int i = 0; i < 30; ++i) {
+		size_t k = std::rand() % (std.size() + 2);
+		t_iter it = ft.select(k);
+
+		if (k >= std.size()) {
+			UnitTester::assert_(it == ft.end());
+			continue;
+		}
+		std::set<int>::const_iterator its = std.begin();
+		std::advance(its, k);
+		UnitTester::assert_(*it == *its);
+
+		t_iter adv = ft.begin();
+		std::advance(adv, k);
+		UnitTester::assert_(adv == it);
+		UnitTester::assert_(static_cast<size_t>(std::distance(ft.begin(), it)) == k);
+		UnitTester::assert_(static_cast<size_t>(std::distance(it, ft.end())) == std.size() - k);
+
+		t_iter back = ft.end();
+		std::advance(back, -static_cast<long>(std.size() - k));
+		UnitTester::assert_(back == it);
+	}
+	for (int i = 0; i < 30; ++i) {
+		int lo = std::rand() % (range + 2) - 1;
+		int hi = std::rand() % (range + 2) - 1;
+		long std_lo = std::distance(std.begin(), std.lower_bound(lo));
+		long std_hi = std::distance(std.begin(), std.lower_bound(hi));
+
+		UnitTester::assert_(ft.rank(lo) == static_cast<size_t>(std_lo));
+		UnitTester::assert_(ft.count_range(lo, hi) == static_cast<size_t>(std_lo < std_hi ? std_hi - std_lo : 0));
+	}
+}
+
+template <bool OrderStat>
+void _order_stat_fill(ft::set<int, std::less<int>, std::allocator<int>, OrderStat>& ft, std::set<int>& std,
+                      int size, int range)
+{
+	for (int i = 0; i < size; ++i) {
+		int val = std::rand() % range;
+
+		ft.insert(val);
+		std.insert(val);
+	}
+}
+
+template <bool OrderStat>
+void _order_stat_insert()
+{
+	ft::set<int, std::less<int>, std::allocator<int>, OrderStat> ft;
+	std::set<int>                                                std;
+
+	_order_stat_check(ft, std, 10);
+	for (int i = 0; i < 10; ++i) {
+		_order_stat_fill(ft, std, 100, 2000);
+		_order_stat_check(ft, std, 2000);
+	}
+}
+
+template <bool OrderStat>
+void _order_stat_erase()
+{
+	typedef ft::set<int, std::less<int>, std::allocator<int>, OrderStat> t_set;
+	t_set                                                                 ft;
+	std::set<int>                                                         std;
+
+	_order_stat_fill(ft, std, 1000, 2000);
+	while (!std.empty()) {
+		for (int i = 0; i < 50 && !std.empty(); ++i) {
+			if (std::rand() % 2) {
+				int val = std::rand() % 2000;
+
+				UnitTester::assert_(ft.erase(val) == std.erase(val));
+			} else {
+				size_t k = std::rand() % std.size();
+				std::set<int>::iterator its = std.begin();
+
+				std::advance(its, k);
+				ft.erase(ft.select(k));
+				std.erase(its);
+			}
+		}
+		_order_stat_check(ft, std, 2000);
+	}
+}
+
+template <bool OrderStat>
+void _order_stat_merge()
+{
+	typedef ft::set<int, std::less<int>, std::allocator<int>, OrderStat> t_set;
+	t_set                                                                 ft;
+	std::set<int>                                                         std;
+
+	for (int i = 0; i < 10; ++i) {
+		t_set         other;
+		std::set<int> std_other;
+
+		_order_stat_fill(other, std_other, 200, 3000);
+		ft.merge(other);
+		for (std::set<int>::iterator it = std_other.begin(); it != std_other.end();) {
+			if (std.insert(*it).second)
+				std_other.erase(it++);
+			else
+				++it;
+		}
+		_order_stat_check(ft, std, 3000);
+		_order_stat_check(other, std_other, 3000);
+	}
+}
+
+template <bool OrderStat>
+void _order_stat_algebra()
+{
+	typedef ft::set<int, std::less<int>, std::allocator<int>, OrderStat> t_set;
+	t_set                                                                 ft;
+	std::set<int>                                                         std;
+
+	_order_stat_fill(ft, std, 500, 2000);
+	for (int i = 0; i < 30; ++i) {
+		t_set         other;
+		std::set<int> std_other;
+		std::set<int> result;
+
+		_order_stat_fill(other, std_other, std::rand() % 500, 2000);
+		switch (i % 3) {
+		case 0:
+			ft.set_union(other);
+			std::set_union(std.begin(), std.end(), std_other.begin(), std_other.end(),
+			               std::inserter(result, result.end()));
+			break;
+		case 1:
+			ft.set_intersection(other);
+			std::set_intersection(std.begin(), std.end(), std_other.begin(), std_other.end(),
+			                      std::inserter(result, result.end()));
+			break;
+		default:
+			ft.set_difference(other);
+			std::set_difference(std.begin(), std.end(), std_other.begin(), std_other.end(),
+			                    std::inserter(result, result.end()));
+		}
+		std.swap(result);
+		_order_stat_check(ft, std, 2000);
+		if (std.size() < 100)
+			_order_stat_fill(ft, std, 300, 2000);
+	}
+}
+
+// -------------------------------------------------------------------------- //
+//                              order statistics                              //
+// -------------------------------------------------------------------------- //
+
+void _set_order_stat_insert()
+{
+	set_explanation_("rank / select / count_range / distance differ from std::set after insert");
+	_order_stat_insert<true>();
+	_order_stat_insert<false>();
+}
+
+void _set_order_stat_erase()
+{
+	set_explanation_("rank / select / count_range / distance differ from std::set after erase");
+	_order_stat_erase<true>();
+	_order_stat_erase<false>();
+}
+
+void _set_order_stat_merge()
+{
+	set_explanation_("rank / select / count_range / distance differ from std::set after merge");
+	_order_stat_merge<true>();
+	_order_stat_merge<false>();
+}
+
+void _set_order_stat_algebra()
+{
+	set_explanation_("rank / select / count_range / distance differ from std::set after set algebra");
+	_order_stat_algebra<true>();
+	_order_stat_algebra<false>();
+}
+
+void _set_order_stat_iterator()
+{
+	set_explanation_("counted iterator arithmetic differs from std::distance");
+	ft::set<int, std::less<int>, std::allocator<int>, true> ft;
+	std::set<int>                                           std;
+
+	_order_stat_fill(ft, std, 1000, 5000);
+	for (int i = 0; i < 200; ++i) {
+		long a = std::rand() % (std.size() + 1);
+		long b = std::rand() % (std.size() + 1);
+		ft::set<int, std::less<int>, std::allocator<int>, true>::iterator it_a = ft.begin() + a;
+		ft::set<int, std::less<int>, std::allocator<int>, true>::iterator it_b = ft.end() - (std.size() - b);
+
+		UnitTester::assert_(it_b - it_a == b - a);
+		UnitTester::assert_((it_a < it_b) == (a < b));
+		UnitTester::assert_(it_a + (b - a) == it_b);
+		if (a < static_cast<long>(std.size())) {
+			std::set<int>::iterator its = std.begin();
+
+			std::advance(its, a);
+			UnitTester::assert_(ft.begin()[a] == *its);
+		}
+	}
+}
+
+void set_order_stat()
+{
+	load_subtest_(_set_order_stat_insert);
+	load_subtest_(_set_order_stat_erase);
+	load_subtest_(_set_order_stat_merge);
+	load_subtest_(_set_order_stat_algebra);
+	load_subtest_(_set_order_stat_iterator);
+}
+
+} // namespace SetTest
+
+#endif
@@ -0,0 +1,129 @@
+#include "../includes/SetTest.hpp"
+#include "../includes/UnitTester.hpp"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <set>
+#include <unistd.h>
+
+#if !STD
+
+namespace SetTest {
+
+/* snapshot 을 임시 파일에 쓰고 버퍼로 읽어 restore 한다. 깨진 버퍼는 snapshot_error 를 던지고 set 은 그대로여야 한다. */
+
+template <class Container>
+void _snapshot_bytes(const Container& c, std::vector<char>& out)
+{
+	std::FILE* f  = std::tmpfile();
+	int        fd = fileno(f);
+
+	c.snapshot(fd);
+	off_t len = lseek(fd, 0, SEEK_END);
+	out.resize(len);
+	UnitTester::assert_(pread(fd, &out[0], len, 0) == len);
+	std::fclose(f);
+}
+
+template <class Set>
+bool _snapshot_rejected(Set& s, const void* data, size_t len)
+{
+	Set before(s);
+
+	try {
+		s.restore(data, len);
+	} catch (ft::snapshot_error&) {
+		UnitTester::assert_(s.stats().valid);
+		UnitTester::assert_(s == before);
+		return true;
+	}
+	return false;
+}
+
+template <class Set>
+void _snapshot_round_trip(int size)
+{
+	Set               s;
+	Set               back;
+	std::set<int>     std;
+	std::vector<char> buf;
+
+	for (int i = 0; i < size; ++i) {
+		int val = std::rand() % (4 * size + 1);
+
+		s.insert(val);
+		std.insert(val);
+	}
+	back.insert(-1);
+	_snapshot_bytes(s, buf);
+	back.restore(&buf[0], buf.size());
+	UnitTester::assert_(back.stats().valid);
+	UnitTester::assert_(back.size() == std.size());
+	UnitTester::assert_(std::equal(back.begin(), back.end(), std.begin()));
+	for (size_t k = 0; k < back.size(); k += 1 + back.size() / 8)
+		UnitTester::assert_(back.rank(*back.select(k)) == k);
+	back.insert(4 * size + 5);
+	back.erase(back.begin());
+	UnitTester::assert_(back.stats().valid);
+}
+
+// -------------------------------------------------------------------------- //
+//                                  snapshot                                  //
+// -------------------------------------------------------------------------- //
+
+void _set_snapshot_round_trip()
+{
+	set_explanation_("restore(snapshot) must rebuild the same set");
+	int sizes[] = { 0, 1, 2, 3, 7, 100, 1000 };
+
+	for (int i = 0; i < 7; ++i) {
+		_snapshot_round_trip<ft::set<int> >(sizes[i]);
+		_snapshot_round_trip<ft::set<int, std::less<int>, std::allocator<int>, true> >(sizes[i]);
+	}
+}
+
+void _set_snapshot_errors()
+{
+	set_explanation_("restore of a corrupted, truncated, misaligned or foreign snapshot must throw and leave the set untouched");
+	ft::set<int>      s  = _set_set(200, false);
+	ft::set<int>      to = _set_set(10, true);
+	std::vector<char> buf;
+
+	_snapshot_bytes(s, buf);
+	for (size_t i = 0; i < buf.size(); i += 23) {
+		std::vector<char> bad(buf);
+
+		bad[i] ^= 0x40;
+		UnitTester::assert_(_snapshot_rejected(to, &bad[0], bad.size()));
+	}
+	for (size_t len = 0; len < buf.size(); len += 17)
+		UnitTester::assert_(_snapshot_rejected(to, &buf[0], len));
+
+	std::vector<char> shifted(buf.size() + 1);
+	std::memcpy(&shifted[1], &buf[0], buf.size());
+	UnitTester::assert_(_snapshot_rejected(to, &shifted[1], buf.size()));
+
+	/* vector 의 snapshot 은 정렬되어 있어도 set 이 아니다. */
+	ft::vector<int> v;
+	for (int i = 0; i < 10; ++i)
+		v.push_back(i);
+	_snapshot_bytes(v, buf);
+	UnitTester::assert_(_snapshot_rejected(to, &buf[0], buf.size()));
+
+	/* 다른 비교자로 쓴 snapshot 은 checksum 은 맞지만 정렬 순서가 맞지 않는다. */
+	ft::set<int, std::greater<int> > desc;
+	for (int i = 0; i < 10; ++i)
+		desc.insert(i);
+	_snapshot_bytes(desc, buf);
+	UnitTester::assert_(_snapshot_rejected(to, &buf[0], buf.size()));
+}
+
+void set_snapshot()
+{
+	load_subtest_(_set_snapshot_round_trip);
+	load_subtest_(_set_snapshot_errors);
+}
+
+} // namespace SetTest
+
+#endif
@@ -62,6 +62,12 @@ t_unit_tests func_test_table[] = {
 	{	     "vector_operator_g",          vector_operator_g, FAIL, VECTOR},
 	{	    "vector_operator_ge",         vector_operator_ge, FAIL, VECTOR},
 	{	        "vector_ft_swap",             vector_ft_swap, FAIL, VECTOR},
+#if !STD
+ // ----------------------------- Extensions ----------------------------- //
+	{	       "vector_snapshot",            vector_snapshot, FAIL, VECTOR},
+	{	         "vector_mapped",              vector_mapped, FAIL, VECTOR},
+	{	     "vector_allocation",          vector_allocation, FAIL, VECTOR},
+#endif
  // ------------------- Terminater (Do not comment out) ------------------ //
 	{	                    "\0",	                   NULL, FAIL, VECTOR}
 };
@@ -0,0 +1,102 @@
+#include "../includes/UnitTester.hpp"
+#include "../includes/VectorTest.hpp"
+#include <iostream>
+#include <vector>
+
+#if !STD
+#include "../../../../utils/counting_allocator.hpp"
+
+namespace VectorTest {
+
+/* ft::counting_allocator 로 vector 의 할당을 센다. 버퍼는 늘 하나이고 capacity 가 바뀔 때만 새로 할당한다. */
+
+typedef ft::counting_allocator<int>     t_count_alloc;
+typedef ft::vector<int, t_count_alloc> t_count_vector;
+
+// -------------------------------------------------------------------------- //
+//                                 allocation                                 //
+// -------------------------------------------------------------------------- //
+
+void _vector_allocation_growth()
+{
+	set_explanation_("push_back allocates without growing capacity or frees the old buffer late");
+	ft::allocation_stats stats;
+	{
+		t_count_vector v((t_count_alloc(&stats)));
+		unsigned long  grows = 0;
+
+		UnitTester::assert_(stats.snapshot().allocations == 0);
+		for (int i = 0; i < 10000; ++i) {
+			size_t capacity = v.capacity();
+
+			v.push_back(i);
+			if (v.capacity() != capacity)
+				++grows;
+			UnitTester::assert_(stats.snapshot().allocations == grows);
+			UnitTester::assert_(stats.live_blocks() == 1);
+			UnitTester::assert_(stats.snapshot().live_bytes == v.capacity() * sizeof(int));
+		}
+		/* 두 배씩 자라므로 log2(10000) 번 남짓 */
+		UnitTester::assert_(grows <= 15);
+
+		/* reserve 한 만큼은 더 할당하지 않는다. */
+		v.reserve(v.size() + 5000);
+		unsigned long allocations = stats.snapshot().allocations;
+		while (v.size() < v.capacity())
+			v.push_back(0);
+		UnitTester::assert_(stats.snapshot().allocations == allocations);
+
+		/* 복사본은 한 번 할당하고 같은 stats 에 기록한다. */
+		{
+			t_count_vector copy(v);
+
+			UnitTester::assert_(stats.snapshot().allocations == allocations + 1);
+			UnitTester::assert_(copy == v);
+		}
+		UnitTester::assert_(stats.live_blocks() == 1);
+	}
+	UnitTester::assert_(stats.snapshot().live_bytes == 0);
+	UnitTester::assert_(stats.live_blocks() == 0);
+}
+
+void _vector_allocation_reuse()
+{
+	set_explanation_("clear + refill, assign, resize or erase within capacity allocate a new buffer");
+	ft::allocation_stats stats;
+	t_count_vector       v((t_count_alloc(&stats)));
+
+	for (int i = 0; i < 1000; ++i)
+		v.push_back(i);
+	ft::allocation_stats before   = stats.snapshot();
+	size_t               capacity = v.capacity();
+	int*                 data     = &v[0];
+
+	for (int round = 0; round < 3; ++round) {
+		v.clear();
+		UnitTester::assert_(v.empty() && v.capacity() == capacity);
+		for (int i = 0; i < 1000; ++i)
+			v.push_back(-i);
+		UnitTester::assert_(v.size() == 1000 && v.back() == -999);
+	}
+	v.assign(capacity, 7);
+	v.resize(10);
+	v.resize(capacity / 2, 3);
+	v.erase(v.begin(), v.begin() + 5);
+	v.insert(v.begin(), 4, 1);
+	v.pop_back();
+
+	ft::allocation_stats after = stats.snapshot();
+	UnitTester::assert_(after.allocations == before.allocations);
+	UnitTester::assert_(after.deallocations == before.deallocations);
+	UnitTester::assert_(v.capacity() == capacity && &v[0] == data);
+}
+
+void vector_allocation()
+{
+	load_subtest_(_vector_allocation_growth);
+	load_subtest_(_vector_allocation_reuse);
+}
+
+} // namespace VectorTest
+
+#endif
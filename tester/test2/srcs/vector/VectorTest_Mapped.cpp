@@ -0,0 +1,292 @@
+#include "../includes/UnitTester.hpp"
+#include "../includes/VectorTest.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#if !STD
+#include "../../../../mapped_vector.hpp"
+
+namespace VectorTest {
+
+/* mapped_vector 를 임시 파일 위에 만들어 std::vector 와 비교하고, 파일 자체(크기, 내용) 도 직접 읽어 확인한다. */
+
+/* mkstemp 로 만든 빈 파일. 끝나면 지운다. */
+struct t_mapped_file
+{
+	char path[32];
+
+	t_mapped_file()
+	{
+		std::strcpy(path, "/tmp/ft_mapped_XXXXXX");
+		int fd = mkstemp(path);
+		UnitTester::assert_(fd >= 0);
+		close(fd);
+	}
+	~t_mapped_file() { unlink(path); }
+
+	off_t size() const
+	{
+		struct stat st;
+		UnitTester::assert_(stat(path, &st) == 0);
+		return st.st_size;
+	}
+
+	/* mapping 을 거치지 않고 파일을 read 로 읽는다. */
+	std::vector<long> contents() const
+	{
+		std::vector<long> out(size() / sizeof(long));
+		int               fd = open(path, O_RDONLY);
+
+		UnitTester::assert_(fd >= 0);
+		if (!out.empty())
+			UnitTester::assert_(pread(fd, &out[0], out.size() * sizeof(long), 0) == static_cast<ssize_t>(out.size() * sizeof(long)));
+		close(fd);
+		return out;
+	}
+};
+
+bool _mapped_same(const ft::mapped_vector<long>& ft, const std::vector<long>& std)
+{
+	return ft.size() == std.size() && std::equal(std.begin(), std.end(), ft.begin());
+}
+
+template <class F>
+bool _mapped_logic_error(F f)
+{
+	try {
+		f();
+	} catch (std::logic_error&) {
+		return true;
+	}
+	return false;
+}
+
+struct t_mapped_push
+{
+	ft::mapped_vector<long>* v;
+	void operator()() const { v->push_back(1); }
+};
+struct t_mapped_pop
+{
+	ft::mapped_vector<long>* v;
+	void operator()() const { v->pop_back(); }
+};
+struct t_mapped_resize
+{
+	ft::mapped_vector<long>* v;
+	void operator()() const { v->resize(v->size() + 1); }
+};
+struct t_mapped_reserve
+{
+	ft::mapped_vector<long>* v;
+	void operator()() const { v->reserve(v->capacity() + 1); }
+};
+struct t_mapped_assign
+{
+	ft::mapped_vector<long>* v;
+	void operator()() const { v->assign(3, 7L); }
+};
+struct t_mapped_clear
+{
+	ft::mapped_vector<long>* v;
+	void operator()() const { v->clear(); }
+};
+
+// -------------------------------------------------------------------------- //
+//                                mapped vector                               //
+// -------------------------------------------------------------------------- //
+
+void _vector_mapped_grow()
+{
+	set_explanation_("push_back past several doublings differs from std::vector or close() does not truncate the file");
+	t_mapped_file           file;
+	std::vector<long>       std;
+	ft::mapped_vector<long> v(file.path);
+	size_t                  doublings = 0;
+
+	UnitTester::assert_(v.is_open() && v.empty());
+	for (long i = 0; i < 5000; ++i) {
+		size_t capacity = v.capacity();
+
+		v.push_back(i * 3 - 7);
+		std.push_back(i * 3 - 7);
+		if (v.capacity() != capacity)
+			++doublings;
+		UnitTester::assert_(v.capacity() >= v.size());
+	}
+	UnitTester::assert_(doublings >= 5);
+	UnitTester::assert_(_mapped_same(v, std));
+	UnitTester::assert_(v.at(4999) == std.back() && v.front() == std.front());
+
+	/* 자라는 동안 파일은 capacity 길이다. */
+	UnitTester::assert_(file.size() == static_cast<off_t>(v.capacity() * sizeof(long)));
+	v.close();
+	UnitTester::assert_(!v.is_open() && v.size() == 0);
+	UnitTester::assert_(file.size() == static_cast<off_t>(std.size() * sizeof(long)));
+	UnitTester::assert_(file.contents() == std);
+}
+
+void _vector_mapped_reopen()
+{
+	set_explanation_("reopening a closed file does not show the same contents");
+	t_mapped_file     file;
+	std::vector<long> std;
+	{
+		ft::mapped_vector<long> v(file.path);
+
+		for (long i = 0; i < 1000; ++i) {
+			v.push_back(i * i);
+			std.push_back(i * i);
+		}
+		v.pop_back();
+		std.pop_back();
+		v[10] = -1;
+		std[10] = -1;
+	}
+	/* 소멸자도 close 한다. */
+	UnitTester::assert_(file.size() == static_cast<off_t>(std.size() * sizeof(long)));
+
+	ft::mapped_vector<long> rw(file.path);
+	UnitTester::assert_(_mapped_same(rw, std));
+	rw.push_back(42);
+	std.push_back(42);
+	rw.close();
+
+	ft::mapped_vector<long> ro(file.path, ft::mapped_vector<long>::read_only);
+	UnitTester::assert_(ro.mode() == ft::mapped_vector<long>::read_only);
+	UnitTester::assert_(_mapped_same(ro, std));
+}
+
+void _vector_mapped_flush()
+{
+	set_explanation_("after flush() the file alone does not hold the current contents");
+	t_mapped_file           file;
+	std::vector<long>       std;
+	ft::mapped_vector<long> v(file.path);
+
+	for (long i = 0; i < 3000; ++i) {
+		v.push_back(i ^ 0x55);
+		std.push_back(i ^ 0x55);
+	}
+	v.flush();
+	UnitTester::assert_(file.size() == static_cast<off_t>(std.size() * sizeof(long)));
+	UnitTester::assert_(file.contents() == std);
+
+	/* 열린 채로 다른 mapping 에서 읽어도 같다. flush 뒤에도 계속 쓸 수 있다. */
+	ft::mapped_vector<long> other(file.path, ft::mapped_vector<long>::read_only);
+	UnitTester::assert_(_mapped_same(other, std));
+	v.push_back(1);
+	std.push_back(1);
+	v.flush();
+	UnitTester::assert_(file.contents() == std);
+}
+
+void _vector_mapped_read_only()
+{
+	set_explanation_("a mutator on a read_only or closed mapped_vector does not throw std::logic_error");
+	t_mapped_file file;
+	{
+		ft::mapped_vector<long> v(file.path);
+
+		v.assign(100, 9L);
+	}
+	ft::mapped_vector<long> ro(file.path, ft::mapped_vector<long>::read_only);
+	ft::mapped_vector<long> closed;
+
+	for (int i = 0; i < 2; ++i) {
+		ft::mapped_vector<long>* p = i == 0 ? &ro : &closed;
+		t_mapped_push            push    = { p };
+		t_mapped_pop             pop     = { p };
+		t_mapped_resize          resize  = { p };
+		t_mapped_reserve         reserve = { p };
+		t_mapped_assign          assign  = { p };
+		t_mapped_clear           clear   = { p };
+
+		UnitTester::assert_(_mapped_logic_error(push));
+		UnitTester::assert_(_mapped_logic_error(pop));
+		UnitTester::assert_(_mapped_logic_error(resize));
+		UnitTester::assert_(_mapped_logic_error(reserve));
+		UnitTester::assert_(_mapped_logic_error(assign));
+		UnitTester::assert_(_mapped_logic_error(clear));
+	}
+	/* 던진 뒤에도 그대로다. */
+	UnitTester::assert_(ro.size() == 100 && ro[0] == 9 && ro[99] == 9);
+	UnitTester::assert_(file.size() == static_cast<off_t>(100 * sizeof(long)));
+}
+
+void _vector_mapped_bad_size()
+{
+	set_explanation_("a file whose size is not a multiple of sizeof(T) is not rejected");
+	t_mapped_file file;
+	int           fd = open(file.path, O_WRONLY);
+	char          junk[sizeof(long) * 3 + 1] = { 0 };
+
+	UnitTester::assert_(fd >= 0 && write(fd, junk, sizeof(junk)) == static_cast<ssize_t>(sizeof(junk)));
+	close(fd);
+
+	for (int i = 0; i < 2; ++i) {
+		ft::mapped_vector<long> v;
+		bool                    threw = false;
+
+		try {
+			v.open(file.path, i == 0 ? ft::mapped_vector<long>::read_write : ft::mapped_vector<long>::read_only);
+		} catch (std::runtime_error&) {
+			threw = true;
+		}
+		UnitTester::assert_(threw && !v.is_open());
+	}
+	UnitTester::assert_(file.size() == static_cast<off_t>(sizeof(junk)));
+}
+
+void _vector_mapped_swap()
+{
+	set_explanation_("swap does not exchange the files");
+	t_mapped_file           fa;
+	t_mapped_file           fb;
+	std::vector<long>       sa(10, 1);
+	std::vector<long>       sb(2000, 2);
+	ft::mapped_vector<long> a(fa.path);
+	ft::mapped_vector<long> b(fb.path);
+
+	a.assign(sa.begin(), sa.end());
+	b.assign(sb.begin(), sb.end());
+	a.swap(b);
+	UnitTester::assert_(_mapped_same(a, sb) && _mapped_same(b, sa));
+	ft::swap(a, b);
+	UnitTester::assert_(_mapped_same(a, sa) && _mapped_same(b, sb));
+	a.swap(b);
+
+	/* a 는 이제 fb 를 쓴다. 쓰고 닫으면 fb 에 남는다. */
+	a.push_back(3);
+	sb.push_back(3);
+	a.close();
+	b.close();
+	UnitTester::assert_(fa.contents() == sa);
+	UnitTester::assert_(fb.contents() == sb);
+
+	/* 닫힌 것과의 swap */
+	ft::mapped_vector<long> closed;
+	ft::mapped_vector<long> c(fa.path, ft::mapped_vector<long>::read_only);
+	closed.swap(c);
+	UnitTester::assert_(!c.is_open() && c.empty());
+	UnitTester::assert_(closed.is_open() && _mapped_same(closed, sa));
+}
+
+void vector_mapped()
+{
+	load_subtest_(_vector_mapped_grow);
+	load_subtest_(_vector_mapped_reopen);
+	load_subtest_(_vector_mapped_flush);
+	load_subtest_(_vector_mapped_read_only);
+	load_subtest_(_vector_mapped_bad_size);
+	load_subtest_(_vector_mapped_swap);
+}
+
+} // namespace VectorTest
+
+#endif
@@ -0,0 +1,133 @@
+#include "../includes/UnitTester.hpp"
+#include "../includes/VectorTest.hpp"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <unistd.h>
+#include <vector>
+
+#if !STD
+
+namespace VectorTest {
+
+/* snapshot 을 임시 파일에 쓰고 버퍼로 읽어 restore 한다. 깨진 버퍼는 snapshot_error 를 던지고 vector 는 그대로여야 한다. */
+
+struct _snap_record
+{
+	long   id;
+	double score;
+	char   tag[4];
+};
+
+void _snapshot_bytes(const ft::vector<int>& v, std::vector<char>& out)
+{
+	std::FILE* f  = std::tmpfile();
+	int        fd = fileno(f);
+
+	v.snapshot(fd);
+	off_t len = lseek(fd, 0, SEEK_END);
+	out.resize(len);
+	UnitTester::assert_(pread(fd, &out[0], len, 0) == len);
+	std::fclose(f);
+}
+
+bool _snapshot_rejected(ft::vector<int>& v, const void* data, size_t len)
+{
+	ft::vector<int> before(v);
+	size_t          capacity = v.capacity();
+
+	try {
+		v.restore(data, len);
+	} catch (ft::snapshot_error&) {
+		UnitTester::assert_(v == before);
+		UnitTester::assert_(v.capacity() == capacity);
+		return true;
+	}
+	return false;
+}
+
+// -------------------------------------------------------------------------- //
+//                                  snapshot                                  //
+// -------------------------------------------------------------------------- //
+
+void _vector_snapshot_round_trip()
+{
+	set_explanation_("restore(snapshot) must rebuild the same vector");
+	int sizes[] = { 0, 1, 2, 17, 1000, 100000 };
+
+	for (int i = 0; i < 6; ++i) {
+		ft::vector<int>   v = _set_vector(sizes[i]);
+		ft::vector<int>   back(3, 7);
+		std::vector<char> buf;
+
+		_snapshot_bytes(v, buf);
+		back.restore(&buf[0], buf.size());
+		UnitTester::assert_(back == v);
+		back.push_back(1);
+		UnitTester::assert_(back.size() == v.size() + 1 && back.back() == 1);
+	}
+
+	/* 여러 field 를 가진 원소 */
+	ft::vector<_snap_record> r;
+	for (int i = 0; i < 300; ++i) {
+		_snap_record rec;
+
+		std::memset(&rec, 0, sizeof(rec));
+		rec.id    = i;
+		rec.score = i * 0.5;
+		std::memcpy(rec.tag, "abc", 4);
+		r.push_back(rec);
+	}
+	std::FILE* f = std::tmpfile();
+	r.snapshot(fileno(f));
+	std::vector<char> buf(lseek(fileno(f), 0, SEEK_END));
+	UnitTester::assert_(pread(fileno(f), &buf[0], buf.size(), 0) == static_cast<ssize_t>(buf.size()));
+	std::fclose(f);
+	ft::vector<_snap_record> back;
+	back.restore(&buf[0], buf.size());
+	UnitTester::assert_(back.size() == r.size());
+	for (size_t i = 0; i < back.size(); ++i)
+		UnitTester::assert_(back[i].id == r[i].id && back[i].score == r[i].score && !std::strcmp(back[i].tag, "abc"));
+}
+
+void _vector_snapshot_errors()
+{
+	set_explanation_("restore of a corrupted, truncated or misaligned snapshot must throw and leave the vector untouched");
+	ft::vector<int>   v  = _set_vector(200);
+	ft::vector<int>   to = _set_vector(10, true);
+	std::vector<char> buf;
+
+	_snapshot_bytes(v, buf);
+	for (size_t i = 0; i < buf.size(); i += 29) {
+		std::vector<char> bad(buf);
+
+		bad[i] ^= 0x01;
+		UnitTester::assert_(_snapshot_rejected(to, &bad[0], bad.size()));
+	}
+	for (size_t len = 0; len < buf.size(); len += 31)
+		UnitTester::assert_(_snapshot_rejected(to, &buf[0], len));
+
+	std::vector<char> shifted(buf.size() + 1);
+	std::memcpy(&shifted[1], &buf[0], buf.size());
+	UnitTester::assert_(_snapshot_rejected(to, &shifted[1], buf.size()));
+
+	/* 원소 크기가 다른 vector */
+	ft::vector<char> c(10, 'x');
+	UnitTester::assert_(to.size() == 10);
+	std::FILE* f = std::tmpfile();
+	c.snapshot(fileno(f));
+	std::vector<char> cbuf(lseek(fileno(f), 0, SEEK_END));
+	UnitTester::assert_(pread(fileno(f), &cbuf[0], cbuf.size(), 0) == static_cast<ssize_t>(cbuf.size()));
+	std::fclose(f);
+	UnitTester::assert_(_snapshot_rejected(to, &cbuf[0], cbuf.size()));
+}
+
+void vector_snapshot()
+{
+	load_subtest_(_vector_snapshot_round_trip);
+	load_subtest_(_vector_snapshot_errors);
+}
+
+} // namespace VectorTest
+
+#endif
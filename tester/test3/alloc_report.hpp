@@ -0,0 +1,28 @@
+#ifndef ALLOC_REPORT_HPP
+#define ALLOC_REPORT_HPP
+
+#include "../../utils/counting_allocator.hpp"
+#include <cstdio>
+#include <ctime>
+
+// Both the ft and the std build put their containers on ft::counting_allocator,
+// so every run can report heap traffic per operation next to time per operation.
+// The report goes to stderr; stdout stays the output that is diffed.
+
+static unsigned long g_ops = 0;
+
+struct alloc_report {
+  clock_t start;
+
+  alloc_report() : start(clock()) {}
+  // Declared first in main, so it runs after every container has been destroyed
+  ~alloc_report() {
+    double ns = (double)(clock() - start) / CLOCKS_PER_SEC * 1e9;
+    double ops = g_ops ? (double)g_ops : 1;
+    ft::allocation_stats s = ft::allocation_stats::global().snapshot();
+    fprintf(stderr, "ops %lu  time/op %.1f ns  allocs/op %.3g  frees/op %.3g  peak %lu B\n",
+            g_ops, ns / ops, s.allocations / ops, s.deallocations / ops, s.peak_bytes);
+  }
+};
+
+#endif
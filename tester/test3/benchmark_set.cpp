@@ -12,23 +12,28 @@
 #include <iostream>
 #include <string>
 #include <cstdio>
+#include "alloc_report.hpp"
+
+typedef NS::set<int, std::less<int>, ft::counting_allocator<int> > set_type;
 
 // Read integer n, then insert n space-separated key-value pairs into __set
-void insert(NS::set<int> &__set) {
+void insert(set_type &__set) {
   int input_numbers = 0;
   scanf("%d", &input_numbers);
+  g_ops += input_numbers;
   for (int i = 0 ; i < input_numbers ; i++) {
     int key;
     scanf("%d", &key);
-    NS::pair<NS::set<int>::iterator, bool> ret = __set.insert(key);
+    NS::pair<set_type::iterator, bool> ret = __set.insert(key);
     printf("%d %d\n", *ret.first, ret.second);
   }
 }
 
 // Read integer n, then delete n keys from __set
-void del(NS::set<int> &__set) {
+void del(set_type &__set) {
   int input_numbers = 0;
   scanf("%d", &input_numbers);
+  g_ops += input_numbers;
   for (int i = 0 ; i < input_numbers ; i++) {
     int key;
     scanf("%d", &key);
@@ -37,13 +42,14 @@ void del(NS::set<int> &__set) {
 }
 
 // Read integer n, then search n keys in __set
-void search(NS::set<int> &__set) {
+void search(set_type &__set) {
   int input_numbers = 0;
   scanf("%d", &input_numbers);
+  g_ops += input_numbers;
   for (int i = 0 ; i < input_numbers ; i++) {
     int key;
     scanf("%d", &key);
-    NS::set<int>::iterator ret = __set.find(key);
+    set_type::iterator ret = __set.find(key);
     if (ret == __set.end()) {
       printf("miss\n");
     } else {
@@ -53,17 +59,18 @@ void search(NS::set<int> &__set) {
 }
 
 int main(void) {
-  NS::set<int> __set;
+  alloc_report report;
+  set_type __set;
   // Main operations
   insert(__set);
   del(__set);
   search(__set);
   // Copy construction and destruction
   {
-    NS::set<int> tmp(__set);
+    set_type tmp(__set);
   }
   printf("Size: %lu\n", __set.size());
-  for (NS::set<int>::const_iterator it = __set.begin(); it != __set.end(); it++) {
+  for (set_type::const_iterator it = __set.begin(); it != __set.end(); it++) {
     printf("Key: %d\n", *it);
   }
   return 0;
@@ -3,6 +3,7 @@
 
 #ifdef STD
 # include <stack>
+# include <vector>
 # define NS std
 #else
 # define NS ft
@@ -12,11 +13,15 @@
 #include <iostream>
 #include <string>
 #include <cstdio>
+#include "alloc_report.hpp"
+
+typedef NS::stack<int, NS::vector<int, ft::counting_allocator<int> > > stack_type;
 
 // Read integer n, then push n values on __stack
-void insert(NS::stack<int> &__stack) {
+void insert(stack_type &__stack) {
   int input_numbers = 0;
   scanf("%d", &input_numbers);
+  g_ops += input_numbers;
   for (int i = 0 ; i < input_numbers ; i++) {
     int value;
     scanf("%d", &value);
@@ -26,12 +31,13 @@ void insert(NS::stack<int> &__stack) {
 }
 
 int main(void) {
-  NS::stack<int> __stack;
+  alloc_report report;
+  stack_type __stack;
   // Main operations
   insert(__stack);
   // Copy construction and destruction
   {
-    NS::stack<int> stk2(__stack);
+    stack_type stk2(__stack);
   }
   printf("Size: %lu\n", __stack.size());
   while (__stack.size() != 0) {
@@ -12,11 +12,15 @@
 #include <iostream>
 #include <string>
 #include <cstdio>
+#include "alloc_report.hpp"
+
+typedef NS::vector<int, ft::counting_allocator<int> > vector_type;
 
 // Read integer n, then insert n values into __vector
-void insert(NS::vector<int> &__vector) {
+void insert(vector_type &__vector) {
   int input_numbers = 0;
   scanf("%d", &input_numbers);
+  g_ops += input_numbers;
   for (int i = 0 ; i < input_numbers ; i++) {
     int value;
     scanf("%d", &value);
@@ -26,13 +30,14 @@ void insert(NS::vector<int> &__vector) {
 }
 
 // Read integer n, then delete n indexes from __vector
-void del(NS::vector<int> &__vector) {
+void del(vector_type &__vector) {
   int input_numbers = 0;
   scanf("%d", &input_numbers);
+  g_ops += input_numbers;
   for (int i = 0 ; i < input_numbers ; i++) {
     std::size_t index;
     scanf("%lu", &index);
-    NS::vector<int>::iterator ret = __vector.erase(__vector.begin() + index);
+    vector_type::iterator ret = __vector.erase(__vector.begin() + index);
     if (ret == __vector.end()) {
       printf("end");
     } else {
@@ -42,16 +47,17 @@ void del(NS::vector<int> &__vector) {
 }
 
 int main(void) {
-  NS::vector<int> __vector;
+  alloc_report report;
+  vector_type __vector;
   // Main operations
   insert(__vector);
   del(__vector);
   // Copy construction and destruction
   {
-    NS::vector<int> vec2(__vector);
+    vector_type vec2(__vector);
   }
   printf("Size: %lu\n", __vector.size());
-  for (NS::vector<int>::const_iterator it = __vector.begin() ; it != __vector.end() ; it++) {
+  for (vector_type::const_iterator it = __vector.begin() ; it != __vector.end() ; it++) {
     printf("%d\n", *it);
   }
   return 0;
@@ -7,10 +7,10 @@ python3 generate_input_set.py > input_set
 python3 generate_input_stack.py > input_stack
 python3 generate_input_vector.py > input_vector
 
-clang++ benchmark_map.cpp -D STD && cat input_map | ./a.out > std_output_map && rm a.out
-clang++ benchmark_set.cpp -D STD && cat input_set | ./a.out > std_output_set && rm a.out
-clang++ benchmark_stack.cpp -D STD && cat input_stack | ./a.out > std_output_stack && rm a.out
-clang++ benchmark_vector.cpp -D STD && cat input_vector | ./a.out > std_output_vector && rm a.out
+clang++ benchmark_map.cpp -D STD && cat input_map | ./a.out > std_output_map 2> std_alloc_map && rm a.out
+clang++ benchmark_set.cpp -D STD && cat input_set | ./a.out > std_output_set 2> std_alloc_set && rm a.out
+clang++ benchmark_stack.cpp -D STD && cat input_stack | ./a.out > std_output_stack 2> std_alloc_stack && rm a.out
+clang++ benchmark_vector.cpp -D STD && cat input_vector | ./a.out > std_output_vector 2> std_alloc_vector && rm a.out
 
 clang++ benchmark_map.cpp -o ft_benchmark_map
 clang++ benchmark_set.cpp -o ft_benchmark_set
@@ -14,6 +14,7 @@ test_container () {
     else
         echo -e "\033[1;32m[PASS]\033[0m\n"
     fi
+    printf "std: %s\n ft: %s\n" "$(cat std_alloc_$1)" "$(cat test_alloc_$1)"
 }
 
 printf "\033[1;94m\
@@ -2,4 +2,4 @@
 # Copyright @nesvoboda
 # Modified by @bigpel66
 
-cat input_map | ./ft_benchmark_map > test_output_map
+cat input_map | ./ft_benchmark_map > test_output_map 2> test_alloc_map
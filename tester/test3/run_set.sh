@@ -2,4 +2,4 @@
 # Copyright @nesvoboda
 # Modified by @bigpel66
 
-cat input_set | ./ft_benchmark_set > test_output_set
+cat input_set | ./ft_benchmark_set > test_output_set 2> test_alloc_set
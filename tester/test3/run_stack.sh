@@ -2,4 +2,4 @@
 # Copyright @nesvoboda
 # Modified by @bigpel66
 
-cat input_stack | ./ft_benchmark_stack > test_output_stack
+cat input_stack | ./ft_benchmark_stack > test_output_stack 2> test_alloc_stack
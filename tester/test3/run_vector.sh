@@ -2,4 +2,4 @@
 # Copyright @nesvoboda
 # Modified by @bigpel66
 
-cat input_vector | ./ft_benchmark_vector > test_output_vector
+cat input_vector | ./ft_benchmark_vector > test_output_vector 2> test_alloc_vector
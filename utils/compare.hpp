@@ -0,0 +1,145 @@
+#ifndef COMPARE_HPP
+# define COMPARE_HPP
+
+# include <functional>
+# include <string>
+# include "type.hpp"
+
+/* three-way comparison
+ *
+ * 보통의 비교자(Comp)는 a < b 만 알려주기 때문에 a == b 를 알려면 comp(a, b), comp(b, a) 두 번 호출해야 한다.
+ * int compare(a, b) const 를 가진 비교자는 한 번의 호출로 음수(a < b) / 0(a == b) / 양수(a > b) 를 돌려준다.
+ * __rbt는 __three_way<Comp, Key>::value 가 true 일 때 레벨 당 비교를 한 번만 하는 탐색을 사용한다.
+ *
+ * 1. compare() 멤버를 가진 비교자 -> comp.compare(a, b)
+ * 2. std::less<산술형>				-> (b < a) - (a < b)
+ * 3. std::less<std::string>		-> a.compare(b)
+ * 그 외에는 value == false 이고 ordering 비교(comp(a, b))만 사용한다.
+ */
+
+namespace ft {
+
+	/* is_class : 멤버 포인터를 만들 수 있는 타입인지 확인 */
+	template <typename T>
+	struct __is_class_type
+	{
+		private:
+			template <typename U> static char	__test(int U::*);
+			template <typename U> static long	__test(...);
+		public:
+			static const bool value = sizeof(__test<T>(0)) == sizeof(char);
+	};
+
+	/* has_compare : T가 compare 라는 이름의 멤버를 가졌는지 확인
+	 * fallback과 T를 같이 상속받은 __derived 에서 &U::compare 가 모호해지면 T에도 compare가 있는 것.
+	 * 오버로딩 되거나 template인 compare 도 찾을 수 있다. */
+	template <typename T, bool = __is_class_type<T>::value>
+	struct __has_compare
+	{
+		private:
+			struct __fallback { int compare; };
+			struct __derived : T, __fallback { };
+			template <typename U, U> struct __check;
+			template <typename U> static char	__test(__check<int __fallback::*, &U::compare>*);
+			template <typename U> static long	__test(...);
+		public:
+			static const bool value = sizeof(__test<__derived>(0)) == sizeof(long);
+	};
+
+	template <typename T>
+	struct __has_compare<T, false> : public false_type { };
+
+	template <typename T>
+	struct __void_t { typedef void type; };
+
+	/* is_arithmetic */
+	template <typename T>
+	struct __is_floating_point_ : public false_type { };
+
+	template <>
+	struct __is_floating_point_<float> : public true_type { };
+
+	template <>
+	struct __is_floating_point_<double> : public true_type { };
+
+	template <>
+	struct __is_floating_point_<long double> : public true_type { };
+
+	template <typename T>
+	struct __is_arithmetic
+		: public integral_constant<bool, is_integral<T>::value
+			|| __is_floating_point_<typename remove_cv<T>::type>::value> { };
+
+	/* __three_way<Comp, Key>
+	 * value   : one-comparison 탐색을 쓸 수 있는지
+	 * compare : 음수 / 0 / 양수 반환 (value == true 일 때만 호출) */
+	template <class Comp, typename Key, typename = void>
+	struct __three_way
+	{
+		static const bool value = __has_compare<Comp>::value;
+
+		template <typename T, typename U>
+		static int	compare(const Comp& comp, const T& t, const U& u)
+		{ return comp.compare(t, u); }
+	};
+
+	template <typename Key>
+	struct __three_way<std::less<Key>, Key, typename enable_if<__is_arithmetic<Key>::value>::type>
+	{
+		static const bool value = true;
+
+		static int	compare(const std::less<Key>&, const Key& t, const Key& u)
+		{ return (u < t) - (t < u); }
+	};
+
+	template <class CharT, class Traits, class Alloc>
+	struct __three_way<std::less<std::basic_string<CharT, Traits, Alloc> >, std::basic_string<CharT, Traits, Alloc> >
+	{
+		typedef std::basic_string<CharT, Traits, Alloc>	string_type;
+
+		static const bool value = true;
+
+		static int	compare(const std::less<string_type>&, const string_type& t, const string_type& u)
+		{ return t.compare(u); }
+	};
+
+	/* is_transparent : Comp::is_transparent 가 있으면 key_type 이 아닌 타입으로도 lookup 할 수 있다. (std::less<> 처럼)
+	 * map::find(const K&) 등의 반환형에서 SFINAE 로 쓰이므로 K 에 의존하게 만든다. */
+	template <class Comp, typename K, typename = void>
+	struct __is_transparent : public false_type { };
+
+	template <class Comp, typename K>
+	struct __is_transparent<Comp, K, typename __void_t<typename Comp::is_transparent>::type> : public true_type { };
+
+	/* map의 value_compare 처럼 pair(value)와 key를 섞어 비교하는 비교자의 기반 클래스.
+	 * key 비교자가 three-way 를 지원할 때만 compare() 를 노출해서 __has_compare 가 그대로 판단하도록 한다. */
+	template <class Value, typename Key, class KeyComp, bool = __three_way<KeyComp, Key>::value>
+	class __value_compare_base
+	{
+		protected:
+			KeyComp comp;
+		public:
+			__value_compare_base(KeyComp c) : comp(c) {}
+	};
+
+	template <class Value, typename Key, class KeyComp>
+	class __value_compare_base<Value, Key, KeyComp, true>
+	{
+		protected:
+			KeyComp comp;
+		public:
+			__value_compare_base(KeyComp c) : comp(c) {}
+
+			int compare(const Value& x, const Value& y) const
+			{ return __three_way<KeyComp, Key>::compare(comp, x.first, y.first); }
+
+			int compare(const Value& x, const Key& y) const
+			{ return __three_way<KeyComp, Key>::compare(comp, x.first, y); }
+
+			int compare(const Key& x, const Value& y) const
+			{ return __three_way<KeyComp, Key>::compare(comp, x, y.first); }
+	};
+
+}
+
+#endif
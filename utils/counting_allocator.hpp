@@ -0,0 +1,200 @@
+#ifndef COUNTING_ALLOCATOR_HPP
+# define COUNTING_ALLOCATOR_HPP
+
+# include <cstddef>
+# include <cstdio>
+# include <limits>
+# include <new>
+
+/* 할당을 세는 allocator
+ *
+ * ft::counting_allocator<T> 는 ::operator new / delete 로 메모리를 얻고 돌려주면서 allocation_stats 하나에 기록한다.
+ * rebind 한 allocator 도 같은 allocation_stats 를 가리키므로 map / set 의 노드 할당(__rbt 의 node_allocator)도
+ * container 에 넘긴 allocator 의 stats 에 모인다. 기본 생성하면 process 전체가 같이 쓰는 allocation_stats::global() 에 기록한다.
+ *
+ * 세는 값: allocate / deallocate 호출 수, 할당 / 해제한 byte, 살아 있는 byte 와 그 최고치, 요청 크기의 2 의 거듭제곱 histogram.
+ * counter 는 relaxed atomic 으로 올리므로 여러 thread 에서 써도 되고, 읽는 값은 그 순간의 근사치다.
+ *
+ * typedef ft::counting_allocator<ft::pair<const int, int> > alloc;
+ * ft::allocation_stats stats;
+ * alloc a(&stats);
+ * ft::map<int, int, std::less<int>, alloc> m(std::less<int>(), a);
+ * unsigned long before = stats.snapshot().allocations;
+ * m.find(1);
+ * assert(stats.snapshot().allocations == before);
+ */
+
+namespace ft {
+
+	struct allocation_stats
+	{
+		/* i 번째 칸은 (2^(i-1), 2^i] byte 요청. 0 번째 칸은 0 ~ 1 byte, 마지막 칸은 2^30 byte 를 넘는 요청 전부 */
+		enum { histogram_size = 32 };
+
+		unsigned long	allocations;
+		unsigned long	deallocations;
+		unsigned long	bytes_allocated;
+		unsigned long	bytes_deallocated;
+		unsigned long	live_bytes;
+		unsigned long	peak_bytes;
+		unsigned long	histogram[histogram_size];
+
+		allocation_stats()
+		{
+			unsigned long* p = reinterpret_cast<unsigned long*>(this);
+			for (std::size_t i = 0 ; i < sizeof(allocation_stats) / sizeof(unsigned long) ; ++i)
+				p[i] = 0;
+		}
+
+		void	record_allocate(std::size_t bytes)
+		{
+			__atomic_fetch_add(&allocations, 1, __ATOMIC_RELAXED);
+			__atomic_fetch_add(&bytes_allocated, bytes, __ATOMIC_RELAXED);
+			__atomic_fetch_add(&histogram[bin(bytes)], 1, __ATOMIC_RELAXED);
+			unsigned long live = __atomic_add_fetch(&live_bytes, bytes, __ATOMIC_RELAXED);
+			unsigned long cur = __atomic_load_n(&peak_bytes, __ATOMIC_RELAXED);
+			while (cur < live && !__atomic_compare_exchange_n(&peak_bytes, &cur, live, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+				;
+		}
+
+		void	record_deallocate(std::size_t bytes)
+		{
+			__atomic_fetch_add(&deallocations, 1, __ATOMIC_RELAXED);
+			__atomic_fetch_add(&bytes_deallocated, bytes, __ATOMIC_RELAXED);
+			__atomic_fetch_sub(&live_bytes, bytes, __ATOMIC_RELAXED);
+		}
+
+		/* 모든 counter 를 0 으로. peak 도 지금 살아 있는 byte 부터 다시 잰다. */
+		void	reset()
+		{
+			unsigned long* p = reinterpret_cast<unsigned long*>(this);
+			unsigned long live = __atomic_load_n(&live_bytes, __ATOMIC_RELAXED);
+			for (std::size_t i = 0 ; i < sizeof(allocation_stats) / sizeof(unsigned long) ; ++i)
+				__atomic_store_n(p + i, 0, __ATOMIC_RELAXED);
+			__atomic_store_n(&live_bytes, live, __ATOMIC_RELAXED);
+			__atomic_store_n(&peak_bytes, live, __ATOMIC_RELAXED);
+		}
+
+		/* 다른 thread 가 올리는 중에도 읽을 수 있는 사본 */
+		allocation_stats	snapshot() const
+		{
+			allocation_stats snap;
+			const unsigned long* src = reinterpret_cast<const unsigned long*>(this);
+			unsigned long* dst = reinterpret_cast<unsigned long*>(&snap);
+			for (std::size_t i = 0 ; i < sizeof(allocation_stats) / sizeof(unsigned long) ; ++i)
+				dst[i] = __atomic_load_n(src + i, __ATOMIC_RELAXED);
+			return snap;
+		}
+
+		/* 아직 해제되지 않은 block 수 */
+		unsigned long	live_blocks() const
+		{ return allocations - deallocations; }
+
+		static int	bin(std::size_t bytes)
+		{
+			int i = 0;
+			while (i < histogram_size - 1 && (static_cast<std::size_t>(1) << i) < bytes)
+				++i;
+			return i;
+		}
+
+		void	dump(std::FILE* out) const
+		{
+			allocation_stats s = snapshot();
+			std::fprintf(out, "alloc %lu  dealloc %lu  bytes %lu / %lu  live %lu  peak %lu\n",
+				s.allocations, s.deallocations, s.bytes_allocated, s.bytes_deallocated, s.live_bytes, s.peak_bytes);
+			for (int i = 0 ; i < histogram_size ; ++i)
+				if (s.histogram[i])
+					std::fprintf(out, "  %s %10lu B : %lu\n", i == histogram_size - 1 ? " >" : "<=",
+						static_cast<unsigned long>(1) << (i == histogram_size - 1 ? i - 1 : i), s.histogram[i]);
+		}
+
+		static allocation_stats&	global();
+	};
+
+	/* 처음 쓸 때 만들어지므로 다른 전역 객체의 생성자에서 할당해도 된다. */
+	inline allocation_stats&	allocation_stats::global()
+	{
+		static allocation_stats stats;
+		return stats;
+	}
+
+	template <typename T>
+	class counting_allocator
+	{
+		public:
+			typedef T					value_type;
+			typedef T*					pointer;
+			typedef const T*			const_pointer;
+			typedef T&					reference;
+			typedef const T&			const_reference;
+			typedef std::size_t			size_type;
+			typedef std::ptrdiff_t		difference_type;
+
+			template <typename U>
+			struct rebind
+			{ typedef counting_allocator<U> other; };
+
+			counting_allocator() throw()
+			: __stats(&allocation_stats::global()) {}
+			explicit counting_allocator(allocation_stats* stats) throw()
+			: __stats(stats) {}
+			counting_allocator(const counting_allocator& other) throw()
+			: __stats(other.__stats) {}
+			template <typename U>
+			counting_allocator(const counting_allocator<U>& other) throw()
+			: __stats(other.stats()) {}
+			~counting_allocator() throw() {}
+
+			allocation_stats*	stats() const throw()
+			{ return __stats; }
+
+			pointer	address(reference x) const
+			{ return &x; }
+			const_pointer	address(const_reference x) const
+			{ return &x; }
+
+			pointer	allocate(size_type n, const void* hint = 0)
+			{
+				(void)hint;
+				if (n > max_size())
+					throw std::bad_alloc();
+				pointer p = static_cast<pointer>(::operator new(n * sizeof(T)));
+				__stats->record_allocate(n * sizeof(T));
+				return p;
+			}
+			/* 빈 vector 처럼 할당한 적 없는 null 을 돌려받으면 세지 않는다. */
+			void	deallocate(pointer p, size_type n)
+			{
+				if (p == 0)
+					return;
+				__stats->record_deallocate(n * sizeof(T));
+				::operator delete(static_cast<void*>(p));
+			}
+
+			size_type	max_size() const throw()
+			{ return std::numeric_limits<size_type>::max() / sizeof(T); }
+
+			void	construct(pointer p)
+			{ ::new (static_cast<void*>(p)) T(); }
+			template <typename U>
+			void	construct(pointer p, const U& val)
+			{ ::new (static_cast<void*>(p)) T(val); }
+			void	destroy(pointer p)
+			{ p->~T(); }
+
+		private:
+			allocation_stats*	__stats;
+	};
+
+	/* 같은 stats 에 기록하면 서로의 메모리를 해제해도 된다. */
+	template <typename T, typename U>
+	bool	operator==(const counting_allocator<T>& a, const counting_allocator<U>& b)
+	{ return a.stats() == b.stats(); }
+	template <typename T, typename U>
+	bool	operator!=(const counting_allocator<T>& a, const counting_allocator<U>& b)
+	{ return a.stats() != b.stats(); }
+
+}
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef FOOTPRINT_HPP
+# define FOOTPRINT_HPP
+
+# include <cstddef>
+
+/* container 의 memory_usage() 가 돌려주는 메모리 내역 (byte)
+ *
+ * payload   : 원소 자체. size() * sizeof(value_type) 이고, 원소가 따로 잡은 heap (std::string 의 buffer 등)은 세지 않는다.
+ * overhead  : 원소가 아닌 구조. container 객체, 노드의 link / color, sentinel 노드, frozen 의 채움 칸과 순서 표 등
+ * slack     : 잡아 두었지만 원소가 없는 칸. vector 의 capacity - size 등
+ * allocator : 할당 한 번마다 allocator 가 더 쓰는 header 와 올림의 추정치 (__heap_block_overhead)
+ *
+ * total() 을 size() 로 나누면 원소 하나가 실제로 차지하는 byte 다.
+ */
+
+namespace ft {
+
+	struct memory_footprint
+	{
+		std::size_t	payload;
+		std::size_t	overhead;
+		std::size_t	slack;
+		std::size_t	allocator;
+
+		memory_footprint() : payload(0), overhead(0), slack(0), allocator(0) {}
+
+		std::size_t	total() const
+		{ return payload + overhead + slack + allocator; }
+
+		memory_footprint&	operator+=(const memory_footprint& x)
+		{
+			payload += x.payload;
+			overhead += x.overhead;
+			slack += x.slack;
+			allocator += x.allocator;
+			return *this;
+		}
+	};
+
+	/* bytes 를 malloc 으로 받을 때 요청보다 더 쓰는 byte 의 추정치
+	 * glibc : 8 byte header 를 붙여 16 byte 단위로 올리고 최소 32 byte
+	 * 그 외 (macOS 의 magazine 등) : header 없이 16 byte 단위로 올리고 최소 16 byte */
+	inline std::size_t	__heap_block_overhead(std::size_t bytes)
+	{
+# ifdef __GLIBC__
+		std::size_t block = (bytes + sizeof(std::size_t) + 15) & ~static_cast<std::size_t>(15);
+		if (block < 32)
+			block = 32;
+# else
+		std::size_t block = (bytes + 15) & ~static_cast<std::size_t>(15);
+		if (block < 16)
+			block = 16;
+# endif
+		return block - bytes;
+	}
+
+}
+
+#endif
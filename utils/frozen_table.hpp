@@ -0,0 +1,452 @@
+#ifndef FROZEN_TABLE_HPP
+# define FROZEN_TABLE_HPP
+
+# include <cstddef>
+# include <memory>
+# include "type.hpp"
+# include "footprint.hpp"
+# include "../vector.hpp"
+
+/* frozen_set / frozen_map 의 저장소
+ *
+ * 한 번 만들고 나면 바뀌지 않는 정렬된 원소들을 노드 없이 배열 하나에 담는다.
+ * 이진 탐색 트리의 모양(완전 이진 트리)을 배열 안의 위치로만 표현하므로 포인터를 따라갈 필요가 없고,
+ * 탐색은 비교 결과를 index 에 더하는 것만으로 내려가서 분기 예측 실패가 없다. (branch-free)
+ *
+ * eytzinger_layout : BFS 순서. node k 의 자식은 2k, 2k + 1 (k 는 1 부터)
+ *                    자손 16 개(4 단계 아래)가 배열에서 붙어있으므로 내려가는 동안 미리 prefetch 한다.
+ * veb_layout       : van Emde Boas 순서. 트리를 높이의 절반에서 위 / 아래 sub-tree 로 나누는 걸 재귀적으로 반복해
+ *                    sub-tree 하나를 연속된 구간에 둔다. cache line 크기를 몰라도 한 번 읽은 line 에서 여러 단계를 내려간다.
+ *                    완전 트리를 맞추기 위해 빈 자리는 최대 원소의 복사본으로 채우고(최대 n 개 더),
+ *                    순회를 위해 순위 -> 위치 표를 따로 둔다.
+ *
+ * 위치(cursor) 는 layout 마다 뜻이 다르다. (eytzinger : BFS index, end 는 0 / veb : 순위, end 는 size)
+ * iterator 는 table 객체가 아니라 배열을 가리키는 __frozen_view 를 들고 다니므로 container 를 swap 해도 같은 원소를 가리킨다.
+ * 원소 비교는 Comp(value, key) / Comp(key, value) 두 방향을 쓴다.
+ */
+
+namespace ft {
+
+	struct eytzinger_layout {};
+	struct veb_layout {};
+
+	/* iterator 가 보는 배열. __order 는 veb 의 순위 -> 칸 표 (eytzinger 는 NIL) */
+	template <typename T>
+	struct __frozen_view
+	{
+		const T*			__data;
+		const std::size_t*	__order;
+		std::size_t			__size;
+
+		__frozen_view() : __data(ft::NIL), __order(ft::NIL), __size(0) {}
+		__frozen_view(const T* data, const std::size_t* order, std::size_t size)
+		: __data(data), __order(order), __size(size) {}
+	};
+
+	/* [__lo, __hi) 칸에 원소가 생성되어 있다. 복사와 해제는 layout 과 상관없이 칸 단위로 한다. */
+	template <typename T, class Alloc>
+	class __frozen_storage
+	{
+		public:
+			typedef std::size_t									size_type;
+			typedef typename Alloc::template rebind<T>::other	allocator_type;
+
+		protected:
+			allocator_type	__alloc;
+			T*				__data;
+			size_type		__slots;
+			size_type		__lo;
+			size_type		__hi;
+			size_type		__size;
+
+			explicit __frozen_storage(const Alloc& alloc)
+			: __alloc(alloc), __data(ft::NIL), __slots(0), __lo(0), __hi(0), __size(0) {}
+			__frozen_storage(const __frozen_storage& x)
+			: __alloc(x.__alloc), __data(ft::NIL), __slots(0), __lo(0), __hi(0), __size(0)
+			{
+				if (x.__slots == 0)
+					return;
+				__allocate(x.__slots);
+				__lo = x.__lo;
+				__hi = x.__lo;
+				try
+				{
+					for ( ; __hi < x.__hi ; ++__hi)
+						__alloc.construct(__data + __hi, x.__data[__hi]);
+				}
+				catch (...)
+				{
+					__release();
+					throw;
+				}
+				__size = x.__size;
+			}
+			~__frozen_storage()	{ __release(); }
+
+			/* 대입은 복사 후 swap 으로 한다. */
+			__frozen_storage& operator=(const __frozen_storage&);
+
+			void	__allocate(size_type slots)
+			{
+				__data = __alloc.allocate(slots);
+				__slots = slots;
+			}
+			void	__release()
+			{
+				for (size_type i = __lo ; i < __hi ; ++i)
+					__alloc.destroy(__data + i);
+				if (__data != ft::NIL)
+					__alloc.deallocate(__data, __slots);
+				__data = ft::NIL;
+				__slots = __lo = __hi = __size = 0;
+			}
+			void	__swap_storage(__frozen_storage& x)
+			{
+				std::swap(__alloc, x.__alloc);
+				std::swap(__data, x.__data);
+				std::swap(__slots, x.__slots);
+				std::swap(__lo, x.__lo);
+				std::swap(__hi, x.__hi);
+				std::swap(__size, x.__size);
+			}
+
+			/* 가장 아래까지 내려온 index 에서 마지막으로 왼쪽으로 내려간 node 로 돌아간다. (없으면 0)
+			 * 오른쪽으로 간 만큼 끝에 1 이 쌓여있으므로 그 1 들과 왼쪽으로 간 한 칸을 떼어낸다. */
+			static size_type	__climb_right(size_type k)	{ return k >> (__builtin_ctzl(~k) + 1); }
+			static size_type	__climb_left(size_type k)	{ return k >> (__builtin_ctzl(k) + 1); }
+
+		public:
+			size_type		size() const			{ return __size; }
+			allocator_type	get_allocator() const	{ return __alloc; }
+
+			/* 다시 자라지 않으므로 slack 은 없고, 원소가 아닌 칸(eytzinger 의 0 번 칸, veb 의 채움 칸)은 overhead 다.
+			container 객체의 크기는 부르는 쪽이 더한다. */
+			ft::memory_footprint	memory_usage() const
+			{
+				ft::memory_footprint m;
+				m.payload = __size * sizeof(T);
+				m.overhead = (__slots - __size) * sizeof(T);
+				if (__data != ft::NIL)
+					m.allocator = ft::__heap_block_overhead(__slots * sizeof(T));
+				return m;
+			}
+	};
+
+	template <typename T, class Comp, class Alloc, class Layout>
+	class __frozen_table;
+
+	template <typename T, class Comp, class Alloc>
+	class __frozen_table<T, Comp, Alloc, eytzinger_layout> : public __frozen_storage<T, Alloc>
+	{
+		private:
+			typedef __frozen_storage<T, Alloc>	__base;
+
+			Comp	__comp;
+
+		public:
+			typedef typename __base::size_type	size_type;
+			typedef __frozen_view<T>			view_type;
+
+			__frozen_table(const Comp& comp, const Alloc& alloc) : __base(alloc), __comp(comp) {}
+
+			/* [first, first + n) 은 정렬되어 있고 중복이 없어야 한다. in-order 로 칸을 돌며 차례로 채운다. O(n) */
+			template <class ForwardIterator>
+			void	__build(ForwardIterator first, size_type n)
+			{
+				if (n == 0)
+					return;
+				/* 0 번 칸은 비워두고 prefetch 가 범위를 넘을 때 대신 가리킨다. */
+				this->__allocate(n + 1);
+				this->__size = n;
+				this->__lo = this->__hi = 1;
+				size_type k = __begin();
+				size_type built = 0;
+				try
+				{
+					for ( ; built < n ; ++built, ++first, k = __next(k))
+						this->__alloc.construct(this->__data + k, *first);
+				}
+				catch (...)
+				{
+					for (k = __begin() ; built > 0 ; --built, k = __next(k))
+						this->__alloc.destroy(this->__data + k);
+					this->__size = 0;
+					this->__release();
+					throw;
+				}
+				this->__hi = n + 1;
+			}
+
+			void	swap(__frozen_table& x)
+			{
+				this->__swap_storage(x);
+				std::swap(__comp, x.__comp);
+			}
+
+			view_type	__view() const	{ return view_type(this->__data, ft::NIL, this->__size); }
+
+			const T&	__at(size_type k) const			{ return this->__data[k]; }
+			size_type	__next(size_type k) const		{ return __next(__view(), k); }
+			size_type	__prev(size_type k) const		{ return __prev(__view(), k); }
+
+			size_type	__end() const	{ return 0; }
+			size_type	__begin() const
+			{
+				if (this->__size == 0)
+					return 0;
+				size_type k = 1;
+				while (2 * k <= this->__size)
+					k = 2 * k;
+				return k;
+			}
+
+			static const T&	__at(const view_type& v, size_type k)	{ return v.__data[k]; }
+			static size_type	__next(const view_type& v, size_type k)
+			{
+				if (2 * k + 1 <= v.__size)
+				{
+					for (k = 2 * k + 1 ; 2 * k <= v.__size ; k = 2 * k)
+						;
+					return k;
+				}
+				return __base::__climb_right(k);
+			}
+			/* end 에서 -- 하면 최대 원소 */
+			static size_type	__prev(const view_type& v, size_type k)
+			{
+				if (k == 0)
+				{
+					for (k = 1 ; 2 * k + 1 <= v.__size ; k = 2 * k + 1)
+						;
+					return k;
+				}
+				if (2 * k <= v.__size)
+				{
+					for (k = 2 * k ; 2 * k + 1 <= v.__size ; k = 2 * k + 1)
+						;
+					return k;
+				}
+				return __base::__climb_left(k);
+			}
+
+			/* key 보다 작으면 오른쪽(2k + 1), 아니면 왼쪽(2k). 끝까지 내려간 뒤 마지막으로 왼쪽으로 간 node 가 답 */
+			template <typename K>
+			size_type	__lower_bound(const K& key) const
+			{
+				size_type k = 1;
+				while (k <= this->__size)
+				{
+					__prefetch(k);
+					k = 2 * k + static_cast<size_type>(__comp(this->__data[k], key));
+				}
+				return this->__climb_right(k);
+			}
+			template <typename K>
+			size_type	__upper_bound(const K& key) const
+			{
+				size_type k = 1;
+				while (k <= this->__size)
+				{
+					__prefetch(k);
+					k = 2 * k + static_cast<size_type>(!__comp(key, this->__data[k]));
+				}
+				return this->__climb_right(k);
+			}
+
+		private:
+			/* 4 단계 아래 자손 16 개는 16k 부터 붙어있다. 범위를 넘으면 0 번 칸을 가리켜 분기 없이 넘어간다. */
+			void	__prefetch(size_type k) const
+			{
+				size_type ahead = k << 4;
+				__builtin_prefetch(this->__data + (ahead <= this->__size ? ahead : 0));
+			}
+	};
+
+	template <typename T, class Comp, class Alloc>
+	class __frozen_table<T, Comp, Alloc, veb_layout> : public __frozen_storage<T, Alloc>
+	{
+		private:
+			typedef __frozen_storage<T, Alloc>	__base;
+
+		public:
+			typedef typename __base::size_type	size_type;
+			typedef __frozen_view<T>			view_type;
+
+		private:
+			static const int	__max_height = 8 * sizeof(void*);
+
+			Comp					__comp;
+			int						__height;
+			/* depth d 의 node 가 뿌리인 아래 sub-tree 를 만든 분할 : 위 sub-tree 의 뿌리 depth, 위 sub-tree 크기, 아래 sub-tree 크기 */
+			int						__top_depth[__max_height];
+			size_type				__top_size[__max_height];
+			size_type				__bottom_size[__max_height];
+			/* 순위 -> 칸 */
+			ft::vector<size_type>	__order;
+
+		public:
+			__frozen_table(const Comp& comp, const Alloc& alloc) : __base(alloc), __comp(comp), __height(0) {}
+
+			template <class ForwardIterator>
+			void	__build(ForwardIterator first, size_type n)
+			{
+				if (n == 0)
+					return;
+				__height = 1;
+				while ((static_cast<size_type>(1) << __height) - 1 < n)
+					++__height;
+				__split(0, __height);
+				size_type slots = (static_cast<size_type>(1) << __height) - 1;
+				/* vEB 순서로 BFS index 를 늘어놓고, 순위마다 들어갈 칸을 구한다. */
+				ft::vector<size_type> bfs;
+				bfs.reserve(slots);
+				__emit(1, __height, bfs);
+				ft::vector<size_type> slot_of(slots);
+				for (size_type i = 0 ; i < slots ; ++i)
+					slot_of[__rank_of(bfs[i])] = i;
+				this->__allocate(slots);
+				/* 순위 n 이상의 남는 칸은 최대 원소로 채운다. 찾은 자리의 순위가 n 이상이면 end 로 본다. */
+				size_type built = 0;
+				try
+				{
+					for ( ; built < n ; ++built, ++first)
+						this->__alloc.construct(this->__data + slot_of[built], *first);
+					for ( ; built < slots ; ++built)
+						this->__alloc.construct(this->__data + slot_of[built], this->__data[slot_of[n - 1]]);
+				}
+				catch (...)
+				{
+					while (built > 0)
+						this->__alloc.destroy(this->__data + slot_of[--built]);
+					this->__release();
+					throw;
+				}
+				__order.assign(slot_of.begin(), slot_of.begin() + n);
+				this->__size = n;
+				this->__lo = 0;
+				this->__hi = slots;
+			}
+
+			/* 순위 -> 칸 표도 overhead 다. */
+			ft::memory_footprint	memory_usage() const
+			{
+				ft::memory_footprint m = __base::memory_usage();
+				ft::memory_footprint order = __order.memory_usage();
+				m.overhead += order.total() - order.allocator - sizeof(__order);
+				m.allocator += order.allocator;
+				return m;
+			}
+
+			void	swap(__frozen_table& x)
+			{
+				this->__swap_storage(x);
+				std::swap(__comp, x.__comp);
+				std::swap(__height, x.__height);
+				for (int d = 0 ; d < __max_height ; ++d)
+				{
+					std::swap(__top_depth[d], x.__top_depth[d]);
+					std::swap(__top_size[d], x.__top_size[d]);
+					std::swap(__bottom_size[d], x.__bottom_size[d]);
+				}
+				__order.swap(x.__order);
+			}
+
+			view_type	__view() const
+			{ return view_type(this->__data, __order.empty() ? ft::NIL : __order.data(), this->__size); }
+
+			const T&	__at(size_type r) const	{ return this->__data[__order[r]]; }
+
+			size_type	__begin() const				{ return 0; }
+			size_type	__end() const				{ return this->__size; }
+			size_type	__next(size_type r) const	{ return r + 1; }
+			size_type	__prev(size_type r) const	{ return r - 1; }
+
+			static const T&	__at(const view_type& v, size_type r)	{ return v.__data[v.__order[r]]; }
+			static size_type	__next(const view_type&, size_type r)	{ return r + 1; }
+			static size_type	__prev(const view_type&, size_type r)	{ return r - 1; }
+
+			template <typename K>
+			size_type	__lower_bound(const K& key) const
+			{
+				if (this->__size == 0)
+					return 0;
+				size_type pos[__max_height];
+				size_type k = 1;
+				pos[0] = 0;
+				for (int d = 0 ; ; )
+				{
+					k = 2 * k + static_cast<size_type>(__comp(this->__data[pos[d]], key));
+					if (++d == __height)
+						break;
+					pos[d] = __position(pos, d, k);
+				}
+				return __result(this->__climb_right(k));
+			}
+			template <typename K>
+			size_type	__upper_bound(const K& key) const
+			{
+				if (this->__size == 0)
+					return 0;
+				size_type pos[__max_height];
+				size_type k = 1;
+				pos[0] = 0;
+				for (int d = 0 ; ; )
+				{
+					k = 2 * k + static_cast<size_type>(!__comp(key, this->__data[pos[d]]));
+					if (++d == __height)
+						break;
+					pos[d] = __position(pos, d, k);
+				}
+				return __result(this->__climb_right(k));
+			}
+
+		private:
+			/* 높이 height 인 sub-tree (뿌리 depth) 를 위 height / 2, 아래 나머지로 나눈다. */
+			void	__split(int depth, int height)
+			{
+				if (height <= 1)
+					return;
+				int top = height / 2;
+				int bottom = height - top;
+				int d = depth + top;
+				__top_depth[d] = depth;
+				__top_size[d] = (static_cast<size_type>(1) << top) - 1;
+				__bottom_size[d] = (static_cast<size_type>(1) << bottom) - 1;
+				__split(depth, top);
+				__split(d, bottom);
+			}
+			/* 위 sub-tree 를 먼저, 그 다음 아래 sub-tree 들을 왼쪽부터 */
+			void	__emit(size_type k, int height, ft::vector<size_type>& out) const
+			{
+				if (height == 1)
+				{
+					out.push_back(k);
+					return;
+				}
+				int top = height / 2;
+				__emit(k, top, out);
+				for (size_type i = 0 ; i < (static_cast<size_type>(1) << top) ; ++i)
+					__emit((k << top) + i, height - top, out);
+			}
+			/* depth d, BFS index k 인 node 의 칸 : 위 sub-tree 뿌리의 칸 + 위 sub-tree + 앞선 아래 sub-tree 들 */
+			size_type	__position(const size_type* pos, int d, size_type k) const
+			{ return pos[__top_depth[d]] + __top_size[d] + (k & __top_size[d]) * __bottom_size[d]; }
+
+			/* 높이 __height 인 완전 트리에서 BFS index k 의 in-order 순위 */
+			size_type	__rank_of(size_type k) const
+			{
+				int d = 8 * sizeof(size_type) - 1 - __builtin_clzl(k);
+				return ((((k - (static_cast<size_type>(1) << d)) << 1) | 1) << (__height - 1 - d)) - 1;
+			}
+			size_type	__result(size_type k) const
+			{
+				if (k == 0)
+					return this->__size;
+				size_type r = __rank_of(k);
+				return r < this->__size ? r : this->__size;
+			}
+	};
+
+}
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef HASH_HPP
+# define HASH_HPP
+
+# include <cstddef>
+# include <string>
+# include "type.hpp"
+
+/* hash
+ *
+ * concurrent_map 이 key 를 shard 로 나눌 때 쓰는 hash 함수 객체. (C++98 에는 std::hash 가 없다)
+ * 정수형, 포인터, std::basic_string 만 기본으로 제공하고, 그 외의 key 는 직접 Hash 를 넘긴다.
+ * shard 번호는 하위 비트로 고르므로 연속된 정수 key 도 고르게 퍼지도록 비트를 섞는다.
+ */
+
+namespace ft {
+
+	inline std::size_t	__hash_mix(std::size_t x)
+	{
+		x ^= x >> 16;
+		x *= 0x45d9f3b;
+		x ^= x >> 16;
+		x *= 0x45d9f3b;
+		x ^= x >> 16;
+		return x;
+	}
+
+	template <typename T, typename = void>
+	struct hash;
+
+	template <typename T>
+	struct hash<T, typename enable_if<is_integral<T>::value>::type>
+	{
+		std::size_t	operator()(T val) const
+		{ return __hash_mix(static_cast<std::size_t>(val)); }
+	};
+
+	template <typename T>
+	struct hash<T*>
+	{
+		std::size_t	operator()(T* ptr) const
+		{ return __hash_mix(reinterpret_cast<std::size_t>(ptr)); }
+	};
+
+	/* FNV-1a */
+	template <class CharT, class Traits, class Alloc>
+	struct hash<std::basic_string<CharT, Traits, Alloc> >
+	{
+		std::size_t	operator()(const std::basic_string<CharT, Traits, Alloc>& str) const
+		{
+			std::size_t h = 2166136261u;
+			for (typename std::basic_string<CharT, Traits, Alloc>::size_type i = 0 ; i < str.size() ; ++i)
+			{
+				h ^= static_cast<std::size_t>(str[i]);
+				h *= 16777619u;
+			}
+			return __hash_mix(h);
+		}
+	};
+
+}
+
+#endif
@@ -0,0 +1,168 @@
+#ifndef INSTRUMENT_HPP
+# define INSTRUMENT_HPP
+
+# include <cstddef>
+# include <cstdio>
+# include <cstdlib>
+# include <typeinfo>
+# include <cxxabi.h>
+
+/* 연산 counter
+ *
+ * FT_INSTRUMENT 를 정의하고 빌드하면 container type 마다 아래 counter 를 센다.
+ * 정의하지 않으면 FT_OP_COUNT / FT_OP_MAX 는 ((void)0) 이 되고 인자도 평가하지 않으므로 아무 코드도 남지 않는다.
+ * (op_registry 는 그대로 있지만 아무 type 도 등록되지 않는다)
+ *
+ * type 은 counter 를 처음 올릴 때 op_registry 에 등록된다. vector 는 ft::vector<T, Alloc>, map / set 은 안의 ft::__rbt<...> 단위다.
+ * counter 는 relaxed atomic 으로 올리므로 여러 thread 에서 써도 되고, 읽는 값은 그 순간의 근사치다.
+ *
+ * ft::op_registry::dump(stderr);
+ * ft::op_registry::visit(my_callback, my_ctx);   // void my_callback(const char* type, const ft::op_counters&, void* ctx)
+ * ft::op_registry::reset();
+ */
+
+namespace ft {
+
+	struct op_counters
+	{
+		unsigned long	allocations;		/* allocate 호출 수 */
+		unsigned long	deallocations;
+		unsigned long	bytes_allocated;
+		unsigned long	reallocations;		/* vector 가 버퍼를 옮긴 횟수 */
+		unsigned long	elements_copied;	/* 버퍼를 옮기면서 복사한 원소 수 */
+		unsigned long	comparisons;		/* 비교자 호출 수 (three-way 한 번도 1) */
+		unsigned long	rotations;
+		unsigned long	fixup_iterations;	/* insert / erase 뒤 rebalance loop 를 돈 횟수 */
+		unsigned long	inserts;			/* 새 노드를 매단 횟수 */
+		unsigned long	insert_depth_sum;	/* 매단 노드의 깊이 합 (root 가 0) */
+		unsigned long	insert_depth_max;
+	};
+
+	/* visit 에 넘기는 callback. type 은 demangle 된 type 이름 */
+	typedef void	(*op_visitor)(const char* type, const op_counters& counters, void* ctx);
+
+	/* type 마다 static entry 하나를 두고 처음 쓰는 thread 가 list 앞에 CAS 로 끼우는 목록. 빼지는 않는다.
+	Entry 에는 type, next, registered 가 있어야 한다. 연산 counter 와 latency histogram (latency.hpp) 이 같이 쓴다. */
+	template <class Entry>
+	struct __type_registry
+	{
+		static Entry*	head;
+
+		/* entry 를 Tag 의 이름으로 한 번만 등록한다. */
+		template <class Tag>
+		static void	__register(Entry& entry)
+		{
+			if (!__sync_bool_compare_and_swap(&entry.registered, 0, 1))
+				return;
+			entry.type = typeid(Tag).name();
+			Entry* old;
+			do
+			{
+				old = head;
+				entry.next = old;
+			} while (!__sync_bool_compare_and_swap(&head, old, &entry));
+		}
+
+		/* 나중에 등록된 것부터 next 로 이어진다. */
+		static Entry*	__first()	{ return __sync_fetch_and_add(&head, 0); }
+	};
+
+	template <class Entry>
+	Entry*	__type_registry<Entry>::head = 0;
+
+	struct __op_entry
+	{
+		const char*		type;
+		op_counters		counters;
+		__op_entry*		next;
+		int				registered;
+	};
+
+	/* Tag(container type) 하나에 entry 하나. 처음 counter 를 올릴 때 등록한다. */
+	template <class Tag>
+	struct __op_stats
+	{
+		static __op_entry	entry;
+
+		static void	__add(unsigned long op_counters::* field, unsigned long n)
+		{
+			if (!entry.registered)
+				__type_registry<__op_entry>::__register<Tag>(entry);
+			__atomic_fetch_add(&(entry.counters.*field), n, __ATOMIC_RELAXED);
+		}
+
+		static void	__max(unsigned long op_counters::* field, unsigned long v)
+		{
+			if (!entry.registered)
+				__type_registry<__op_entry>::__register<Tag>(entry);
+			unsigned long cur = __atomic_load_n(&(entry.counters.*field), __ATOMIC_RELAXED);
+			while (cur < v && !__atomic_compare_exchange_n(&(entry.counters.*field), &cur, v, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+				;
+		}
+	};
+
+	template <class Tag>
+	__op_entry	__op_stats<Tag>::entry = { 0, op_counters(), 0, 0 };
+
+	struct op_registry
+	{
+		/* 등록된 type 마다 fn(type, counters, ctx). 새 type 이 나중에 등록된 것부터 */
+		static void	visit(op_visitor fn, void* ctx)
+		{
+			for (__op_entry* e = __type_registry<__op_entry>::__first() ; e != 0 ; e = e->next)
+			{
+				op_counters snap = __snapshot(e->counters);
+				int status = 0;
+				char* name = abi::__cxa_demangle(e->type, 0, 0, &status);
+				fn(status == 0 && name ? name : e->type, snap, ctx);
+				std::free(name);
+			}
+		}
+
+		static void	dump(std::FILE* out)
+		{ visit(__print, out); }
+
+		static void	reset()
+		{
+			for (__op_entry* e = __type_registry<__op_entry>::__first() ; e != 0 ; e = e->next)
+			{
+				unsigned long* p = reinterpret_cast<unsigned long*>(&e->counters);
+				for (std::size_t i = 0 ; i < sizeof(op_counters) / sizeof(unsigned long) ; ++i)
+					__atomic_store_n(p + i, 0, __ATOMIC_RELAXED);
+			}
+		}
+
+		private:
+			static op_counters	__snapshot(op_counters& c)
+			{
+				op_counters snap;
+				unsigned long* src = reinterpret_cast<unsigned long*>(&c);
+				unsigned long* dst = reinterpret_cast<unsigned long*>(&snap);
+				for (std::size_t i = 0 ; i < sizeof(op_counters) / sizeof(unsigned long) ; ++i)
+					dst[i] = __atomic_load_n(src + i, __ATOMIC_RELAXED);
+				return snap;
+			}
+
+			static void	__print(const char* type, const op_counters& c, void* ctx)
+			{
+				std::FILE* out = static_cast<std::FILE*>(ctx);
+				std::fprintf(out, "%s\n", type);
+				std::fprintf(out, "  alloc %lu  dealloc %lu  bytes %lu  realloc %lu  copied %lu\n",
+					c.allocations, c.deallocations, c.bytes_allocated, c.reallocations, c.elements_copied);
+				std::fprintf(out, "  cmp %lu  rot %lu  fixup %lu  insert %lu  depth avg %.2f max %lu\n",
+					c.comparisons, c.rotations, c.fixup_iterations, c.inserts,
+					c.inserts ? static_cast<double>(c.insert_depth_sum) / c.inserts : 0.0, c.insert_depth_max);
+			}
+	};
+
+}
+
+# ifdef FT_INSTRUMENT
+#  define FT_OP_COUNT(Tag, field, n)	ft::__op_stats<Tag>::__add(&ft::op_counters::field, (n))
+#  define FT_OP_MAX(Tag, field, v)		ft::__op_stats<Tag>::__max(&ft::op_counters::field, (v))
+# else
+#  define FT_OP_COUNT(Tag, field, n)	((void)0)
+#  define FT_OP_MAX(Tag, field, v)		((void)0)
+# endif
+
+#endif
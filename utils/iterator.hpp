@@ -1,6 +1,7 @@
 #ifndef ITERATOR_HPP
 # define ITERATOR_HPP
 
+# include <algorithm>
 # include <cstddef>
 # include <iterator>
 # include "type.hpp"
@@ -263,6 +264,10 @@ namespace ft {
 			typename random_access_iterator<T1>::difference_type operator-(const random_access_iterator<T1>& lhs, const random_access_iterator<T2>& rhs)
 			{ return (lhs.base() - rhs.base()); }
 
+		/* red-black tree (left-leaning 포함) 의 높이는 2 log2(n + 1) 이하이므로 노드 수가 주소 공간 안이면 이 깊이를 넘지 않는다.
+		root 부터의 경로를 배열에 담는 곳(persistent iterator, 순회, 일괄 조회, 통계)은 모두 이 크기를 쓴다. */
+		enum { __tree_max_height = 2 * 8 * sizeof(void*) };
+
 		template <typename T, typename U>
 		class tree_iterator {
 			public:
@@ -274,25 +279,24 @@ namespace ft {
 			typedef typename iterator_traits<iterator_type>::value_type			node_type;
 			typedef typename iterator_traits<iterator_type>::pointer			node_pointer;
 			typedef typename iterator_traits<iterator_type>::reference			node_reference;
-			typedef typename iterator_traits<iterator_type>::iterator_category	iterator_category;
+			/* 일반 노드는 bidirectional, sub-tree 크기를 가진 노드(order statistic)는 random access */
+			typedef typename node_type::iterator_category						iterator_category;
 
+			/* leaf가 null로 끝나고 root가 end 노드에 매달려 있으므로
+			순회에 필요한 건 현재 노드 포인터 하나 뿐이다. */
 			private:
 			node_pointer	__cur;
-			node_pointer	__nil;
 
 			public:
-			tree_iterator() : __cur(ft::NIL), __nil(ft::NIL) {}
-			tree_iterator(node_pointer cur, node_pointer nil) : __cur(cur), __nil(nil) {}
-			tree_iterator(const tree_iterator& tit) : __cur(tit.__cur), __nil(tit.__nil) {}
+			tree_iterator() : __cur(ft::NIL) {}
+			explicit tree_iterator(node_pointer cur) : __cur(cur) {}
+			tree_iterator(const tree_iterator& tit) : __cur(tit.__cur) {}
 			~tree_iterator() {}
 
 			tree_iterator& operator=(const tree_iterator& rhs)
 			{
 				if (this != &rhs)
-				{
 					__cur = rhs.__cur;
-					__nil = rhs.__nil;
-				}
 				return (*this);
 			}
 
@@ -302,7 +306,7 @@ namespace ft {
 
 			tree_iterator& operator++()
 			{
-				__cur = __next_node(__cur, __nil);
+				__cur = __next_node(__cur);
 				return (*this);
 			}
 
@@ -315,7 +319,7 @@ namespace ft {
 
 			tree_iterator& operator--()
 			{
-				__cur = __prev_node(__cur, __nil);
+				__cur = __prev_node(__cur);
 				return (*this);
 			}
 
@@ -326,6 +330,48 @@ namespace ft {
 				return (tmp);
 			}
 
+			/* 아래 연산은 order statistic 노드에서만 정의된다. (__advance_node / __node_distance) O(log n) */
+			tree_iterator& operator+=(difference_type n)
+			{
+				__cur = __advance_node(__cur, n);
+				return (*this);
+			}
+
+			tree_iterator& operator-=(difference_type n)
+			{
+				__cur = __advance_node(__cur, -n);
+				return (*this);
+			}
+
+			tree_iterator operator+(difference_type n) const
+			{ return (tree_iterator(*this) += n); }
+
+			tree_iterator operator-(difference_type n) const
+			{ return (tree_iterator(*this) -= n); }
+
+			reference operator[](difference_type n) const
+			{ return *(*this + n); }
+
+			template <typename V>
+			difference_type operator-(const tree_iterator<V, node_type>& x) const
+			{ return __node_distance(x.base(), __cur); }
+
+			template <typename V>
+			bool operator<(const tree_iterator<V, node_type>& x) const
+			{ return (x - *this) > 0; }
+
+			template <typename V>
+			bool operator>(const tree_iterator<V, node_type>& x) const
+			{ return (*this - x) > 0; }
+
+			template <typename V>
+			bool operator<=(const tree_iterator<V, node_type>& x) const
+			{ return !(*this > x); }
+
+			template <typename V>
+			bool operator>=(const tree_iterator<V, node_type>& x) const
+			{ return !(*this < x); }
+
 			template <typename V>
 			bool operator==(const tree_iterator<V, node_type>& x) const
 			{ return (__cur == x.base()); }
@@ -335,7 +381,7 @@ namespace ft {
 			{ return !(__cur == x.base()); }
 
 			operator tree_iterator<const value_type, node_type>(void) const
-			{ return (tree_iterator<const value_type, node_type>(__cur, __nil)); }
+			{ return (tree_iterator<const value_type, node_type>(__cur)); }
 
 			friend bool operator==(const tree_iterator& lhs, const tree_iterator& rhs)
 			{ return (lhs.__cur == rhs.__cur); }
@@ -344,6 +390,182 @@ namespace ft {
 			{ return (!(lhs == rhs)); }
 		};
 
+		/* persistent tree(__persistent_rbt) 용 iterator
+		노드가 여러 snapshot 에 공유되므로 parent 포인터가 없다.
+		root 부터 현재 노드까지의 경로를 직접 들고 다니며, 경로가 비어있으면(__depth == 0) end 이다.
+		snapshot 이 살아있는 동안 가리키는 노드는 바뀌지 않으므로 lock 없이 순회할 수 있다. */
+		template <typename T, typename U>
+		class persistent_tree_iterator {
+			public:
+			typedef T								value_type;
+			typedef T*								pointer;
+			typedef T&								reference;
+			typedef std::ptrdiff_t					difference_type;
+			typedef std::bidirectional_iterator_tag	iterator_category;
+			typedef U								node_type;
+			typedef U*								node_pointer;
+
+			private:
+			node_pointer	__root;
+			node_pointer	__path[__tree_max_height];
+			int				__depth;
+
+			public:
+			persistent_tree_iterator() : __root(ft::NIL), __depth(0) {}
+			explicit persistent_tree_iterator(node_pointer root) : __root(root), __depth(0) {}
+			persistent_tree_iterator(const persistent_tree_iterator& it) : __root(it.__root), __depth(it.__depth)
+			{ std::copy(it.__path, it.__path + it.__depth, __path); }
+			~persistent_tree_iterator() {}
+
+			persistent_tree_iterator& operator=(const persistent_tree_iterator& rhs)
+			{
+				if (this != &rhs)
+				{
+					__root = rhs.__root;
+					__depth = rhs.__depth;
+					std::copy(rhs.__path, rhs.__path + rhs.__depth, __path);
+				}
+				return (*this);
+			}
+
+			node_pointer	base() const		{ return (__depth ? __path[__depth - 1] : node_pointer(ft::NIL)); }
+			pointer			operator->() const	{ return (&base()->__value); }
+			reference		operator*() const	{ return (base()->__value); }
+
+			/* tree 가 탐색하면서 경로를 쌓는다. */
+			void	__push(node_pointer nd_ptr)	{ __path[__depth++] = nd_ptr; }
+			int		__get_depth() const			{ return (__depth); }
+			void	__set_depth(int depth)		{ __depth = depth; }
+
+			persistent_tree_iterator& operator++()
+			{
+				node_pointer cur = __path[__depth - 1];
+				if (cur->__right != ft::NIL)
+				{
+					for (cur = cur->__right ; cur != ft::NIL ; cur = cur->__left)
+						__push(cur);
+					return (*this);
+				}
+				/* 오른쪽 자식에서 올라오는 동안은 계속 올라간다. */
+				do {
+					cur = __path[--__depth];
+				} while (__depth > 0 && __path[__depth - 1]->__right == cur);
+				return (*this);
+			}
+
+			persistent_tree_iterator operator++(int)
+			{
+				persistent_tree_iterator tmp(*this);
+				++(*this);
+				return (tmp);
+			}
+
+			/* end 에서 -- 하면 최대 노드 */
+			persistent_tree_iterator& operator--()
+			{
+				node_pointer cur;
+				if (__depth == 0)
+				{
+					for (cur = __root ; cur != ft::NIL ; cur = cur->__right)
+						__push(cur);
+					return (*this);
+				}
+				cur = __path[__depth - 1];
+				if (cur->__left != ft::NIL)
+				{
+					for (cur = cur->__left ; cur != ft::NIL ; cur = cur->__right)
+						__push(cur);
+					return (*this);
+				}
+				do {
+					cur = __path[--__depth];
+				} while (__depth > 0 && __path[__depth - 1]->__left == cur);
+				return (*this);
+			}
+
+			persistent_tree_iterator operator--(int)
+			{
+				persistent_tree_iterator tmp(*this);
+				--(*this);
+				return (tmp);
+			}
+
+			friend bool operator==(const persistent_tree_iterator& lhs, const persistent_tree_iterator& rhs)
+			{ return (lhs.base() == rhs.base()); }
+
+			friend bool operator!=(const persistent_tree_iterator& lhs, const persistent_tree_iterator& rhs)
+			{ return (!(lhs == rhs)); }
+		};
+
+		/* frozen table(__frozen_table) 용 iterator
+		원소가 배열 안에 layout 순서로 있으므로 배열(view)과 그 안의 위치(cursor) 만 들고 다닌다.
+		table 객체를 가리키지 않으므로 container 를 swap 해도 같은 원소를 가리킨다.
+		cursor 의 뜻과 다음 / 이전 위치는 layout 마다 다르므로 Table 의 static 함수에 묻는다. */
+		template <typename T, typename Table>
+		class frozen_iterator {
+			public:
+			typedef T								value_type;
+			typedef T*								pointer;
+			typedef T&								reference;
+			typedef std::ptrdiff_t					difference_type;
+			typedef std::bidirectional_iterator_tag	iterator_category;
+			typedef typename Table::size_type		cursor_type;
+			typedef typename Table::view_type		view_type;
+
+			private:
+			view_type		__view;
+			cursor_type		__cur;
+
+			public:
+			frozen_iterator() : __view(), __cur(0) {}
+			frozen_iterator(const view_type& view, cursor_type cur) : __view(view), __cur(cur) {}
+			frozen_iterator(const frozen_iterator& it) : __view(it.__view), __cur(it.__cur) {}
+			~frozen_iterator() {}
+
+			frozen_iterator& operator=(const frozen_iterator& rhs)
+			{
+				__view = rhs.__view;
+				__cur = rhs.__cur;
+				return (*this);
+			}
+
+			cursor_type	base() const		{ return (__cur); }
+			pointer		operator->() const	{ return (&Table::__at(__view, __cur)); }
+			reference	operator*() const	{ return (Table::__at(__view, __cur)); }
+
+			frozen_iterator& operator++()
+			{
+				__cur = Table::__next(__view, __cur);
+				return (*this);
+			}
+
+			frozen_iterator operator++(int)
+			{
+				frozen_iterator tmp(*this);
+				++(*this);
+				return (tmp);
+			}
+
+			frozen_iterator& operator--()
+			{
+				__cur = Table::__prev(__view, __cur);
+				return (*this);
+			}
+
+			frozen_iterator operator--(int)
+			{
+				frozen_iterator tmp(*this);
+				--(*this);
+				return (tmp);
+			}
+
+			friend bool operator==(const frozen_iterator& lhs, const frozen_iterator& rhs)
+			{ return (lhs.__cur == rhs.__cur); }
+
+			friend bool operator!=(const frozen_iterator& lhs, const frozen_iterator& rhs)
+			{ return (!(lhs == rhs)); }
+		};
+
 }
 
 #endif
@@ -0,0 +1,296 @@
+#ifndef LATENCY_HPP
+# define LATENCY_HPP
+
+# include <cstddef>
+# include <cstdio>
+# include <cstdlib>
+# include <ctime>
+# include <typeinfo>
+# include <stdint.h>
+# include <cxxabi.h>
+# include "instrument.hpp"
+
+/* 연산별 지연 시간 histogram
+ *
+ * FT_LATENCY 를 정의하고 빌드하면 container type 마다 insert / erase / find / push_back / reserve 의 걸린 시간을 잰다.
+ * 정의하지 않으면 FT_LATENCY_SCOPE 는 ((void)0) 이 되어 아무 코드도 남지 않는다.
+ *
+ * 모든 호출을 재지 않고 thread 마다 sample_rate 번에 한 번만 잰다. (기본 100 = 1%, 0 이면 끔)
+ * 재지 않는 호출은 thread-local counter 하나를 줄이는 것이 전부다.
+ * 시간은 x86 에선 rdtsc, 그 외에는 clock_gettime(CLOCK_MONOTONIC) 으로 재고 내보낼 때 ns 로 바꾼다.
+ *
+ * histogram 은 HDR 처럼 2 의 거듭제곱 구간을 16 칸씩 나눈 log-linear bucket 이라 상대 오차가 1/16 이내이고,
+ * 값의 크기와 상관없이 크기가 고정이다. (할당하지 않는다)
+ *
+ * ft::latency_registry::set_sample_rate(1000);       // 0.1%
+ * ft::latency_registry::dump(stderr);                // type / 연산 마다 p50 p90 p99 p99.9 max (ns)
+ * ft::latency_registry::visit(my_callback, my_ctx);
+ */
+
+namespace ft {
+
+	enum latency_op
+	{
+		latency_insert,
+		latency_erase,
+		latency_find,
+		latency_push_back,
+		latency_reserve,
+		latency_op_count
+	};
+
+	inline const char*	latency_op_name(latency_op op)
+	{
+		static const char* names[latency_op_count] = { "insert", "erase", "find", "push_back", "reserve" };
+		return names[op];
+	}
+
+	/* 0 ~ 15 는 그대로, 그 위로는 [2^e, 2^(e+1)) 을 16 칸으로 나눈다. 단위는 tick
+	생성자가 없는 POD 라 정적 저장소에선 0 으로 시작하고, 그 외에는 reset() 한 뒤 쓴다. */
+	class latency_histogram
+	{
+		public:
+			enum
+			{
+				__sub_bits = 4,
+				__sub_count = 1 << __sub_bits,
+				__bucket_count = (64 - __sub_bits + 1) * __sub_count
+			};
+
+			void	record(uint64_t ticks)
+			{
+				__atomic_fetch_add(&__buckets[__index(ticks)], 1, __ATOMIC_RELAXED);
+				__atomic_fetch_add(&__count, 1, __ATOMIC_RELAXED);
+				__atomic_fetch_add(&__sum, ticks, __ATOMIC_RELAXED);
+				uint64_t cur = __atomic_load_n(&__max, __ATOMIC_RELAXED);
+				while (cur < ticks && !__atomic_compare_exchange_n(&__max, &cur, ticks, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+					;
+			}
+
+			uint64_t	count() const	{ return __atomic_load_n(&__count, __ATOMIC_RELAXED); }
+			uint64_t	max() const		{ return __atomic_load_n(&__max, __ATOMIC_RELAXED); }
+			double		mean() const
+			{
+				uint64_t n = count();
+				return n ? static_cast<double>(__atomic_load_n(&__sum, __ATOMIC_RELAXED)) / n : 0.0;
+			}
+
+			/* p (0 ~ 100) 번째 백분위수가 들어있는 bucket 의 상한. 기록이 없으면 0 */
+			uint64_t	percentile(double p) const
+			{
+				uint64_t n = count();
+				if (n == 0)
+					return 0;
+				uint64_t rank = static_cast<uint64_t>(p / 100.0 * n + 0.5);
+				if (rank == 0)
+					rank = 1;
+				uint64_t seen = 0;
+				for (std::size_t i = 0 ; i < __bucket_count ; ++i)
+				{
+					seen += __atomic_load_n(&__buckets[i], __ATOMIC_RELAXED);
+					if (seen >= rank)
+					{
+						uint64_t upper = __upper_bound(i);
+						return upper < max() ? upper : max();
+					}
+				}
+				return max();
+			}
+
+			void	reset()
+			{
+				for (std::size_t i = 0 ; i < __bucket_count ; ++i)
+					__atomic_store_n(&__buckets[i], 0, __ATOMIC_RELAXED);
+				__atomic_store_n(&__count, 0, __ATOMIC_RELAXED);
+				__atomic_store_n(&__sum, 0, __ATOMIC_RELAXED);
+				__atomic_store_n(&__max, 0, __ATOMIC_RELAXED);
+			}
+
+		private:
+			uint64_t	__buckets[__bucket_count];
+			uint64_t	__count;
+			uint64_t	__sum;
+			uint64_t	__max;
+
+			static std::size_t	__index(uint64_t v)
+			{
+				if (v < __sub_count)
+					return static_cast<std::size_t>(v);
+				int e = 63 - __builtin_clzll(v);
+				std::size_t sub = static_cast<std::size_t>(v >> (e - __sub_bits)) & (__sub_count - 1);
+				return (e - __sub_bits + 1) * __sub_count + sub;
+			}
+
+			static uint64_t	__upper_bound(std::size_t i)
+			{
+				if (i < __sub_count)
+					return i;
+				int e = static_cast<int>(i / __sub_count) + __sub_bits - 1;
+				uint64_t sub = i % __sub_count;
+				uint64_t width = uint64_t(1) << (e - __sub_bits);
+				return ((__sub_count + sub) << (e - __sub_bits)) + width - 1;
+			}
+	};
+
+	struct __latency_clock
+	{
+		/* <x86intrin.h> 는 이 header 를 include 하는 모든 곳에 따라 들어가므로 gcc / clang 내장 함수를 바로 쓴다. */
+		static uint64_t	now()
+		{
+# if defined(__x86_64__) || defined(__i386__)
+			return __builtin_ia32_rdtsc();
+# else
+			return __monotonic_ns();
+# endif
+		}
+
+		static uint64_t	__monotonic_ns()
+		{
+			struct timespec ts;
+			clock_gettime(CLOCK_MONOTONIC, &ts);
+			return static_cast<uint64_t>(ts.tv_sec) * 1000000000u + ts.tv_nsec;
+		}
+
+		/* rdtsc 는 처음 물어볼 때 2ms 동안 clock_gettime 과 맞춰본다. (dump 할 때라 hot path 와 상관없다) */
+		static double	ns_per_tick()
+		{
+# if defined(__x86_64__) || defined(__i386__)
+			static double ratio = 0.0;
+			if (ratio == 0.0)
+			{
+				uint64_t ns0 = __monotonic_ns();
+				uint64_t t0 = __builtin_ia32_rdtsc();
+				uint64_t ns1;
+				while ((ns1 = __monotonic_ns()) - ns0 < 2000000)
+					;
+				ratio = static_cast<double>(ns1 - ns0) / (__builtin_ia32_rdtsc() - t0);
+			}
+			return ratio;
+# else
+			return 1.0;
+# endif
+		}
+	};
+
+	struct __latency_entry
+	{
+		const char*			type;
+		latency_histogram	ops[latency_op_count];
+		__latency_entry*	next;
+		int					registered;
+	};
+
+	template <int Dummy = 0>
+	struct __latency_config
+	{ static unsigned int	rate; };
+
+	template <int Dummy>
+	unsigned int		__latency_config<Dummy>::rate = 100;
+
+	/* thread 마다 rate 번에 한 번 true. 첫 호출은 잰다. rate 가 줄면 바로 따라간다. */
+	inline bool	__latency_sample()
+	{
+		static __thread unsigned int countdown = 0;
+		unsigned int rate = __atomic_load_n(&__latency_config<>::rate, __ATOMIC_RELAXED);
+		if (rate == 0)
+			return false;
+		if (countdown > rate)
+			countdown = rate;
+		if (countdown > 1)
+		{
+			--countdown;
+			return false;
+		}
+		countdown = rate;
+		return true;
+	}
+
+	/* Tag(container type) 하나에 entry 하나. 처음 기록할 때 등록한다. (__type_registry) */
+	template <class Tag>
+	struct __latency_stats
+	{
+		static __latency_entry	entry;
+
+		static void	record(latency_op op, uint64_t ticks)
+		{
+			if (!entry.registered)
+				__type_registry<__latency_entry>::__register<Tag>(entry);
+			entry.ops[op].record(ticks);
+		}
+	};
+
+	template <class Tag>
+	__latency_entry	__latency_stats<Tag>::entry;
+
+	/* 함수 처음에 만들면 sample 된 호출만 끝날 때 걸린 시간을 기록한다. */
+	template <class Tag>
+	class __latency_scope
+	{
+		public:
+			explicit __latency_scope(latency_op op) : __op(op), __start(__latency_sample() ? __latency_clock::now() : 0) {}
+			~__latency_scope()
+			{
+				if (__start != 0)
+					__latency_stats<Tag>::record(__op, __latency_clock::now() - __start);
+			}
+
+		private:
+			latency_op	__op;
+			uint64_t	__start;
+
+			__latency_scope(const __latency_scope&);
+			__latency_scope& operator=(const __latency_scope&);
+	};
+
+	/* visit 에 넘기는 callback. 기록이 있는 (type, 연산) 마다 불린다. 값은 tick 이므로 ns_per_tick() 을 곱한다. */
+	typedef void	(*latency_visitor)(const char* type, latency_op op, const latency_histogram& hist, void* ctx);
+
+	struct latency_registry
+	{
+		static void			set_sample_rate(unsigned int every)	{ __atomic_store_n(&__latency_config<>::rate, every, __ATOMIC_RELAXED); }
+		static unsigned int	sample_rate()	{ return __atomic_load_n(&__latency_config<>::rate, __ATOMIC_RELAXED); }
+		static double		ns_per_tick()	{ return __latency_clock::ns_per_tick(); }
+
+		static void	visit(latency_visitor fn, void* ctx)
+		{
+			for (__latency_entry* e = __type_registry<__latency_entry>::__first() ; e != 0 ; e = e->next)
+			{
+				int status = 0;
+				char* name = abi::__cxa_demangle(e->type, 0, 0, &status);
+				for (int op = 0 ; op < latency_op_count ; ++op)
+					if (e->ops[op].count() > 0)
+						fn(status == 0 && name ? name : e->type, static_cast<latency_op>(op), e->ops[op], ctx);
+				std::free(name);
+			}
+		}
+
+		static void	dump(std::FILE* out)
+		{ visit(__print, out); }
+
+		static void	reset()
+		{
+			for (__latency_entry* e = __type_registry<__latency_entry>::__first() ; e != 0 ; e = e->next)
+				for (int op = 0 ; op < latency_op_count ; ++op)
+					e->ops[op].reset();
+		}
+
+		private:
+			static void	__print(const char* type, latency_op op, const latency_histogram& h, void* ctx)
+			{
+				double k = ns_per_tick();
+				std::fprintf(static_cast<std::FILE*>(ctx),
+					"%s %s: n %lu  mean %.0f  p50 %.0f  p90 %.0f  p99 %.0f  p99.9 %.0f  max %.0f (ns)\n",
+					type, latency_op_name(op), static_cast<unsigned long>(h.count()), h.mean() * k,
+					h.percentile(50) * k, h.percentile(90) * k, h.percentile(99) * k, h.percentile(99.9) * k, h.max() * k);
+			}
+	};
+
+}
+
+# ifdef FT_LATENCY
+#  define FT_LATENCY_SCOPE(Tag, op)	ft::__latency_scope<Tag> __ft_latency_scope(ft::op)
+# else
+#  define FT_LATENCY_SCOPE(Tag, op)	((void)0)
+# endif
+
+#endif
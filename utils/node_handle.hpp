@@ -0,0 +1,127 @@
+#ifndef NODE_HANDLE_HPP
+# define NODE_HANDLE_HPP
+
+# include <algorithm>
+# include "type.hpp"
+
+/* node handle
+ *
+ * map / set 의 extract() 가 tree 에서 떼어낸 노드 하나를 소유하는 객체.
+ * insert(node_handle) 로 다른 tree 에 그대로 다시 연결되므로 value 를 복사하거나 노드를 새로 할당하지 않는다.
+ * 비어있지 않은 채로 소멸하면 노드를 해제한다.
+ *
+ * C++98 에는 move 가 없으므로 std::auto_ptr 처럼 복사(대입)하면 소유권이 옮겨가고 원본은 비게 된다.
+ * 노드는 같은(equal) 할당자를 쓰는 tree 사이에서만 옮길 수 있다.
+ */
+
+namespace ft {
+
+	template <class Node, class Alloc>
+	class __node_handle_base
+	{
+		public:
+			typedef Alloc	allocator_type;
+			typedef Node*	node_pointer;
+
+		protected:
+			typedef typename Alloc::template rebind<Node>::other	node_allocator;
+
+			/* 복사 생성 / 대입의 원본(const)에서도 소유권을 가져올 수 있게 mutable */
+			mutable node_pointer	__ptr;
+			allocator_type			__alloc;
+
+		public:
+			__node_handle_base() : __ptr(ft::NIL), __alloc() {}
+			__node_handle_base(node_pointer ptr, const allocator_type& alloc) : __ptr(ptr), __alloc(alloc) {}
+			__node_handle_base(const __node_handle_base& nh) : __ptr(nh.__release()), __alloc(nh.__alloc) {}
+			~__node_handle_base() { __destroy(); }
+
+			__node_handle_base& operator=(const __node_handle_base& nh)
+			{
+				if (this != &nh)
+				{
+					__destroy();
+					__alloc = nh.__alloc;
+					__ptr = nh.__release();
+				}
+				return *this;
+			}
+
+			bool			empty() const			{ return __ptr == ft::NIL; }
+			allocator_type	get_allocator() const	{ return __alloc; }
+
+			void	swap(__node_handle_base& nh)
+			{
+				std::swap(__ptr, nh.__ptr);
+				std::swap(__alloc, nh.__alloc);
+			}
+
+			/* tree 가 노드를 가져갈 때 사용 */
+			node_pointer	__get() const { return __ptr; }
+			node_pointer	__release() const
+			{
+				node_pointer ptr = __ptr;
+				__ptr = ft::NIL;
+				return ptr;
+			}
+
+		protected:
+			void	__destroy()
+			{
+				if (__ptr == ft::NIL)
+					return;
+				node_allocator alloc(__alloc);
+				alloc.destroy(__ptr);
+				alloc.deallocate(__ptr, 1);
+				__ptr = ft::NIL;
+			}
+	};
+
+	/* map 용 : key(), mapped() */
+	template <class Node, class Alloc>
+	class __map_node_handle : public __node_handle_base<Node, Alloc>
+	{
+		public:
+			typedef typename Node::value_type			value_type;
+			typedef typename value_type::first_type		key_type;
+			typedef typename value_type::second_type	mapped_type;
+			typedef Alloc								allocator_type;
+			typedef Node*								node_pointer;
+
+			__map_node_handle() {}
+			__map_node_handle(node_pointer ptr, const allocator_type& alloc)
+			: __node_handle_base<Node, Alloc>(ptr, alloc) {}
+
+			const key_type&	key() const		{ return this->__ptr->__value.first; }
+			mapped_type&	mapped() const	{ return this->__ptr->__value.second; }
+	};
+
+	/* set 용 : value() */
+	template <class Node, class Alloc>
+	class __set_node_handle : public __node_handle_base<Node, Alloc>
+	{
+		public:
+			typedef typename Node::value_type	value_type;
+			typedef Alloc						allocator_type;
+			typedef Node*						node_pointer;
+
+			__set_node_handle() {}
+			__set_node_handle(node_pointer ptr, const allocator_type& alloc)
+			: __node_handle_base<Node, Alloc>(ptr, alloc) {}
+
+			value_type&	value() const	{ return this->__ptr->__value; }
+	};
+
+	/* insert(node_handle) 의 반환형
+	inserted == false 면 같은 key 의 노드가 이미 있던 것이고, 넘겨준 노드는 node 로 돌려받는다. */
+	template <class Iterator, class NodeHandle>
+	struct __insert_return_type
+	{
+		Iterator	position;
+		bool		inserted;
+		NodeHandle	node;
+	};
+
+}
+
+#endif
@@ -17,7 +17,10 @@ namespace ft {
 		template <typename U, typename V>
 		pair(const pair<U,V>& pr): first(pr.first), second(pr.second) {}
 
-		pair(const first_type& x, const second_type& y = second_type()): first(x), second(y) {}
+		/* second 는 임시 객체 복사 없이 바로 기본 생성 (map::try_emplace, operator[]) */
+		pair(const first_type& x): first(x), second() {}
+
+		pair(const first_type& x, const second_type& y): first(x), second(y) {}
 
 		pair& operator=(const pair& pr)
 		{
@@ -0,0 +1,583 @@
+#ifndef PERSISTENT_RBTREE_HPP
+# define PERSISTENT_RBTREE_HPP
+
+# include <algorithm>
+# include <limits>
+# include <memory>
+# include <new>
+# include "pair.hpp"
+# include "iterator.hpp"
+# include "type.hpp"
+# include "footprint.hpp"
+
+/* persistent(copy-on-write) red-black tree
+ *
+ * 노드를 참조 카운트로 여러 tree 가 공유한다.
+ * - 복사(snapshot) 는 root 의 참조 카운트만 올리므로 O(1)
+ * - 쓰기는 root 부터 바뀌는 노드까지의 경로(O(log n))만 복사한다. (path copying)
+ *   참조 카운트가 1 인 노드는 이 tree 만 가지고 있으므로 복사하지 않고 그대로 고친다.
+ * - 한 번 공유된 노드는 바뀌지 않으므로 snapshot 을 들고 있는 reader 는 lock 없이 순회할 수 있다.
+ *
+ * 노드가 여러 부모를 가질 수 있어 parent 포인터를 둘 수 없다.
+ * 그래서 재귀만으로 insert / erase 가 되는 left-leaning red-black tree (Sedgewick) 를 쓰고,
+ * iterator 는 root 부터의 경로를 들고 다닌다. (persistent_tree_iterator)
+ *
+ * 쓰는 도중 노드 복사나 비교가 던지면 tree 는 쓰기 전의 원소를 그대로 가지고, 노드도 새거나 두 번 해제되지 않는다.
+ *
+ * 참조 카운트는 __sync builtin 으로 atomic 하게 바꾸므로 snapshot 을 다른 thread 로 넘겨 읽고 버려도 된다.
+ * 같은 tree 객체를 쓰는 writer 와 그 객체의 snapshot() 호출은 보통의 컨테이너처럼 호출하는 쪽에서 동기화해야 한다.
+ */
+
+namespace ft {
+
+	template <typename T>
+	struct __persistent_node
+	{
+		typedef T value_type;
+
+		__persistent_node*	__left;
+		__persistent_node*	__right;
+		value_type			__value;
+		bool				__is_black;
+		long				__refs;
+
+		__persistent_node(const value_type& value) : __left(ft::NIL), __right(ft::NIL), __value(value), __is_black(false), __refs(1) {}
+		~__persistent_node(void) {}
+
+		private:
+			__persistent_node(const __persistent_node&);
+			__persistent_node& operator=(const __persistent_node&);
+	};
+
+	template <typename Node>
+	void	__node_retain(Node* nd_ptr)
+	{
+		if (nd_ptr != ft::NIL)
+			__sync_fetch_and_add(&nd_ptr->__refs, 1);
+	}
+
+	template <typename Node>
+	bool	__is_red_link(const Node* nd_ptr)
+	{ return nd_ptr != ft::NIL && !nd_ptr->__is_black; }
+
+	template <typename T, class Key, class Comp, class Alloc = std::allocator<T> >
+	class __persistent_rbt
+	{
+		public:
+			typedef T		value_type;
+			typedef Key		key_type;
+			typedef Comp	compare_type;
+
+			typedef ft::__persistent_node<value_type>	node_type;
+			typedef node_type*							node_pointer;
+			/* 공유된 노드를 iterator 로 고칠 수 없도록 const iterator 만 있다. */
+			typedef ft::persistent_tree_iterator<const value_type, node_type>	const_iterator;
+			typedef const_iterator												iterator;
+
+			typedef Alloc		allocator_type;
+			typedef typename Alloc::template rebind<node_type>::other	node_allocator;
+
+			typedef std::size_t		size_type;
+
+		private:
+			node_pointer	__root;
+			compare_type	__comp;
+			node_allocator	__alloc;
+			size_type		__size;
+
+		public:
+			__persistent_rbt(const compare_type& comp, const allocator_type& alloc)
+			: __root(ft::NIL), __comp(comp), __alloc(alloc), __size(size_type()) {}
+
+			/* 노드를 공유하므로 O(1) */
+			__persistent_rbt(const __persistent_rbt& rbt)
+			: __root(rbt.__root), __comp(rbt.__comp), __alloc(rbt.__alloc), __size(rbt.__size)
+			{ __node_retain(__root); }
+
+			~__persistent_rbt()
+			{ __release(__root); }
+
+			__persistent_rbt& operator=(const __persistent_rbt& rbt)
+			{
+				if (this != &rbt)
+				{
+					__persistent_rbt tmp(rbt);
+					swap(tmp);
+				}
+				return *this;
+			}
+
+			const_iterator	begin() const
+			{
+				const_iterator it(__root);
+				for (node_pointer nd_ptr = __root ; nd_ptr != ft::NIL ; nd_ptr = nd_ptr->__left)
+					it.__push(nd_ptr);
+				return it;
+			}
+			const_iterator	end() const	{ return const_iterator(__root); }
+
+			size_type	size() const	{ return __size; }
+			bool		empty() const	{ return __size == 0; }
+			size_type	max_size() const
+			{
+				return std::min<size_type>(std::numeric_limits<size_type>::max(),
+						__alloc.max_size());
+			}
+
+			template <typename K>
+			const_iterator	find(const K& key) const
+			{
+				const_iterator it(__root);
+				node_pointer nd_ptr = __root;
+				while (nd_ptr != ft::NIL)
+				{
+					it.__push(nd_ptr);
+					if (__comp(key, nd_ptr->__value))
+						nd_ptr = nd_ptr->__left;
+					else if (__comp(nd_ptr->__value, key))
+						nd_ptr = nd_ptr->__right;
+					else
+						return it;
+				}
+				return end();
+			}
+
+			/* 내려가면서 경로를 쌓고, 후보를 찾았던 깊이로 경로를 자른다. */
+			template <typename K>
+			const_iterator	lower_bound(const K& key) const
+			{
+				const_iterator it(__root);
+				int depth = 0;
+				for (node_pointer nd_ptr = __root ; nd_ptr != ft::NIL ; )
+				{
+					it.__push(nd_ptr);
+					if (!__comp(nd_ptr->__value, key))
+					{
+						depth = it.__get_depth();
+						nd_ptr = nd_ptr->__left;
+					}
+					else
+						nd_ptr = nd_ptr->__right;
+				}
+				it.__set_depth(depth);
+				return it;
+			}
+
+			template <typename K>
+			const_iterator	upper_bound(const K& key) const
+			{
+				const_iterator it(__root);
+				int depth = 0;
+				for (node_pointer nd_ptr = __root ; nd_ptr != ft::NIL ; )
+				{
+					it.__push(nd_ptr);
+					if (__comp(key, nd_ptr->__value))
+					{
+						depth = it.__get_depth();
+						nd_ptr = nd_ptr->__left;
+					}
+					else
+						nd_ptr = nd_ptr->__right;
+				}
+				it.__set_depth(depth);
+				return it;
+			}
+
+			/* 같은 값이 있으면 아무것도 복사하지 않는다. */
+			ft::pair<const_iterator, bool>	insert(const value_type& val)
+			{
+				node_pointer path[__tree_max_height];
+				int depth;
+				bool to_left;
+				if (__search(val, path, depth, to_left))
+					return ft::make_pair(__make_iterator(path, depth), false);
+				return ft::make_pair(__insert(path, depth, to_left, val), true);
+			}
+
+			/* 같은 key 의 원소가 있으면 그 노드를 val 을 가진 새 노드로 바꾼다. (경로만 복사) */
+			ft::pair<const_iterator, bool>	insert_or_assign(const value_type& val)
+			{
+				node_pointer path[__tree_max_height];
+				int depth;
+				bool to_left;
+				if (!__search(val, path, depth, to_left))
+					return ft::make_pair(__insert(path, depth, to_left, val), true);
+				__own_path(path, depth - 1);
+				node_pointer old = path[depth - 1];
+				node_pointer new_node = __make_node(val);
+				new_node->__left = old->__left;
+				new_node->__right = old->__right;
+				new_node->__is_black = old->__is_black;
+				__node_retain(new_node->__left);
+				__node_retain(new_node->__right);
+				__slot_of(path, depth - 1) = new_node;
+				__release(old);
+				path[depth - 1] = new_node;
+				return ft::make_pair(__make_iterator(path, depth), false);
+			}
+
+			template <typename K>
+			size_type	erase(const K& key)
+			{
+				if (find(key) == end())
+					return 0;
+				__own(__root);
+				if (!__is_red_link(__root->__left) && !__is_red_link(__root->__right))
+					__root->__is_black = false;
+				try
+				{
+					__erase(__root, key);
+				}
+				catch (...)
+				{
+					__root->__is_black = true;
+					throw;
+				}
+				if (__root != ft::NIL)
+					__root->__is_black = true;
+				--__size;
+				return 1;
+			}
+
+			void	swap(__persistent_rbt& rbt)
+			{
+				std::swap(__root, rbt.__root);
+				std::swap(__comp, rbt.__comp);
+				std::swap(__alloc, rbt.__alloc);
+				std::swap(__size, rbt.__size);
+			}
+
+			void	clear()
+			{
+				__release(__root);
+				__root = ft::NIL;
+				__size = 0;
+			}
+
+			allocator_type	get_allocator() const
+			{ return __alloc; }
+
+			/* 이 version 에서 닿는 노드를 모두 센다. 다른 snapshot 과 공유하는 노드도 들어가므로
+			snapshot 들의 값을 더하면 실제보다 크다. container 객체의 크기는 부르는 쪽이 더한다. */
+			ft::memory_footprint	memory_usage() const
+			{
+				ft::memory_footprint m;
+				m.payload = __size * sizeof(value_type);
+				m.overhead = __size * (sizeof(node_type) - sizeof(value_type));
+				m.allocator = __size * ft::__heap_block_overhead(sizeof(node_type));
+				return m;
+			}
+
+			node_pointer	getRoot() const
+			{ return __root; }
+
+		private:
+			/* 넣은 노드부터 위로 올라가며 쌓는 경로. (__nodes[__size - 1] 이 지금까지 고친 sub-tree 의 맨 위)
+			고치며 회전하면 그 자리의 경로만 바꾸므로 다 고친 뒤에 다시 찾지 않고 iterator 를 만들 수 있다. */
+			struct __trail
+			{
+				node_pointer	__nodes[__tree_max_height];
+				int				__size;
+
+				__trail() : __size(0) {}
+
+				void	__push(node_pointer nd_ptr)	{ __nodes[__size++] = nd_ptr; }
+
+				/* 맨 위의 top 과 그 자식 ch 가 회전해 ch 가 올라왔다.
+				경로가 ch 로 내려갔다면 top 을 빼고, 그 다음 노드가 ch 에서 top 으로 옮겨진 안쪽 손자면 top 을 사이에 다시 넣는다.
+				반대쪽으로 내려갔다면 경로는 ch -> top 으로 시작한다. */
+				void	__rotated(node_pointer top, node_pointer ch)
+				{
+					if (__size >= 2 && __nodes[__size - 2] == ch)
+					{
+						--__size;
+						if (__size >= 2 && (top->__left == __nodes[__size - 2] || top->__right == __nodes[__size - 2]))
+						{
+							__nodes[__size - 1] = top;
+							__push(ch);
+						}
+					}
+					else
+						__push(ch);
+				}
+			};
+
+			node_pointer	__make_node(const value_type& val)
+			{
+				node_pointer nd_ptr = __alloc.allocate(1);
+				try
+				{
+					::new (static_cast<void*>(nd_ptr)) node_type(val);
+				}
+				catch (...)
+				{
+					__alloc.deallocate(nd_ptr, 1);
+					throw;
+				}
+				return nd_ptr;
+			}
+			/* 자식은 건드리지 않고 노드 하나만 해제 */
+			void	__free_node(node_pointer nd_ptr)
+			{
+				__alloc.destroy(nd_ptr);
+				__alloc.deallocate(nd_ptr, 1);
+			}
+			/* 참조를 하나 놓고, 아무도 안 가지게 되면 자식들의 참조도 놓으며 해제한다. */
+			void	__release(node_pointer nd_ptr)
+			{
+				while (nd_ptr != ft::NIL && __sync_sub_and_fetch(&nd_ptr->__refs, 1) == 0)
+				{
+					__release(nd_ptr->__left);
+					node_pointer right = nd_ptr->__right;
+					__free_node(nd_ptr);
+					nd_ptr = right;
+				}
+			}
+			/* 고치기 전에 노드를 가리키는 자리(부모의 자식 포인터 또는 __root)로 호출한다.
+			이 tree 만 가진 노드면 그대로 두고, 공유된 노드면 복사본을 그 자리에 넣은 뒤에 원래 노드의 참조를 놓는다.
+			복사가 실패하면 아무것도 바뀌지 않고, 성공하면 tree 는 같은 모양과 색 그대로이므로 어느 단계에서 던져도 tree 는 온전하다.
+			refs == 1 이면 다른 thread 가 이 노드에 닿을 방법이 없으므로 그대로 고쳐도 안전하다. */
+			node_pointer&	__own(node_pointer& slot)
+			{
+				node_pointer nd_ptr = slot;
+				if (__atomic_load_n(&nd_ptr->__refs, __ATOMIC_ACQUIRE) == 1)
+					return slot;
+				node_pointer cp = __make_node(nd_ptr->__value);
+				cp->__left = nd_ptr->__left;
+				cp->__right = nd_ptr->__right;
+				cp->__is_black = nd_ptr->__is_black;
+				__node_retain(cp->__left);
+				__node_retain(cp->__right);
+				slot = cp;
+				__release(nd_ptr);
+				return slot;
+			}
+			/* path[i] 를 가리키는 자리. path[i - 1] 은 own 된 뒤여도 자식 포인터는 그대로다. */
+			node_pointer&	__slot_of(node_pointer* path, int i)
+			{
+				if (i == 0)
+					return __root;
+				return path[i - 1]->__left == path[i] ? path[i - 1]->__left : path[i - 1]->__right;
+			}
+			/* 경로의 노드들을 위에서부터 own 하고 path 를 복사본으로 바꾼다. */
+			void	__own_path(node_pointer* path, int depth)
+			{
+				for (int i = 0 ; i < depth ; ++i)
+					path[i] = __own(__slot_of(path, i));
+			}
+			/* root 부터 val 의 자리까지 내려가며 path 에 쌓는다.
+			있으면 true 이고 path[depth - 1] 이 그 노드, 없으면 마지막 노드의 to_left 쪽이 넣을 자리다. */
+			bool	__search(const value_type& val, node_pointer* path, int& depth, bool& to_left) const
+			{
+				depth = 0;
+				to_left = false;
+				for (node_pointer nd_ptr = __root ; nd_ptr != ft::NIL ; )
+				{
+					path[depth++] = nd_ptr;
+					to_left = __comp(val, nd_ptr->__value);
+					if (to_left)
+						nd_ptr = nd_ptr->__left;
+					else if (__comp(nd_ptr->__value, val))
+						nd_ptr = nd_ptr->__right;
+					else
+						return true;
+				}
+				return false;
+			}
+			const_iterator	__make_iterator(node_pointer* path, int depth) const
+			{
+				const_iterator it(__root);
+				for (int i = 0 ; i < depth ; ++i)
+					it.__push(path[i]);
+				return it;
+			}
+
+			/* 아래 연산들은 모두 이미 own 된 nd_ptr 을 받고, 새로 고치는 자식은 own 해서 쓴다. */
+			/* trail 이 있으면 회전을 경로에 반영한다. */
+			node_pointer	__rotate_left(node_pointer nd_ptr, __trail* trail = ft::NIL)
+			{
+				node_pointer ch = __own(nd_ptr->__right);
+				nd_ptr->__right = ch->__left;
+				ch->__left = nd_ptr;
+				ch->__is_black = nd_ptr->__is_black;
+				nd_ptr->__is_black = false;
+				if (trail != ft::NIL)
+					trail->__rotated(nd_ptr, ch);
+				return ch;
+			}
+			node_pointer	__rotate_right(node_pointer nd_ptr, __trail* trail = ft::NIL)
+			{
+				node_pointer ch = __own(nd_ptr->__left);
+				nd_ptr->__left = ch->__right;
+				ch->__right = nd_ptr;
+				ch->__is_black = nd_ptr->__is_black;
+				nd_ptr->__is_black = false;
+				if (trail != ft::NIL)
+					trail->__rotated(nd_ptr, ch);
+				return ch;
+			}
+			void	__flip_colors(node_pointer nd_ptr)
+			{
+				__own(nd_ptr->__left);
+				__own(nd_ptr->__right);
+				nd_ptr->__is_black = !nd_ptr->__is_black;
+				nd_ptr->__left->__is_black = !nd_ptr->__left->__is_black;
+				nd_ptr->__right->__is_black = !nd_ptr->__right->__is_black;
+			}
+			/* 오른쪽으로 기운 red, 연속된 red, 양쪽 red 를 차례로 고친다. */
+			node_pointer	__balance(node_pointer nd_ptr, __trail* trail = ft::NIL)
+			{
+				if (__is_red_link(nd_ptr->__right) && !__is_red_link(nd_ptr->__left))
+					nd_ptr = __rotate_left(nd_ptr, trail);
+				if (__is_red_link(nd_ptr->__left) && __is_red_link(nd_ptr->__left->__left))
+					nd_ptr = __rotate_right(nd_ptr, trail);
+				if (__is_red_link(nd_ptr->__left) && __is_red_link(nd_ptr->__right))
+					__flip_colors(nd_ptr);
+				return nd_ptr;
+			}
+			/* __search 가 쌓은 경로 아래에 val 을 넣고 넣은 노드의 iterator 를 돌려준다. 비교는 다시 하지 않는다.
+			복사와 할당은 모두 모양을 바꾸기 전에 끝내므로 도중에 던지면 tree 는 넣기 전 그대로다.
+			올라오며 고칠 때 경로 밖에서 건드리는 노드는 오른쪽으로 내려간 자리의 red 인 왼쪽 자식(색을 뒤집는다) 뿐이라 그것도 미리 own 한다. */
+			const_iterator	__insert(node_pointer* path, int depth, bool to_left, const value_type& val)
+			{
+				__own_path(path, depth);
+				for (int i = 0 ; i < depth ; ++i)
+				{
+					bool to_right = i + 1 < depth ? path[i]->__right == path[i + 1] : !to_left;
+					if (to_right && __is_red_link(path[i]->__left))
+						__own(path[i]->__left);
+				}
+				node_pointer leaf = __make_node(val);
+				if (depth == 0)
+					__root = leaf;
+				else if (to_left)
+					path[depth - 1]->__left = leaf;
+				else
+					path[depth - 1]->__right = leaf;
+				__trail trail;
+				trail.__push(leaf);
+				for (int i = depth - 1 ; i >= 0 ; --i)
+				{
+					trail.__push(path[i]);
+					node_pointer top = __balance(path[i], &trail);
+					__slot_of(path, i) = top;
+				}
+				__root->__is_black = true;
+				++__size;
+				const_iterator it(__root);
+				for (int i = trail.__size - 1 ; i >= 0 ; --i)
+					it.__push(trail.__nodes[i]);
+				return it;
+			}
+			/* 지우러 내려가는 쪽 자식이 2-node 가 되지 않도록 red 를 빌려온다.
+			건드릴 노드를 먼저 모두 own 하므로 던지면 아무것도 바뀌지 않는다. */
+			node_pointer	__move_red_left(node_pointer nd_ptr)
+			{
+				__own(nd_ptr->__left);
+				__own(nd_ptr->__right);
+				bool rotate = __is_red_link(nd_ptr->__right->__left);
+				if (rotate)
+					__own(nd_ptr->__right->__left);
+				__flip_colors(nd_ptr);
+				if (rotate)
+				{
+					nd_ptr->__right = __rotate_right(nd_ptr->__right);
+					nd_ptr = __rotate_left(nd_ptr);
+					__flip_colors(nd_ptr);
+				}
+				return nd_ptr;
+			}
+			node_pointer	__move_red_right(node_pointer nd_ptr)
+			{
+				__own(nd_ptr->__left);
+				__own(nd_ptr->__right);
+				bool rotate = __is_red_link(nd_ptr->__left->__left);
+				if (rotate)
+					__own(nd_ptr->__left->__left);
+				__flip_colors(nd_ptr);
+				if (rotate)
+				{
+					nd_ptr = __rotate_right(nd_ptr);
+					__flip_colors(nd_ptr);
+				}
+				return nd_ptr;
+			}
+			/* 최소 노드를 떼어내 min 으로 돌려준다. (해제하지 않음)
+			nd_ptr 은 own 된 노드를 가리키는 자리라서 내려가며 바꾼 모양이 늘 그 자리에 있다.
+			아래에서 던지면 빌려온 red 를 __balance 로 되돌려 놓고 다시 던진다. */
+			void	__erase_min(node_pointer& nd_ptr, node_pointer& min)
+			{
+				if (nd_ptr->__left == ft::NIL)
+				{
+					min = nd_ptr;
+					nd_ptr = ft::NIL;
+					return;
+				}
+				try
+				{
+					if (!__is_red_link(nd_ptr->__left) && !__is_red_link(nd_ptr->__left->__left))
+						nd_ptr = __move_red_left(nd_ptr);
+					__erase_min(__own(nd_ptr->__left), min);
+				}
+				catch (...)
+				{
+					nd_ptr = __balance(nd_ptr);
+					throw;
+				}
+				nd_ptr = __balance(nd_ptr);
+			}
+			/* key 가 있다는 것을 확인한 뒤 호출. nd_ptr 은 __erase_min 처럼 own 된 노드를 가리키는 자리다.
+			지울 노드가 안쪽에 있으면 오른쪽 sub-tree 의 최소 노드를 떼어내 그 자리에 연결한다. (value 를 복사하지 않음)
+			노드를 떼어낸 뒤에는 복사도 비교도 하지 않으므로, 던졌다면 아무것도 지워지지 않은 것이다. */
+			template <typename K>
+			void	__erase(node_pointer& nd_ptr, const K& key)
+			{
+				try
+				{
+					if (__comp(key, nd_ptr->__value))
+					{
+						if (!__is_red_link(nd_ptr->__left) && !__is_red_link(nd_ptr->__left->__left))
+							nd_ptr = __move_red_left(nd_ptr);
+						__erase(__own(nd_ptr->__left), key);
+					}
+					else
+					{
+						if (__is_red_link(nd_ptr->__left))
+							nd_ptr = __rotate_right(nd_ptr);
+						if (__is_equal(nd_ptr, key) && nd_ptr->__right == ft::NIL)
+						{
+							node_pointer old = nd_ptr;
+							nd_ptr = ft::NIL;
+							__free_node(old);
+							return;
+						}
+						if (!__is_red_link(nd_ptr->__right) && !__is_red_link(nd_ptr->__right->__left))
+							nd_ptr = __move_red_right(nd_ptr);
+						if (__is_equal(nd_ptr, key))
+						{
+							node_pointer min;
+							__erase_min(__own(nd_ptr->__right), min);
+							min->__left = nd_ptr->__left;
+							min->__right = nd_ptr->__right;
+							min->__is_black = nd_ptr->__is_black;
+							__free_node(nd_ptr);
+							nd_ptr = min;
+						}
+						else
+							__erase(__own(nd_ptr->__right), key);
+					}
+				}
+				catch (...)
+				{
+					nd_ptr = __balance(nd_ptr);
+					throw;
+				}
+				nd_ptr = __balance(nd_ptr);
+			}
+			template <typename K>
+			bool	__is_equal(node_pointer nd_ptr, const K& key) const
+			{ return !__comp(key, nd_ptr->__value) && !__comp(nd_ptr->__value, key); }
+	};
+}
+
+#endif
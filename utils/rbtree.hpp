@@ -4,15 +4,25 @@
 # include <algorithm>
 # include <limits>
 # include <memory>
+# include <new>
 # include "pair.hpp"
 # include "iterator.hpp"
 # include "type.hpp"
+# include "compare.hpp"
+# include "instrument.hpp"
+# include "latency.hpp"
+# include "footprint.hpp"
+# include "../vector.hpp"
 
 namespace ft {
+	/* value_type 임시 객체 없이 노드 안에서 value 를 바로 생성할 때 쓰는 tag */
+	struct __in_place_t {};
+
 	template <typename T>
 	struct __tree_node
 	{
 		typedef T value_type;
+		typedef std::bidirectional_iterator_tag	iterator_category;
 
 		__tree_node*	__parent;
 		__tree_node*	__left;
@@ -22,6 +32,10 @@ namespace ft {
 
 		__tree_node(void) : __parent(ft::NIL), __left(ft::NIL), __right(ft::NIL), __value(value_type()), __is_black(bool()) {}
 		__tree_node(const value_type& value) : __parent(ft::NIL), __left(ft::NIL), __right(ft::NIL), __value(value), __is_black(bool()) {}
+		template <typename A>
+		__tree_node(__in_place_t, const A& a) : __parent(ft::NIL), __left(ft::NIL), __right(ft::NIL), __value(a), __is_black(bool()) {}
+		template <typename A, typename B>
+		__tree_node(__in_place_t, const A& a, const B& b) : __parent(ft::NIL), __left(ft::NIL), __right(ft::NIL), __value(a, b), __is_black(bool()) {}
 		__tree_node(const __tree_node& n) : __parent(n.__parent), __left(n.__left), __right(n.__right), __value(n.__value), __is_black(n.__is_black) {}
 		~__tree_node(void) {}
 
@@ -39,6 +53,51 @@ namespace ft {
 		}
 	};
 
+	/* order statistic 노드 : __count = 자신을 root 로 하는 sub-tree 의 노드 수
+	rank / select 를 O(log n) 에 할 수 있으므로 iterator 도 random access 로 취급한다. */
+	template <typename T>
+	struct __counted_tree_node
+	{
+		typedef T value_type;
+		typedef std::random_access_iterator_tag	iterator_category;
+
+		__counted_tree_node*	__parent;
+		__counted_tree_node*	__left;
+		__counted_tree_node*	__right;
+		value_type				__value;
+		bool					__is_black;
+		std::size_t				__count;
+
+		__counted_tree_node(void) : __parent(ft::NIL), __left(ft::NIL), __right(ft::NIL), __value(value_type()), __is_black(bool()), __count(1) {}
+		__counted_tree_node(const value_type& value) : __parent(ft::NIL), __left(ft::NIL), __right(ft::NIL), __value(value), __is_black(bool()), __count(1) {}
+		template <typename A>
+		__counted_tree_node(__in_place_t, const A& a) : __parent(ft::NIL), __left(ft::NIL), __right(ft::NIL), __value(a), __is_black(bool()), __count(1) {}
+		template <typename A, typename B>
+		__counted_tree_node(__in_place_t, const A& a, const B& b) : __parent(ft::NIL), __left(ft::NIL), __right(ft::NIL), __value(a, b), __is_black(bool()), __count(1) {}
+		__counted_tree_node(const __counted_tree_node& n) : __parent(n.__parent), __left(n.__left), __right(n.__right), __value(n.__value), __is_black(n.__is_black), __count(n.__count) {}
+		~__counted_tree_node(void) {}
+
+		__counted_tree_node& operator=(const __counted_tree_node& n)
+		{
+			if (this != &n)
+			{
+				__parent = n.__parent;
+				__left = n.__left;
+				__right = n.__right;
+				__value = n.__value;
+				__is_black = n.__is_black;
+				__count = n.__count;
+			}
+			return *this;
+		}
+	};
+
+	template <typename T, bool Counted>
+	struct __tree_node_type { typedef __tree_node<T>	type; };
+
+	template <typename T>
+	struct __tree_node_type<T, true> { typedef __counted_tree_node<T>	type; };
+
 	template <class NodePtr>
 	bool __is_left_child(const NodePtr& ptr)
 	{ return ptr == ptr->__parent->__left; }
@@ -47,67 +106,240 @@ namespace ft {
 	bool __is_right_child(const NodePtr& ptr)
 	{ return ptr == ptr->__parent->__right; }
 
+	/* leaf는 null 이므로 null 노드는 black으로 취급 */
 	template <class NodePtr>
 	bool __is_black_color(const NodePtr& ptr)
-	{ return ptr->__is_black; }
+	{ return ptr == NodePtr() || ptr->__is_black; }
 
 	template <class NodePtr>
 	bool __is_red_color(const NodePtr& ptr)
-	{ return !ptr->__is_black; }
+	{ return !__is_black_color(ptr); }
 
 	/* ptr 기준 sub-tree 중 가장 작은 노드 */
 	template <class NodePtr>
-	NodePtr __min_node(NodePtr ptr, NodePtr nil)
+	NodePtr __min_node(NodePtr ptr)
 	{
-		while (ptr->__left != nil)
+		while (ptr->__left != NodePtr())
 			ptr = ptr->__left;
 		return ptr;
 	}
 
 	/* ptr 기준 sub-tree 중 가장 큰 노드 */
 	template <class NodePtr>
-	NodePtr __max_node(NodePtr ptr, NodePtr nil)
+	NodePtr __max_node(NodePtr ptr)
 	{
-		while (ptr->__right != nil)
+		while (ptr->__right != NodePtr())
 			ptr = ptr->__right;
 		return ptr;
 	}
 
-	/* Red-Black Tree의 iterator(node) 중위 순회 */
+	/* Red-Black Tree의 iterator(node) 중위 순회
+	root는 end 노드의 left child 이므로 가장 큰 노드의 다음은 end 노드가 된다. */
 	template <class NodePtr>
-	NodePtr __next_node(NodePtr ptr, NodePtr nil)
+	NodePtr __next_node(NodePtr ptr)
 	{
-		if (ptr->__right != nil)
-			return __min_node(ptr->__right, nil);
+		if (ptr->__right != NodePtr())
+			return __min_node(ptr->__right);
 		while (!__is_left_child(ptr))
 			ptr = ptr->__parent;
 		return ptr->__parent;
 	}
 
+	/* end 노드의 이전은 root 기준 가장 큰 노드 */
 	template <class NodePtr>
-	NodePtr __prev_node(NodePtr ptr, NodePtr nil)
+	NodePtr __prev_node(NodePtr ptr)
 	{
-		if (ptr->__left != nil)
-			return __max_node(ptr->__left, nil);
+		if (ptr->__left != NodePtr())
+			return __max_node(ptr->__left);
 		while (!__is_right_child(ptr))
 			ptr = ptr->__parent;
 		return ptr->__parent;
 	}
 
-	template <typename T, typename U, class Comp>
-	bool __is_equal(const T& t, const U& u, Comp comp)
-	{ return !comp(t, u) && !comp(u, t); }
+	/* sub-tree 크기 유지. 일반 노드는 아무것도 하지 않는다. */
+	template <typename T>
+	std::size_t __count_of(const __counted_tree_node<T>* ptr)
+	{ return ptr == ft::NIL ? 0 : ptr->__count; }
+
+	template <typename T>
+	void __update_count(__tree_node<T>*) {}
+
+	template <typename T>
+	void __update_count(__counted_tree_node<T>* ptr)
+	{ ptr->__count = 1 + __count_of(ptr->__left) + __count_of(ptr->__right); }
+
+	/* ptr 부터 root 까지 __count 재계산 (end 노드는 parent 가 없으므로 거기서 멈춤) */
+	template <typename T>
+	void __update_count_path(__tree_node<T>*) {}
+
+	template <typename T>
+	void __update_count_path(__counted_tree_node<T>* ptr)
+	{
+		for ( ; ptr->__parent != ft::NIL ; ptr = ptr->__parent)
+			__update_count(ptr);
+	}
+
+	/* 중위 순회 순서 (0 부터). end 노드는 root 의 __count(= size) */
+	template <typename T>
+	std::size_t __node_rank(const __counted_tree_node<T>* ptr)
+	{
+		std::size_t rank = __count_of(ptr->__left);
+		for ( ; ptr->__parent != ft::NIL ; ptr = ptr->__parent)
+			if (__is_right_child(ptr))
+				rank += __count_of(ptr->__parent->__left) + 1;
+		return rank;
+	}
+
+	/* end 노드 기준 k 번째 노드. 범위를 넘으면 end 노드 */
+	template <typename T>
+	__counted_tree_node<T>* __node_select(__counted_tree_node<T>* end, std::size_t k)
+	{
+		__counted_tree_node<T>* ptr = end->__left;
+		while (ptr != ft::NIL)
+		{
+			std::size_t left = __count_of(ptr->__left);
+			if (k < left)
+				ptr = ptr->__left;
+			else if (k == left)
+				return ptr;
+			else
+			{
+				k -= left + 1;
+				ptr = ptr->__right;
+			}
+		}
+		return end;
+	}
+
+	/* random access iterator 연산 : rank 로 바꿔 더한 뒤 end 노드에서 다시 select. O(log n) */
+	template <typename T>
+	__counted_tree_node<T>* __advance_node(__counted_tree_node<T>* ptr, std::ptrdiff_t n)
+	{
+		std::size_t rank = __node_rank(ptr) + n;
+		while (ptr->__parent != ft::NIL)
+			ptr = ptr->__parent;
+		return __node_select(ptr, rank);
+	}
+
+	template <typename T>
+	std::ptrdiff_t __node_distance(const __counted_tree_node<T>* first, const __counted_tree_node<T>* last)
+	{ return static_cast<std::ptrdiff_t>(__node_rank(last)) - static_cast<std::ptrdiff_t>(__node_rank(first)); }
+
+	/* 일괄 순회용 중위 순회
+	iterator 의 ++ 는 parent / right 를 하나씩 읽어야 다음 노드를 알 수 있어서 cache miss 가 줄줄이 이어진다.
+	여기선 방문을 기다리는 조상들을 stack 에 쌓고, 쌓을 때 그 오른쪽 자식을 prefetch 해둔다.
+	왼쪽 sub-tree 를 도는 동안 나중에 갈 오른쪽 sub-tree 들이 미리 올라와 있다.
+	방문한 노드의 오른쪽 sub-tree 는 다음 호출 때 펼쳐서 f 의 일과 메모리 읽기가 겹치게 한다.
+	__last 를 꺼내면 끝. (기본은 NIL 이라 stack 이 빌 때까지) */
+	template <class NodePtr>
+	class __inorder_walker
+	{
+		private:
+			NodePtr	__stack[__tree_max_height];
+			int		__depth;
+			NodePtr	__pending;
+			NodePtr	__last;
+
+		public:
+			__inorder_walker() : __depth(0), __pending(ft::NIL), __last(ft::NIL) {}
+
+			void	__push(NodePtr ptr)
+			{
+				__builtin_prefetch(ptr->__right);
+				__stack[__depth++] = ptr;
+			}
+			void	__push_left(NodePtr ptr)
+			{
+				for ( ; ptr != NodePtr() ; ptr = ptr->__left)
+					__push(ptr);
+			}
+			NodePtr	__top() const			{ return __depth ? __stack[__depth - 1] : NodePtr(); }
+			void	__set_last(NodePtr ptr)	{ __last = ptr; }
+			void	__clear()
+			{
+				__depth = 0;
+				__pending = NodePtr();
+			}
+
+			/* 다음 노드. 끝이면 NIL */
+			NodePtr	__next()
+			{
+				if (__pending != NodePtr())
+				{
+					__push_left(__pending);
+					__pending = NodePtr();
+				}
+				if (__depth == 0 || __stack[__depth - 1] == __last)
+				{
+					__clear();
+					return NodePtr();
+				}
+				NodePtr ptr = __stack[--__depth];
+				__pending = ptr->__right;
+				return ptr;
+			}
+	};
+
+	/* 원소를 n 개씩 복사해 내보내는 cursor. 만든 뒤 tree 가 바뀌면 쓸 수 없다. */
+	template <class Node, typename Value>
+	class __batch_cursor
+	{
+		private:
+			__inorder_walker<Node*>	__walker;
+
+		public:
+			typedef Value		value_type;
+			typedef std::size_t	size_type;
+
+			__batch_cursor() {}
+			explicit __batch_cursor(const __inorder_walker<Node*>& walker) : __walker(walker) {}
+
+			/* 최대 n 개를 순서대로 out 에 복사. 복사한 개수를 돌려주고 0 이면 끝 */
+			template <class OutputIterator>
+			size_type	read(OutputIterator out, size_type n)
+			{
+				size_type k = 0;
+				for (Node* ptr ; k < n && (ptr = __walker.__next()) != ft::NIL ; ++k, ++out)
+					*out = static_cast<value_type&>(ptr->__value);
+				return k;
+			}
+	};
+
+	/* map / set 의 stats() 결과. 운영 중에 주기적으로 뽑아서 tree 를 다시 만들지(compact) 판단하는 데 쓴다.
+	height / depth 는 root 를 0 이 아닌 1 로 세면 탐색 한 번에 거치는 노드 수가 된다.
+	contiguous_ratio : key 순서로 이웃한 두 노드가 메모리에서도 붙어 있는(노드 두 개 크기 이내) 비율. 낮을수록 순회가 cache 를 못 쓴다.
+	valid : root 가 black, red 노드의 자식은 black, 모든 경로의 black 노드 수가 같음, parent 연결, key 순서, 크기(와 Counted 의 sub-tree 크기)가 맞음 */
+	struct tree_stats
+	{
+		enum { max_depth = __tree_max_height };
+
+		std::size_t	size;
+		std::size_t	height;							/* 가장 긴 root -> 노드 경로의 노드 수 (빈 tree 0) */
+		std::size_t	black_height;					/* root -> leaf 경로의 black 노드 수 */
+		std::size_t	depth_histogram[max_depth];		/* [d] = 깊이 d (root 0) 인 노드 수 */
+		double		average_path_length;			/* 있는 key 를 찾을 때 거치는 평균 노드 수 */
+		double		contiguous_ratio;
+		bool		valid;
+	};
+
+	template <typename T>
+	bool __count_consistent(const __tree_node<T>*) { return true; }
+
+	template <typename T>
+	bool __count_consistent(const __counted_tree_node<T>* ptr)
+	{ return ptr->__count == 1 + __count_of(ptr->__left) + __count_of(ptr->__right); }
 
 	/* Red-Black Tree */
-	template <typename T, class Key, class Comp, class Alloc = std::allocator<T> >
+	/* Counted == true 면 노드마다 sub-tree 크기를 유지해 rank / select / count_range 를 O(log n) 에 한다. */
+	template <typename T, class Key, class Comp, class Alloc = std::allocator<T>, bool Counted = false>
 	class __rbt{
 		public:
 			typedef T		value_type;
 			typedef Key		key_type;
 			typedef Comp	compare_type;
 
-			typedef __tree_node<value_type>		node_type;
-			typedef __tree_node<value_type>*	node_pointer;
+			typedef typename __tree_node_type<value_type, Counted>::type	node_type;
+			typedef node_type*												node_pointer;
 			typedef ft::tree_iterator<value_type, node_type>			iterator;
 			typedef ft::tree_iterator<const value_type, node_type>		const_iterator;
 
@@ -118,25 +350,41 @@ namespace ft {
 			typedef std::size_t		size_type;
 			typedef std::ptrdiff_t	diffefence_type;
 
+			/* 비교자가 three-way를 지원하면 탐색 시 레벨 당 비교를 한 번만 한다. */
+			typedef ft::__three_way<compare_type, key_type>								three_way;
+			typedef ft::integral_constant<bool, three_way::value>						is_three_way;
+			typedef ft::integral_constant<bool, Counted>								is_counted;
+
 		private:
-			node_pointer	__nil;
+			/* 일괄 조회에서 함께 내려가는 key 의 수 */
+			static const size_type	__lookup_group = 16;
+
 			node_pointer	__begin;
 			node_pointer	__end;
 			compare_type	__comp;
 			node_allocator	__alloc;
 			size_type		__size;
 
+			/* 비교자 호출은 모두 여기를 거친다. (FT_INSTRUMENT 면 비교 횟수를 센다) */
+			template <typename A, typename B>
+			bool	__less(const A& a, const B& b) const
+			{
+				FT_OP_COUNT(__rbt, comparisons, 1);
+				return __comp(a, b);
+			}
+			template <typename A, typename B>
+			int	__compare3(const A& a, const B& b) const
+			{
+				FT_OP_COUNT(__rbt, comparisons, 1);
+				return three_way::compare(__comp, a, b);
+			}
+
 		public:
 			/* orthodox */
+			/* leaf는 null로 끝나고 root는 __end->__left 에 매달린다. */
 			__rbt(const compare_type& comp, const allocator_type& alloc)
 			: __comp(comp), __alloc(alloc), __size(size_type())
 			{
-				__nil = __alloc.allocate(1);
-				__alloc.construct(__nil, value_type());
-				__nil->__parent = __nil;
-				__nil->__left = __nil;
-				__nil->__right = __nil;
-				__nil->__is_black = true;
 				__end = make_node(value_type());
 				__end->__is_black = true;
 				__begin = __end;
@@ -144,12 +392,6 @@ namespace ft {
 			__rbt(const __rbt& rbt)
 			: __comp(rbt.__comp), __alloc(rbt.__alloc), __size(size_type())
 			{
-				__nil = __alloc.allocate(1);
-				__alloc.construct(__nil, value_type());
-				__nil->__parent = __nil;
-				__nil->__left = __nil;
-				__nil->__right = __nil;
-				__nil->__is_black = true;
 				__end = make_node(value_type());
 				__end->__is_black = true;
 				__begin = __end;
@@ -158,7 +400,6 @@ namespace ft {
 			~__rbt()
 			{
 				del_node_all(__end);
-				del_node(__nil);
 			}
 			__rbt& operator=(const __rbt& rbt)
 			{
@@ -170,10 +411,10 @@ namespace ft {
 				return *this;
 			}
 			/* iterator */
-			iterator begin()				{ return iterator(__begin, __nil); }
-			iterator end()					{ return iterator(__end, __nil); }
-			const_iterator begin() const	{ return const_iterator(__begin, __nil); }
-			const_iterator end() const		{ return const_iterator(__end, __nil); }
+			iterator begin()				{ return iterator(__begin); }
+			iterator end()					{ return iterator(__end); }
+			const_iterator begin() const	{ return const_iterator(__begin); }
+			const_iterator end() const		{ return const_iterator(__end); }
 
 			size_type size() const	{ return __size; }
 			size_type max_size() const
@@ -183,20 +424,49 @@ namespace ft {
 			}
 			bool empty() const { return __size == 0; }
 
+			/* __search_parent 가 돌려준 자리(slot)가 비어있으면 새 노드를 매달고, 아니면 같은 값의 노드 반환 */
 			ft::pair<iterator, bool> insert(const value_type& val)
 			{
-				node_pointer nd_ptr = __search_parent(val);
-				if ( nd_ptr != __end && __is_equal(nd_ptr->__value, val, __comp))
-					return ft::make_pair(iterator(nd_ptr, __nil), false);
-				return ft::make_pair(iterator(__insert_tree(val, nd_ptr), __nil), true);
+				FT_LATENCY_SCOPE(__rbt, latency_insert);
+				node_pointer parent;
+				node_pointer& slot = __search_parent(val, parent);
+				if (slot != ft::NIL)
+					return ft::make_pair(iterator(slot), false);
+				return ft::make_pair(iterator(__insert_tree(val, parent, slot)), true);
 			}
 
 			iterator	insert(iterator _idx, const value_type& val)
 			{
-				node_pointer nd_ptr = __search_parent(val, _idx.base());
-				if (nd_ptr != __end && __is_equal(nd_ptr->__value, val, __comp))
-					return iterator(nd_ptr, __nil);
-				return iterator(__insert_tree(val, nd_ptr), __nil);
+				FT_LATENCY_SCOPE(__rbt, latency_insert);
+				node_pointer parent;
+				node_pointer& slot = __search_parent(val, parent, _idx.base());
+				if (slot != ft::NIL)
+					return iterator(slot);
+				return iterator(__insert_tree(val, parent, slot));
+			}
+
+			/* key 가 없을 때만 노드 안에서 value_type(key) 를 생성한다. 있으면 아무것도 만들지 않는다. */
+			template <typename K>
+			ft::pair<iterator, bool> try_emplace(const K& key)
+			{
+				FT_LATENCY_SCOPE(__rbt, latency_insert);
+				node_pointer parent;
+				node_pointer& slot = __search_parent(key, parent, is_three_way());
+				if (slot != ft::NIL)
+					return ft::make_pair(iterator(slot), false);
+				return ft::make_pair(iterator(__link_node(__make_node_in_place(key), parent, slot)), true);
+			}
+
+			/* key 가 없을 때만 노드 안에서 value_type(key, obj) 를 생성한다. */
+			template <typename K, typename M>
+			ft::pair<iterator, bool> try_emplace(const K& key, const M& obj)
+			{
+				FT_LATENCY_SCOPE(__rbt, latency_insert);
+				node_pointer parent;
+				node_pointer& slot = __search_parent(key, parent, is_three_way());
+				if (slot != ft::NIL)
+					return ft::make_pair(iterator(slot), false);
+				return ft::make_pair(iterator(__link_node(__make_node_in_place(key, obj), parent, slot)), true);
 			}
 
 			template <typename InputIterator>
@@ -206,11 +476,38 @@ namespace ft {
 					insert(*first);
 			}
 
+			/* [first, first + n) 이 정렬되어 있고 중복이 없을 때 기존 원소를 모두 버리고 O(n) 으로 tree 를 다시 만든다. (snapshot 복원) */
+			template <typename InputIterator>
+			void	assign_sorted(InputIterator first, size_type n)
+			{
+				clear();
+				if (n == 0)
+					return;
+				int bottom = 0;
+				for (size_type m = n ; m > 1 ; m >>= 1)
+					++bottom;
+				node_pointer root;
+				try
+				{
+					root = __build_sorted(first, n, 0, bottom);
+				}
+				catch (...)
+				{
+					__size = 0;
+					throw;
+				}
+				root->__is_black = true;
+				setRoot(root);
+				__begin = __min_node(root);
+				__size = n;
+			}
+
 			/* nullptr or ++iterator 반환 */
 			iterator	erase(iterator _idx)
 			{
+				FT_LATENCY_SCOPE(__rbt, latency_erase);
 				if (__size == 0)
-					return iterator(__nil, __nil);
+					return end();
 				iterator tmp(_idx);
 				++tmp;
 				if (_idx == begin())
@@ -222,27 +519,73 @@ namespace ft {
 			/* erase */
 			size_type	erase(const key_type& val)
 			{
-				iterator it(__find(val), __nil);
-				if (it == end())
-					return 0;
-				if (it == begin())
-				{
-					iterator tmp(it);
-					++tmp;
-					__begin = tmp.base();
-				}
-				__remove(it.base());
-				del_node(it.base());
-				return 1;
+				FT_LATENCY_SCOPE(__rbt, latency_erase);
+				return __erase_node(__find(val));
+			}
+
+			/* transparent 비교자용 heterogeneous erase. key_type 임시 객체를 만들지 않는다. */
+			template <typename K>
+			size_type	erase(const K& key)
+			{
+				FT_LATENCY_SCOPE(__rbt, latency_erase);
+				return __erase_node(__find(key, ft::false_type()));
 			}
+
 			void	erase(iterator first, iterator last)
 			{
 				for ( ; first != last ;)
 					first = erase(first);
 			}
+			/* node handle 지원
+			extract     : 노드를 tree 에서 떼어내기만 하고 해제하지 않는다. end 면 NIL
+			insert_node : 떼어낸 노드를 그대로 연결한다. 같은 key 가 있으면 연결하지 않고 (그 노드, false)
+			merge       : other 에서 *this 에 없는 key 의 노드만 옮겨 연결한다. 겹치는 노드는 other 에 남는다.
+			노드는 같은(equal) 할당자를 쓰는 tree 사이에서만 옮길 수 있다. */
+			node_pointer	extract(iterator _idx)
+			{
+				if (_idx.base() == __end)
+					return ft::NIL;
+				return __extract(_idx.base());
+			}
+
+			node_pointer	extract(const key_type& key)
+			{ return extract(iterator(__find(key))); }
+
+			ft::pair<iterator, bool>	insert_node(node_pointer nd_ptr)
+			{
+				node_pointer parent;
+				node_pointer& slot = __search_parent(nd_ptr->__value, parent);
+				if (slot != ft::NIL)
+					return ft::make_pair(iterator(slot), false);
+				return ft::make_pair(iterator(__link_node(nd_ptr, parent, slot)), true);
+			}
+
+			ft::pair<iterator, bool>	insert_node(iterator _idx, node_pointer nd_ptr)
+			{
+				node_pointer parent;
+				node_pointer& slot = __search_parent(nd_ptr->__value, parent, _idx.base());
+				if (slot != ft::NIL)
+					return ft::make_pair(iterator(slot), false);
+				return ft::make_pair(iterator(__link_node(nd_ptr, parent, slot)), true);
+			}
+
+			void	merge(__rbt& other)
+			{
+				if (this == &other)
+					return;
+				node_pointer nd_ptr = other.__begin;
+				while (nd_ptr != other.__end)
+				{
+					node_pointer next = __next_node(nd_ptr);
+					node_pointer parent;
+					node_pointer& slot = __search_parent(nd_ptr->__value, parent);
+					if (slot == ft::NIL)
+						__link_node(other.__extract(nd_ptr), parent, slot);
+					nd_ptr = next;
+				}
+			}
 			void	swap(__rbt& rbt)
 			{
-				std::swap(__nil, rbt.__nil);
 				std::swap(__begin, rbt.__begin);
 				std::swap(__end, rbt.__end);
 				std::swap(__comp, rbt.__comp);
@@ -258,35 +601,196 @@ namespace ft {
 			}
 
 			iterator	find(const key_type& key)
-			{ return iterator(__find(key), __nil); }
+			{
+				FT_LATENCY_SCOPE(__rbt, latency_find);
+				return iterator(__find(key));
+			}
 
 			const_iterator	find(const key_type& key) const
-			{ return const_iterator(__find(key), __nil); }
+			{
+				FT_LATENCY_SCOPE(__rbt, latency_find);
+				return const_iterator(__find(key));
+			}
+
+			/* transparent 비교자용 heterogeneous find
+			key_type 이 아닌 K 에 대해선 three-way 비교를 보장할 수 없으므로 ordering 탐색을 쓴다. */
+			template <typename K>
+			iterator	find(const K& key)
+			{
+				FT_LATENCY_SCOPE(__rbt, latency_find);
+				return iterator(__find(key, ft::false_type()));
+			}
 
-			/* lower_bound k : 오른쪽 원소 중 k와 같거나 큰 값 중 가장 왼쪽의 iterator */
-			iterator	lower_bound(const key_type& key)
-			{ return iterator(__lower_bound(key), __nil); }
+			template <typename K>
+			const_iterator	find(const K& key) const
+			{
+				FT_LATENCY_SCOPE(__rbt, latency_find);
+				return const_iterator(__find(key, ft::false_type()));
+			}
 
-			const_iterator	lower_bound(const key_type& key) const
-			{ return const_iterator(__lower_bound(key), __nil); }
+			/* lower_bound k : 오른쪽 원소 중 k와 같거나 큰 값 중 가장 왼쪽의 iterator
+			bound 탐색은 ordering 비교만 쓰므로 K 는 key_type 또는 transparent 비교자가 받는 타입 */
+			template <typename K>
+			iterator	lower_bound(const K& key)
+			{ return iterator(__lower_bound(key)); }
+
+			template <typename K>
+			const_iterator	lower_bound(const K& key) const
+			{ return const_iterator(__lower_bound(key)); }
 
 			/* upper_bound k : 오른쪽 원소 중 k보다 큰 값 중 가장 왼쪽의 iterator */
-			iterator upper_bound(const key_type& key)
-			{ return iterator(__upper_bound(key), __nil); }
+			template <typename K>
+			iterator upper_bound(const K& key)
+			{ return iterator(__upper_bound(key)); }
 
-			const_iterator upper_bound(const key_type& key) const
-			{ return const_iterator(__upper_bound(key), __nil); }
+			template <typename K>
+			const_iterator upper_bound(const K& key) const
+			{ return const_iterator(__upper_bound(key)); }
 
 			/* pair<lower_bound iterator , upper_bound iterator> 객체로 반환*/
-			ft::pair<iterator, iterator> equal_range(const key_type& key)
+			template <typename K>
+			ft::pair<iterator, iterator> equal_range(const K& key)
 			{ return ft::make_pair(lower_bound(key), upper_bound(key)); }
 
-			ft::pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+			template <typename K>
+			ft::pair<const_iterator, const_iterator> equal_range(const K& key) const
 			{ return ft::make_pair(lower_bound(key), upper_bound(key)); }
 
+			/* 일괄 조회 : [first, last) 의 key 마다 결과를 out 에 차례로 채운다. (out 은 비우고 다시 채운다)
+			out 은 ft::vector<iterator / const_iterator> 또는 ft::vector<size_type> (count)
+			sorted 면 앞 key 의 탐색 경로를 이어서 쓰고, 아니면 key 들을 묶어 함께 내려간다. */
+			template <typename ForwardIterator, class Out>
+			void	lower_bound_many(ForwardIterator first, ForwardIterator last, Out& out, bool sorted) const
+			{ __many(first, last, out, sorted, false); }
+
+			template <typename ForwardIterator, class Out>
+			void	find_many(ForwardIterator first, ForwardIterator last, Out& out, bool sorted) const
+			{ __many(first, last, out, sorted, true); }
+
+			/* tree 전체를 한 번 돌며 모양을 재고 red-black 규칙을 검사한다. O(n), 할당하지 않는다. */
+			tree_stats	stats() const
+			{
+				tree_stats st = tree_stats();
+				st.valid = true;
+				node_pointer root = getRoot();
+				if (root == ft::NIL)
+				{
+					st.valid = __begin == __end && __size == 0;
+					st.contiguous_ratio = 1.0;
+					return st;
+				}
+				if (!root->__is_black || root->__parent != __end || __begin != __min_node(root))
+					st.valid = false;
+				node_pointer prev = ft::NIL;
+				std::size_t adjacent = 0;
+				std::size_t path_sum = 0;
+				st.black_height = __stats_walk(root, 0, st, prev, adjacent, path_sum);
+				if (st.size != __size)
+					st.valid = false;
+				st.average_path_length = static_cast<double>(path_sum) / st.size;
+				st.contiguous_ratio = st.size > 1 ? static_cast<double>(adjacent) / (st.size - 1) : 1.0;
+				return st;
+			}
+
+			/* order statistics
+			rank(key)            : key 보다 작은 원소의 수 (= lower_bound 의 순서)
+			select(k)            : k 번째(0 부터) 원소. k >= size 면 end()
+			count_range(lo, hi)  : [lo, hi) 범위의 원소 수
+			Counted 면 O(log n), 아니면 순회하므로 O(n) */
+			template <typename K>
+			size_type	rank(const K& key) const
+			{ return __rank(key, is_counted()); }
+
+			iterator	select(size_type k)
+			{ return iterator(__select(k, is_counted())); }
+
+			const_iterator	select(size_type k) const
+			{ return const_iterator(__select(k, is_counted())); }
+
+			template <typename K>
+			size_type	count_range(const K& lo, const K& hi) const
+			{
+				size_type r_lo = rank(lo);
+				size_type r_hi = rank(hi);
+				return r_lo < r_hi ? r_hi - r_lo : 0;
+			}
+
+			/* 일괄 순회 (__inorder_walker 참고). iterator 로 도는 것과 순서는 같다.
+			for_each(f)               : 모든 원소에 차례로 f(value)
+			range_for_each(lo, hi, f) : [lo, hi) 의 원소에 차례로 f(value)
+			cursor() / cursor(lo, hi) : 같은 순서로 n 개씩 복사해 가는 cursor
+			도는 동안 f 가 tree 를 바꾸면 안 된다. */
+			typedef ft::__batch_cursor<node_type, const value_type>	batch_cursor;
+
+			template <class F>
+			F	for_each(F f)		{ return __walk<value_type>(__full_walker(), f); }
+			template <class F>
+			F	for_each(F f) const	{ return __walk<const value_type>(__full_walker(), f); }
+
+			template <typename K, class F>
+			F	range_for_each(const K& lo, const K& hi, F f)		{ return __walk<value_type>(__range_walker(lo, hi), f); }
+			template <typename K, class F>
+			F	range_for_each(const K& lo, const K& hi, F f) const	{ return __walk<const value_type>(__range_walker(lo, hi), f); }
+
+			batch_cursor	cursor() const	{ return batch_cursor(__full_walker()); }
+			template <typename K>
+			batch_cursor	cursor(const K& lo, const K& hi) const	{ return batch_cursor(__range_walker(lo, hi)); }
+
+			/* set algebra (join / split 기반)
+			set_union(other)        : *this = *this ∪ other
+			set_intersection(other) : *this = *this ∩ other
+			set_difference(other)   : *this = *this - other
+			other 의 노드는 *this 로 다시 연결되거나 해제되고 other 는 비워진다. 새 노드는 할당하지 않는다.
+			양쪽에 같은 원소가 있으면 *this 의 노드가 남는다. (map 이면 *this 의 mapped 값)
+			두 tree 의 크기가 m <= n 일 때 O(m log(n / m + 1)) */
+			void	set_union(__rbt& other)
+			{
+				if (this == &other)
+					return;
+				__join_tree t1 = __detach_tree();
+				__join_tree t2 = other.__detach_tree();
+				__size += other.__size;
+				other.__size = 0;
+				__attach_tree(__union(t1, t2));
+			}
+			void	set_intersection(__rbt& other)
+			{
+				if (this == &other)
+					return;
+				__join_tree t1 = __detach_tree();
+				__join_tree t2 = other.__detach_tree();
+				__size += other.__size;
+				other.__size = 0;
+				__attach_tree(__intersection(t1, t2));
+			}
+			void	set_difference(__rbt& other)
+			{
+				if (this == &other)
+				{
+					clear();
+					return;
+				}
+				__join_tree t1 = __detach_tree();
+				__join_tree t2 = other.__detach_tree();
+				__size += other.__size;
+				other.__size = 0;
+				__attach_tree(__difference(t1, t2));
+			}
+
 			allocator_type get_allocator() const
 			{ return __alloc; }
 
+			/* 원소 노드는 value 를 뺀 나머지(link, color, 부분 크기)가, __end sentinel 은 통째로 overhead 다.
+			container 객체의 크기는 부르는 쪽이 더한다. */
+			ft::memory_footprint	memory_usage() const
+			{
+				ft::memory_footprint m;
+				m.payload = __size * sizeof(value_type);
+				m.overhead = (__size + 1) * sizeof(node_type) - m.payload;
+				m.allocator = (__size + 1) * ft::__heap_block_overhead(sizeof(node_type));
+				return m;
+			}
+
 			node_pointer	getRoot() const
 			{ return __end->__left; }
 
@@ -297,83 +801,232 @@ namespace ft {
 				__end->__left = nd_ptr;
 			}
 
+			node_pointer	__allocate_node()
+			{
+				FT_OP_COUNT(__rbt, allocations, 1);
+				FT_OP_COUNT(__rbt, bytes_allocated, sizeof(node_type));
+				return __alloc.allocate(1);
+			}
+			/* 생성하지 못한 노드를 돌려준다. */
+			void	__deallocate_node(node_pointer nd_ptr)
+			{
+				FT_OP_COUNT(__rbt, deallocations, 1);
+				__alloc.deallocate(nd_ptr, 1);
+			}
 			node_pointer	make_node(const value_type& val)
 			{
-				node_pointer nd_ptr = __alloc.allocate(1);
+				node_pointer nd_ptr = __allocate_node();
 				__alloc.construct(nd_ptr, val);
-				nd_ptr->__parent = __nil;
-				nd_ptr->__left = __nil;
-				nd_ptr->__right = __nil;
+				nd_ptr->__parent = ft::NIL;
+				nd_ptr->__left = ft::NIL;
+				nd_ptr->__right = ft::NIL;
+				nd_ptr->__is_black = false;
+				return nd_ptr;
+			}
+			/* __find 결과 노드 삭제. 없으면(__end) 0 */
+			size_type	__erase_node(node_pointer nd_ptr)
+			{
+				if (nd_ptr == __end)
+					return 0;
+				if (nd_ptr == __begin)
+					__begin = __next_node(nd_ptr);
+				__remove(nd_ptr);
+				del_node(nd_ptr);
+				return 1;
+			}
+			/* 노드를 떼어내고 새 노드처럼(red leaf) 초기화한다. 해제는 하지 않는다. */
+			node_pointer	__extract(node_pointer nd_ptr)
+			{
+				if (nd_ptr == __begin)
+					__begin = __next_node(nd_ptr);
+				__remove(nd_ptr);
+				--__size;
+				nd_ptr->__parent = ft::NIL;
+				nd_ptr->__left = ft::NIL;
+				nd_ptr->__right = ft::NIL;
 				nd_ptr->__is_black = false;
+				__update_count(nd_ptr);
+				return nd_ptr;
+			}
+			template <typename A>
+			node_pointer	__make_node_in_place(const A& a)
+			{
+				node_pointer nd_ptr = __allocate_node();
+				try
+				{
+					::new (static_cast<void*>(nd_ptr)) node_type(__in_place_t(), a);
+				}
+				catch (...)
+				{
+					__deallocate_node(nd_ptr);
+					throw;
+				}
+				return nd_ptr;
+			}
+			template <typename A, typename B>
+			node_pointer	__make_node_in_place(const A& a, const B& b)
+			{
+				node_pointer nd_ptr = __allocate_node();
+				try
+				{
+					::new (static_cast<void*>(nd_ptr)) node_type(__in_place_t(), a, b);
+				}
+				catch (...)
+				{
+					__deallocate_node(nd_ptr);
+					throw;
+				}
 				return nd_ptr;
 			}
 			void	del_node(node_pointer nd_ptr)
 			{
+				FT_OP_COUNT(__rbt, deallocations, 1);
 				--__size;
 				__alloc.destroy(nd_ptr);
 				__alloc.deallocate(nd_ptr, 1);
 			}
 			void	del_node_all(node_pointer nd_ptr)
 			{
-				if (nd_ptr == __nil)
+				if (nd_ptr == ft::NIL)
 					return;
 				del_node_all(nd_ptr->__left);
 				del_node_all(nd_ptr->__right);
 				del_node(nd_ptr);
 			}
-			node_pointer	__search_parent(const value_type& val, node_pointer _idx = ft::NIL)
+			/* nd_ptr 를 가리키고 있는 부모의 child 포인터 */
+			node_pointer&	__child_slot(node_pointer nd_ptr)
+			{
+				if (__is_left_child(nd_ptr))
+					return nd_ptr->__parent->__left;
+				return nd_ptr->__parent->__right;
+			}
+			/* val 이 매달릴 자리(부모의 child 포인터)를 반환하고 parent 에 그 부모를 담는다.
+			같은 값의 노드가 있으면 그 노드를 가리키는 자리를 반환하므로 slot != NIL 로 중복을 판단한다.
+			_idx(hint) 가 val 의 바로 앞/뒤 라면 탐색 없이 hint 주변에 매단다. */
+			node_pointer&	__search_parent(const value_type& val, node_pointer& parent, node_pointer _idx = ft::NIL)
 			{
-				if (_idx && _idx != __end)
+				if (_idx != ft::NIL)
 				{
-					if (__comp(val, _idx->__value) && _idx->__left == __nil)
+					if (_idx == __end || __less(val, _idx->__value))
+					{
+						/* val < hint : hint 의 이전 노드 < val 이면 둘 사이에 들어간다. */
+						node_pointer prev = _idx;
+						if (_idx == __begin || __less((prev = __prev_node(_idx))->__value, val))
+						{
+							if (_idx->__left == ft::NIL)
+							{
+								parent = _idx;
+								return _idx->__left;
+							}
+							parent = prev;
+							return prev->__right;
+						}
+					}
+					else if (__less(_idx->__value, val))
 					{
-						iterator it_prev = iterator(_idx, __nil);
-						if (it_prev == begin() || __comp(*--it_prev, val))
-							return _idx;
+						/* hint < val : val < hint 의 다음 노드 이면 둘 사이에 들어간다. */
+						node_pointer next = __next_node(_idx);
+						if (next == __end || __less(val, next->__value))
+						{
+							if (_idx->__right == ft::NIL)
+							{
+								parent = _idx;
+								return _idx->__right;
+							}
+							parent = next;
+							return next->__left;
+						}
 					}
-					else if (_idx->__right == __nil)
+					else
 					{
-						iterator it_next = iterator(_idx, __nil);
-						if (it_next == end() || __comp(val, *++it_next))
-							return _idx;
+						parent = _idx->__parent;
+						return __child_slot(_idx);
 					}
 				}
-				node_pointer cur = getRoot();
-				node_pointer tmp = __end;
-				for ( ; cur != __nil ; )
+				return __search_parent(val, parent, is_three_way());
+			}
+			/* three-way : 레벨 당 compare 한 번
+			val 은 value_type 또는 key_type (비교자가 둘 다 받는다) */
+			template <typename V>
+			node_pointer&	__search_parent(const V& val, node_pointer& parent, ft::true_type)
+			{
+				node_pointer* slot = &__end->__left;
+				parent = __end;
+				while (*slot != ft::NIL)
 				{
-					tmp = cur;
-					if (__comp(val, cur->__value))
-						cur = cur->__left;
-					else if (__comp(cur->__value, val))
-						cur = cur->__right;
+					int cmp = __compare3(val, (*slot)->__value);
+					if (cmp == 0)
+						break;
+					parent = *slot;
+					slot = cmp < 0 ? &parent->__left : &parent->__right;
+				}
+				return *slot;
+			}
+			/* ordering : 레벨 당 comp 한 번, 마지막에 오른쪽으로 꺾었던 노드(val 이하 중 가장 큰 노드)와 같은지 한 번 확인 */
+			template <typename V>
+			node_pointer&	__search_parent(const V& val, node_pointer& parent, ft::false_type)
+			{
+				node_pointer* slot = &__end->__left;
+				node_pointer* cand = ft::NIL;
+				parent = __end;
+				while (*slot != ft::NIL)
+				{
+					parent = *slot;
+					if (__less(val, parent->__value))
+						slot = &parent->__left;
 					else
-						return cur;
+					{
+						cand = slot;
+						slot = &parent->__right;
+					}
 				}
-				/* 루트 노드의 leaf가 비어있을경우 그대로 반환 */
-				return tmp;
+				if (cand != ft::NIL && !__less((*cand)->__value, val))
+				{
+					parent = (*cand)->__parent;
+					return *cand;
+				}
+				return *slot;
 			}
-			/* parent value보다 작으면 왼쪽 크면 오른쪽 삽입 -> 해당 노드를 삽입 후 Tree 재정렬 */
-			node_pointer	__insert_tree(const value_type& val, node_pointer parent)
+			node_pointer	__insert_tree(const value_type& val, node_pointer parent, node_pointer& slot)
+			{ return __link_node(make_node(val), parent, slot); }
+
+			/* parent 의 빈 자리(slot)에 노드를 매단 후 Tree 재정렬 */
+			node_pointer	__link_node(node_pointer nd_ptr, node_pointer parent, node_pointer& slot)
 			{
-				node_pointer nd_ptr = make_node(val);
-				if (parent == __end)
-					setRoot(nd_ptr);
-				else if (__comp(val, parent->__value))
-					parent->__left = nd_ptr;
-				else
-					parent->__right = nd_ptr;
 				nd_ptr->__parent = parent;
-				__insert_fix(nd_ptr);
+				slot = nd_ptr;
+				FT_OP_COUNT(__rbt, inserts, 1);
+# ifdef FT_INSTRUMENT
+				size_type depth = __depth_of(nd_ptr);
+				FT_OP_COUNT(__rbt, insert_depth_sum, depth);
+				FT_OP_MAX(__rbt, insert_depth_max, depth);
+# endif
 				__insert_init(nd_ptr);
+				__update_count_path(parent);
+				__insert_fix(nd_ptr);
 				return nd_ptr;
 			}
+			/* root 가 0 */
+			size_type	__depth_of(node_pointer nd_ptr) const
+			{
+				size_type depth = 0;
+				for ( ; nd_ptr->__parent != __end ; nd_ptr = nd_ptr->__parent)
+					++depth;
+				return depth;
+			}
 			/* 부모 컬러가 red 일 경우 !! double red !!
 			-> parent 노드의 위치를 보고 fix_left or fix_right 실행 */
 			void	__insert_fix(node_pointer nd_ptr)
+			{
+				__insert_rebalance(nd_ptr);
+				getRoot()->__is_black = true;
+			}
+			/* red-red 를 root 쪽으로 올리며 해결한다. root 가 red 로 남을 수 있다. (__join 이 black-height 를 계산할 때 사용) */
+			void	__insert_rebalance(node_pointer nd_ptr)
 			{
 				while (__is_red_color(nd_ptr->__parent))
 				{
+					FT_OP_COUNT(__rbt, fixup_iterations, 1);
 					if (__is_left_child(nd_ptr->__parent))
 					{
 						node_pointer uncle = nd_ptr->__parent->__parent->__right;
@@ -391,7 +1044,6 @@ namespace ft {
 							__restructing_right(nd_ptr);
 					}
 				}
-				getRoot()->__is_black = true;
 			}
 
 			void	__recoloring(node_pointer& nd_ptr, node_pointer& uncle)
@@ -402,7 +1054,7 @@ namespace ft {
 				nd_ptr = uncle->__parent;
 			}
 
-			void	__restructing_left(node_pointer nd_ptr)
+			void	__restructing_left(node_pointer& nd_ptr)
 			{
 				if (__is_right_child(nd_ptr))
 				{
@@ -413,7 +1065,7 @@ namespace ft {
 				nd_ptr->__parent->__parent->__is_black = false;
 				__rot_right(nd_ptr->__parent->__parent);
 			}
-			void	__restructing_right(node_pointer nd_ptr)
+			void	__restructing_right(node_pointer& nd_ptr)
 			{
 				if (__is_left_child(nd_ptr))
 				{
@@ -424,42 +1076,48 @@ namespace ft {
 				nd_ptr->__parent->__parent->__is_black = false;
 				__rot_left(nd_ptr->__parent->__parent);
 			}
-			// /* insert로 변화된 트리 초기값 설정 */
+			/* insert로 변화된 트리 초기값 설정
+			begin 은 left child 가 없으므로 새 노드가 begin 의 left 에 매달렸을 때만 begin 이 바뀐다. (빈 트리면 __end->__left)
+			rotation 전에 확인해야 한다. */
 			void	__insert_init(const node_pointer nd_ptr)
 			{
-				if (__begin == __end || __comp(nd_ptr->__value, __begin->__value))
+				if (__begin->__left == nd_ptr)
 					__begin = nd_ptr;
 				__size++;
 			}
 			/* recoloring 노드 포인터설정 매개변수로 받은 노드 포인터를 nd_fix으로 설정
 			nd_fix : 자식이 둘 일때 삭제될 자리로 바꿀 노드 포인터
-			nd_recolor : recoloring(rebalancing)을 고려할 노드 포인터 */
+			nd_recolor : recoloring(rebalancing)을 고려할 노드 포인터
+			nd_parent : nd_recolor의 부모. leaf(null)는 부모를 가질 수 없으므로 따로 들고 다닌다. */
 			void	__remove(node_pointer nd_ptr)
 			{
 				node_pointer nd_recolor;
+				node_pointer nd_parent;
 				node_pointer nd_fix = nd_ptr;
 				bool origin_color = __is_black_color(nd_ptr);
 				/* nd_ptr -> left leaf만 비어있을 경우 nd_ptr->right를 옮겨 link됨 */
-				if (nd_ptr->__left == __nil)
+				if (nd_ptr->__left == ft::NIL)
 				{
 					nd_recolor = nd_ptr->__right;
+					nd_parent = nd_ptr->__parent;
 					__transplant(nd_ptr, nd_ptr->__right);
 				}
 				/* nd_ptr -> right leaf만 비어있을 경우 */
-				else if (nd_ptr->__right == __nil)
+				else if (nd_ptr->__right == ft::NIL)
 				{
 					nd_recolor = nd_ptr->__left;
+					nd_parent = nd_ptr->__parent;
 					__transplant(nd_ptr, nd_ptr->__left);
 				}
 				/* left & right 모두 있을 경우 */
 				else
 				{
-					nd_fix = __min_node(nd_ptr->__right, __nil);
+					nd_fix = __min_node(nd_ptr->__right);
 					origin_color = __is_black_color(nd_fix);
 					/* nd_fix은 left가 없으므로 옮길때 고려할 nd_recolor은 right */
 					nd_recolor = nd_fix->__right;
 					if (nd_fix->__parent == nd_ptr)
-						nd_recolor->__parent = nd_fix;
+						nd_parent = nd_fix;
 					else
 					{
 						/* 옮겨 심어질 경우 고려할 경우
@@ -467,6 +1125,7 @@ namespace ft {
 						2. 오른쪽 자식이 없는 경우 -> 그냥 이어주면 됨
 						3. 서브트리로 이어나가 오른쪽 자식이 있는경우
 						-> nd_fix을 옮겨주고 right를 nd_fix 부모와 연결 하면 끝*/
+						nd_parent = nd_fix->__parent;
 						__transplant(nd_fix, nd_fix->__right);
 						nd_fix->__right = nd_ptr->__right;
 						nd_fix->__right->__parent = nd_fix;
@@ -479,34 +1138,39 @@ namespace ft {
 				/* 삭제한 노드가 red 색상이면 그냥 지워도 상관 없음.
 				-> origin_color 가 black 이면 이를 지나는 모든 경로에서 black - 1이 됨
 				-> 리밸런싱 */
+				/* fixup 의 rotation 은 __count 가 맞다고 가정하므로 먼저 잘려나간 경로를 갱신 */
+				__update_count_path(nd_parent);
 				if (origin_color)
-					__remove_fixup(nd_recolor);
+					__remove_fixup(nd_recolor, nd_parent);
 			}
-			/* nd_ptr이 새로운 root가 아니고 black 일 경우 fixup 반복문 */
-			void	__remove_fixup(node_pointer nd_ptr)
+			/* nd_ptr이 새로운 root가 아니고 black 일 경우 fixup 반복문
+			nd_ptr은 null leaf일 수 있으므로 left/right 판단은 parent 기준으로 한다. */
+			void	__remove_fixup(node_pointer nd_ptr, node_pointer parent)
 			{
 				while (nd_ptr != getRoot() && __is_black_color(nd_ptr))
 				{
-					if (__is_left_child(nd_ptr))
-						__remove_fixup_left(nd_ptr);
+					FT_OP_COUNT(__rbt, fixup_iterations, 1);
+					if (nd_ptr == parent->__left)
+						__remove_fixup_left(nd_ptr, parent);
 					else
-						__remove_fixup_right(nd_ptr);
+						__remove_fixup_right(nd_ptr, parent);
 				}
-				nd_ptr->__is_black = true;
+				if (nd_ptr != ft::NIL)
+					nd_ptr->__is_black = true;
 			}
 
-			void	__remove_fixup_left(node_pointer& nd_ptr)
+			void	__remove_fixup_left(node_pointer& nd_ptr, node_pointer& parent)
 			{
-				node_pointer sibling = nd_ptr->__parent->__right;
+				node_pointer sibling = parent->__right;
 				/* case 1) 형제가 red 일 경우.
 				-> 부모와 형제의 색을 바꾸고 부모기준 left_rotation */
 				if (__is_red_color(sibling))
 				{
 					sibling->__is_black = true;
-					nd_ptr->__parent->__is_black = false;
-					__rot_left(nd_ptr->__parent);
+					parent->__is_black = false;
+					__rot_left(parent);
 					/* 새로운 sibling이 black이 됨. nd_ptr을 지나는 경로의 black - 1은 유지. */
-					sibling = nd_ptr->__parent->__right;
+					sibling = parent->__right;
 				}
 				/* case 2) S의 자식들이 모두 black인 경우.
 				-> S를 red로 바꾸면 N-P 경로와 S-P 경로의 black - 1 이 됨.
@@ -514,83 +1178,84 @@ namespace ft {
 				if (__is_black_color(sibling->__left) && __is_black_color(sibling->__right))
 				{
 					sibling->__is_black = false;
-					nd_ptr = nd_ptr->__parent;
+					nd_ptr = parent;
+					parent = nd_ptr->__parent;
+					return;
 				}
 				/* case 2-1) S와 S->right S가 black 인 경우 (case 1에 의해 S는 반드시 black)
 				-> S->left를 black으로 만들고 S를 red로 만듬. -> S기준 right_rotation
 				-> 모든 경로에서 black 노드 수는 변함 없음. */
-				else if (__is_black_color(sibling->__right))
+				if (__is_black_color(sibling->__right))
 				{
 					sibling->__left->__is_black = true;
 					sibling->__is_black = false;
 					__rot_right(sibling);
-					sibling = nd_ptr->__parent->__right;
+					sibling = parent->__right;
 				}
 				/* S는 black S->right가 red인 경우
 				-> P와 S의 색을 바꾸고 (S는 반드시 black) S->right를 black 으로 바꿈.
 				-> P 기준 left_rotation
 				-> 짜잔 N-P 경로에서 black 경로가 + 1 되서 종료.(getRoot()를 추가하면서 종료 시그널을 보냄) */
-				if (__is_red_color(sibling->__right))
-				{
-					sibling->__is_black = __is_black_color(nd_ptr->__parent);
-					nd_ptr->__parent->__is_black = true;
-					sibling->__right->__is_black = true;
-					__rot_left(nd_ptr->__parent);
-					nd_ptr = getRoot();
-				}
+				sibling->__is_black = __is_black_color(parent);
+				parent->__is_black = true;
+				sibling->__right->__is_black = true;
+				__rot_left(parent);
+				nd_ptr = getRoot();
 			}
 			/* fixup_left와 대칭 */
-			void	__remove_fixup_right(node_pointer& nd_ptr)
+			void	__remove_fixup_right(node_pointer& nd_ptr, node_pointer& parent)
 			{
-				node_pointer sibling = nd_ptr->__parent->__left;
+				node_pointer sibling = parent->__left;
 				if (__is_red_color(sibling))
 				{
 					sibling->__is_black = true;
-					nd_ptr->__parent->__is_black = false;
-					__rot_right(nd_ptr->__parent);
-					sibling = nd_ptr->__parent->__left;
+					parent->__is_black = false;
+					__rot_right(parent);
+					sibling = parent->__left;
 				}
 				if (__is_black_color(sibling->__right) && __is_black_color(sibling->__left))
 				{
 					sibling->__is_black = false;
-					nd_ptr = nd_ptr->__parent;
+					nd_ptr = parent;
+					parent = nd_ptr->__parent;
+					return;
 				}
-				else if (__is_black_color(sibling->__left))
+				if (__is_black_color(sibling->__left))
 				{
 					sibling->__right->__is_black = true;
 					sibling->__is_black = false;
 					__rot_left(sibling);
-					sibling = nd_ptr->__parent->__left;
-				}
-				if (__is_red_color(sibling->__left))
-				{
-					sibling->__is_black = __is_black_color(nd_ptr->__parent);
-					nd_ptr->__parent->__is_black = true;
-					sibling->__left->__is_black = true;
-					__rot_right(nd_ptr->__parent);
-					nd_ptr = getRoot();
+					sibling = parent->__left;
 				}
+				sibling->__is_black = __is_black_color(parent);
+				parent->__is_black = true;
+				sibling->__left->__is_black = true;
+				__rot_right(parent);
+				nd_ptr = getRoot();
 			}
-			/* 삭제할 노드의 부모가 end 노드일 경우와 아닐경우의 link 함수 */
+			/* 삭제할 노드의 부모가 end 노드일 경우와 아닐경우의 link 함수
+			after는 null leaf일 수 있다. */
 			void	__transplant(node_pointer before, node_pointer after)
 			{
-				/* __end 일 경우 nil만 존재. setRoot */
+				/* __end 일 경우 root를 교체 */
 				if (before->__parent == __end)
-					setRoot(after);
+					__end->__left = after;
 				/* 아닐경우 직접 옮김 */
 				else if (__is_left_child(before))
 					before->__parent->__left = after;
 				else
 					before->__parent->__right = after;
 				/* link */
-				after->__parent = before->__parent;
+				if (after != ft::NIL)
+					after->__parent = before->__parent;
 			}
 			/* nd_ptr 기준으로 왼쪽 회전 BST 특성상 옮겨간 sub-tree도 특성을 유지하고 RBT의 규칙도 유지함. */
 			void	__rot_left(node_pointer nd_ptr)
 			{
+				FT_OP_COUNT(__rbt, rotations, 1);
 				node_pointer ch = nd_ptr->__right;
 				nd_ptr->__right = ch->__left;
-				if (nd_ptr->__right != __nil)
+				if (nd_ptr->__right != ft::NIL)
 					nd_ptr->__right->__parent = nd_ptr;
 				node_pointer parent = nd_ptr->__parent;
 				ch->__parent = parent;
@@ -602,13 +1267,16 @@ namespace ft {
 					parent->__right = ch;
 				ch->__left = nd_ptr;
 				nd_ptr->__parent = ch;
+				__update_count(nd_ptr);
+				__update_count(ch);
 			}
 			/* left랑 대칭 */
 			void	__rot_right(node_pointer nd_ptr)
 			{
+				FT_OP_COUNT(__rbt, rotations, 1);
 				node_pointer ch = nd_ptr->__left;
 				nd_ptr->__left = ch->__right;
-				if (nd_ptr->__left != __nil)
+				if (nd_ptr->__left != ft::NIL)
 					nd_ptr->__left->__parent = nd_ptr;
 				node_pointer parent = nd_ptr->__parent;
 				ch->__parent = parent;
@@ -620,28 +1288,83 @@ namespace ft {
 					parent->__right = ch;
 				ch->__right = nd_ptr;
 				nd_ptr->__parent = ch;
+				__update_count(nd_ptr);
+				__update_count(ch);
+			}
+			/* lower_bound 처럼 내려가며 오른쪽으로 꺾을 때마다 왼쪽 sub-tree + 자신을 더한다. */
+			template <typename K>
+			size_type	__rank(const K& key, ft::true_type) const
+			{
+				size_type rank = 0;
+				node_pointer nd_ptr = getRoot();
+				while (nd_ptr != ft::NIL)
+				{
+					if (!__less(nd_ptr->__value, key))
+						nd_ptr = nd_ptr->__left;
+					else
+					{
+						rank += __count_of(nd_ptr->__left) + 1;
+						nd_ptr = nd_ptr->__right;
+					}
+				}
+				return rank;
+			}
+			template <typename K>
+			size_type	__rank(const K& key, ft::false_type) const
+			{
+				size_type rank = 0;
+				node_pointer last = __lower_bound(key);
+				for (node_pointer nd_ptr = __begin ; nd_ptr != last ; nd_ptr = __next_node(nd_ptr))
+					++rank;
+				return rank;
+			}
+			node_pointer	__select(size_type k, ft::true_type) const
+			{ return __node_select(__end, k); }
+
+			node_pointer	__select(size_type k, ft::false_type) const
+			{
+				if (k >= __size)
+					return __end;
+				node_pointer nd_ptr = __begin;
+				for ( ; k > 0 ; --k)
+					nd_ptr = __next_node(nd_ptr);
+				return nd_ptr;
 			}
 			node_pointer __find(const key_type& val) const
+			{ return __find(val, is_three_way()); }
+
+			node_pointer __find(const key_type& val, ft::true_type) const
 			{
 				node_pointer nd_ptr = getRoot();
-				while (nd_ptr != __nil)
+				while (nd_ptr != ft::NIL)
 				{
-					if (__comp(val, nd_ptr->__value))
+					int cmp = __compare3(val, nd_ptr->__value);
+					if (cmp < 0)
 						nd_ptr = nd_ptr->__left;
-					else if (__comp(nd_ptr->__value, val))
+					else if (cmp > 0)
 						nd_ptr = nd_ptr->__right;
 					else
 						return nd_ptr;
 				}
 				return __end;
 			}
-			node_pointer	__lower_bound(const key_type& key) const
+			/* lower_bound 로 내려간 후 찾은 노드가 val 과 같은지 한 번만 확인 */
+			template <typename K>
+			node_pointer __find(const K& val, ft::false_type) const
+			{
+				node_pointer nd_ptr = __lower_bound(val);
+				if (nd_ptr != __end && !__less(val, nd_ptr->__value))
+					return nd_ptr;
+				return __end;
+			}
+			template <typename K>
+			node_pointer	__lower_bound(const K& key) const
 			{
 				node_pointer nd_ptr = getRoot();
 				node_pointer tmp = __end;
-				while (nd_ptr != __nil)
+				while (nd_ptr != ft::NIL)
 				{
-					if (!__comp(nd_ptr->__value, key))
+					if (!__less(nd_ptr->__value, key))
 					{
 						tmp = nd_ptr;
 						nd_ptr = nd_ptr->__left;
@@ -651,13 +1374,14 @@ namespace ft {
 				}
 				return tmp;
 			}
-			node_pointer	__upper_bound(const key_type& key) const
+			template <typename K>
+			node_pointer	__upper_bound(const K& key) const
 			{
 				node_pointer nd_ptr = getRoot();
 				node_pointer tmp = __end;
-				while (nd_ptr != __nil)
+				while (nd_ptr != ft::NIL)
 				{
-					if (__comp(key, nd_ptr->__value))
+					if (__less(key, nd_ptr->__value))
 					{
 						tmp = nd_ptr;
 						nd_ptr = nd_ptr->__left;
@@ -667,6 +1391,454 @@ namespace ft {
 				}
 				return tmp;
 			}
+
+			template <typename ForwardIterator, class Out>
+			void	__many(ForwardIterator first, ForwardIterator last, Out& out, bool sorted, bool exact) const
+			{
+				size_type n = 0;
+				for (ForwardIterator it = first ; it != last ; ++it)
+					++n;
+				out.clear();
+				out.reserve(n);
+				if (sorted)
+					__many_sorted(first, last, out, exact);
+				else
+					__many_grouped(first, last, out, exact);
+			}
+
+			/* group prefetching : key __lookup_group 개를 한 단계씩 번갈아 내려가고, 다음에 읽을 노드를 미리 prefetch 한다.
+			한 key 의 다음 노드가 메모리에서 오는 동안 다른 key 들을 처리하므로 cache miss 가 겹친다. */
+			template <typename ForwardIterator, class Out>
+			void	__many_grouped(ForwardIterator first, ForwardIterator last, Out& out, bool exact) const
+			{
+				ForwardIterator	keys[__lookup_group];
+				node_pointer	cur[__lookup_group];
+				node_pointer	best[__lookup_group];
+				while (first != last)
+				{
+					size_type g = 0;
+					for ( ; g < __lookup_group && first != last ; ++g, ++first)
+					{
+						keys[g] = first;
+						cur[g] = getRoot();
+						best[g] = __end;
+					}
+					for (bool active = true ; active ; )
+					{
+						active = false;
+						for (size_type i = 0 ; i < g ; ++i)
+						{
+							node_pointer nd_ptr = cur[i];
+							if (nd_ptr == ft::NIL)
+								continue;
+							if (!__less(nd_ptr->__value, *keys[i]))
+							{
+								best[i] = nd_ptr;
+								nd_ptr = nd_ptr->__left;
+							}
+							else
+								nd_ptr = nd_ptr->__right;
+							cur[i] = nd_ptr;
+							if (nd_ptr != ft::NIL)
+							{
+								__builtin_prefetch(nd_ptr);
+								active = true;
+							}
+						}
+					}
+					for (size_type i = 0 ; i < g ; ++i)
+						__emit(out, exact ? __exact(best[i], *keys[i]) : best[i]);
+				}
+			}
+
+			/* 정렬된 key : 앞 key 의 탐색에서 왼쪽으로 꺾은 노드(= lower_bound 후보)들을 stack 에 남겨둔다.
+			깊을수록 작으므로 위에서부터 key 이상인 첫 노드까지만 올라가 그 왼쪽 sub-tree 부터 다시 내려간다.
+			앞 key 의 lower_bound 가 이미 key 이상이면 답이 같으므로 내려가지 않는다. */
+			template <typename ForwardIterator, class Out>
+			void	__many_sorted(ForwardIterator first, ForwardIterator last, Out& out, bool exact) const
+			{
+				node_pointer	turns[__tree_max_height];
+				int				m = 0;
+				for ( ; first != last ; ++first)
+				{
+					if (m == 0 || __less(turns[m - 1]->__value, *first))
+					{
+						while (m > 0 && __less(turns[m - 1]->__value, *first))
+							--m;
+						node_pointer nd_ptr = m ? turns[m - 1]->__left : getRoot();
+						while (nd_ptr != ft::NIL)
+						{
+							if (!__less(nd_ptr->__value, *first))
+							{
+								turns[m++] = nd_ptr;
+								nd_ptr = nd_ptr->__left;
+							}
+							else
+								nd_ptr = nd_ptr->__right;
+						}
+					}
+					node_pointer lb = m ? turns[m - 1] : __end;
+					__emit(out, exact ? __exact(lb, *first) : lb);
+				}
+			}
+
+			template <typename K>
+			node_pointer	__exact(node_pointer nd_ptr, const K& key) const
+			{ return nd_ptr != __end && !__less(key, nd_ptr->__value) ? nd_ptr : __end; }
+
+			void	__emit(ft::vector<size_type>& out, node_pointer nd_ptr) const
+			{ out.push_back(nd_ptr != __end); }
+
+			template <class Result>
+			void	__emit(ft::vector<Result>& out, node_pointer nd_ptr) const
+			{ out.push_back(Result(nd_ptr)); }
+
+			__inorder_walker<node_pointer>	__full_walker() const
+			{
+				__inorder_walker<node_pointer> w;
+				w.__push_left(getRoot());
+				return w;
+			}
+			/* lower_bound(lo) 까지 내려가며 lo 이상인 조상만 쌓고, lower_bound(hi) 에서 멈춘다. */
+			template <typename K>
+			__inorder_walker<node_pointer>	__range_walker(const K& lo, const K& hi) const
+			{
+				__inorder_walker<node_pointer> w;
+				for (node_pointer nd_ptr = getRoot() ; nd_ptr != ft::NIL ; )
+				{
+					if (!__less(nd_ptr->__value, lo))
+					{
+						w.__push(nd_ptr);
+						nd_ptr = nd_ptr->__left;
+					}
+					else
+						nd_ptr = nd_ptr->__right;
+				}
+				if (w.__top() == ft::NIL || !__less(w.__top()->__value, hi))
+					w.__clear();
+				else
+					w.__set_last(__lower_bound(hi));
+				return w;
+			}
+			template <typename V, class F>
+			static F	__walk(__inorder_walker<node_pointer> w, F f)
+			{
+				for (node_pointer nd_ptr ; (nd_ptr = w.__next()) != ft::NIL ; )
+					f(static_cast<V&>(nd_ptr->__value));
+				return f;
+			}
+
+			/* 가운데 원소를 root 로 양쪽 크기가 1 이하로 차이나게 나누므로 leaf(null) 의 깊이는 bottom 또는 bottom + 1 이다.
+			bottom 깊이의 노드만 red 로 칠하면 모든 경로의 black 노드 수가 bottom 으로 같고 red 끼리 붙지 않는다.
+			중간에 할당이 실패하면 지금까지 만든 노드를 풀고 다시 던진다. */
+			template <typename InputIterator>
+			node_pointer	__build_sorted(InputIterator& first, size_type n, int depth, int bottom)
+			{
+				if (n == 0)
+					return ft::NIL;
+				size_type n_left = (n - 1) / 2;
+				node_pointer left = __build_sorted(first, n_left, depth + 1, bottom);
+				node_pointer nd_ptr = ft::NIL;
+				try
+				{
+					nd_ptr = make_node(*first);
+					++first;
+					__set_children(nd_ptr, left, __build_sorted(first, n - 1 - n_left, depth + 1, bottom));
+				}
+				catch (...)
+				{
+					del_node_all(left);
+					if (nd_ptr != ft::NIL)
+						del_node(nd_ptr);
+					throw;
+				}
+				nd_ptr->__is_black = depth != bottom;
+				__update_count(nd_ptr);
+				return nd_ptr;
+			}
+
+			/* in-order 로 돌며 nd_ptr sub-tree 를 st 에 더하고 black-height 를 돌려준다.
+			깊이가 max_depth 를 넘으면 (깨진 tree 의 순환 등) 더 내려가지 않는다. */
+			std::size_t	__stats_walk(node_pointer nd_ptr, std::size_t depth, tree_stats& st, node_pointer& prev,
+				std::size_t& adjacent, std::size_t& path_sum) const
+			{
+				if (nd_ptr == ft::NIL)
+					return 0;
+				if (depth >= static_cast<std::size_t>(tree_stats::max_depth))
+				{
+					st.valid = false;
+					return 0;
+				}
+				++st.size;
+				++st.depth_histogram[depth];
+				path_sum += depth + 1;
+				if (depth + 1 > st.height)
+					st.height = depth + 1;
+				node_pointer left = nd_ptr->__left;
+				node_pointer right = nd_ptr->__right;
+				if ((left != ft::NIL && left->__parent != nd_ptr) || (right != ft::NIL && right->__parent != nd_ptr))
+					st.valid = false;
+				if (!nd_ptr->__is_black && (__is_red_color(left) || __is_red_color(right)))
+					st.valid = false;
+				if (!__count_consistent(nd_ptr))
+					st.valid = false;
+
+				std::size_t left_bh = __stats_walk(left, depth + 1, st, prev, adjacent, path_sum);
+				if (prev != ft::NIL)
+				{
+					if (!__less(prev->__value, nd_ptr->__value))
+						st.valid = false;
+					const char* a = reinterpret_cast<const char*>(prev);
+					const char* b = reinterpret_cast<const char*>(nd_ptr);
+					if ((a < b ? b - a : a - b) <= static_cast<std::ptrdiff_t>(2 * sizeof(node_type)))
+						++adjacent;
+				}
+				prev = nd_ptr;
+				std::size_t right_bh = __stats_walk(right, depth + 1, st, prev, adjacent, path_sum);
+				if (left_bh != right_bh)
+					st.valid = false;
+				return std::max(left_bh, right_bh) + nd_ptr->__is_black;
+			}
+
+			/* join / split
+			tree 에서 떼어낸 sub-tree 를 (root, black-height) 로 다룬다. root 는 항상 black, parent 는 NIL.
+			black-height 는 root 부터 leaf 까지의 black 노드 수 (빈 tree 는 0) */
+			struct __join_tree
+			{
+				node_pointer	root;
+				size_type		bh;
+
+				__join_tree() : root(ft::NIL), bh(0) {}
+				__join_tree(node_pointer r, size_type h) : root(r), bh(h) {}
+			};
+
+			/* root 가 red 면 black 으로 바꾸고 black-height 를 하나 올린다. */
+			static __join_tree	__make_join_tree(node_pointer root, size_type bh)
+			{
+				if (root == ft::NIL)
+					return __join_tree();
+				root->__parent = ft::NIL;
+				if (!root->__is_black)
+				{
+					root->__is_black = true;
+					++bh;
+				}
+				return __join_tree(root, bh);
+			}
+			/* tree 전체를 떼어내고 빈 tree 로 만든다. __size 는 호출한 쪽이 정리 */
+			__join_tree	__detach_tree()
+			{
+				node_pointer root = getRoot();
+				size_type bh = 0;
+				for (node_pointer nd_ptr = root ; nd_ptr != ft::NIL ; nd_ptr = nd_ptr->__left)
+					bh += nd_ptr->__is_black;
+				__end->__left = ft::NIL;
+				__begin = __end;
+				return __make_join_tree(root, bh);
+			}
+			void	__attach_tree(__join_tree t)
+			{
+				if (t.root == ft::NIL)
+					return;
+				setRoot(t.root);
+				__begin = __min_node(t.root);
+			}
+			static void	__set_children(node_pointer nd_ptr, node_pointer left, node_pointer right)
+			{
+				nd_ptr->__left = left;
+				nd_ptr->__right = right;
+				if (left != ft::NIL)
+					left->__parent = nd_ptr;
+				if (right != ft::NIL)
+					right->__parent = nd_ptr;
+			}
+			/* root 를 떼어내 (left, root, right) 로 나눈다. */
+			static void	__expose(__join_tree t, __join_tree& l, node_pointer& k, __join_tree& r)
+			{
+				k = t.root;
+				l = __make_join_tree(k->__left, t.bh - 1);
+				r = __make_join_tree(k->__right, t.bh - 1);
+				k->__left = ft::NIL;
+				k->__right = ft::NIL;
+				k->__parent = ft::NIL;
+			}
+			/* join(l, k, r) : l < k < r 인 두 tree 와 노드 k 를 하나의 red-black tree 로 합친다.
+			black-height 가 같으면 k 를 black root 로 삼고,
+			다르면 높은 쪽의 척추를 따라 내려가 낮은 쪽과 black-height 가 같은 black 노드 c 를 찾은 뒤
+			red 인 k 로 c 와 낮은 쪽 tree 를 묶어 c 자리에 단다. 남는 red-red 는 insert 와 같은 방법으로 고친다.
+			O(|bh(l) - bh(r)| + 1) */
+			__join_tree	__join(__join_tree l, node_pointer k, __join_tree r)
+			{
+				if (l.bh == r.bh)
+				{
+					k->__is_black = true;
+					k->__parent = ft::NIL;
+					__set_children(k, l.root, r.root);
+					__update_count(k);
+					return __join_tree(k, l.bh + 1);
+				}
+				/* 회전과 fix 가 __end 를 root 의 부모로 가정하므로 높은 쪽 tree 를 잠시 __end 에 매단다. */
+				__join_tree& high = l.bh > r.bh ? l : r;
+				setRoot(high.root);
+				node_pointer parent = __end;
+				node_pointer c = high.root;
+				size_type bh = high.bh;
+				size_type target = l.bh > r.bh ? r.bh : l.bh;
+				while (__is_red_color(c) || bh != target)
+				{
+					if (__is_black_color(c))
+						--bh;
+					parent = c;
+					c = l.bh > r.bh ? c->__right : c->__left;
+				}
+				k->__is_black = false;
+				k->__parent = parent;
+				if (l.bh > r.bh)
+				{
+					__set_children(k, c, r.root);
+					parent->__right = k;
+				}
+				else
+				{
+					__set_children(k, l.root, c);
+					parent->__left = k;
+				}
+				__update_count_path(k);
+				__insert_rebalance(k);
+
+				node_pointer root = getRoot();
+				size_type root_bh = high.bh;
+				if (!root->__is_black)
+				{
+					root->__is_black = true;
+					++root_bh;
+				}
+				__end->__left = ft::NIL;
+				root->__parent = ft::NIL;
+				return __join_tree(root, root_bh);
+			}
+			/* join2(l, r) : 가운데 노드 없이 합친다. l 의 최대 노드를 떼어내 pivot 으로 쓴다. */
+			__join_tree	__join2(__join_tree l, __join_tree r)
+			{
+				if (l.root == ft::NIL)
+					return r;
+				node_pointer k;
+				l = __split_last(l, k);
+				return __join(l, k, r);
+			}
+			__join_tree	__split_last(__join_tree t, node_pointer& last)
+			{
+				__join_tree l, r;
+				node_pointer k;
+				__expose(t, l, k, r);
+				if (r.root == ft::NIL)
+				{
+					last = k;
+					return l;
+				}
+				r = __split_last(r, last);
+				return __join(l, k, r);
+			}
+			/* split(t, val) : t 를 val 보다 작은 tree l, 같은 노드 mid(없으면 NIL), 큰 tree r 로 나눈다.
+			올라오면서 하는 join 들의 black-height 차이 합이 O(log n) 이므로 전체 O(log n) */
+			void	__split(__join_tree t, const value_type& val, __join_tree& l, node_pointer& mid, __join_tree& r)
+			{
+				if (t.root == ft::NIL)
+				{
+					l = __join_tree();
+					r = __join_tree();
+					mid = ft::NIL;
+					return;
+				}
+				__join_tree tl, tr, sub;
+				node_pointer k;
+				__expose(t, tl, k, tr);
+				int cmp = __compare_value(val, k->__value, is_three_way());
+				if (cmp < 0)
+				{
+					__split(tl, val, l, mid, sub);
+					r = __join(sub, k, tr);
+				}
+				else if (cmp > 0)
+				{
+					__split(tr, val, sub, mid, r);
+					l = __join(tl, k, sub);
+				}
+				else
+				{
+					l = tl;
+					mid = k;
+					r = tr;
+				}
+			}
+			int	__compare_value(const value_type& x, const value_type& y, ft::true_type) const
+			{ return __compare3(x, y); }
+
+			int	__compare_value(const value_type& x, const value_type& y, ft::false_type) const
+			{
+				if (__less(x, y))
+					return -1;
+				return __less(y, x) ? 1 : 0;
+			}
+			/* t1 은 *this, t2 는 other 에서 온 tree. t2 의 root 로 t1 을 split 해서 양쪽을 재귀로 처리한 뒤 join 한다. */
+			__join_tree	__union(__join_tree t1, __join_tree t2)
+			{
+				if (t1.root == ft::NIL)
+					return t2;
+				if (t2.root == ft::NIL)
+					return t1;
+				__join_tree l1, r1, l2, r2;
+				node_pointer k2, mid;
+				__expose(t2, l2, k2, r2);
+				__split(t1, k2->__value, l1, mid, r1);
+				if (mid != ft::NIL)
+				{
+					del_node(k2);
+					k2 = mid;
+				}
+				__join_tree l = __union(l1, l2);
+				__join_tree r = __union(r1, r2);
+				return __join(l, k2, r);
+			}
+			__join_tree	__intersection(__join_tree t1, __join_tree t2)
+			{
+				if (t1.root == ft::NIL || t2.root == ft::NIL)
+				{
+					del_node_all(t1.root);
+					del_node_all(t2.root);
+					return __join_tree();
+				}
+				__join_tree l1, r1, l2, r2;
+				node_pointer k2, mid;
+				__expose(t2, l2, k2, r2);
+				__split(t1, k2->__value, l1, mid, r1);
+				del_node(k2);
+				__join_tree l = __intersection(l1, l2);
+				__join_tree r = __intersection(r1, r2);
+				if (mid != ft::NIL)
+					return __join(l, mid, r);
+				return __join2(l, r);
+			}
+			__join_tree	__difference(__join_tree t1, __join_tree t2)
+			{
+				if (t1.root == ft::NIL)
+				{
+					del_node_all(t2.root);
+					return t1;
+				}
+				if (t2.root == ft::NIL)
+					return t1;
+				__join_tree l1, r1, l2, r2;
+				node_pointer k2, mid;
+				__expose(t2, l2, k2, r2);
+				__split(t1, k2->__value, l1, mid, r1);
+				del_node(k2);
+				if (mid != ft::NIL)
+					del_node(mid);
+				__join_tree l = __difference(l1, l2);
+				__join_tree r = __difference(r1, r2);
+				return __join2(l, r);
+			}
 	};
 }
 #endif
@@ -0,0 +1,387 @@
+#ifndef SNAPSHOT_HPP
+# define SNAPSHOT_HPP
+
+# include <cerrno>
+# include <cstddef>
+# include <cstring>
+# include <stdexcept>
+# include <string>
+# include <stdint.h>
+# include <fcntl.h>
+# include <unistd.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <sys/uio.h>
+# include "type.hpp"
+# include "pair.hpp"
+
+/* snapshot
+ *
+ * 원소가 trivially copyable 인 vector / set / map 을 바이트 그대로 저장하고 되살리는 binary 형식.
+ * 하나씩 insert 하는 대신 vector 는 memcpy 한 번, set / map 은 정렬된 배열에서 O(n) 으로 tree 를 만든다.
+ *
+ * [header 64 bytes][payload : count * elem_size][checksum 8 bytes]
+ * header   : magic, version, kind(vector / set / map), byte order 표시, 원소 크기와 정렬, 원소 수
+ * payload  : vector 는 원소 배열 그대로, set / map 은 key 순서로 정렬된 value_type 배열 (map 은 ft::pair<const Key, T>)
+ * checksum : header 와 payload 전체를 8 byte 씩 섞은 64 bit 값
+ *
+ * 같은 기계(같은 byte order, 같은 type 배치)에서 쓰고 읽는 것을 전제로 하고, 맞지 않으면 snapshot_error 를 던진다.
+ * 쓸 때는 작은 원소는 버퍼에 모으고 큰 배열은 복사 없이 writev 로 한 번에 내보낸다.
+ * 읽을 때는 버퍼 하나(보통 snapshot_file 로 mmap 한 파일)를 받는다. 버퍼 시작은 원소 정렬에 맞아야 한다.
+ */
+
+namespace ft {
+
+	class snapshot_error : public std::runtime_error
+	{
+		public:
+			explicit snapshot_error(const std::string& what) : std::runtime_error(what) {}
+	};
+
+	/* 바이트 복사로 옮겨도 되는 type. ft::pair 는 operator= 를 직접 정의해서 builtin 이 false 라 따로 본다. */
+	template <typename T>
+	struct __snapshot_safe : public integral_constant<bool, __is_trivially_copyable(T)> { };
+
+	template <typename A, typename B>
+	struct __snapshot_safe<ft::pair<A, B> >
+	: public integral_constant<bool, __snapshot_safe<A>::value && __snapshot_safe<B>::value> { };
+
+	/* snapshot / restore 를 부른 곳에서만 검사한다. (trivially copyable 이 아니면 __ok 가 없어 컴파일 에러) */
+	template <bool Safe>
+	struct __snapshot_check { };
+
+	template <>
+	struct __snapshot_check<true>
+	{ static void	__ok() {} };
+
+	enum __snapshot_kind
+	{
+		__snapshot_vector = 1,
+		__snapshot_set = 2,
+		__snapshot_map = 3
+	};
+
+	struct __snapshot_header
+	{
+		char		magic[8];
+		uint32_t	version;
+		uint32_t	kind;
+		uint32_t	byte_order;
+		uint32_t	elem_size;
+		uint32_t	elem_align;
+		uint32_t	reserved0;
+		uint64_t	count;
+		char		reserved[24];
+	};
+
+	const char		__snapshot_magic[8] = { 'F', 'T', 'S', 'N', 'A', 'P', '\0', '\0' };
+	const uint32_t	__snapshot_version = 1;
+	const uint32_t	__snapshot_byte_order = 0x01020304;
+
+	/* 8 byte 단위로 섞는 64 bit checksum. 조각으로 나눠 넣어도 이어 붙여 넣은 것과 같은 값이 나온다. */
+	class __snapshot_checksum
+	{
+		public:
+			__snapshot_checksum() : __h(__k(0x9e3779b9, 0x7f4a7c15)), __len(0), __pending(0) {}
+
+			void	__update(const void* data, std::size_t n)
+			{
+				const unsigned char* p = static_cast<const unsigned char*>(data);
+				__len += n;
+				if (__pending)
+				{
+					for ( ; n > 0 && __pending < 8 ; --n)
+						__tail[__pending++] = *p++;
+					if (__pending < 8)
+						return;
+					__h = __round(__h, __tail);
+					__pending = 0;
+				}
+				for ( ; n >= 8 ; p += 8, n -= 8)
+					__h = __round(__h, p);
+				if (n > 0)
+					std::memcpy(__tail, p, n);
+				__pending = n;
+			}
+
+			uint64_t	__digest() const
+			{
+				uint64_t h = __h;
+				if (__pending)
+				{
+					unsigned char last[8] = { 0 };
+					std::memcpy(last, __tail, __pending);
+					h = __round(h, last);
+				}
+				h ^= __len;
+				h ^= h >> 33;
+				h *= __k(0xff51afd7, 0xed558ccd);
+				h ^= h >> 33;
+				h *= __k(0xc4ceb9fe, 0x1a85ec53);
+				h ^= h >> 33;
+				return h;
+			}
+
+		private:
+			uint64_t		__h;
+			uint64_t		__len;
+			unsigned char	__tail[8];
+			std::size_t		__pending;
+
+			/* C++98 에는 long long 이 없어 64 bit 상수를 literal 로 못 쓰므로 32 bit 두 개로 만든다. */
+			static uint64_t	__k(uint32_t hi, uint32_t lo)
+			{ return (static_cast<uint64_t>(hi) << 32) | lo; }
+
+			static uint64_t	__round(uint64_t h, const unsigned char* p)
+			{
+				uint64_t w;
+				std::memcpy(&w, p, 8);
+				h ^= w * __k(0x87c37b91, 0x114253d5);
+				h = (h << 31) | (h >> 33);
+				return h * __k(0x4cf5ad43, 0x2745937f);
+			}
+	};
+
+	inline std::string	__snapshot_errno(const char* what)
+	{ return std::string("ft::snapshot: ") + what + ": " + std::strerror(errno); }
+
+	/* header -> payload -> checksum 순서로 fd 에 쓴다.
+	작은 조각은 __stage 에 복사해 모으고, __direct_min 이상인 조각은 복사 없이 iovec 으로 건다.
+	iovec 이 다 차거나 __stage 가 넘치면 writev 로 내보낸다. */
+	class __snapshot_writer
+	{
+		public:
+			__snapshot_writer(int fd, __snapshot_kind kind, std::size_t elem_size, std::size_t elem_align, std::size_t count)
+			: __fd(fd), __cnt(0), __stage(new char[__stage_size]), __staged(0)
+			{
+				__snapshot_header h;
+				std::memset(&h, 0, sizeof(h));
+				std::memcpy(h.magic, __snapshot_magic, sizeof(h.magic));
+				h.version = __snapshot_version;
+				h.kind = kind;
+				h.byte_order = __snapshot_byte_order;
+				h.elem_size = static_cast<uint32_t>(elem_size);
+				h.elem_align = static_cast<uint32_t>(elem_align);
+				h.count = count;
+				__put(&h, sizeof(h));
+			}
+			~__snapshot_writer()	{ delete[] __stage; }
+
+			void	__put(const void* data, std::size_t n)
+			{
+				__sum.__update(data, n);
+				__append(data, n);
+			}
+
+			/* checksum 을 붙이고 남은 것을 모두 내보낸다. */
+			void	__finish()
+			{
+				uint64_t digest = __sum.__digest();
+				__append(&digest, sizeof(digest));
+				__flush();
+			}
+
+		private:
+			enum
+			{
+				__stage_size = 64 * 1024,
+				__direct_min = 4 * 1024,
+				__iov_max = 16,
+				/* writev 한 번의 합이 ssize_t 를 넘지 않도록 큰 배열은 나눠서 건다. */
+				__direct_max = 1 << 30
+			};
+
+			int						__fd;
+			struct iovec			__iov[__iov_max];
+			int						__cnt;
+			char*					__stage;
+			std::size_t				__staged;
+			__snapshot_checksum		__sum;
+
+			__snapshot_writer(const __snapshot_writer&);
+			__snapshot_writer& operator=(const __snapshot_writer&);
+
+			void	__append(const void* data, std::size_t n)
+			{
+				const char* p = static_cast<const char*>(data);
+				if (n >= std::size_t(__direct_min))
+				{
+					for ( ; n > 0 ; )
+					{
+						std::size_t len = n < std::size_t(__direct_max) ? n : std::size_t(__direct_max);
+						__add_iov(const_cast<char*>(p), len);
+						p += len;
+						n -= len;
+					}
+					return;
+				}
+				if (n == 0)
+					return;
+				if (__cnt == __iov_max || __staged + n > std::size_t(__stage_size))
+					__flush();
+				char* dst = __stage + __staged;
+				std::memcpy(dst, p, n);
+				__staged += n;
+				if (__cnt > 0 && static_cast<char*>(__iov[__cnt - 1].iov_base) + __iov[__cnt - 1].iov_len == dst)
+					__iov[__cnt - 1].iov_len += n;
+				else
+					__add_iov(dst, n);
+			}
+
+			void	__add_iov(char* p, std::size_t n)
+			{
+				if (__cnt == __iov_max)
+					__flush();
+				__iov[__cnt].iov_base = p;
+				__iov[__cnt].iov_len = n;
+				++__cnt;
+			}
+
+			/* writev 는 일부만 쓰고 돌아올 수 있으므로 쓴 만큼 iovec 을 넘기며 다시 부른다. */
+			void	__flush()
+			{
+				struct iovec* iov = __iov;
+				int cnt = __cnt;
+				while (cnt > 0)
+				{
+					ssize_t ret = ::writev(__fd, iov, cnt);
+					if (ret < 0)
+					{
+						if (errno == EINTR)
+							continue;
+						throw snapshot_error(__snapshot_errno("writev"));
+					}
+					std::size_t done = static_cast<std::size_t>(ret);
+					for ( ; cnt > 0 && done >= iov->iov_len ; ++iov, --cnt)
+						done -= iov->iov_len;
+					if (cnt > 0)
+					{
+						iov->iov_base = static_cast<char*>(iov->iov_base) + done;
+						iov->iov_len -= done;
+					}
+				}
+				__cnt = 0;
+				__staged = 0;
+			}
+	};
+
+	/* 버퍼를 검사하고 payload 위치와 원소 수를 알려준다. 복사하지 않으므로 버퍼는 restore 가 끝날 때까지 살아있어야 한다. */
+	class __snapshot_reader
+	{
+		public:
+			__snapshot_reader(const void* data, std::size_t len, __snapshot_kind kind, std::size_t elem_size, std::size_t elem_align)
+			{
+				const std::size_t overhead = sizeof(__snapshot_header) + sizeof(uint64_t);
+				const char* p = static_cast<const char*>(data);
+				__snapshot_header h;
+				if (p == ft::NIL || len < overhead)
+					throw snapshot_error("ft::snapshot: truncated");
+				std::memcpy(&h, p, sizeof(h));
+				if (std::memcmp(h.magic, __snapshot_magic, sizeof(h.magic)) != 0)
+					throw snapshot_error("ft::snapshot: bad magic");
+				if (h.version != __snapshot_version)
+					throw snapshot_error("ft::snapshot: unsupported version");
+				if (h.byte_order != __snapshot_byte_order)
+					throw snapshot_error("ft::snapshot: byte order mismatch");
+				if (h.kind != static_cast<uint32_t>(kind))
+					throw snapshot_error("ft::snapshot: container kind mismatch");
+				if (h.elem_size != elem_size || h.elem_align != elem_align)
+					throw snapshot_error("ft::snapshot: element layout mismatch");
+				if (h.count > (len - overhead) / elem_size || h.count * elem_size != len - overhead)
+					throw snapshot_error("ft::snapshot: size mismatch");
+				__payload = p + sizeof(h);
+				__count = static_cast<std::size_t>(h.count);
+				if (__count > 0 && reinterpret_cast<uintptr_t>(__payload) % elem_align != 0)
+					throw snapshot_error("ft::snapshot: misaligned buffer");
+
+				__snapshot_checksum sum;
+				uint64_t digest;
+				sum.__update(p, sizeof(h) + __count * elem_size);
+				std::memcpy(&digest, p + len - sizeof(digest), sizeof(digest));
+				if (digest != sum.__digest())
+					throw snapshot_error("ft::snapshot: checksum mismatch");
+			}
+
+			const void*	__data() const	{ return __payload; }
+			std::size_t	__size() const	{ return __count; }
+
+		private:
+			const char*	__payload;
+			std::size_t	__count;
+	};
+
+	/* tree 의 for_each 로 원소를 하나씩 writer 에 넘긴다. */
+	template <typename T>
+	struct __snapshot_put
+	{
+		__snapshot_writer*	__w;
+
+		explicit __snapshot_put(__snapshot_writer* w) : __w(w) {}
+		void	operator()(const T& val) const	{ __w->__put(&val, sizeof(T)); }
+	};
+
+	/* [first, first + n) 이 comp 로 strict 하게 오름차순인지
+	 * (set / map 의 restore 와 frozen_set / frozen_map 의 범위 생성자는 정렬되고 중복 없는 입력만 받는다) */
+	template <class ForwardIterator, class Compare>
+	bool	__snapshot_sorted(ForwardIterator first, std::size_t n, const Compare& comp)
+	{
+		if (n == 0)
+			return true;
+		for (ForwardIterator prev = first ; --n > 0 ; prev = first)
+			if (!comp(*prev, *++first))
+				return false;
+		return true;
+	}
+
+	/* 읽기 전용으로 mmap 한 snapshot 파일. 페이지는 처음 읽을 때 올라온다.
+	 * ft::map<int, int> m;
+	 * ft::snapshot_file f("m.snap");
+	 * m.restore(f.data(), f.size()); */
+	class snapshot_file
+	{
+		public:
+			explicit snapshot_file(const char* path) : __addr(ft::NIL), __len(0)
+			{
+				int fd = ::open(path, O_RDONLY);
+				if (fd < 0)
+					throw snapshot_error(__snapshot_errno("open"));
+				struct stat st;
+				if (::fstat(fd, &st) < 0)
+				{
+					::close(fd);
+					throw snapshot_error(__snapshot_errno("fstat"));
+				}
+				__len = static_cast<std::size_t>(st.st_size);
+				if (__len > 0)
+				{
+					void* addr = ::mmap(ft::NIL, __len, PROT_READ, MAP_PRIVATE, fd, 0);
+					if (addr == MAP_FAILED)
+					{
+						::close(fd);
+						throw snapshot_error(__snapshot_errno("mmap"));
+					}
+					__addr = addr;
+					::madvise(__addr, __len, MADV_SEQUENTIAL);
+				}
+				::close(fd);
+			}
+			~snapshot_file()
+			{
+				if (__addr != ft::NIL)
+					::munmap(__addr, __len);
+			}
+
+			const void*	data() const	{ return __addr; }
+			std::size_t	size() const	{ return __len; }
+
+		private:
+			void*		__addr;
+			std::size_t	__len;
+
+			snapshot_file(const snapshot_file&);
+			snapshot_file& operator=(const snapshot_file&);
+	};
+
+}
+
+#endif
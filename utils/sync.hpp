@@ -0,0 +1,102 @@
+#ifndef SYNC_HPP
+# define SYNC_HPP
+
+# include <cstddef>
+# include <pthread.h>
+# include "type.hpp"
+
+/* 동기화 도구
+ *
+ * C++98 에는 thread 라이브러리가 없으므로 pthread 를 얇게 감싼다.
+ * 복사할 수 없고, guard 는 생성자에서 잠그고 소멸자에서 푼다. (예외가 나가도 풀린다)
+ */
+
+namespace ft {
+
+	/* 서로 다른 thread 가 쓰는 값이 같은 cache line 에 있으면 (false sharing) 쓸 때마다 line 을 뺏고 뺏긴다. */
+	const std::size_t	__cache_line_size = 64;
+
+	/* 한 쪽이 값을 써두고 index 를 store_release 하면, 그 index 를 load_acquire 로 본 쪽은 앞서 쓴 값도 보인다.
+	 * (gcc / clang 내장 함수. lock 이나 read-modify-write 없이 순서만 보장한다) */
+	template <class T>
+	inline T	__load_acquire(const volatile T* p)	{ return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+	template <class T>
+	inline T	__load_relaxed(const volatile T* p)	{ return __atomic_load_n(p, __ATOMIC_RELAXED); }
+	template <class T>
+	inline void	__store_release(volatile T* p, T val)	{ __atomic_store_n(p, val, __ATOMIC_RELEASE); }
+
+	class __mutex
+	{
+		private:
+			pthread_mutex_t	__lock;
+
+			__mutex(const __mutex&);
+			__mutex& operator=(const __mutex&);
+
+		public:
+			__mutex()	{ pthread_mutex_init(&__lock, ft::NIL); }
+			~__mutex()	{ pthread_mutex_destroy(&__lock); }
+
+			void	lock()		{ pthread_mutex_lock(&__lock); }
+			void	unlock()	{ pthread_mutex_unlock(&__lock); }
+	};
+
+	class __rwlock
+	{
+		private:
+			pthread_rwlock_t	__lock;
+
+			__rwlock(const __rwlock&);
+			__rwlock& operator=(const __rwlock&);
+
+		public:
+			__rwlock()	{ pthread_rwlock_init(&__lock, ft::NIL); }
+			~__rwlock()	{ pthread_rwlock_destroy(&__lock); }
+
+			void	read_lock()		{ pthread_rwlock_rdlock(&__lock); }
+			void	write_lock()	{ pthread_rwlock_wrlock(&__lock); }
+			void	unlock()		{ pthread_rwlock_unlock(&__lock); }
+	};
+
+	class __lock_guard
+	{
+		private:
+			__mutex&	__m;
+
+			__lock_guard(const __lock_guard&);
+			__lock_guard& operator=(const __lock_guard&);
+
+		public:
+			explicit __lock_guard(__mutex& m) : __m(m)	{ __m.lock(); }
+			~__lock_guard()								{ __m.unlock(); }
+	};
+
+	class __read_guard
+	{
+		private:
+			__rwlock&	__l;
+
+			__read_guard(const __read_guard&);
+			__read_guard& operator=(const __read_guard&);
+
+		public:
+			explicit __read_guard(__rwlock& l) : __l(l)	{ __l.read_lock(); }
+			~__read_guard()								{ __l.unlock(); }
+	};
+
+	class __write_guard
+	{
+		private:
+			__rwlock&	__l;
+
+			__write_guard(const __write_guard&);
+			__write_guard& operator=(const __write_guard&);
+
+		public:
+			explicit __write_guard(__rwlock& l) : __l(l)	{ __l.write_lock(); }
+			~__write_guard()								{ __l.unlock(); }
+	};
+
+}
+
+#endif
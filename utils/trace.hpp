@@ -0,0 +1,433 @@
+#ifndef TRACE_HPP
+# define TRACE_HPP
+
+# include <cerrno>
+# include <cstddef>
+# include <cstdlib>
+# include <cstring>
+# include <stdexcept>
+# include <string>
+# include <typeinfo>
+# include <stdint.h>
+# include <fcntl.h>
+# include <unistd.h>
+# include <cxxabi.h>
+# include "type.hpp"
+# include "pair.hpp"
+# include "hash.hpp"
+
+/* 연산 trace
+ *
+ * container 에 들어온 연산을 (opcode, key, value) 의 고정 길이 binary record 로 남기고, 나중에 그대로 다시 돌린다.
+ *
+ * [header 64 bytes][record 16 bytes * count][stream 이름 표]
+ * record     : key(int64) value(int32) op(uint16) stream(uint16)
+ * stream     : 기록한 container type 마다 번호 하나. 이름 표는 파일 끝에 NUL 로 끝나는 문자열이 번호 순서대로 있다.
+ *
+ * key 는 정수(ft::is_integral)면 그대로, std::string 이면 ft::hash 값, 그 외의 type 은 0 이다. (hash 는 같은 key 끼리만 같고 순서는 잃는다)
+ * map 의 value 는 정수일 때만 남기고 그 외에는 0 이다.
+ *
+ * 기록 shim : FT_TRACE 를 정의하고 빌드하면 map / set 의 insert (operator[], try_emplace, upsert 포함), erase, find, lower_bound, clear 와
+ *             vector (stack) 의 push_back, pop_back, clear 에 hook 이 들어간다. 정의하지 않으면 hook 은 ((void)0) 이다.
+ *             범위 insert / erase 와 복사는 남기지 않는다. hook macro 는 trace_hook.hpp 에 있고, container 는 그것만 include 하므로
+ *             FT_TRACE 가 없으면 이 header 는 따라 들어가지 않는다.
+ *             hook 은 ft::trace_recorder::start(path) 를 부른 동안만 기록하고, 그 밖에는 포인터 하나를 읽고 끝난다.
+ *             기록은 spinlock 하나로 여러 thread 의 record 를 한 파일에 차례로 쌓는다.
+ *
+ * ft::trace_recorder::start("/var/tmp/ft.trace");
+ * ...
+ * ft::trace_recorder::stop();    // 남은 버퍼와 이름 표를 쓰고 header 의 record 수를 채운다.
+ */
+
+namespace ft {
+
+	enum trace_op
+	{
+		trace_insert = 1,
+		trace_erase,
+		trace_find,
+		trace_lower_bound,
+		trace_push,			/* vector::push_back, stack::push */
+		trace_pop,			/* vector::pop_back, stack::pop */
+		trace_clear
+	};
+
+	struct trace_record
+	{
+		int64_t		key;
+		int32_t		value;
+		uint16_t	op;
+		uint16_t	stream;
+	};
+
+	struct __trace_header
+	{
+		char		magic[8];
+		uint32_t	version;
+		uint32_t	record_size;
+		uint32_t	byte_order;
+		uint32_t	stream_count;
+		uint64_t	count;
+		uint64_t	names_offset;
+		char		reserved[24];
+	};
+
+	const char		__trace_magic[8] = { 'F', 'T', 'T', 'R', 'A', 'C', 'E', '\0' };
+	const uint32_t	__trace_version = 1;
+	const uint32_t	__trace_byte_order = 0x01020304;
+
+	class trace_error : public std::runtime_error
+	{
+		public:
+			explicit trace_error(const std::string& what) : std::runtime_error(what) {}
+	};
+
+	/* key 와 value 를 record 에 들어갈 정수로 바꾼다. */
+	template <typename T, typename = void>
+	struct __trace_int
+	{ static int64_t	__of(const T&) { return 0; } };
+
+	template <typename T>
+	struct __trace_int<T, typename enable_if<is_integral<T>::value>::type>
+	{ static int64_t	__of(const T& val) { return static_cast<int64_t>(val); } };
+
+	template <class CharT, class Traits, class Alloc>
+	struct __trace_int<std::basic_string<CharT, Traits, Alloc>, void>
+	{
+		static int64_t	__of(const std::basic_string<CharT, Traits, Alloc>& str)
+		{ return static_cast<int64_t>(ft::hash<std::basic_string<CharT, Traits, Alloc> >()(str)); }
+	};
+
+	/* map 의 value_type 은 (first, second), 나머지는 (원소, 0) */
+	template <typename T>
+	void	__trace_split(const T& item, int64_t& key, int32_t& value)
+	{
+		key = __trace_int<T>::__of(item);
+		value = 0;
+	}
+
+	template <typename A, typename B>
+	void	__trace_split(const ft::pair<A, B>& item, int64_t& key, int32_t& value)
+	{
+		key = __trace_int<typename remove_cv<A>::type>::__of(item.first);
+		value = static_cast<int32_t>(__trace_int<B>::__of(item.second));
+	}
+
+	/* 파일 하나에 record 를 쌓는다. 직접 만들어 써도 되고 (합성 trace) trace_recorder 가 안에서 쓴다. */
+	class trace_writer
+	{
+		public:
+			enum
+			{
+				__buffer_records = 4096,
+				__max_streams = 256
+			};
+
+			explicit trace_writer(const char* path) : __fd(-1), __pending(0), __count(0), __stream_count(0)
+			{
+				__fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+				if (__fd < 0)
+					throw trace_error(__error("open"));
+				__trace_header header;
+				std::memset(&header, 0, sizeof(header));
+				if (!__write_all(&header, sizeof(header)))
+				{
+					::close(__fd);
+					throw trace_error(__error("write"));
+				}
+			}
+			~trace_writer()
+			{
+				try
+				{
+					close();
+				}
+				catch (...)
+				{
+				}
+			}
+
+			/* 이름을 붙인 stream 번호를 새로 받는다. 다 쓰면 마지막 번호를 같이 쓴다. */
+			uint16_t	add_stream(const char* name)
+			{
+				if (__stream_count == __max_streams)
+					return __max_streams - 1;
+				__names[__stream_count] = name;
+				return static_cast<uint16_t>(__stream_count++);
+			}
+
+			void	append(trace_op op, uint16_t stream, int64_t key, int32_t value)
+			{
+				trace_record& rec = __buffer[__pending++];
+				rec.key = key;
+				rec.value = value;
+				rec.op = static_cast<uint16_t>(op);
+				rec.stream = stream;
+				++__count;
+				if (__pending == __buffer_records)
+					flush();
+			}
+
+			void	flush()
+			{
+				if (__pending == 0 || __fd < 0)
+					return;
+				std::size_t n = __pending;
+				__pending = 0;
+				if (!__write_all(__buffer, n * sizeof(trace_record)))
+					throw trace_error(__error("write"));
+			}
+
+			/* 이름 표를 붙이고 header 를 채운다. 두 번 불러도 된다. */
+			void	close()
+			{
+				if (__fd < 0)
+					return;
+				int fd = __fd;
+				try
+				{
+					flush();
+					for (std::size_t i = 0 ; i < __stream_count ; ++i)
+						if (!__write_all(__names[i].c_str(), __names[i].size() + 1))
+							throw trace_error(__error("write"));
+					__trace_header header;
+					std::memset(&header, 0, sizeof(header));
+					std::memcpy(header.magic, __trace_magic, sizeof(header.magic));
+					header.version = __trace_version;
+					header.record_size = sizeof(trace_record);
+					header.byte_order = __trace_byte_order;
+					header.stream_count = static_cast<uint32_t>(__stream_count);
+					header.count = __count;
+					header.names_offset = sizeof(__trace_header) + __count * sizeof(trace_record);
+					if (::pwrite(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)))
+						throw trace_error(__error("pwrite"));
+				}
+				catch (...)
+				{
+					__fd = -1;
+					::close(fd);
+					throw;
+				}
+				__fd = -1;
+				if (::close(fd) < 0)
+					throw trace_error(__error("close"));
+			}
+
+			uint64_t	count() const	{ return __count; }
+
+		private:
+			int				__fd;
+			std::size_t		__pending;
+			uint64_t		__count;
+			std::size_t		__stream_count;
+			std::string		__names[__max_streams];
+			trace_record	__buffer[__buffer_records];
+
+			trace_writer(const trace_writer&);
+			trace_writer& operator=(const trace_writer&);
+
+			static std::string	__error(const char* what)
+			{ return std::string("ft::trace_writer: ") + what + ": " + std::strerror(errno); }
+
+			bool	__write_all(const void* data, std::size_t n)
+			{
+				const char* p = static_cast<const char*>(data);
+				while (n > 0)
+				{
+					ssize_t w = ::write(__fd, p, n);
+					if (w < 0 && errno == EINTR)
+						continue;
+					if (w <= 0)
+						return false;
+					p += w;
+					n -= static_cast<std::size_t>(w);
+				}
+				return true;
+			}
+	};
+
+	/* 버퍼 하나(보통 snapshot_file 로 mmap 한 파일)에서 header 를 확인하고 record 와 stream 이름을 꺼낸다. */
+	class trace_reader
+	{
+		public:
+			trace_reader(const void* data, std::size_t len) : __records(ft::NIL), __count(0), __names(ft::NIL), __names_len(0), __stream_count(0)
+			{
+				const char* base = static_cast<const char*>(data);
+				if (len < sizeof(__trace_header))
+					throw trace_error("ft::trace_reader: truncated header");
+				__trace_header header;
+				std::memcpy(&header, base, sizeof(header));
+				if (std::memcmp(header.magic, __trace_magic, sizeof(header.magic)) != 0)
+					throw trace_error("ft::trace_reader: not a trace file (or recording was not stopped)");
+				if (header.version != __trace_version || header.record_size != sizeof(trace_record)
+					|| header.byte_order != __trace_byte_order)
+					throw trace_error("ft::trace_reader: incompatible trace format");
+				if (header.count > (len - sizeof(__trace_header)) / sizeof(trace_record)
+					|| header.names_offset != sizeof(__trace_header) + header.count * sizeof(trace_record))
+					throw trace_error("ft::trace_reader: truncated records");
+				if (reinterpret_cast<uintptr_t>(base) % sizeof(int64_t) != 0)
+					throw trace_error("ft::trace_reader: buffer is not aligned");
+				__records = reinterpret_cast<const trace_record*>(base + sizeof(__trace_header));
+				__count = static_cast<std::size_t>(header.count);
+				__names = base + header.names_offset;
+				__names_len = len - static_cast<std::size_t>(header.names_offset);
+				__stream_count = header.stream_count;
+			}
+
+			const trace_record*	records() const	{ return __records; }
+			std::size_t			size() const	{ return __count; }
+			std::size_t			stream_count() const	{ return __stream_count; }
+
+			/* n 번 stream 의 이름. 없으면 "" */
+			std::string	stream_name(std::size_t n) const
+			{
+				const char* p = __names;
+				const char* end = __names + __names_len;
+				for (std::size_t i = 0 ; p < end ; ++i)
+				{
+					const char* nul = static_cast<const char*>(std::memchr(p, '\0', end - p));
+					if (nul == ft::NIL)
+						break;
+					if (i == n)
+						return std::string(p, nul);
+					p = nul + 1;
+				}
+				return std::string();
+			}
+
+		private:
+			const trace_record*	__records;
+			std::size_t			__count;
+			const char*			__names;
+			std::size_t			__names_len;
+			std::size_t			__stream_count;
+	};
+
+	template <int Dummy = 0>
+	struct __trace_state
+	{
+		static trace_writer*	writer;
+		static int				lock;
+		static unsigned int		session;	/* start 마다 하나씩 올라 stream 번호를 새로 받게 한다. */
+	};
+
+	template <int Dummy>
+	trace_writer*	__trace_state<Dummy>::writer = 0;
+	template <int Dummy>
+	int				__trace_state<Dummy>::lock = 0;
+	template <int Dummy>
+	unsigned int	__trace_state<Dummy>::session = 0;
+
+	struct __trace_spin
+	{
+		__trace_spin()	{ while (__sync_lock_test_and_set(&__trace_state<>::lock, 1)) ; }
+		~__trace_spin()	{ __sync_lock_release(&__trace_state<>::lock); }
+	};
+
+	struct trace_recorder
+	{
+		/* path 에 새로 기록을 시작한다. 이미 기록 중이면 그것을 먼저 끝낸다. */
+		static void	start(const char* path)
+		{
+			trace_writer* w = new trace_writer(path);
+			trace_writer* old;
+			{
+				__trace_spin guard;
+				old = __trace_state<>::writer;
+				++__trace_state<>::session;
+				__atomic_store_n(&__trace_state<>::writer, w, __ATOMIC_RELEASE);
+			}
+			__close(old);
+		}
+
+		static void	stop()
+		{
+			trace_writer* old;
+			{
+				__trace_spin guard;
+				old = __trace_state<>::writer;
+				__atomic_store_n(&__trace_state<>::writer, static_cast<trace_writer*>(0), __ATOMIC_RELEASE);
+			}
+			__close(old);
+		}
+
+		static bool	recording()
+		{ return __atomic_load_n(&__trace_state<>::writer, __ATOMIC_RELAXED) != 0; }
+
+		private:
+			static void	__close(trace_writer* w)
+			{
+				if (w == 0)
+					return;
+				try
+				{
+					w->close();
+				}
+				catch (...)
+				{
+					delete w;
+					throw;
+				}
+				delete w;
+			}
+	};
+
+	/* Tag(container type) 하나에 stream 번호 하나. 기록 중이 아니면 포인터 하나만 읽는다. */
+	template <class Tag>
+	struct __trace_hook
+	{
+		static uint16_t		stream;
+		static unsigned int	session;
+
+		template <typename Item>
+		static void	record(trace_op op, const Item& item)
+		{
+			if (!trace_recorder::recording())
+				return;
+			int64_t key;
+			int32_t value;
+			__trace_split(item, key, value);
+			__append(op, key, value);
+		}
+
+		template <typename K, typename V>
+		static void	record(trace_op op, const K& key, const V& value)
+		{
+			if (!trace_recorder::recording())
+				return;
+			__append(op, __trace_int<K>::__of(key), static_cast<int32_t>(__trace_int<V>::__of(value)));
+		}
+
+		static void	__append(trace_op op, int64_t key, int32_t value)
+		{
+			__trace_spin guard;
+			trace_writer* w = __trace_state<>::writer;
+			if (w == 0)
+				return;
+			if (session != __trace_state<>::session)
+			{
+				int status = 0;
+				char* name = abi::__cxa_demangle(typeid(Tag).name(), 0, 0, &status);
+				stream = w->add_stream(status == 0 && name ? name : typeid(Tag).name());
+				std::free(name);
+				session = __trace_state<>::session;
+			}
+			try
+			{
+				w->append(op, stream, key, value);
+			}
+			catch (...)
+			{
+				/* 기록 실패로 container 연산이 실패하면 안 된다. 남은 record 는 버린다. */
+			}
+		}
+	};
+
+	template <class Tag>
+	uint16_t		__trace_hook<Tag>::stream = 0;
+	template <class Tag>
+	unsigned int	__trace_hook<Tag>::session = 0;
+
+}
+
+#endif
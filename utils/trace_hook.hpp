@@ -0,0 +1,20 @@
+#ifndef TRACE_HOOK_HPP
+# define TRACE_HOOK_HPP
+
+/* container 에 들어가는 trace hook (trace.hpp 참고)
+ *
+ * FT_TRACE 를 정의하지 않으면 hook 은 ((void)0) 이고 trace.hpp 는 include 하지 않는다.
+ * (파일 I/O 와 demangle 에 쓰는 <fcntl.h>, <cxxabi.h>, <typeinfo> 가 container 를 쓰는 모든 곳에 따라 들어가지 않게)
+ * trace 를 읽고 쓰는 도구는 trace.hpp 를 직접 include 한다.
+ */
+
+# ifdef FT_TRACE
+#  include "trace.hpp"
+#  define FT_TRACE_OP(Tag, op, item)			ft::__trace_hook<Tag>::record(ft::op, (item))
+#  define FT_TRACE_KV(Tag, op, key, value)	ft::__trace_hook<Tag>::record(ft::op, (key), (value))
+# else
+#  define FT_TRACE_OP(Tag, op, item)			((void)0)
+#  define FT_TRACE_KV(Tag, op, key, value)	((void)0)
+# endif
+
+#endif
@@ -13,10 +13,17 @@
 #ifndef VECTOR_HPP
 # define VECTOR_HPP
 
+# include <cstring>
+# include <limits>
 # include <memory>
 # include "utils/iterator.hpp"
 # include "utils/type.hpp"
 # include "utils/algorithm.hpp"
+# include "utils/snapshot.hpp"
+# include "utils/instrument.hpp"
+# include "utils/latency.hpp"
+# include "utils/trace_hook.hpp"
+# include "utils/footprint.hpp"
 
 /* std::allocator
  * 메모리 할당과 해제 클래스
@@ -99,6 +106,7 @@ namespace ft {
 				if (_begin == NULL)
 					return;
 				size_type x_capacity = capacity();
+				FT_OP_COUNT(vector, deallocations, 1);
 				_alloc_destroy(_begin);
 				_alloc.deallocate(_begin, x_capacity);
 			}
@@ -180,6 +188,7 @@ namespace ft {
 			받아올 인자 n이, capacity < n < capacity * 2 일경우 capacity를 2배로 늘려주고 각 멤버 값을 정리 후 재할당. */
 			void reserve(size_type n)
 			{
+				FT_LATENCY_SCOPE(vector, latency_reserve);
 				if (n <= size() || n <= capacity())
 					return;
 				if (n < capacity() * 2)
@@ -188,7 +197,15 @@ namespace ft {
 					throw std::length_error("ft::vector::reserve");
 				size_type x_size = size();
 				size_type x_capacity = capacity();
+				FT_OP_COUNT(vector, allocations, 1);
+				FT_OP_COUNT(vector, bytes_allocated, n * sizeof(T));
 				pointer _ptr = _alloc.allocate(n);
+				if (_begin != NULL)
+				{
+					FT_OP_COUNT(vector, reallocations, 1);
+					FT_OP_COUNT(vector, elements_copied, x_size);
+					FT_OP_COUNT(vector, deallocations, 1);
+				}
 				std::uninitialized_copy(_begin, _end, _ptr);
 				_alloc_destroy(_begin);
 				_alloc.deallocate(_begin, x_capacity);
@@ -220,13 +237,19 @@ namespace ft {
 			}
 			void push_back(const value_type& val)
 			{
+				FT_LATENCY_SCOPE(vector, latency_push_back);
+				FT_TRACE_OP(vector, trace_push, val);
 				size_type n = size() + 1;
 				if (capacity() < n)
 					reserve(n);
 				_alloc_construct(1);
 				*(_end - 1) = val;
 			}
-			void pop_back() { _alloc_destroy(1); }
+			void pop_back()
+			{
+				FT_TRACE_KV(vector, trace_pop, 0, 0);
+				_alloc_destroy(1);
+			}
 			// copy 차이 copy_backward
 			// 0 1 2 3 4 5 6 7 8 9
 			// lst   2 3 4 5 6    을 해당 위치에 대응되게 복사
@@ -236,6 +259,7 @@ namespace ft {
 			// copy_backward 는 원본을 먼저 옮겨두고 복사.
 			iterator insert(iterator _idx, const value_type& val)
 			{
+				FT_LATENCY_SCOPE(vector, latency_insert);
 				difference_type space = _idx - begin();
 				if (capacity() < size() + 1)
 					reserve(size() + 1);
@@ -247,6 +271,7 @@ namespace ft {
 			}
 			void insert(iterator _idx, size_type n, const value_type& val)
 			{
+				FT_LATENCY_SCOPE(vector, latency_insert);
 				difference_type space = _idx - begin();
 				if (capacity() < size() + n)
 					reserve(size() + n);
@@ -260,6 +285,7 @@ namespace ft {
 			void insert(iterator _idx, InputIterator first, InputIterator last,
 					typename ft::enable_if<!ft::is_integral<InputIterator>::value>::type* = ft::NIL)
 			{
+				FT_LATENCY_SCOPE(vector, latency_insert);
 				difference_type n = std::distance(first, last);
 				difference_type space = _idx - begin();
 				if (capacity() < size() + n)
@@ -276,6 +302,7 @@ namespace ft {
 
 			iterator erase(iterator _idx)
 			{
+				FT_LATENCY_SCOPE(vector, latency_erase);
 				difference_type space = _idx - begin();
 				pointer ptr = _begin + space;
 				std::copy(ptr + 1, _end, ptr);
@@ -284,6 +311,7 @@ namespace ft {
 			}
 			iterator erase(iterator first, iterator last)
 			{
+				FT_LATENCY_SCOPE(vector, latency_erase);
 				difference_type n = std::distance(first, last);
 				std::copy(last, end(), first);
 				_alloc_destroy(n);
@@ -296,14 +324,54 @@ namespace ft {
 				std::swap(_capacity, v._capacity);
 				std::swap(_alloc, v._alloc);
 			}
-			void clear() { _alloc_destroy(_begin); }
+			void clear()
+			{
+				FT_TRACE_KV(vector, trace_clear, 0, 0);
+				_alloc_destroy(_begin);
+			}
 
 			allocator_type get_allocator() const { return _alloc; }
 
+			/* payload : 원소, slack : capacity 중 빈 칸, overhead : vector 객체. 내역은 utils/footprint.hpp 참고 */
+			ft::memory_footprint memory_usage() const
+			{
+				ft::memory_footprint m;
+				m.payload = size() * sizeof(T);
+				m.slack = (capacity() - size()) * sizeof(T);
+				m.overhead = sizeof(*this);
+				if (_begin != NULL)
+					m.allocator = ft::__heap_block_overhead(capacity() * sizeof(T));
+				return m;
+			}
+
+			/* snapshot : 원소 배열을 그대로 fd 에 쓴다. (복사 없이 writev)
+			restore : snapshot 버퍼(보통 ft::snapshot_file)의 원소들로 내용을 바꾼다. memcpy 한 번
+			T 가 trivially copyable 일 때만 쓸 수 있다. 형식과 오류는 utils/snapshot.hpp 참고 */
+			void snapshot(int fd) const
+			{
+				ft::__snapshot_check<ft::__snapshot_safe<T>::value>::__ok();
+				ft::__snapshot_writer w(fd, ft::__snapshot_vector, sizeof(T), __alignof__(T), size());
+				w.__put(_begin, size() * sizeof(T));
+				w.__finish();
+			}
+			void restore(const void* data, size_type len)
+			{
+				ft::__snapshot_check<ft::__snapshot_safe<T>::value>::__ok();
+				ft::__snapshot_reader r(data, len, ft::__snapshot_vector, sizeof(T), __alignof__(T));
+				size_type n = r.__size();
+				clear();
+				reserve(n);
+				if (n > 0)
+					std::memcpy(static_cast<void*>(_begin), r.__data(), n * sizeof(T));
+				_end = _begin + n;
+			}
+
 			void	_vector_init(size_type n)
 			{
 				if (n > max_size())
 					{ throw std::length_error("ft::vector::_vector_init"); }
+				FT_OP_COUNT(vector, allocations, 1);
+				FT_OP_COUNT(vector, bytes_allocated, n * sizeof(T));
 				_begin = _alloc.allocate(n);
 				_end = _begin;
 				_capacity = _begin + n;